@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file marketdataconverter.cpp
+    \brief Convert csv market and fixing data files to a binary market data file
+*/
+
+#include <iostream>
+
+#include <boost/algorithm/string.hpp>
+
+#include <ored/marketdata/binaryloader.hpp>
+#include <ored/utilities/log.hpp>
+
+#ifdef BOOST_MSVC
+#include <ored/auto_link.hpp>
+#include <ql/auto_link.hpp>
+#include <qle/auto_link.hpp>
+#endif
+
+using namespace std;
+using namespace ore::data;
+
+int main(int argc, char** argv) {
+
+    if (argc != 4) {
+        cout << endl
+             << "usage: marketdataconverter marketFile1[,marketFile2,...] fixingFile1[,fixingFile2,...] outputFile"
+             << endl
+             << endl;
+        return -1;
+    }
+
+    try {
+        vector<string> marketFiles, fixingFiles;
+        boost::split(marketFiles, argv[1], boost::is_any_of(","), boost::token_compress_on);
+        boost::split(fixingFiles, argv[2], boost::is_any_of(","), boost::token_compress_on);
+        writeBinaryMarketData(marketFiles, fixingFiles, argv[3]);
+        cout << "wrote " << argv[3] << endl;
+        return 0;
+    } catch (const exception& e) {
+        cout << endl << "an error occured: " << e.what() << endl;
+        return -1;
+    }
+}
@@ -27,6 +27,7 @@
 #include <iostream>
 
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreserver.hpp>
 
 #ifdef BOOST_MSVC
 #include <orea/auto_link.hpp>
@@ -57,16 +58,48 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
-    if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+    // options precede the input file, the shard options can be combined
+    bool server = false, merge = false;
+    vector<pair<string, string>> shards;
+    bool usage = argc < 2 || string(argv[argc - 1]).compare(0, 2, "--") == 0;
+    for (int i = 1; i < argc - 1 && !usage; ++i) {
+        string option(argv[i]);
+        if (option == "--server")
+            server = true;
+        else if (option == "--merge-shards")
+            merge = true;
+        else if ((option == "--shard" || option == "--trade-shard") && i + 1 < argc - 1)
+            shards.push_back(make_pair(option, string(argv[++i])));
+        else
+            usage = true;
+    }
+    if (usage || (server && (merge || !shards.empty())) || (merge && !shards.empty())) {
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --server path/to/ore.xml (answer requests read from stdin)" << endl;
+        std::cout << "       ORE [--shard i/n] [--trade-shard j/m] path/to/ore.xml (simulate one cube shard)" << endl;
+        std::cout << "       ORE --merge-shards path/to/ore.xml (merge the cube shards, then run the analytics)" << endl
+                  << endl;
         return -1;
     }
 
-    string inputFile(argv[1]);
+    string inputFile(argv[argc - 1]);
 
     boost::shared_ptr<Parameters> params = boost::make_shared<Parameters>();
     try {
         params->fromFile(inputFile);
+        for (auto const& s : shards) {
+            string prefix = s.first == "--shard" ? "shard" : "tradeShard";
+            auto slash = s.second.find('/');
+            QL_REQUIRE(slash != string::npos, "expected " << s.first << " index/count, got " << s.second);
+            params->set("simulation", prefix + "Index", s.second.substr(0, slash));
+            params->set("simulation", prefix + "Count", s.second.substr(slash + 1));
+        }
+        if (merge)
+            params->set("simulation", "mergeShards", "Y");
+        if (server) {
+            OREServer ore(params, cerr);
+            return ore.serve(cin, cout);
+        }
         OREApp ore(params);
         return ore.run();
     } catch (const exception& e) {
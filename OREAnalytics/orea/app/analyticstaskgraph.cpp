@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/analyticstaskgraph.hpp>
+#include <ored/utilities/log.hpp>
+#include <ql/errors.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+AnalyticsTaskGraph::AnalyticsTaskGraph(const Size threads) : threads_(threads) {
+    QL_REQUIRE(threads_ > 0, "AnalyticsTaskGraph: at least one thread required");
+}
+
+void AnalyticsTaskGraph::add(const std::string& name, const std::vector<std::string>& dependencies,
+                             const std::function<void()>& task, const bool concurrent) {
+    Task t = {name, task, {}, concurrent, false, 0.0};
+    for (auto const& d : dependencies) {
+        Size i = 0;
+        while (i < tasks_.size() && tasks_[i].name != d)
+            ++i;
+        QL_REQUIRE(i < tasks_.size(), "AnalyticsTaskGraph: dependency " << d << " of task " << name
+                                                                        << " must be added before the task");
+        t.dependencies.push_back(i);
+    }
+    tasks_.push_back(t);
+}
+
+double AnalyticsTaskGraph::execute(Task& task) const {
+    LOG("Task " << task.name << " started");
+    auto start = std::chrono::steady_clock::now();
+    task.task();
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG("Task " << task.name << " done in " << time << " sec");
+    return time;
+}
+
+void AnalyticsTaskGraph::run() {
+    for (auto& t : tasks_)
+        t.done = false;
+
+    // the worker threads signal the indices of the finished tasks, declared before the futures so that they
+    // outlive the threads
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    std::vector<Size> finished;
+    auto waitForAny = [&mutex, &finishedCondition, &finished]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finishedCondition.wait(lock, [&finished]() { return !finished.empty(); });
+    };
+
+    std::map<Size, std::future<double>> running;
+    std::exception_ptr error;
+    std::vector<bool> started(tasks_.size(), false);
+    auto ready = [this, &started](Size i) {
+        if (started[i])
+            return false;
+        for (auto d : tasks_[i].dependencies) {
+            if (!tasks_[d].done)
+                return false;
+        }
+        return true;
+    };
+
+    Size done = 0;
+    while (done < tasks_.size()) {
+        // collect the concurrent tasks that have finished
+        std::vector<Size> collect;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            collect.swap(finished);
+        }
+        for (auto i : collect) {
+            auto it = running.find(i);
+            try {
+                tasks_[i].time = it->second.get();
+                tasks_[i].done = true;
+                ++done;
+            } catch (...) {
+                if (!error)
+                    error = std::current_exception();
+            }
+            running.erase(it);
+        }
+        if (error) {
+            if (running.empty())
+                break;
+            waitForAny();
+            continue;
+        }
+        if (done == tasks_.size())
+            break;
+
+        bool progress = false;
+        // start concurrent tasks on worker threads, the calling thread counts as one thread
+        for (Size i = 0; i < tasks_.size() && threads_ > 1 && running.size() + 1 < threads_; ++i) {
+            if (tasks_[i].concurrent && ready(i)) {
+                started[i] = true;
+                running[i] = std::async(std::launch::async, [this, i, &mutex, &finishedCondition, &finished]() {
+                    double time = 0.0;
+                    std::exception_ptr taskError;
+                    try {
+                        time = execute(tasks_[i]);
+                    } catch (...) {
+                        taskError = std::current_exception();
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished.push_back(i);
+                    }
+                    finishedCondition.notify_one();
+                    if (taskError)
+                        std::rethrow_exception(taskError);
+                    return time;
+                });
+                progress = true;
+            }
+        }
+        // run the next task on the calling thread
+        for (Size i = 0; i < tasks_.size(); ++i) {
+            if ((!tasks_[i].concurrent || threads_ == 1) && ready(i)) {
+                started[i] = true;
+                try {
+                    tasks_[i].time = execute(tasks_[i]);
+                    tasks_[i].done = true;
+                    ++done;
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                progress = true;
+                break;
+            }
+        }
+
+        if (!progress) {
+            // everything left waits for a concurrent task
+            QL_REQUIRE(!running.empty(), "AnalyticsTaskGraph: no task can be started");
+            waitForAny();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::vector<std::pair<std::string, double>> AnalyticsTaskGraph::timings() const {
+    std::vector<std::pair<std::string, double>> result;
+    for (auto const& t : tasks_) {
+        if (t.done)
+            result.push_back(std::make_pair(t.name, t.time));
+    }
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/analyticstaskgraph.hpp
+    \brief Runs the analytics of an ORE run as a graph of dependent tasks
+    \ingroup app
+*/
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Runs the analytics of an ORE run as a graph of dependent tasks
+/*! Each task names the tasks whose results it needs. Tasks must be added after their dependencies, so that the
+    order in which they are added is a valid sequential order.
+
+    Most analytics move the global evaluation date, add fixings or rely on the lazy recalculation of instruments
+    shared with other analytics, so that they have to run on the calling thread one after the other. Tasks that
+    only use their own data, e.g. loading a cube from file or aggregating sensitivities read from file, can be
+    marked as concurrent. If more than one thread is available, they run on worker threads as soon as their
+    dependencies are done, overlapping with the other tasks. Concurrent tasks must not write to the console; the
+    log is safe to use from several threads.
+
+    If a task throws, no further tasks are started, running tasks are waited for and the first error is rethrown.
+
+    \ingroup app
+*/
+class AnalyticsTaskGraph {
+public:
+    explicit AnalyticsTaskGraph(const QuantLib::Size threads = 1);
+
+    //! add a task depending on the given tasks, which must have been added before
+    void add(const std::string& name, const std::vector<std::string>& dependencies,
+             const std::function<void()>& task, const bool concurrent = false);
+
+    //! run all tasks
+    void run();
+
+    //! names and wall clock times in seconds of the completed tasks, in the order they were added
+    std::vector<std::pair<std::string, double>> timings() const;
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> task;
+        std::vector<QuantLib::Size> dependencies;
+        bool concurrent;
+        bool done;
+        double time;
+    };
+    double execute(Task& task) const;
+
+    QuantLib::Size threads_;
+    std::vector<Task> tasks_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -53,6 +53,28 @@ vector<string> getFilenames(const string& fileString, const string& path) {
     return fileNames;
 }
 
+// the contiguous range [first, end) of n items covered by shard index out of count shards
+std::pair<Size, Size> shardRange(Size n, Size index, Size count) {
+    return std::make_pair(index * n / count, (index + 1) * n / count);
+}
+
+string shardFileName(const string& fileName, Size sampleShard, Size tradeShard) {
+    return fileName + ".shard_" + std::to_string(sampleShard) + "_" + std::to_string(tradeShard);
+}
+
+// releases the sim markets and portfolios shared between the analytics of a run, also if the run fails
+struct ScenarioSimMarketCacheGuard {
+    ~ScenarioSimMarketCacheGuard() {
+        ScenarioSimMarketCache& cache = ScenarioSimMarketCache::instance();
+        if (cache.enabled()) {
+            // read outside of the LOG statement, which holds the log mutex
+            Size hits = cache.hits(), misses = cache.misses();
+            LOG("Simulation market cache: " << hits << " reused, " << misses << " built");
+            cache.clear();
+        }
+    }
+};
+
 } // anonymous namespace
 
 namespace ore {
@@ -79,139 +101,193 @@ OREApp::~OREApp() {
 int OREApp::run() {
 
     boost::timer timer;
+    ScenarioSimMarketCacheGuard simMarketCacheGuard;
 
     try {
         out_ << "ORE starting" << std::endl;
         LOG("ORE starting");
         // readSetup();
 
+        // The analytics form a graph of tasks, most of them have to run one after the other on this thread since
+        // they move the global evaluation date or share the T0 portfolio, tasks that only work on their own data
+        // may run concurrently if more than one thread is configured
+        AnalyticsTaskGraph tasks(analyticsThreads_);
+
         /*********
          * Build Markets
          */
-        out_ << setw(tab_) << left << "Market... " << flush;
-        buildMarket();
-        out_ << "OK" << endl;
+        tasks.add("Market", {}, [this]() {
+            out_ << setw(tab_) << left << "Market... " << flush;
+            buildMarket();
+            out_ << "OK" << endl;
+        });
 
         /************************
          *Build Pricing Engine Factory
          */
-        out_ << setw(tab_) << left << "Engine factory... " << flush;
-        engineFactory_ = buildEngineFactory(market_);
-        out_ << "OK" << endl;
+        tasks.add("Engine factory", {"Market"}, [this]() {
+            out_ << setw(tab_) << left << "Engine factory... " << flush;
+            engineFactory_ = buildEngineFactory(market_);
+            out_ << "OK" << endl;
+        });
 
         /******************************
          * Load and Build the Portfolio
          */
-        out_ << setw(tab_) << left << "Portfolio... " << flush;
-        portfolio_ = buildPortfolio(engineFactory_);
-        out_ << "OK" << endl;
+        tasks.add("Portfolio", {"Engine factory"}, [this]() {
+            out_ << setw(tab_) << left << "Portfolio... " << flush;
+            portfolio_ = buildPortfolio(engineFactory_);
+            out_ << "OK" << endl;
+        });
 
         /******************************
          * Write initial reports
          */
-        out_ << setw(tab_) << left << "Write Reports... " << flush;
-        writeInitialReports();
-        out_ << "OK" << endl;
+        tasks.add("Initial reports", {"Portfolio"}, [this]() {
+            out_ << setw(tab_) << left << "Write Reports... " << flush;
+            if (writeInitialReports_) {
+                writeInitialReports();
+                out_ << "OK" << endl;
+            } else {
+                LOG("skip initial reports");
+                out_ << "SKIP" << endl;
+            }
+        });
 
         /**************************
          * Write base scenario file
          */
-        out_ << setw(tab_) << left << "Write Base Scenario... " << flush;
-        if (writeBaseScenario_) {
-            writeBaseScenario();
-            out_ << "OK" << endl;
-        } else {
-            LOG("skip base scenario");
-            out_ << "SKIP" << endl;
-        }
+        tasks.add("Base scenario", {"Market"}, [this]() {
+            out_ << setw(tab_) << left << "Write Base Scenario... " << flush;
+            if (writeBaseScenario_) {
+                writeBaseScenario();
+                out_ << "OK" << endl;
+            } else {
+                LOG("skip base scenario");
+                out_ << "SKIP" << endl;
+            }
+        });
 
         /**********************
          * Sensitivity analysis
          */
-        if (sensitivity_) {
-            out_ << setw(tab_) << left << "Sensitivity Report... " << flush;
-
-            // We reset this here because the date grid building in sensitivity analysis depends on it.
-            Settings::instance().evaluationDate() = asof_;
-            getSensitivityRunner()->runSensitivityAnalysis(market_, conventions_, curveConfigs_, marketParameters_);
-            out_ << "OK" << endl;
-        } else {
-            LOG("skip sensitivity analysis");
-            out_ << setw(tab_) << left << "Sensitivity... ";
-            out_ << "SKIP" << endl;
-        }
+        tasks.add("Sensitivity", {"Market"}, [this]() {
+            if (sensitivity_) {
+                out_ << setw(tab_) << left << "Sensitivity Report... " << flush;
+
+                // We reset this here because the date grid building in sensitivity analysis depends on it.
+                Settings::instance().evaluationDate() = asof_;
+                getSensitivityRunner()->runSensitivityAnalysis(market_, conventions_, curveConfigs_,
+                                                               marketParameters_);
+                out_ << "OK" << endl;
+            } else {
+                LOG("skip sensitivity analysis");
+                out_ << setw(tab_) << left << "Sensitivity... ";
+                out_ << "SKIP" << endl;
+            }
+        });
 
         /****************
          * Stress testing
          */
-        if (stress_) {
-            runStressTest();
-        } else {
-            LOG("skip stress test");
-            out_ << setw(tab_) << left << "Stress testing... ";
-            out_ << "SKIP" << endl;
-        }
+        tasks.add("Stress test", {"Market"}, [this]() {
+            if (stress_) {
+                runStressTest();
+            } else {
+                LOG("skip stress test");
+                out_ << setw(tab_) << left << "Stress testing... ";
+                out_ << "SKIP" << endl;
+            }
+        });
 
         /****************
          * Parametric VaR
          */
+        // reads the sensitivities from file and only needs the trade ids of the portfolio, so it can run
+        // alongside the remaining analytics; its status is reported once all tasks are done
         if (parametricVar_) {
-            runParametricVar();
+            tasks.add("Parametric VaR", {"Portfolio", "Sensitivity"}, [this]() { runParametricVar(); }, true);
         } else {
-            LOG("skip parametric var");
-            out_ << setw(tab_) << left << "Parametric VaR... ";
-            out_ << "SKIP" << endl;
+            tasks.add("Parametric VaR", {}, [this]() {
+                LOG("skip parametric var");
+                out_ << setw(tab_) << left << "Parametric VaR... ";
+                out_ << "SKIP" << endl;
+            });
         }
 
         /******************************************
          * Simulation: Scenario and Cube Generation
          */
-
-        if (simulate_) {
-            generateNPVCube();
-        } else {
-            LOG("skip simulation");
-            out_ << setw(tab_) << left << "Simulation... ";
-            out_ << "SKIP" << endl;
-        }
+        tasks.add("Simulation", {"Portfolio"}, [this]() {
+            if (simulate_) {
+                if (mergeShards_)
+                    mergeCubeShards();
+                else if (incrementalTrades_.empty())
+                    generateNPVCube();
+                else
+                    generateIncrementalNPVCube();
+            } else {
+                LOG("skip simulation");
+                out_ << setw(tab_) << left << "Simulation... ";
+                out_ << "SKIP" << endl;
+            }
+        });
 
         /*****************************
          * Aggregation and XVA Reports
          */
-        out_ << setw(tab_) << left << "Aggregation and XVA Reports... " << flush;
-        if (xva_) {
-
-            // We reset this here because the date grid building below depends on it.
-            Settings::instance().evaluationDate() = asof_;
-
-            // Use pre-generated cube
-            if (!cube_)
-                loadCube();
-
-            QL_REQUIRE(cube_->numIds() == portfolio_->size(),
-                       "cube x dimension (" << cube_->numIds() << ") does not match portfolio size ("
-                                            << portfolio_->size() << ")");
-
-            // Use pre-generared scenarios
-            if (!scenarioData_)
-                loadScenarioData();
-
-            QL_REQUIRE(scenarioData_->dimDates() == cube_->dates().size(),
-                       "scenario dates do not match cube grid size");
-            QL_REQUIRE(scenarioData_->dimSamples() == cube_->samples(),
-                       "scenario sample size does not match cube sample size");
-
-            runPostProcessor();
-            out_ << "OK" << endl;
-            out_ << setw(tab_) << left << "Write Reports... " << flush;
-            writeXVAReports();
-            if (writeDIMReport_)
-                writeDIMReport();
-            out_ << "OK" << endl;
-        } else {
-            LOG("skip XVA reports");
-            out_ << "SKIP" << endl;
+        vector<string> xvaDependencies = {"Portfolio", "Simulation"};
+        if (xva_ && !simulate_) {
+            // pre-generated cube and scenarios, loaded from file while the other analytics run
+            tasks.add("Load cube", {}, [this]() { loadCube(); }, true);
+            tasks.add("Load scenario data", {}, [this]() { loadScenarioData(); }, true);
+            xvaDependencies.push_back("Load cube");
+            xvaDependencies.push_back("Load scenario data");
         }
+        tasks.add("XVA", xvaDependencies, [this]() {
+            out_ << setw(tab_) << left << "Aggregation and XVA Reports... " << flush;
+            if (xva_) {
+
+                // We reset this here because the date grid building below depends on it.
+                Settings::instance().evaluationDate() = asof_;
+
+                // Use pre-generated cube
+                if (!cube_)
+                    loadCube();
+
+                QL_REQUIRE(cube_->numIds() == portfolio_->size(),
+                           "cube x dimension (" << cube_->numIds() << ") does not match portfolio size ("
+                                                << portfolio_->size() << ")");
+
+                // Use pre-generared scenarios
+                if (!scenarioData_)
+                    loadScenarioData();
+
+                QL_REQUIRE(scenarioData_->dimDates() == cube_->dates().size(),
+                           "scenario dates do not match cube grid size");
+                QL_REQUIRE(scenarioData_->dimSamples() == cube_->samples(),
+                           "scenario sample size does not match cube sample size");
+
+                runPostProcessor();
+                out_ << "OK" << endl;
+                out_ << setw(tab_) << left << "Write Reports... " << flush;
+                writeXVAReports();
+                if (writeDIMReport_)
+                    writeDIMReport();
+                out_ << "OK" << endl;
+            } else {
+                LOG("skip XVA reports");
+                out_ << "SKIP" << endl;
+            }
+        });
+
+        tasks.run();
+
+        if (parametricVar_)
+            out_ << setw(tab_) << left << "Parametric VaR Report... " << "OK" << endl;
+
+        for (auto const& t : tasks.timings())
+            out_ << setw(tab_) << left << t.first + " run time: " << setprecision(2) << t.second << " sec" << endl;
 
     } catch (std::exception& e) {
         ALOG("Error: " << e.what());
@@ -239,6 +315,28 @@ void OREApp::readSetup() {
         LOG("Observation Mode is " << om);
     }
 
+    if (params_->has("setup", "bootstrapWarmStart") && parseBool(params_->get("setup", "bootstrapWarmStart"))) {
+        YieldCurveWarmStarts::instance().setEnabled(true);
+        if (params_->has("setup", "bootstrapGlobalNewton"))
+            YieldCurveWarmStarts::instance().setGlobalNewton(parseBool(params_->get("setup", "bootstrapGlobalNewton")));
+        LOG("Yield curve bootstrap warm start enabled, global Newton is "
+            << (YieldCurveWarmStarts::instance().globalNewton() ? "on" : "off"));
+    }
+
+    analyticsThreads_ = 1;
+    if (params_->has("setup", "analyticsThreads")) {
+        int threads = parseInteger(params_->get("setup", "analyticsThreads"));
+        QL_REQUIRE(threads >= 1, "analyticsThreads must be at least 1, got " << threads);
+        analyticsThreads_ = threads;
+        LOG("Using " << analyticsThreads_ << " threads for concurrent analytics");
+    }
+
+    if (params_->has("setup", "reuseSimulationMarket") &&
+        parseBool(params_->get("setup", "reuseSimulationMarket"))) {
+        ScenarioSimMarketCache::instance().setEnabled(true);
+        LOG("Simulation market and portfolio reuse across analytics enabled");
+    }
+
     writeInitialReports_ = true;
     simulate_ = (params_->hasGroup("simulation") && params_->get("simulation", "active") == "Y") ? true : false;
     buildSimMarket_ = true;
@@ -256,6 +354,81 @@ void OREApp::readSetup() {
     continueOnError_ = false;
     if (params_->has("setup", "continueOnError"))
         continueOnError_ = parseBool(params_->get("setup", "continueOnError"));
+
+    binaryReports_ = false;
+    if (params_->has("setup", "reportFormat")) {
+        string format = params_->get("setup", "reportFormat");
+        QL_REQUIRE(format == "csv" || format == "binary",
+                   "reportFormat " << format << " not recognised, expected csv or binary");
+        binaryReports_ = format == "binary";
+    }
+
+    incrementalTrades_.clear();
+    if (simulate_ && params_->has("simulation", "incrementalTrades")) {
+        for (auto const& t : parseListOfValues(params_->get("simulation", "incrementalTrades")))
+            incrementalTrades_.insert(t);
+        LOG("Incremental simulation for " << incrementalTrades_.size() << " new or amended trades");
+    }
+
+    shardCount_ = 1;
+    shardIndex_ = 0;
+    tradeShardCount_ = 1;
+    tradeShardIndex_ = 0;
+    firstSample_ = 0;
+    mergeShards_ = false;
+    if (params_->hasGroup("simulation")) {
+        if (params_->has("simulation", "shardCount"))
+            shardCount_ = parseInteger(params_->get("simulation", "shardCount"));
+        if (params_->has("simulation", "shardIndex"))
+            shardIndex_ = parseInteger(params_->get("simulation", "shardIndex"));
+        if (params_->has("simulation", "tradeShardCount"))
+            tradeShardCount_ = parseInteger(params_->get("simulation", "tradeShardCount"));
+        if (params_->has("simulation", "tradeShardIndex"))
+            tradeShardIndex_ = parseInteger(params_->get("simulation", "tradeShardIndex"));
+        if (params_->has("simulation", "mergeShards"))
+            mergeShards_ = parseBool(params_->get("simulation", "mergeShards"));
+    }
+    QL_REQUIRE(shardIndex_ < shardCount_, "shardIndex (" << shardIndex_ << ") must be less than shardCount");
+    QL_REQUIRE(tradeShardIndex_ < tradeShardCount_,
+               "tradeShardIndex (" << tradeShardIndex_ << ") must be less than tradeShardCount");
+    sharded_ = simulate_ && !mergeShards_ && (shardCount_ > 1 || tradeShardCount_ > 1);
+    if (sharded_) {
+        QL_REQUIRE(incrementalTrades_.empty(), "incremental simulation can not be sharded");
+        LOG("Sharded simulation: sample shard " << shardIndex_ << " of " << shardCount_ << ", trade shard "
+                                                << tradeShardIndex_ << " of " << tradeShardCount_);
+        // a shard only writes its part of the cube, all other analytics run once on the merged cube
+        writeInitialReports_ = false;
+        writeBaseScenario_ = false;
+        sensitivity_ = false;
+        stress_ = false;
+        parametricVar_ = false;
+        xva_ = false;
+        writeDIMReport_ = false;
+    }
+
+    compressCube_ = false;
+    cubeMaxError_ = 0.0;
+    if (params_->hasGroup("simulation")) {
+        if (params_->has("simulation", "cubeCompression"))
+            compressCube_ = parseBool(params_->get("simulation", "cubeCompression"));
+        if (params_->has("simulation", "cubeMaxError"))
+            cubeMaxError_ = parseReal(params_->get("simulation", "cubeMaxError"));
+    }
+
+    checkpointInterval_ = 0;
+    resume_ = false;
+    startSample_ = 0;
+    if (simulate_) {
+        if (params_->has("simulation", "checkpointInterval"))
+            checkpointInterval_ = parseInteger(params_->get("simulation", "checkpointInterval"));
+        if (params_->has("simulation", "resume"))
+            resume_ = parseBool(params_->get("simulation", "resume"));
+    }
+    if (checkpointInterval_ > 0 || resume_) {
+        QL_REQUIRE(params_->has("simulation", "cubeFile"), "checkpoint and resume require the simulation cubeFile");
+        QL_REQUIRE(incrementalTrades_.empty(), "incremental simulation does not support checkpoint and resume");
+        LOG("Cube checkpoint every " << checkpointInterval_ << " samples, resume " << std::boolalpha << resume_);
+    }
 }
 
 void OREApp::setupLog() {
@@ -325,18 +498,47 @@ boost::shared_ptr<TradeFactory> OREApp::buildTradeFactory() const {
     return boost::make_shared<TradeFactory>(getExtraTradeBuilders());
 }
 
+boost::shared_ptr<Portfolio> OREApp::loadPortfolio() {
+    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
+    string portfoliosString = params_->get("setup", "portfolioFile");
+    if (portfoliosString == "")
+        return portfolio;
+    for (auto portfolioFile : getFilenames(portfoliosString, inputPath_))
+        portfolio->load(portfolioFile, buildTradeFactory());
+    return portfolio;
+}
+
 boost::shared_ptr<Portfolio> OREApp::buildPortfolio(const boost::shared_ptr<EngineFactory>& factory) {
 
     MEM_LOG;
     LOG("Building portfolio");
 
-    string portfoliosString = params_->get("setup", "portfolioFile");
+    if (params_->get("setup", "portfolioFile") == "")
+        return boost::make_shared<Portfolio>();
+    boost::shared_ptr<Portfolio> portfolio = loadPortfolio();
+    portfolio->build(factory);
+
+    LOG("Portfolio built");
+    MEM_LOG;
+
+    return portfolio;
+}
+
+boost::shared_ptr<Portfolio> OREApp::buildPortfolio(const boost::shared_ptr<EngineFactory>& factory,
+                                                    const std::set<std::string>& tradeIds) {
+
+    MEM_LOG;
+    LOG("Building " << tradeIds.size() << " trades of the portfolio");
+
     boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
     if (params_->get("setup", "portfolioFile") == "")
         return portfolio;
-    vector<string> portfolioFiles = getFilenames(portfoliosString, inputPath_);
-    for (auto portfolioFile : portfolioFiles) {
-        portfolio->load(portfolioFile, buildTradeFactory());
+    Portfolio fullPortfolio;
+    for (auto portfolioFile : getFilenames(params_->get("setup", "portfolioFile"), inputPath_))
+        fullPortfolio.load(portfolioFile, buildTradeFactory());
+    for (auto const& t : fullPortfolio.trades()) {
+        if (tradeIds.count(t->id()) > 0)
+            portfolio->add(t);
     }
     portfolio->build(factory);
 
@@ -363,6 +565,18 @@ boost::shared_ptr<ScenarioGenerator>
 OREApp::buildScenarioGenerator(boost::shared_ptr<Market> market,
                                boost::shared_ptr<ScenarioSimMarketParameters> simMarketData,
                                boost::shared_ptr<ScenarioGeneratorData> sgd) {
+    // Optionally replay previously stored scenarios instead of building the model
+    if (params_->has("simulation", "scenarioReplayFile")) {
+        string filename = outputPath_ + "/" + params_->get("simulation", "scenarioReplayFile");
+        LOG("Replay scenarios from binary file " << filename);
+        boost::shared_ptr<BinaryScenarioGenerator> replay =
+            boost::make_shared<BinaryScenarioGenerator>(filename, boost::make_shared<SimpleScenarioFactory>());
+        QL_REQUIRE(replay->dates() == sgd->grid()->dates(), "scenario file dates do not match the simulation grid");
+        QL_REQUIRE(replay->samples() >= sgd->samples(),
+                   "scenario file holds " << replay->samples() << " samples, " << sgd->samples() << " required");
+        return replay;
+    }
+
     LOG("Build Simulation Model");
     string simulationConfigFile = inputPath_ + "/" + params_->get("simulation", "simulationConfigFile");
     LOG("Load simulation model data from file: " << simulationConfigFile);
@@ -398,9 +612,19 @@ OREApp::buildScenarioGenerator(boost::shared_ptr<Market> market,
         string filename = outputPath_ + "/" + params_->get("simulation", "scenariodump");
         sg = boost::make_shared<ScenarioWriter>(sg, filename);
     }
+    if (params_->has("simulation", "scenarioStoreFile")) {
+        string filename = outputPath_ + "/" + params_->get("simulation", "scenarioStoreFile");
+        bool singlePrecision = params_->has("simulation", "scenarioStoreSinglePrecision") &&
+                               parseBool(params_->get("simulation", "scenarioStoreSinglePrecision"));
+        sg = boost::make_shared<BinaryScenarioWriter>(sg, filename, singlePrecision);
+    }
     return sg;
 }
 
+boost::shared_ptr<Report> OREApp::makeReport(const string& fileName) const {
+    return makeFileReport(fileName, binaryReports_);
+}
+
 void OREApp::writeInitialReports() {
 
     MEM_LOG;
@@ -412,9 +636,9 @@ void OREApp::writeInitialReports() {
     out_ << endl << setw(tab_) << left << "Curve Report... " << flush;
     if (params_->hasGroup("curves") && params_->get("curves", "active") == "Y") {
         string fileName = outputPath_ + "/" + params_->get("curves", "outputFileName");
-        CSVFileReport curvesReport(fileName);
+        boost::shared_ptr<Report> curvesReport = makeReport(fileName);
         DateGrid grid(params_->get("curves", "grid"));
-        getReportWriter()->writeCurves(curvesReport, params_->get("curves", "configuration"), grid, marketParameters_,
+        getReportWriter()->writeCurves(*curvesReport, params_->get("curves", "configuration"), grid, marketParameters_,
                                        market_, continueOnError_);
         out_ << "OK" << endl;
     } else {
@@ -428,8 +652,8 @@ void OREApp::writeInitialReports() {
     out_ << setw(tab_) << left << "NPV Report... " << flush;
     if (params_->hasGroup("npv") && params_->get("npv", "active") == "Y") {
         string fileName = outputPath_ + "/" + params_->get("npv", "outputFileName");
-        CSVFileReport npvReport(fileName);
-        getReportWriter()->writeNpv(npvReport, params_->get("npv", "baseCurrency"), market_,
+        boost::shared_ptr<Report> npvReport = makeReport(fileName);
+        getReportWriter()->writeNpv(*npvReport, params_->get("npv", "baseCurrency"), market_,
                                     params_->get("markets", "pricing"), portfolio_);
         out_ << "OK" << endl;
     } else {
@@ -443,8 +667,8 @@ void OREApp::writeInitialReports() {
     out_ << setw(tab_) << left << "Cashflow Report... " << flush;
     if (params_->hasGroup("cashflow") && params_->get("cashflow", "active") == "Y") {
         string fileName = outputPath_ + "/" + params_->get("cashflow", "outputFileName");
-        CSVFileReport cashflowReport(fileName);
-        getReportWriter()->writeCashflow(cashflowReport, portfolio_);
+        boost::shared_ptr<Report> cashflowReport = makeReport(fileName);
+        getReportWriter()->writeCashflow(*cashflowReport, portfolio_);
         out_ << "OK" << endl;
     } else {
         LOG("skip cashflow generation");
@@ -460,8 +684,10 @@ boost::shared_ptr<ReportWriter> OREApp::getReportWriter() const {
 }
 
 boost::shared_ptr<SensitivityRunner> OREApp::getSensitivityRunner() {
-    return boost::make_shared<SensitivityRunner>(params_, getExtraTradeBuilders(), getExtraEngineBuilders(),
-                                                 getExtraLegBuilders(), continueOnError_);
+    auto runner = boost::make_shared<SensitivityRunner>(params_, getExtraTradeBuilders(), getExtraEngineBuilders(),
+                                                        getExtraLegBuilders(), continueOnError_, binaryReports_);
+    runner->setPortfolio(loadPortfolio());
+    return runner;
 }
 
 void OREApp::runStressTest() {
@@ -489,10 +715,8 @@ void OREApp::runStressTest() {
     engineData->fromFile(pricingEnginesFile);
 
     LOG("Get Portfolio");
-    string portfolioFile = inputPath_ + "/" + params_->get("setup", "portfolioFile");
-    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
-    // Just load here. We build the portfolio in SensitivityAnalysis, after building SimMarket.
-    portfolio->load(portfolioFile);
+    // Just load here. We build the portfolio in StressTest, after building SimMarket.
+    boost::shared_ptr<Portfolio> portfolio = loadPortfolio();
 
     LOG("Build Stress Test");
     string marketConfiguration = params_->get("markets", "pricing");
@@ -502,7 +726,7 @@ void OREApp::runStressTest() {
 
     string outputFile = outputPath_ + "/" + params_->get("stress", "scenarioOutputFile");
     Real threshold = parseReal(params_->get("stress", "outputThreshold"));
-    boost::shared_ptr<Report> stressReport = boost::make_shared<CSVFileReport>(outputFile);
+    boost::shared_ptr<Report> stressReport = makeReport(outputFile);
     stressTest->writeReport(stressReport, threshold);
 
     out_ << "OK" << endl;
@@ -516,8 +740,6 @@ void OREApp::runParametricVar() {
     MEM_LOG;
     LOG("Running parametric VaR");
 
-    out_ << setw(tab_) << left << "Parametric VaR Report... " << flush;
-
     LOG("Get sensitivity data");
     string sensiFile = inputPath_ + "/" + params_->get("parametricVar", "sensitivityInputFile");
     auto ss = boost::make_shared<SensitivityFileStream>(sensiFile);
@@ -549,9 +771,8 @@ void OREApp::runParametricVar() {
                                      method, mcSamples, mcSeed, parseBool(params_->get("parametricVar", "breakdown")),
                                      parseBool(params_->get("parametricVar", "salvageCovarianceMatrix")));
 
-    CSVFileReport report(outputPath_ + "/" + params_->get("parametricVar", "outputFile"));
-    calc->calculate(report);
-    out_ << "OK" << endl;
+    boost::shared_ptr<Report> report = makeReport(outputPath_ + "/" + params_->get("parametricVar", "outputFile"));
+    calc->calculate(*report);
 
     LOG("Parametric VaR completed");
     MEM_LOG;
@@ -611,15 +832,31 @@ void OREApp::initAggregationScenarioData() {
     scenarioData_ = boost::make_shared<InMemoryAggregationScenarioData>(grid_->size(), samples_);
 }
 
-void OREApp::initCube() {
-    if (cubeDepth_ == 1)
-        cube_ = boost::make_shared<SinglePrecisionInMemoryCube>(asof_, simPortfolio_->ids(), grid_->dates(), samples_);
-    else if (cubeDepth_ == 2)
-        cube_ = boost::make_shared<SinglePrecisionInMemoryCubeN>(asof_, simPortfolio_->ids(), grid_->dates(), samples_,
-                                                                 cubeDepth_);
-    else {
-        QL_FAIL("cube depth 1 or 2 expected");
-    }
+void OREApp::initCube() { cube_ = createCube(simPortfolio_->ids()); }
+
+boost::shared_ptr<NPVCube> OREApp::createCube(const vector<string>& ids) const {
+    QL_REQUIRE(cubeDepth_ == 1 || cubeDepth_ == 2, "cube depth 1 or 2 expected");
+    if (compressCube_)
+        return boost::make_shared<CompressedInMemoryCube>(asof_, ids, grid_->dates(), samples_, cubeDepth_,
+                                                          cubeMaxError_);
+    else if (cubeDepth_ == 1)
+        return boost::make_shared<SinglePrecisionInMemoryCube>(asof_, ids, grid_->dates(), samples_);
+    else
+        return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof_, ids, grid_->dates(), samples_, cubeDepth_);
+}
+
+boost::shared_ptr<NPVCube> OREApp::loadCubeFile(const string& fileName, bool compressed) const {
+    boost::shared_ptr<NPVCube> cube;
+    if (compressed)
+        cube = boost::make_shared<CompressedInMemoryCube>();
+    else if (cubeDepth_ > 1)
+        cube = boost::make_shared<SinglePrecisionInMemoryCubeN>();
+    else
+        cube = boost::make_shared<SinglePrecisionInMemoryCube>();
+    cube->load(fileName);
+    QL_REQUIRE(cube->depth() == cubeDepth_,
+               "cube " << fileName << " has depth " << cube->depth() << ", expected " << cubeDepth_);
+    return cube;
 }
 
 void OREApp::buildNPVCube() {
@@ -632,6 +869,28 @@ void OREApp::buildNPVCube() {
         calculators.push_back(boost::make_shared<CashflowCalculator>(baseCurrency, asof_, grid_, 1));
     LOG("Build cube");
     ValuationEngine engine(asof_, grid_, simMarket_);
+    engine.setFirstSample(firstSample_);
+    engine.setStartSample(startSample_);
+    if (checkpointInterval_ > 0)
+        engine.setCheckpoint(checkpointInterval_, [this](Size samples) { writeCheckpoint(samples); });
+    if (params_->has("simulation", "vectorisedValuation") &&
+        parseBool(params_->get("simulation", "vectorisedValuation")))
+        engine.enableVectorisedValuation();
+    if (params_->has("simulation", "compressLinearBooks") &&
+        parseBool(params_->get("simulation", "compressLinearBooks")))
+        engine.enableLinearBookCompression();
+    if (params_->has("simulation", "amcValuation") && parseBool(params_->get("simulation", "amcValuation"))) {
+        AmcParameters amcParameters;
+        if (params_->has("simulation", "amcTrainingSamples"))
+            amcParameters.trainingSamples = parseInteger(params_->get("simulation", "amcTrainingSamples"));
+        if (params_->has("simulation", "amcPolynomOrder"))
+            amcParameters.polynomOrder = parseInteger(params_->get("simulation", "amcPolynomOrder"));
+        if (params_->has("simulation", "amcPolynomType"))
+            amcParameters.polynomType = parsePolynomType(params_->get("simulation", "amcPolynomType"));
+        if (params_->has("simulation", "amcSeed"))
+            amcParameters.seed = parseInteger(params_->get("simulation", "amcSeed"));
+        engine.enableAmcValuation(amcParameters);
+    }
     ostringstream o;
     o.str("");
     o << "Build Cube " << simPortfolio_->size() << " x " << grid_->size() << " x " << samples_ << "... ";
@@ -655,6 +914,13 @@ void OREApp::generateNPVCube() {
     boost::shared_ptr<ScenarioGeneratorData> sgd = getScenarioGeneratorData();
     grid_ = sgd->grid();
     samples_ = sgd->samples();
+    if (sharded_) {
+        Size end;
+        std::tie(firstSample_, end) = shardRange(samples_, shardIndex_, shardCount_);
+        QL_REQUIRE(end > firstSample_, "sample shard " << shardIndex_ << " is empty");
+        LOG("Sample shard " << shardIndex_ << " covers samples " << firstSample_ << " to " << end - 1);
+        samples_ = end - firstSample_;
+    }
     boost::shared_ptr<ScenarioGenerator> sg = buildScenarioGenerator(market_, simMarketData, sgd);
 
     if (buildSimMarket_) {
@@ -669,9 +935,19 @@ void OREApp::generateNPVCube() {
         boost::shared_ptr<EngineFactory> simFactory = buildEngineFactory(simMarket_, groupName);
 
         LOG("Build portfolio linked to sim market");
-        simPortfolio_ = buildPortfolio(simFactory);
-        QL_REQUIRE(simPortfolio_->size() == portfolio_->size(),
-                   "portfolio size mismatch, check simulation market setup");
+        if (sharded_) {
+            vector<string> ids = portfolio_->ids();
+            Size first, end;
+            std::tie(first, end) = shardRange(ids.size(), tradeShardIndex_, tradeShardCount_);
+            QL_REQUIRE(end > first, "trade shard " << tradeShardIndex_ << " is empty");
+            LOG("Trade shard " << tradeShardIndex_ << " covers trades " << first << " to " << end - 1);
+            simPortfolio_ = buildPortfolio(simFactory, set<string>(ids.begin() + first, ids.begin() + end));
+            QL_REQUIRE(simPortfolio_->size() == end - first, "portfolio size mismatch, check simulation market setup");
+        } else {
+            simPortfolio_ = buildPortfolio(simFactory);
+            QL_REQUIRE(simPortfolio_->size() == portfolio_->size(),
+                       "portfolio size mismatch, check simulation market setup");
+        }
         out_ << "OK" << endl;
     }
 
@@ -690,25 +966,297 @@ void OREApp::generateNPVCube() {
     out_ << "OK" << endl;
 
     initCube();
+    checkpointSlices_.clear();
+    if (resume_)
+        startSample_ = loadCheckpoint();
     buildNPVCube();
     writeCube();
-    writeScenarioData();
+    // the trade shards of a sample range share the scenario data
+    if (!sharded_ || tradeShardIndex_ == 0)
+        writeScenarioData();
+    if (checkpointInterval_ > 0 || resume_)
+        removeCheckpoint();
 
     LOG("NPV cube generation completed");
     MEM_LOG;
 }
 
+void OREApp::generateIncrementalNPVCube() {
+
+    MEM_LOG;
+    LOG("Running incremental NPV cube generation");
+
+    if (params_->has("simulation", "storeFlows") && params_->get("simulation", "storeFlows") == "Y")
+        cubeDepth_ = 2; // NPV and FLOW
+    else
+        cubeDepth_ = 1; // NPV only
+
+    out_ << setw(tab_) << left << "Load Base Cube... " << flush;
+    string baseCubeFile = outputPath_ + "/" + params_->get("simulation", "incrementalBaseCubeFile");
+    LOG("Load base cube from file " << baseCubeFile);
+    boost::shared_ptr<NPVCube> baseCube = loadCubeFile(baseCubeFile, compressCube_);
+
+    // the scenario paths are the same as in the base run, so the aggregation data is reused as it is
+    string baseScenarioFile = outputPath_ + "/" + params_->get("simulation", "incrementalBaseScenarioDataFile");
+    LOG("Load base aggregation scenario data from file " << baseScenarioFile);
+    scenarioData_ = boost::make_shared<InMemoryAggregationScenarioData>();
+    scenarioData_->load(baseScenarioFile);
+    out_ << "OK" << endl;
+
+    out_ << setw(tab_) << left << "Simulation Setup... " << flush;
+    boost::shared_ptr<ScenarioSimMarketParameters> simMarketData = getSimMarketData();
+    boost::shared_ptr<ScenarioGeneratorData> sgd = getScenarioGeneratorData();
+    grid_ = sgd->grid();
+    samples_ = sgd->samples();
+    QL_REQUIRE(baseCube->asof() == asof_, "base cube asof " << baseCube->asof() << " does not match " << asof_);
+    QL_REQUIRE(baseCube->dates() == grid_->dates(), "base cube dates do not match the simulation grid");
+    QL_REQUIRE(baseCube->samples() == samples_,
+               "base cube samples (" << baseCube->samples() << ") do not match simulation samples (" << samples_
+                                     << ")");
+    QL_REQUIRE(baseCube->depth() == cubeDepth_,
+               "base cube depth (" << baseCube->depth() << ") does not match storeFlows setting");
+    QL_REQUIRE(scenarioData_->dimDates() == grid_->size() && scenarioData_->dimSamples() == samples_,
+               "base scenario data dimensions do not match the simulation grid and samples");
+
+    // same simulation configuration and seed, hence the same paths as in the base run
+    boost::shared_ptr<ScenarioGenerator> sg = buildScenarioGenerator(market_, simMarketData, sgd);
+    simMarket_ = boost::make_shared<ScenarioSimMarket>(market_, simMarketData, conventions_, getFixingManager(),
+                                                       params_->get("markets", "simulation"), curveConfigs_,
+                                                       marketParameters_, continueOnError_);
+    simMarket_->scenarioGenerator() = sg;
+    boost::shared_ptr<EngineFactory> simFactory = buildEngineFactory(simMarket_, "simulation");
+
+    LOG("Build incremental trades linked to sim market");
+    simPortfolio_ = buildPortfolio(simFactory, incrementalTrades_);
+    out_ << "OK" << endl;
+
+    // the netting sets of the base run's trades, written next to the base cube by writeCube()
+    map<string, string> baseNettingSetMap;
+    string baseNettingSetFile = baseCubeFile + ".nettingsets";
+    if (boost::filesystem::exists(baseNettingSetFile)) {
+        std::ifstream file(baseNettingSetFile);
+        QL_REQUIRE(file.is_open(), "error opening netting set file " << baseNettingSetFile);
+        string line;
+        while (getline(file, line)) {
+            auto tab = line.find('\t');
+            QL_REQUIRE(tab != string::npos, "invalid line '" << line << "' in netting set file " << baseNettingSetFile);
+            baseNettingSetMap[line.substr(0, tab)] = line.substr(tab + 1);
+        }
+    } else {
+        WLOG("No netting set file " << baseNettingSetFile << " found for the base cube");
+    }
+
+    // the netting sets to aggregate again are the current and the base run's netting sets of the listed trades,
+    // i.e. also the netting set an amended trade was moved out of or a removed trade belonged to; if a listed trade
+    // of the base cube has no known netting set all netting sets are aggregated
+    incrementalNettingSets_.clear();
+    bool unknownNettingSets = false;
+    map<string, string> nettingSetMap = portfolio_->nettingSetMap();
+    std::set<string> baseIds(baseCube->ids().begin(), baseCube->ids().end());
+    for (auto const& id : incrementalTrades_) {
+        auto n = nettingSetMap.find(id);
+        if (n != nettingSetMap.end()) {
+            // a stale base cube row must not stand in for an amended trade that failed to build
+            QL_REQUIRE(simPortfolio_->has(id), "incremental trade " << id << " not built against simulation market");
+            incrementalNettingSets_.insert(n->second);
+        }
+        auto b = baseNettingSetMap.find(id);
+        if (b != baseNettingSetMap.end())
+            incrementalNettingSets_.insert(b->second);
+        else if (baseIds.count(id) > 0)
+            unknownNettingSets = true;
+    }
+    if (unknownNettingSets) {
+        LOG("Base netting set of incremental trades not known, all netting sets will be aggregated");
+        incrementalNettingSets_.clear();
+    }
+
+    if (simPortfolio_->size() > 0) {
+        initCube();
+        buildNPVCube();
+        cube_ = mergeCubes(portfolio_->ids(), baseCube, cube_);
+    } else {
+        cube_ = mergeCubes(portfolio_->ids(), baseCube);
+    }
+    if (compressCube_)
+        cube_ = boost::make_shared<CompressedInMemoryCube>(*cube_, cubeMaxError_);
+    LOG("Merged " << simPortfolio_->size() << " incremental trades into base cube of " << baseCube->numIds()
+                  << " trades, new cube has " << cube_->numIds() << " trades");
+    writeCube();
+
+    LOG("Incremental NPV cube generation completed");
+    MEM_LOG;
+}
+
+void OREApp::mergeCubeShards() {
+
+    MEM_LOG;
+    LOG("Merging " << shardCount_ << " x " << tradeShardCount_ << " cube shards");
+    out_ << setw(tab_) << left << "Merge Cube Shards... " << flush;
+
+    boost::shared_ptr<ScenarioGeneratorData> sgd = getScenarioGeneratorData();
+    grid_ = sgd->grid();
+    samples_ = sgd->samples();
+    if (params_->has("simulation", "storeFlows") && params_->get("simulation", "storeFlows") == "Y")
+        cubeDepth_ = 2; // NPV and FLOW
+    else
+        cubeDepth_ = 1; // NPV only
+
+    QL_REQUIRE(params_->has("simulation", "cubeFile") &&
+                   params_->has("simulation", "aggregationScenarioDataFileName"),
+               "merging shards requires the simulation parameters cubeFile and aggregationScenarioDataFileName");
+    string cubeFile = outputPath_ + "/" + params_->get("simulation", "cubeFile");
+    string scenarioFile = outputPath_ + "/" + params_->get("simulation", "aggregationScenarioDataFileName");
+
+    // report all missing shards at once, so that only the failed workers have to be run again
+    vector<string> missing;
+    for (Size i = 0; i < shardCount_; ++i) {
+        if (!boost::filesystem::exists(shardFileName(scenarioFile, i, 0)))
+            missing.push_back(shardFileName(scenarioFile, i, 0));
+        for (Size j = 0; j < tradeShardCount_; ++j) {
+            if (!boost::filesystem::exists(shardFileName(cubeFile, i, j)))
+                missing.push_back(shardFileName(cubeFile, i, j));
+        }
+    }
+    QL_REQUIRE(missing.empty(), "missing shard files: " << boost::algorithm::join(missing, ", "));
+
+    vector<string> ids = portfolio_->ids();
+    cube_ = createCube(ids);
+    scenarioData_ = boost::make_shared<InMemoryAggregationScenarioData>(grid_->size(), samples_);
+
+    for (Size i = 0; i < shardCount_; ++i) {
+        Size first, end;
+        std::tie(first, end) = shardRange(samples_, i, shardCount_);
+        Size trades = 0;
+        for (Size j = 0; j < tradeShardCount_; ++j) {
+            boost::shared_ptr<NPVCube> shard = loadCubeFile(shardFileName(cubeFile, i, j), compressCube_);
+            QL_REQUIRE(shard->asof() == asof_ && shard->samples() == end - first,
+                       "cube shard " << i << "_" << j << " does not match the simulation setup");
+            copyCubeShard(*shard, *cube_, first);
+            trades += shard->numIds();
+        }
+        QL_REQUIRE(trades == ids.size(),
+                   "cube shards " << i << "_* cover " << trades << " trades, portfolio has " << ids.size());
+        InMemoryAggregationScenarioData shardData;
+        shardData.load(shardFileName(scenarioFile, i, 0));
+        QL_REQUIRE(shardData.dimSamples() == end - first,
+                   "scenario data shard " << i << " does not match the simulation setup");
+        copyScenarioDataShard(shardData, *scenarioData_, first);
+    }
+    out_ << "OK" << endl;
+
+    writeCube();
+    writeScenarioData();
+
+    LOG("Cube shards merged");
+    MEM_LOG;
+}
+
+string OREApp::cubeFileName() const {
+    string fileName = outputPath_ + "/" + params_->get("simulation", "cubeFile");
+    if (sharded_)
+        fileName = shardFileName(fileName, shardIndex_, tradeShardIndex_);
+    return fileName;
+}
+
 void OREApp::writeCube() {
     out_ << endl << setw(tab_) << left << "Write Cube... " << flush;
     LOG("Write cube");
     if (params_->has("simulation", "cubeFile")) {
-        string cubeFileName = outputPath_ + "/" + params_->get("simulation", "cubeFile");
-        cube_->save(cubeFileName);
+        if (auto compressed = boost::dynamic_pointer_cast<CompressedInMemoryCube>(cube_)) {
+            compressed->compress();
+            LOG("Compressed cube uses " << compressed->memory() / 1024 / 1024 << " MB, compression ratio "
+                                        << compressed->compressionRatio()
+                                        << " against single precision, max quantisation error "
+                                        << compressed->quantisationError());
+        }
+        cube_->save(cubeFileName());
+        // the netting set of each trade, so that an incremental run based on this cube also aggregates the netting
+        // sets trades are moved out of or removed from
+        if (portfolio_) {
+            string nettingSetFile = cubeFileName() + ".nettingsets";
+            map<string, string> nettingSetMap = portfolio_->nettingSetMap();
+            std::ofstream file(nettingSetFile);
+            QL_REQUIRE(file.is_open(), "error opening netting set file " << nettingSetFile);
+            for (auto const& id : cube_->ids()) {
+                auto n = nettingSetMap.find(id);
+                if (n != nettingSetMap.end())
+                    file << id << "\t" << n->second << "\n";
+            }
+            QL_REQUIRE(file.good(), "error writing netting set file " << nettingSetFile);
+        }
         out_ << "OK" << endl;
     } else
         out_ << "SKIP" << endl;
 }
 
+void OREApp::writeCheckpoint(Size samples) {
+    Size first = checkpointSlices_.empty() ? startSample_ : checkpointSlices_.back().second;
+    if (samples <= first)
+        return;
+    string manifest = cubeFileName() + ".checkpoint";
+    string slice = manifest + "_" + std::to_string(first);
+    LOG("Write checkpoint for samples " << first << " to " << samples - 1);
+    // single precision, as read back in loadCheckpoint()
+    sliceCube<float>(*cube_, first, samples - first)->save(slice);
+    sliceScenarioData(*scenarioData_, first, samples - first)->save(slice + ".scenariodata");
+    checkpointSlices_.push_back(std::make_pair(first, samples));
+
+    // the manifest is replaced in one step, so that an interrupted write leaves the previous checkpoint valid
+    {
+        std::ofstream file(manifest + ".tmp");
+        QL_REQUIRE(file.is_open(), "error opening checkpoint file " << manifest << ".tmp");
+        for (auto const& s : checkpointSlices_)
+            file << s.first << " " << s.second << "\n";
+        QL_REQUIRE(file.good(), "error writing checkpoint file " << manifest << ".tmp");
+    }
+    boost::filesystem::rename(manifest + ".tmp", manifest);
+}
+
+Size OREApp::loadCheckpoint() {
+    string manifest = cubeFileName() + ".checkpoint";
+    if (!boost::filesystem::exists(manifest)) {
+        WLOG("No checkpoint " << manifest << " found, the simulation starts at the first sample");
+        return 0;
+    }
+    std::ifstream file(manifest);
+    QL_REQUIRE(file.is_open(), "error opening checkpoint file " << manifest);
+    Size first, end, samples = 0;
+    while (file >> first >> end) {
+        QL_REQUIRE(first == samples && end > first && end <= samples_,
+                   "checkpoint slice " << first << " to " << end << " does not match the simulation setup");
+        string slice = manifest + "_" + std::to_string(first);
+        // single precision, as written in writeCheckpoint()
+        boost::shared_ptr<NPVCube> cube;
+        if (cubeDepth_ > 1)
+            cube = boost::make_shared<SinglePrecisionInMemoryCubeN>();
+        else
+            cube = boost::make_shared<SinglePrecisionInMemoryCube>();
+        cube->load(slice);
+        QL_REQUIRE(cube->asof() == asof_ && cube->samples() == end - first && cube->numIds() == cube_->numIds(),
+                   "checkpoint slice " << slice << " does not match the simulation setup");
+        copyCubeShard(*cube, *cube_, first);
+        InMemoryAggregationScenarioData data;
+        data.load(slice + ".scenariodata");
+        copyScenarioDataShard(data, *scenarioData_, first);
+        checkpointSlices_.push_back(std::make_pair(first, end));
+        samples = end;
+    }
+    LOG("Resume the simulation after " << samples << " checkpointed samples");
+    return samples;
+}
+
+void OREApp::removeCheckpoint() {
+    string manifest = cubeFileName() + ".checkpoint";
+    for (auto const& s : checkpointSlices_) {
+        string slice = manifest + "_" + std::to_string(s.first);
+        boost::filesystem::remove(slice);
+        boost::filesystem::remove(slice + ".scenariodata");
+    }
+    boost::filesystem::remove(manifest);
+    checkpointSlices_.clear();
+}
+
 void OREApp::writeScenarioData() {
     out_ << endl << setw(tab_) << left << "Write Aggregation Scenario Data... " << flush;
     LOG("Write scenario data");
@@ -717,6 +1265,8 @@ void OREApp::writeScenarioData() {
         // binary output
         string outputFileNameAddScenData =
             outputPath_ + "/" + params_->get("simulation", "aggregationScenarioDataFileName");
+        if (sharded_)
+            outputFileNameAddScenData = shardFileName(outputFileNameAddScenData, shardIndex_, 0);
         scenarioData_->save(outputFileNameAddScenData);
         out_ << "OK" << endl;
         skipped = false;
@@ -725,8 +1275,8 @@ void OREApp::writeScenarioData() {
         // csv output
         string outputFileNameAddScenData =
             outputPath_ + "/" + params_->get("simulation", "aggregationScenarioDataDump");
-        CSVFileReport report(outputFileNameAddScenData);
-        getReportWriter()->writeAggregationScenarioData(report, *scenarioData_);
+        boost::shared_ptr<Report> report = makeReport(outputFileNameAddScenData);
+        getReportWriter()->writeAggregationScenarioData(*report, *scenarioData_);
         skipped = false;
     }
     if (skipped)
@@ -745,12 +1295,11 @@ void OREApp::loadCube() {
     if (params_->has("xva", "hyperCube"))
         cubeDepth_ = parseBool(params_->get("xva", "hyperCube")) ? 2 : 1;
 
-    if (cubeDepth_ > 1)
-        cube_ = boost::make_shared<SinglePrecisionInMemoryCubeN>();
-    else
-        cube_ = boost::make_shared<SinglePrecisionInMemoryCube>();
+    bool compressed = compressCube_;
+    if (params_->has("xva", "cubeCompression"))
+        compressed = parseBool(params_->get("xva", "cubeCompression"));
     LOG("Load cube from file " << cubeFile);
-    cube_->load(cubeFile);
+    cube_ = loadCubeFile(cubeFile, compressed);
     LOG("Cube loading done");
 }
 
@@ -838,8 +1387,23 @@ void OREApp::runPostProcessor() {
         fullInitialCollateralisation = parseBool(params_->get("xva", "fullInitialCollateralisation"));
     }
 
+    // after an incremental simulation only the netting sets touched by the incremental trades are aggregated, their
+    // reports are written under distinct names, see xvaReportFileName()
+    xvaPortfolio_ = portfolio_;
+    boost::shared_ptr<NPVCube> xvaCube = cube_;
+    if (!incrementalNettingSets_.empty()) {
+        xvaPortfolio_ = boost::make_shared<Portfolio>();
+        for (auto const& t : portfolio_->trades()) {
+            if (incrementalNettingSets_.count(t->envelope().nettingSetId()) > 0)
+                xvaPortfolio_->add(t);
+        }
+        xvaCube = mergeCubes(xvaPortfolio_->ids(), cube_);
+        LOG("Aggregating " << incrementalNettingSets_.size() << " netting sets with " << xvaPortfolio_->size()
+                           << " trades");
+    }
+
     postProcess_ = boost::make_shared<PostProcess>(
-        portfolio_, netting, market_, marketConfiguration, cube_, scenarioData_, analytics, baseCurrency,
+        xvaPortfolio_, netting, market_, marketConfiguration, xvaCube, scenarioData_, analytics, baseCurrency,
         allocationMethod, marginalAllocationLimit, quantile, calculationType, dvaName, fvaBorrowingCurve,
         fvaLendingCurve, dimQuantile, dimHorizonCalendarDays, dimRegressionOrder, dimRegressors,
         dimLocalRegressionEvaluations, dimLocalRegressionBandwidth, dimScaling, fullInitialCollateralisation,
@@ -859,55 +1423,66 @@ void OREApp::writeXVAReports() {
         for (auto t : postProcess_->tradeIds()) {
 	    ostringstream o;
 	    o << outputPath_ << "/exposure_trade_" << t << ".csv";
-	    string tradeExposureFile = o.str();
-	    CSVFileReport tradeExposureReport(tradeExposureFile);
-	    getReportWriter()->writeTradeExposures(tradeExposureReport, postProcess_, t);
+	    string tradeExposureFile = xvaReportFileName(o.str());
+	    boost::shared_ptr<Report> tradeExposureReport = makeReport(tradeExposureFile);
+	    getReportWriter()->writeTradeExposures(*tradeExposureReport, postProcess_, t);
 	}
     }
     for (auto n : postProcess_->nettingSetIds()) {
         ostringstream o1;
         o1 << outputPath_ << "/exposure_nettingset_" << n << ".csv";
-        string nettingSetExposureFile = o1.str();
-        CSVFileReport nettingSetExposureReport(nettingSetExposureFile);
-        getReportWriter()->writeNettingSetExposures(nettingSetExposureReport, postProcess_, n);
+        string nettingSetExposureFile = xvaReportFileName(o1.str());
+        boost::shared_ptr<Report> nettingSetExposureReport = makeReport(nettingSetExposureFile);
+        getReportWriter()->writeNettingSetExposures(*nettingSetExposureReport, postProcess_, n);
 
         ostringstream o2;
         o2 << outputPath_ << "/colva_nettingset_" << n << ".csv";
-        string nettingSetColvaFile = o2.str();
-        CSVFileReport nettingSetColvaReport(nettingSetColvaFile);
-        getReportWriter()->writeNettingSetColva(nettingSetColvaReport, postProcess_, n);
+        string nettingSetColvaFile = xvaReportFileName(o2.str());
+        boost::shared_ptr<Report> nettingSetColvaReport = makeReport(nettingSetColvaFile);
+        getReportWriter()->writeNettingSetColva(*nettingSetColvaReport, postProcess_, n);
     }
 
-    string XvaFile = outputPath_ + "/xva.csv";
-    CSVFileReport xvaReport(XvaFile);
-    getReportWriter()->writeXVA(xvaReport, params_->get("xva", "allocationMethod"), portfolio_, postProcess_);
+    string XvaFile = xvaReportFileName(outputPath_ + "/xva.csv");
+    boost::shared_ptr<Report> xvaReport = makeReport(XvaFile);
+    getReportWriter()->writeXVA(*xvaReport, params_->get("xva", "allocationMethod"), xvaPortfolio_, postProcess_);
 
     string rawCubeOutputFile = params_->get("xva", "rawCubeOutputFile");
-    CubeWriter cw1(outputPath_ + "/" + rawCubeOutputFile);
-    map<string, string> nettingSetMap = portfolio_->nettingSetMap();
-    cw1.write(cube_, nettingSetMap);
+    CubeWriter cw1(xvaReportFileName(outputPath_ + "/" + rawCubeOutputFile));
+    map<string, string> nettingSetMap = xvaPortfolio_->nettingSetMap();
+    cw1.write(postProcess_->cube(), nettingSetMap);
 
     string netCubeOutputFile = params_->get("xva", "netCubeOutputFile");
-    CubeWriter cw2(outputPath_ + "/" + netCubeOutputFile);
+    CubeWriter cw2(xvaReportFileName(outputPath_ + "/" + netCubeOutputFile));
     cw2.write(postProcess_->netCube(), nettingSetMap);
 
     LOG("XVA reports written");
     MEM_LOG;
 }
 
+string OREApp::xvaReportFileName(const string& fileName) const {
+    // the reports of a partial aggregation must not overwrite the base run's reports covering all netting sets
+    if (incrementalNettingSets_.empty())
+        return fileName;
+    Size dot = fileName.find_last_of('.');
+    Size slash = fileName.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return fileName + "_incremental";
+    return fileName.substr(0, dot) + "_incremental" + fileName.substr(dot);
+}
+
 void OREApp::writeDIMReport() {
-    string dimFile1 = outputPath_ + "/" + params_->get("xva", "dimEvolutionFile");
+    string dimFile1 = xvaReportFileName(outputPath_ + "/" + params_->get("xva", "dimEvolutionFile"));
     vector<string> dimFiles2;
     for (auto f : parseListOfValues(params_->get("xva", "dimRegressionFiles")))
-        dimFiles2.push_back(outputPath_ + "/" + f);
+        dimFiles2.push_back(xvaReportFileName(outputPath_ + "/" + f));
     string nettingSet = params_->get("xva", "dimOutputNettingSet");
     std::vector<Size> dimOutputGridPoints =
         parseListOfValues<Size>(params_->get("xva", "dimOutputGridPoints"), &parseInteger);
-    ore::data::CSVFileReport dimEvolutionReport(dimFile1);
-    postProcess_->exportDimEvolution(dimEvolutionReport);
+    boost::shared_ptr<Report> dimEvolutionReport = makeReport(dimFile1);
+    postProcess_->exportDimEvolution(*dimEvolutionReport);
     vector<boost::shared_ptr<ore::data::Report>> reportVec;
     for (Size i = 0; i < dimOutputGridPoints.size(); ++i)
-        reportVec.push_back(boost::make_shared<ore::data::CSVFileReport>(dimFiles2[i]));
+        reportVec.push_back(makeReport(dimFiles2[i]));
     postProcess_->exportDimRegression(nettingSet, dimOutputGridPoints, reportVec);
 }
 
@@ -947,7 +1522,14 @@ void OREApp::buildMarket(const std::string& todaysMarketXML, const std::string&
         /*******************************
          * Market and fixing data loader
          */
-        if (params_->has("setup", "marketDataFile") && params_->get("setup", "marketDataFile") != "") {
+        if (params_->has("setup", "marketDataBinaryFile") && params_->get("setup", "marketDataBinaryFile") != "") {
+            out_ << setw(tab_) << left << "Market data loader... " << flush;
+            string binaryFile = inputPath_ + "/" + params_->get("setup", "marketDataBinaryFile");
+            BinaryLoader loader(binaryFile, implyTodaysFixings);
+            out_ << "OK" << endl;
+            market_ = boost::make_shared<TodaysMarket>(asof_, marketParameters_, loader, curveConfigs_, conventions_,
+                                                       continueOnError_);
+        } else if (params_->has("setup", "marketDataFile") && params_->get("setup", "marketDataFile") != "") {
             out_ << setw(tab_) << left << "Market data loader... " << flush;
             string marketFileString = params_->get("setup", "marketDataFile");
             vector<string> marketFiles = getFilenames(marketFileString, inputPath_);
@@ -87,17 +87,30 @@ protected:
                                                                 const string& groupName = "setup") const;
     //! build trade factory
     boost::shared_ptr<TradeFactory> buildTradeFactory() const;
+    //! load the trades of the portfolio files without building them
+    virtual boost::shared_ptr<Portfolio> loadPortfolio();
     //! build portfolio for a given market
     boost::shared_ptr<Portfolio> buildPortfolio(const boost::shared_ptr<EngineFactory>& factory);
+    //! build the given trades of the portfolio only
+    boost::shared_ptr<Portfolio> buildPortfolio(const boost::shared_ptr<EngineFactory>& factory,
+                                                const std::set<std::string>& tradeIds);
 
     //! generate NPV cube
     void generateNPVCube();
+    //! value the incremental trades on the base run's paths and merge them into the base cube
+    void generateIncrementalNPVCube();
+    //! assemble the NPV cube and scenario data from the files written by sharded simulations
+    void mergeCubeShards();
     //! get an instance of an aggregationScenarioData class
     virtual void initAggregationScenarioData();
     //! get an instance of a cube class
     virtual void initCube();
     //! build an NPV cube
     virtual void buildNPVCube();
+    //! create a cube of the configured storage type for the given ids, the grid and this run's samples
+    boost::shared_ptr<NPVCube> createCube(const std::vector<std::string>& ids) const;
+    //! load a cube of the configured depth from file, compressed or single precision
+    boost::shared_ptr<NPVCube> loadCubeFile(const std::string& fileName, bool compressed) const;
     //! load simMarketData
     boost::shared_ptr<ScenarioSimMarketParameters> getSimMarketData();
     //! load scenarioGeneratorData
@@ -120,14 +133,27 @@ protected:
     //! run parametric var and write out report
     void runParametricVar();
 
+    //! create a report in the configured format, csv by default
+    boost::shared_ptr<Report> makeReport(const std::string& fileName) const;
     //! write out initial (pre-cube) reports
     void writeInitialReports();
     //! write out XVA reports
     void writeXVAReports();
+    //! name of an XVA report file, with the suffix _incremental before the extension if a subset of the netting
+    //! sets was aggregated after an incremental simulation
+    std::string xvaReportFileName(const std::string& fileName) const;
     //! write out DIM reports
     void writeDIMReport();
+    //! file name of the simulation cube written by this run
+    std::string cubeFileName() const;
     //! write out cube
     void writeCube();
+    //! save the cube and scenario data samples completed since the last checkpoint
+    void writeCheckpoint(Size samples);
+    //! load the checkpointed samples into cube and scenario data, returns the number of completed samples
+    Size loadCheckpoint();
+    //! remove the checkpoint files once the cube is written
+    void removeCheckpoint();
     //! write out scenarioData
     void writeScenarioData();
     //! write out base scenario
@@ -197,6 +223,15 @@ protected:
     bool parametricVar_;
     bool writeBaseScenario_;
     bool continueOnError_;
+    bool binaryReports_;
+    Size analyticsThreads_;
+    std::set<std::string> incrementalTrades_;
+    Size shardCount_, shardIndex_, tradeShardCount_, tradeShardIndex_;
+    bool sharded_, mergeShards_;
+    bool compressCube_;
+    Real cubeMaxError_;
+    Size checkpointInterval_;
+    bool resume_;
     std::string inputPath_;
     std::string outputPath_;
 
@@ -210,12 +245,17 @@ protected:
     boost::shared_ptr<Portfolio> simPortfolio_;      // portfolio linked to sim market
 
     boost::shared_ptr<DateGrid> grid_;
-    Size samples_;
+    Size samples_;     // samples in this run's cube
+    Size firstSample_; // first sample of the scenario generator valued
+    Size startSample_; // first cube sample valued, the preceding ones are loaded from the checkpoint
+    std::vector<std::pair<Size, Size>> checkpointSlices_; // sample ranges [first, end) saved so far
 
     Size cubeDepth_;
     boost::shared_ptr<NPVCube> cube_;
     boost::shared_ptr<AggregationScenarioData> scenarioData_;
     boost::shared_ptr<PostProcess> postProcess_;
+    boost::shared_ptr<Portfolio> xvaPortfolio_;    // portfolio the post processor ran on
+    std::set<std::string> incrementalNettingSets_; // netting sets touched by the incremental trades
 
     ore::data::CurveConfigurations curveConfigs_;
 
@@ -0,0 +1,325 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/oreserver.hpp>
+#include <orea/scenario/scenariosimmarketcache.hpp>
+#include <ored/marketdata/binaryloader.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/utilities/log.hpp>
+#include <ql/quotes/simplequote.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+//! Market quotes, fixings and dividends for the asof date held in memory, quotes can be changed
+class OREServer::QuoteStore : public Loader {
+public:
+    QuoteStore(const Loader& source, const Date& asof)
+        : asof_(asof), fixings_(source.loadFixings()), dividends_(source.loadDividends()) {
+        for (auto const& q : source.loadQuotes(asof))
+            set(q);
+    }
+
+    const vector<boost::shared_ptr<MarketDatum>>& loadQuotes(const Date& d) const override {
+        QL_REQUIRE(d == asof_, "There are no quotes available for date " << d);
+        return quotes_;
+    }
+
+    const boost::shared_ptr<MarketDatum>& get(const string& name, const Date& d) const override {
+        QL_REQUIRE(d == asof_, "There are no quotes available for date " << d);
+        auto it = index_.find(name);
+        QL_REQUIRE(it != index_.end(), "No datum for " << name << " on date " << d);
+        return quotes_[it->second];
+    }
+
+    const vector<Fixing>& loadFixings() const override { return fixings_; }
+    const vector<Fixing>& loadDividends() const override { return dividends_; }
+
+    //! set the quote value in place if the quote exists, so that the market objects holding it are notified,
+    //! returns false if a new quote was added
+    bool set(const string& name, Real value) {
+        auto it = index_.find(name);
+        if (it != index_.end()) {
+            auto q = boost::dynamic_pointer_cast<SimpleQuote>(*quotes_[it->second]->quote());
+            if (q) {
+                q->setValue(value);
+                return true;
+            }
+        }
+        set(parseMarketDatum(asof_, name, value));
+        return false;
+    }
+
+private:
+    void set(const boost::shared_ptr<MarketDatum>& datum) {
+        auto it = index_.find(datum->name());
+        if (it == index_.end()) {
+            index_[datum->name()] = quotes_.size();
+            quotes_.push_back(datum);
+        } else {
+            quotes_[it->second] = datum;
+        }
+    }
+
+    Date asof_;
+    vector<boost::shared_ptr<MarketDatum>> quotes_;
+    unordered_map<string, Size> index_;
+    vector<Fixing> fixings_, dividends_;
+};
+
+namespace {
+vector<string> getFilenames(const string& fileString, const string& path) {
+    vector<string> fileNames;
+    boost::split(fileNames, fileString, boost::is_any_of(",;"), boost::token_compress_on);
+    for (auto& f : fileNames) {
+        boost::trim(f);
+        f = path + "/" + f;
+    }
+    return fileNames;
+}
+} // namespace
+
+OREServer::OREServer(boost::shared_ptr<Parameters> params, ostream& out)
+    : OREApp(params, out), marketStale_(false) {}
+
+void OREServer::initialise() {
+    LOG("Initialise ORE server");
+
+    getConventions();
+    getMarketParameters();
+    if (params_->has("setup", "curveConfigFile") && params_->get("setup", "curveConfigFile") != "")
+        curveConfigs_.fromFile(inputPath_ + "/" + params_->get("setup", "curveConfigFile"));
+
+    bool implyTodaysFixings = parseBool(params_->get("setup", "implyTodaysFixings"));
+    if (params_->has("setup", "marketDataBinaryFile") && params_->get("setup", "marketDataBinaryFile") != "") {
+        BinaryLoader loader(inputPath_ + "/" + params_->get("setup", "marketDataBinaryFile"), implyTodaysFixings);
+        quotes_ = boost::make_shared<QuoteStore>(loader, asof_);
+    } else {
+        CSVLoader loader(getFilenames(params_->get("setup", "marketDataFile"), inputPath_),
+                         getFilenames(params_->get("setup", "fixingDataFile"), inputPath_), implyTodaysFixings);
+        quotes_ = boost::make_shared<QuoteStore>(loader, asof_);
+    }
+
+    engineData_ = boost::make_shared<EngineData>();
+    if (params_->get("setup", "pricingEnginesFile") != "")
+        engineData_->fromFile(inputPath_ + "/" + params_->get("setup", "pricingEnginesFile"));
+
+    // the curve builders copy the values of these quotes, the market holds the FX spot, security and correlation
+    // quotes as handles instead, so that updates of the latter reach the portfolio through the observers
+    rebuildQuotes_.clear();
+    set<string> configurations;
+    for (auto const& c : marketParameters_.configurations())
+        configurations.insert(c.first);
+    auto requiredConfigs =
+        curveConfigs_.minimalCurveConfig(boost::make_shared<TodaysMarketParameters>(marketParameters_), configurations);
+    for (auto type : {CurveSpec::CurveType::Yield, CurveSpec::CurveType::CapFloorVolatility,
+                      CurveSpec::CurveType::SwaptionVolatility, CurveSpec::CurveType::YieldVolatility,
+                      CurveSpec::CurveType::FXVolatility, CurveSpec::CurveType::Default,
+                      CurveSpec::CurveType::CDSVolatility, CurveSpec::CurveType::Inflation,
+                      CurveSpec::CurveType::InflationCapFloorPrice, CurveSpec::CurveType::InflationCapFloorVolatility,
+                      CurveSpec::CurveType::Equity, CurveSpec::CurveType::EquityVolatility,
+                      CurveSpec::CurveType::Commodity, CurveSpec::CurveType::CommodityVolatility}) {
+        auto quotes = requiredConfigs->quotes(type);
+        rebuildQuotes_.insert(quotes.begin(), quotes.end());
+    }
+
+    tradeXml_.clear();
+    for (auto const& t : OREApp::loadPortfolio()->trades())
+        tradeXml_.push_back(make_pair(t->id(), t->toXMLString()));
+
+    buildMarketAndFactory();
+    buildResidentPortfolio();
+    marketStale_ = false;
+
+    LOG("ORE server initialised with " << portfolio_->size() << " trades");
+}
+
+void OREServer::buildMarketAndFactory() {
+    Settings::instance().evaluationDate() = asof_;
+    // cached sim markets are built from the previous market
+    ScenarioSimMarketCache::instance().clear();
+    market_ = boost::make_shared<TodaysMarket>(asof_, marketParameters_, *quotes_, curveConfigs_, conventions_,
+                                               continueOnError_);
+    map<MarketContext, string> configurations;
+    configurations[MarketContext::irCalibration] = params_->get("markets", "lgmcalibration");
+    configurations[MarketContext::fxCalibration] = params_->get("markets", "fxcalibration");
+    configurations[MarketContext::pricing] = params_->get("markets", "pricing");
+    engineFactory_ = boost::make_shared<EngineFactory>(engineData_, market_, configurations, getExtraEngineBuilders(),
+                                                       getExtraLegBuilders());
+}
+
+boost::shared_ptr<Portfolio> OREServer::loadPortfolio() {
+    string xml = "<Portfolio>";
+    for (auto const& t : tradeXml_)
+        xml += t.second;
+    xml += "</Portfolio>";
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->loadFromXMLString(xml, buildTradeFactory());
+    return portfolio;
+}
+
+void OREServer::buildResidentPortfolio() {
+    // trades failing to build are missing from the portfolio but keep their XML, so that they are built again
+    // against the next market
+    portfolio_ = loadPortfolio();
+    if (portfolio_->size() == 0)
+        return;
+    try {
+        portfolio_->build(engineFactory_);
+    } catch (const exception& e) {
+        ALOG("ORE server could not build any trade: " << e.what());
+    }
+}
+
+void OREServer::refresh() {
+    Settings::instance().evaluationDate() = asof_;
+    if (!marketStale_)
+        return;
+    LOG("Rebuild market and portfolio after quote updates");
+    buildMarketAndFactory();
+    marketStale_ = false;
+    buildResidentPortfolio();
+}
+
+vector<pair<string, string>>::iterator OREServer::findTradeXml(const string& id) {
+    return find_if(tradeXml_.begin(), tradeXml_.end(), [&id](const pair<string, string>& t) { return t.first == id; });
+}
+
+int OREServer::serve(istream& in, ostream& reply) {
+    try {
+        initialise();
+        reply << "OK" << endl;
+    } catch (const exception& e) {
+        ALOG("ORE server initialisation failed: " << e.what());
+        reply << "ERROR " << e.what() << endl;
+        return 1;
+    }
+
+    string request;
+    while (getline(in, request)) {
+        boost::trim(request);
+        if (request.empty())
+            continue;
+        if (!process(request, reply))
+            break;
+    }
+    LOG("ORE server stopped");
+    return 0;
+}
+
+bool OREServer::process(const string& request, ostream& reply) {
+    auto start = chrono::steady_clock::now();
+    DLOG("ORE server request: " << request);
+
+    istringstream tokens(request);
+    string command;
+    tokens >> command;
+
+    ostringstream result;
+    result << setprecision(12);
+    bool proceed = true;
+    try {
+        if (command == "quit") {
+            proceed = false;
+        } else if (command == "quote") {
+            string name, value;
+            tokens >> name >> value;
+            QL_REQUIRE(!name.empty() && !value.empty(), "usage: quote <name> <value>");
+            // a new quote or a quote whose value a curve builder copied requires a rebuild
+            if (!quotes_->set(name, parseReal(value)) || rebuildQuotes_.find(name) != rebuildQuotes_.end())
+                marketStale_ = true;
+            // cached sim markets hold the base scenario taken from the previous quote values
+            ScenarioSimMarketCache::instance().clear();
+        } else if (command == "add") {
+            refresh();
+            string xml;
+            getline(tokens, xml);
+            Portfolio added;
+            added.loadFromXMLString(xml, buildTradeFactory());
+            map<string, string> addedXml;
+            for (auto const& t : added.trades())
+                addedXml[t->id()] = t->toXMLString();
+            added.build(engineFactory_);
+            for (auto const& t : added.trades()) {
+                auto it = findTradeXml(t->id());
+                if (it == tradeXml_.end())
+                    tradeXml_.push_back(make_pair(t->id(), addedXml[t->id()]));
+                else
+                    it->second = addedXml[t->id()];
+                portfolio_->remove(t->id());
+                portfolio_->add(t);
+                result << t->id() << "\n";
+            }
+        } else if (command == "remove") {
+            string id;
+            tokens >> id;
+            auto it = findTradeXml(id);
+            QL_REQUIRE(it != tradeXml_.end(), "trade " << id << " not found");
+            tradeXml_.erase(it);
+            portfolio_->remove(id);
+        } else if (command == "npv") {
+            refresh();
+            string id;
+            tokens >> id;
+            QL_REQUIRE(id.empty() || findTradeXml(id) != tradeXml_.end(), "trade " << id << " not found");
+            QL_REQUIRE(id.empty() || portfolio_->has(id), "trade " << id << " could not be built");
+            for (auto const& t : portfolio_->trades()) {
+                if (id.empty() || t->id() == id)
+                    result << t->id() << " " << t->npvCurrency() << " " << t->instrument()->NPV() << "\n";
+            }
+        } else if (command == "reports") {
+            refresh();
+            writeInitialReports();
+        } else if (command == "sensitivity") {
+            refresh();
+            getSensitivityRunner()->runSensitivityAnalysis(market_, conventions_, curveConfigs_, marketParameters_);
+        } else if (command == "stress") {
+            refresh();
+            runStressTest();
+        } else {
+            QL_FAIL("unknown request " << command);
+        }
+        reply << result.str() << "OK" << endl;
+    } catch (const exception& e) {
+        string message = e.what();
+        boost::replace_all(message, "\n", " ");
+        ALOG("ORE server request " << request << " failed: " << message);
+        reply << "ERROR " << message << endl;
+    }
+
+    DLOG("ORE server request done in "
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms");
+    return proceed;
+}
+
+} // namespace analytics
+} // namespace ore
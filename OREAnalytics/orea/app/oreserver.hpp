@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/oreserver.hpp
+    \brief ORE kept resident to answer requests against a market and portfolio held in memory
+    \ingroup app
+*/
+#pragma once
+
+#include <orea/app/oreapp.hpp>
+
+#include <istream>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! ORE kept resident to answer requests against a market and portfolio held in memory
+/*! The server reads the configuration, market data, fixings, pricing engine data and portfolio given in ore.xml once
+    and builds the market and portfolio. It then processes requests, one per line, and answers each request with
+    zero or more data lines followed by a status line, which is either "OK" or "ERROR <message>". After the initial
+    build a status line is written as well. The requests are
+
+    - quote <name> <value>: set a market quote. The quotes the market holds as handles, i.e. FX spots, security
+      spreads, recovery rates, CPRs and correlations, are updated in place and the portfolio follows them through
+      the observers. A new quote or a quote whose value a curve builder copies, e.g. a swap rate or a volatility,
+      triggers a rebuild of the market and portfolio from the quotes held in memory before the next request that
+      needs them, without reading any file
+    - add <xml>: add the trades of a Portfolio XML document given on a single line, the ids of the added trades are
+      returned, trades with an existing id are replaced. The server keeps the XML of its trades and rebuilds the
+      portfolio from it after a market rebuild, so that a trade which fails to build against one market is built
+      again against the next one
+    - remove <id>: remove a trade
+    - npv [id]: one line "<id> <currency> <npv>" for each trade or for the given trade
+    - reports: write the curve, NPV, cashflow and other initial reports configured in ore.xml
+    - sensitivity, stress: run the sensitivity analysis or stress test configured in ore.xml on the trades held in
+      memory and write its reports
+    - quit: stop the server
+
+    Progress messages are written to the output stream passed to the constructor, so that they do not interleave
+    with the replies.
+
+    \ingroup app
+*/
+class OREServer : public OREApp {
+public:
+    OREServer(boost::shared_ptr<Parameters> params, std::ostream& out = std::cerr);
+
+    //! build the market and portfolio, then answer the requests read from in until quit or the end of the input
+    int serve(std::istream& in, std::ostream& reply);
+
+    //! answer a single request, returns false for quit
+    bool process(const std::string& request, std::ostream& reply);
+
+protected:
+    //! load the market data, fixings, engine data and portfolio and build the market and portfolio
+    virtual void initialise();
+    //! rebuild the market from the quotes held in memory, and the portfolio against it, if a quote update needs it
+    void refresh();
+    //! the trades held in memory, parsed from their XML and not built
+    boost::shared_ptr<Portfolio> loadPortfolio() override;
+
+private:
+    class QuoteStore;
+    void buildMarketAndFactory();
+    void buildResidentPortfolio();
+    std::vector<std::pair<std::string, std::string>>::iterator findTradeXml(const std::string& id);
+
+    boost::shared_ptr<QuoteStore> quotes_;
+    // id and XML of each trade held in memory, in the order in which the trades were added
+    std::vector<std::pair<std::string, std::string>> tradeXml_;
+    boost::shared_ptr<EngineData> engineData_;
+    std::set<std::string> rebuildQuotes_;
+    bool marketStale_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -44,6 +44,10 @@ string Parameters::get(const string& groupName, const string& paramName) const {
     return it->second.find(paramName)->second;
 }
 
+void Parameters::set(const string& groupName, const string& paramName, const string& value) {
+    data_[groupName][paramName] = value;
+}
+
 void Parameters::fromFile(const string& fileName) {
     LOG("load ORE configuration from " << fileName);
     clear();
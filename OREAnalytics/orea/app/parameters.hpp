@@ -46,6 +46,8 @@ public:
     bool hasGroup(const string& groupName) const;
     bool has(const string& groupName, const string& paramName) const;
     string get(const string& groupName, const string& paramName) const;
+    // set or override a parameter, e.g. from the command line
+    void set(const string& groupName, const string& paramName, const string& value);
 
     void log();
 
@@ -19,7 +19,7 @@
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/sensitivityrunner.hpp>
 #include <orea/engine/sensitivitycubestream.hpp>
-#include <ored/report/csvreport.hpp>
+#include <ored/report/columnarreport.hpp>
 #include <ored/utilities/log.hpp>
 
 using namespace std;
@@ -50,6 +50,8 @@ void SensitivityRunner::runSensitivityAnalysis(boost::shared_ptr<Market> market,
         sensiPortfolio, market, marketConfiguration, engineData, simMarketData, sensiData, conventions,
         recalibrateModels, curveConfigs, todaysMarketParams, false, extraEngineBuilders_, extraLegBuilders_,
         continueOnError_);
+    if (params_->has("sensitivity", "pruneCrossGamma"))
+        sensiAnalysis->pruneCrossGamma(parseBool(params_->get("sensitivity", "pruneCrossGamma")));
     sensiAnalysis->generateSensitivities();
 
     sensiOutputReports(sensiAnalysis);
@@ -79,9 +81,13 @@ void SensitivityRunner::sensiInputInitialize(boost::shared_ptr<ScenarioSimMarket
     engineData->fromFile(sensiPricingEnginesFile);
 
     LOG("Get Portfolio");
-    string portfolioFile = inputPath + "/" + params_->get("setup", "portfolioFile");
     // Just load here. We build the portfolio in SensitivityAnalysis, after building SimMarket.
-    sensiPortfolio->load(portfolioFile, boost::make_shared<TradeFactory>(extraTradeBuilders_));
+    if (portfolio_) {
+        sensiPortfolio = portfolio_;
+    } else {
+        string portfolioFile = inputPath + "/" + params_->get("setup", "portfolioFile");
+        sensiPortfolio->load(portfolioFile, boost::make_shared<TradeFactory>(extraTradeBuilders_));
+    }
 
     DLOG("sensiInputInitialize done");
 }
@@ -92,16 +98,20 @@ void SensitivityRunner::sensiOutputReports(const boost::shared_ptr<SensitivityAn
     Real sensiThreshold = parseReal(params_->get("sensitivity", "outputSensitivityThreshold"));
 
     string outputFile = outputPath + "/" + params_->get("sensitivity", "scenarioOutputFile");
-    CSVFileReport scenReport(outputFile);
-    ReportWriter().writeScenarioReport(scenReport, sensiAnalysis->sensiCube(), sensiThreshold);
+    boost::shared_ptr<Report> scenReport = makeReport(outputFile);
+    ReportWriter().writeScenarioReport(*scenReport, sensiAnalysis->sensiCube(), sensiThreshold);
 
     // Create a stream from the sensitivity cube
     auto baseCurrency = sensiAnalysis->simMarketData()->baseCcy();
     auto ss = boost::make_shared<SensitivityCubeStream>(sensiAnalysis->sensiCube(), baseCurrency);
 
     outputFile = outputPath + "/" + params_->get("sensitivity", "sensitivityOutputFile");
-    CSVFileReport sensiReport(outputFile);
-    ReportWriter().writeSensitivityReport(sensiReport, ss, sensiThreshold);
+    boost::shared_ptr<Report> sensiReport = makeReport(outputFile);
+    ReportWriter().writeSensitivityReport(*sensiReport, ss, sensiThreshold);
+}
+
+boost::shared_ptr<Report> SensitivityRunner::makeReport(const string& fileName) const {
+    return makeFileReport(fileName, binaryReports_);
 }
 
 } // namespace analytics
@@ -31,6 +31,7 @@
 #include <ored/marketdata/market.hpp>
 #include <ored/portfolio/enginedata.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/report/report.hpp>
 
 namespace ore {
 namespace analytics {
@@ -41,9 +42,9 @@ public:
                       std::map<string, boost::shared_ptr<AbstractTradeBuilder>> extraTradeBuilders = {},
                       std::vector<boost::shared_ptr<ore::data::EngineBuilder>> extraEngineBuilders = {},
                       std::vector<boost::shared_ptr<ore::data::LegBuilder>> extraLegBuilders = {},
-                      const bool continueOnError = false)
+                      const bool continueOnError = false, const bool binaryReports = false)
         : params_(params), extraTradeBuilders_(extraTradeBuilders), extraEngineBuilders_(extraEngineBuilders),
-          extraLegBuilders_(extraLegBuilders), continueOnError_(continueOnError) {}
+          extraLegBuilders_(extraLegBuilders), continueOnError_(continueOnError), binaryReports_(binaryReports) {}
 
     virtual ~SensitivityRunner(){};
 
@@ -60,12 +61,21 @@ public:
     //! Write out some standard sensitivities reports
     virtual void sensiOutputReports(const boost::shared_ptr<SensitivityAnalysis>& sensiAnalysis);
 
+    //! Use the given portfolio, loaded but not built, instead of loading the portfolio file
+    void setPortfolio(const boost::shared_ptr<Portfolio>& portfolio) { portfolio_ = portfolio; }
+
 protected:
+    //! create a report in the configured format, csv by default
+    boost::shared_ptr<ore::data::Report> makeReport(const std::string& fileName) const;
+
+
     boost::shared_ptr<Parameters> params_;
     std::map<string, boost::shared_ptr<AbstractTradeBuilder>> extraTradeBuilders_;
     std::vector<boost::shared_ptr<ore::data::EngineBuilder>> extraEngineBuilders_;
     std::vector<boost::shared_ptr<ore::data::LegBuilder>> extraLegBuilders_;
     const bool continueOnError_;
+    const bool binaryReports_;
+    boost::shared_ptr<Portfolio> portfolio_;
 };
 
 } // namespace analytics
@@ -0,0 +1,246 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/compressedcube.hpp>
+#include <ored/utilities/serializationdate.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace ore {
+namespace analytics {
+
+CompressedInMemoryCube::CompressedInMemoryCube(const Date& asof, const std::vector<std::string>& ids,
+                                               const std::vector<Date>& dates, Size samples, Size depth, Real maxError,
+                                               Size blockSize)
+    : asof_(asof), ids_(ids), dates_(dates), samples_(samples), depth_(depth), maxError_(maxError),
+      blockSize_(blockSize), quantisationError_(0.0) {
+    QL_REQUIRE(ids.size() > 0, "CompressedInMemoryCube: no ids specified");
+    QL_REQUIRE(dates.size() > 0, "CompressedInMemoryCube: no dates specified");
+    QL_REQUIRE(samples > 0, "CompressedInMemoryCube: samples must be > 0");
+    QL_REQUIRE(depth > 0, "CompressedInMemoryCube: depth must be > 0");
+    QL_REQUIRE(blockSize > 0, "CompressedInMemoryCube: block size must be > 0");
+    QL_REQUIRE(maxError >= 0.0, "CompressedInMemoryCube: max error (" << maxError << ") must be non-negative");
+    numBlocks_ = (samples_ + blockSize_ - 1) / blockSize_;
+    t0Data_.resize(ids_.size() * depth_, 0.0);
+    blocks_.resize(ids_.size() * dates_.size() * depth_ * numBlocks_);
+}
+
+CompressedInMemoryCube::CompressedInMemoryCube(const NPVCube& cube, Real maxError, Size blockSize)
+    : CompressedInMemoryCube(cube.asof(), cube.ids(), cube.dates(), cube.samples(), cube.depth(), maxError,
+                             blockSize) {
+    // row by row, so that each block is encoded as soon as it is complete
+    for (Size i = 0; i < numIds(); ++i) {
+        for (Size d = 0; d < depth_; ++d) {
+            setT0(cube.getT0(i, d), i, d);
+            for (Size j = 0; j < numDates(); ++j)
+                for (Size k = 0; k < samples_; ++k)
+                    set(cube.get(i, j, k, d), i, j, k, d);
+        }
+    }
+}
+
+void CompressedInMemoryCube::load(const std::string& fileName) {
+    std::ifstream ifs(fileName.c_str(), std::fstream::binary);
+    QL_REQUIRE(ifs.is_open(), "error opening file " << fileName);
+    boost::archive::binary_iarchive ia(ifs);
+    ia >> *this;
+}
+
+void CompressedInMemoryCube::save(const std::string& fileName) const {
+    std::ofstream ofs(fileName.c_str(), std::fstream::binary);
+    QL_REQUIRE(ofs.is_open(), "error opening file " << fileName);
+    boost::archive::binary_oarchive oa(ofs);
+    oa << *this;
+}
+
+Real CompressedInMemoryCube::getT0(Size i, Size d) const {
+    check(i, 0, 0, d);
+    return t0Data_[i * depth_ + d];
+}
+
+void CompressedInMemoryCube::setT0(Real value, Size i, Size d) {
+    check(i, 0, 0, d);
+    t0Data_[i * depth_ + d] = value;
+}
+
+Real CompressedInMemoryCube::get(Size i, Size j, Size k, Size d) const {
+    check(i, j, k, d);
+    return decode(blocks_[blockIndex(i, j, k, d)], k % blockSize_);
+}
+
+void CompressedInMemoryCube::set(Real value, Size i, Size j, Size k, Size d) {
+    check(i, j, k, d);
+    Block& block = blocks_[blockIndex(i, j, k, d)];
+    Size n = blockLength(k / blockSize_);
+    if (block.encoding != Open) {
+        // decode the block for writing, a value written to a complete block replaces an existing one
+        std::vector<float> values(n);
+        for (Size l = 0; l < n; ++l)
+            values[l] = static_cast<float>(decode(block, l));
+        block.quantised = std::vector<std::uint16_t>();
+        block.values.swap(values);
+        block.encoding = Open;
+        if (block.written == n)
+            --block.written;
+    }
+    block.values[k % blockSize_] = static_cast<float>(value);
+    if (++block.written == n)
+        seal(block);
+}
+
+void CompressedInMemoryCube::compress() {
+    for (auto& block : blocks_) {
+        if (block.encoding == Open)
+            seal(block);
+    }
+}
+
+Size CompressedInMemoryCube::memory() const {
+    Size result = t0Data_.size() * sizeof(double);
+    for (auto const& block : blocks_)
+        result += sizeof(Block) + block.quantised.capacity() * sizeof(std::uint16_t) +
+                  block.values.capacity() * sizeof(float);
+    return result;
+}
+
+Real CompressedInMemoryCube::compressionRatio() const {
+    Real single = static_cast<Real>(numIds()) * numDates() * samples_ * depth_ * sizeof(float);
+    return single / static_cast<Real>(memory());
+}
+
+void CompressedInMemoryCube::check(Size i, Size j, Size k, Size d) const {
+    QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ")");
+    QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ")");
+    QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ")");
+    QL_REQUIRE(d < depth(), "Out of bounds on depth(d=" << d << ")");
+}
+
+Size CompressedInMemoryCube::blockIndex(Size i, Size j, Size k, Size d) const {
+    return ((i * dates_.size() + j) * depth_ + d) * numBlocks_ + k / blockSize_;
+}
+
+Size CompressedInMemoryCube::blockLength(Size block) const {
+    return std::min(blockSize_, samples_ - block * blockSize_);
+}
+
+Real CompressedInMemoryCube::decode(const Block& block, Size l) const {
+    switch (block.encoding) {
+    case Zero:
+        return 0.0;
+    case Constant:
+        return block.offset;
+    case Quantised:
+        return block.offset + block.scale * block.quantised[l];
+    default:
+        return block.values[l];
+    }
+}
+
+Real CompressedInMemoryCube::encode(const std::vector<float>& values, Block& block) const {
+    block.quantised = std::vector<std::uint16_t>();
+    block.values = std::vector<float>();
+    block.offset = block.scale = 0.0;
+
+    double lo = std::numeric_limits<double>::max(), hi = -std::numeric_limits<double>::max();
+    bool finite = true;
+    for (auto v : values) {
+        finite = finite && std::isfinite(v);
+        lo = std::min<double>(lo, v);
+        hi = std::max<double>(hi, v);
+    }
+    if (finite && lo == 0.0 && hi == 0.0) {
+        block.encoding = Zero;
+        return 0.0;
+    }
+    if (finite && lo == hi) {
+        block.encoding = Constant;
+        block.offset = lo;
+        return 0.0;
+    }
+
+    if (finite && !block.lossy && maxError_ > 0.0 && (hi - lo) / 65535.0 / 2.0 <= maxError_) {
+        double scale = (hi - lo) / 65535.0;
+        std::vector<std::uint16_t> quantised(values.size());
+        Real error = 0.0;
+        for (Size l = 0; l < values.size(); ++l) {
+            double q = std::min(std::max(std::round((values[l] - lo) / scale), 0.0), 65535.0);
+            quantised[l] = static_cast<std::uint16_t>(q);
+            error = std::max<Real>(error, std::fabs(lo + scale * quantised[l] - values[l]));
+        }
+        // the bound is checked on the decoded values, rounding may push the error just above the estimate
+        if (error <= maxError_) {
+            block.encoding = Quantised;
+            block.lossy = 1;
+            block.offset = lo;
+            block.scale = scale;
+            block.quantised.swap(quantised);
+            return error;
+        }
+    }
+
+    block.encoding = Single;
+    block.values = values;
+    return 0.0;
+}
+
+void CompressedInMemoryCube::seal(Block& block) {
+    std::vector<float> values;
+    values.swap(block.values);
+    quantisationError_ = std::max(quantisationError_, encode(values, block));
+}
+
+template <class Archive> void CompressedInMemoryCube::save(Archive& ar, const unsigned int) const {
+    ar << asof_ << ids_ << dates_ << samples_ << depth_ << maxError_ << blockSize_ << numBlocks_
+       << quantisationError_ << t0Data_;
+    Size n = blocks_.size();
+    ar << n;
+    for (auto const& block : blocks_) {
+        if (block.encoding == Open) {
+            // encode a copy, the samples not written yet are zero
+            Block encoded;
+            encoded.lossy = block.lossy;
+            encoded.written = block.written;
+            encode(block.values, encoded);
+            ar << encoded;
+        } else {
+            ar << block;
+        }
+    }
+}
+
+template <class Archive> void CompressedInMemoryCube::load(Archive& ar, const unsigned int) {
+    ar >> asof_ >> ids_ >> dates_ >> samples_ >> depth_ >> maxError_ >> blockSize_ >> numBlocks_ >>
+        quantisationError_ >> t0Data_;
+    Size n;
+    ar >> n;
+    QL_REQUIRE(n == ids_.size() * dates_.size() * depth_ * numBlocks_, "CompressedInMemoryCube: inconsistent file");
+    blocks_.resize(n);
+    for (auto& block : blocks_)
+        ar >> block;
+}
+
+} // namespace analytics
+} // namespace ore
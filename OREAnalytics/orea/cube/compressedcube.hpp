@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/compressedcube.hpp
+    \brief A cube implementation that stores quantised sample blocks in memory
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! CompressedInMemoryCube stores the cube in adaptively encoded blocks of samples
+/*! Each (id, date, depth) row is split into blocks of blockSize samples. A block is encoded once all its samples
+    are written, blocks which are zero (e.g. after the trade's maturity) or constant are stored without data, the
+    others are quantised to 16 bit integers with the block's offset and scale if the quantisation error stays within
+    maxError, and kept in single precision otherwise. A maxError of zero disables the quantisation. Writing to an
+    encoded block decodes it again, so the cube can be filled in any order, but since the cube is usually filled
+    sample by sample only one block per row is held in single precision while the cube is built. A block that was
+    quantised once is kept in single precision when it is encoded again, so that the errors do not add up and the
+    values stay within maxError.
+
+    Reading a value decodes it from its block directly, so random access stays cheap. The saved file contains the
+    encoded blocks, blocks not completely written are encoded on saving.
+
+    \ingroup cube
+*/
+class CompressedInMemoryCube : public NPVCube {
+public:
+    //! ctor
+    CompressedInMemoryCube(const Date& asof, const std::vector<std::string>& ids, const std::vector<Date>& dates,
+                           Size samples, Size depth = 1, Real maxError = 0.0, Size blockSize = 256);
+    //! copy the contents of another cube
+    CompressedInMemoryCube(const NPVCube& cube, Real maxError = 0.0, Size blockSize = 256);
+    //! default ctor, to be filled by load()
+    CompressedInMemoryCube()
+        : samples_(0), depth_(0), maxError_(0.0), blockSize_(256), numBlocks_(0), quantisationError_(0.0) {}
+
+    //! load cube from an archive
+    void load(const std::string& fileName) override;
+    //! write cube to an archive
+    void save(const std::string& fileName) const override;
+
+    //! Return the length of each dimension
+    Size numIds() const override { return ids_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
+
+    //! Get the vector of ids for this cube
+    const std::vector<std::string>& ids() const override { return ids_; }
+    //! Get the vector of dates for this cube
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+
+    //! Return the asof date (T0 date)
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d = 0) const override;
+    void setT0(Real value, Size i, Size d = 0) override;
+    Real get(Size i, Size j, Size k, Size d = 0) const override;
+    void set(Real value, Size i, Size j, Size k, Size d = 0) override;
+
+    //! Encode the blocks that are not completely written yet, their missing samples are zero
+    void compress();
+
+    //! \name Inspectors
+    //@{
+    //! Maximum absolute quantisation error allowed
+    Real maxError() const { return maxError_; }
+    //! Maximum absolute quantisation error of the blocks encoded so far
+    Real quantisationError() const { return quantisationError_; }
+    //! Memory used by the cube values in bytes
+    Size memory() const;
+    //! Size of a single precision cube of the same dimensions divided by memory()
+    Real compressionRatio() const;
+    //@}
+
+private:
+    enum Encoding : std::uint8_t { Zero, Constant, Quantised, Single, Open };
+
+    struct Block {
+        Block() : encoding(Zero), lossy(0), written(0), offset(0.0), scale(0.0) {}
+        std::uint8_t encoding;
+        // the values carry a quantisation error, so that the block is not quantised again
+        std::uint8_t lossy;
+        std::uint32_t written;
+        double offset, scale;
+        std::vector<std::uint16_t> quantised;
+        std::vector<float> values;
+
+        template <class Archive> void serialize(Archive& ar, const unsigned int) {
+            ar& encoding;
+            ar& lossy;
+            ar& written;
+            ar& offset;
+            ar& scale;
+            ar& quantised;
+            ar& values;
+        }
+    };
+
+    void check(Size i, Size j, Size k, Size d) const;
+    Size blockIndex(Size i, Size j, Size k, Size d) const;
+    Size blockLength(Size block) const;
+    Real decode(const Block& block, Size l) const;
+    //! encode the given values into the block, returns the maximum quantisation error, lossy blocks are not quantised
+    Real encode(const std::vector<float>& values, Block& block) const;
+    void seal(Block& block);
+
+    friend class boost::serialization::access;
+    template <class Archive> void save(Archive& ar, const unsigned int) const;
+    template <class Archive> void load(Archive& ar, const unsigned int);
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    QuantLib::Date asof_;
+    std::vector<std::string> ids_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_, depth_;
+    Real maxError_;
+    Size blockSize_, numBlocks_;
+    Real quantisationError_;
+    std::vector<double> t0Data_;
+    std::vector<Block> blocks_;
+};
+
+} // namespace analytics
+} // namespace ore
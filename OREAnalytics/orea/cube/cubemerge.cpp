@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/cubemerge.hpp>
+#include <orea/cube/inmemorycube.hpp>
+
+#include <boost/make_shared.hpp>
+#include <map>
+
+namespace ore {
+namespace analytics {
+
+namespace {
+std::map<std::string, Size> indexById(const NPVCube& cube) {
+    std::map<std::string, Size> result;
+    for (Size i = 0; i < cube.numIds(); ++i)
+        result[cube.ids()[i]] = i;
+    return result;
+}
+} // namespace
+
+boost::shared_ptr<NPVCube> mergeCubes(const std::vector<std::string>& ids, const boost::shared_ptr<NPVCube>& base,
+                                      const boost::shared_ptr<NPVCube>& update) {
+
+    QL_REQUIRE(base, "mergeCubes: no base cube given");
+    if (update) {
+        QL_REQUIRE(update->asof() == base->asof(),
+                   "mergeCubes: asof mismatch (" << update->asof() << " vs " << base->asof() << ")");
+        QL_REQUIRE(update->dates() == base->dates(), "mergeCubes: date grid mismatch");
+        QL_REQUIRE(update->samples() == base->samples(),
+                   "mergeCubes: samples mismatch (" << update->samples() << " vs " << base->samples() << ")");
+        QL_REQUIRE(update->depth() == base->depth(),
+                   "mergeCubes: depth mismatch (" << update->depth() << " vs " << base->depth() << ")");
+    }
+
+    boost::shared_ptr<NPVCube> result;
+    if (base->depth() == 1)
+        result = boost::make_shared<SinglePrecisionInMemoryCube>(base->asof(), ids, base->dates(), base->samples());
+    else
+        result = boost::make_shared<SinglePrecisionInMemoryCubeN>(base->asof(), ids, base->dates(), base->samples(),
+                                                                  base->depth());
+
+    std::map<std::string, Size> baseIndex = indexById(*base);
+    std::map<std::string, Size> updateIndex;
+    if (update)
+        updateIndex = indexById(*update);
+
+    for (Size i = 0; i < ids.size(); ++i) {
+        boost::shared_ptr<NPVCube> source;
+        Size j;
+        auto u = updateIndex.find(ids[i]);
+        if (u != updateIndex.end()) {
+            source = update;
+            j = u->second;
+        } else {
+            auto b = baseIndex.find(ids[i]);
+            QL_REQUIRE(b != baseIndex.end(), "mergeCubes: id " << ids[i] << " not found in base or update cube");
+            source = base;
+            j = b->second;
+        }
+        for (Size d = 0; d < result->depth(); ++d) {
+            result->setT0(source->getT0(j, d), i, d);
+            for (Size k = 0; k < result->numDates(); ++k)
+                for (Size s = 0; s < result->samples(); ++s)
+                    result->set(source->get(j, k, s, d), i, k, s, d);
+        }
+    }
+
+    return result;
+}
+
+void copyCubeShard(const NPVCube& shard, NPVCube& target, Size firstSample) {
+    QL_REQUIRE(shard.dates() == target.dates(), "copyCubeShard: date grid mismatch");
+    QL_REQUIRE(shard.depth() == target.depth(),
+               "copyCubeShard: depth mismatch (" << shard.depth() << " vs " << target.depth() << ")");
+    QL_REQUIRE(firstSample + shard.samples() <= target.samples(),
+               "copyCubeShard: samples " << firstSample << " to " << firstSample + shard.samples() - 1
+                                         << " out of range, target has " << target.samples() << " samples");
+    std::map<std::string, Size> targetIndex = indexById(target);
+    for (Size i = 0; i < shard.numIds(); ++i) {
+        auto t = targetIndex.find(shard.ids()[i]);
+        QL_REQUIRE(t != targetIndex.end(), "copyCubeShard: id " << shard.ids()[i] << " not found in target cube");
+        for (Size d = 0; d < shard.depth(); ++d) {
+            target.setT0(shard.getT0(i, d), t->second, d);
+            for (Size k = 0; k < shard.numDates(); ++k)
+                for (Size s = 0; s < shard.samples(); ++s)
+                    target.set(shard.get(i, k, s, d), t->second, k, firstSample + s, d);
+        }
+    }
+}
+
+void copyScenarioDataShard(const AggregationScenarioData& shard, AggregationScenarioData& target, Size firstSample) {
+    QL_REQUIRE(shard.dimDates() == target.dimDates(), "copyScenarioDataShard: number of dates mismatch ("
+                                                          << shard.dimDates() << " vs " << target.dimDates() << ")");
+    QL_REQUIRE(firstSample + shard.dimSamples() <= target.dimSamples(),
+               "copyScenarioDataShard: samples out of range");
+    for (auto const& key : shard.keys()) {
+        for (Size k = 0; k < shard.dimDates(); ++k)
+            for (Size s = 0; s < shard.dimSamples(); ++s)
+                target.set(k, firstSample + s, shard.get(k, s, key.first, key.second), key.first, key.second);
+    }
+}
+
+template <typename T> boost::shared_ptr<NPVCube> sliceCube(const NPVCube& cube, Size firstSample, Size samples) {
+    QL_REQUIRE(firstSample + samples <= cube.samples(),
+               "sliceCube: samples " << firstSample << " to " << firstSample + samples - 1
+                                     << " out of range, cube has " << cube.samples() << " samples");
+    boost::shared_ptr<NPVCube> result;
+    if (cube.depth() == 1)
+        result = boost::make_shared<InMemoryCube1<T>>(cube.asof(), cube.ids(), cube.dates(), samples);
+    else
+        result = boost::make_shared<InMemoryCubeN<T>>(cube.asof(), cube.ids(), cube.dates(), samples, cube.depth());
+    for (Size i = 0; i < cube.numIds(); ++i) {
+        for (Size d = 0; d < cube.depth(); ++d) {
+            result->setT0(cube.getT0(i, d), i, d);
+            for (Size k = 0; k < cube.numDates(); ++k)
+                for (Size s = 0; s < samples; ++s)
+                    result->set(cube.get(i, k, firstSample + s, d), i, k, s, d);
+        }
+    }
+    return result;
+}
+
+template boost::shared_ptr<NPVCube> sliceCube<float>(const NPVCube& cube, Size firstSample, Size samples);
+template boost::shared_ptr<NPVCube> sliceCube<double>(const NPVCube& cube, Size firstSample, Size samples);
+
+boost::shared_ptr<AggregationScenarioData> sliceScenarioData(const AggregationScenarioData& data, Size firstSample,
+                                                             Size samples) {
+    QL_REQUIRE(firstSample + samples <= data.dimSamples(), "sliceScenarioData: samples out of range");
+    auto result = boost::make_shared<InMemoryAggregationScenarioData>(data.dimDates(), samples);
+    for (auto const& key : data.keys()) {
+        for (Size k = 0; k < data.dimDates(); ++k)
+            for (Size s = 0; s < samples; ++s)
+                result->set(k, s, data.get(k, firstSample + s, key.first, key.second), key.first, key.second);
+    }
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
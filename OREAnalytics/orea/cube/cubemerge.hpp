@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/cubemerge.hpp
+    \brief Combine the trade rows and sample ranges of NPV cubes
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <orea/cube/npvcube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Build an in memory cube over the given ids from the rows of existing cubes
+/*! Each id's T0 values and paths are taken from the update cube if it contains the id and from the base cube
+    otherwise, ids found in neither cube are an error. Both cubes have to share asof, date grid, samples and depth,
+    which is the case if they were generated from the same simulation configuration and seed. The base cube alone
+    can be used to cut out a subset of its rows.
+
+    \ingroup cube
+*/
+boost::shared_ptr<NPVCube> mergeCubes(const std::vector<std::string>& ids, const boost::shared_ptr<NPVCube>& base,
+                                      const boost::shared_ptr<NPVCube>& update = boost::shared_ptr<NPVCube>());
+
+//! Copy a cube shard holding a range of samples for some trades into the target cube
+/*! The shard's samples are written to the target samples starting at firstSample, its ids have to be contained in
+    the target, and date grid and depth have to match.
+
+    \ingroup cube
+*/
+void copyCubeShard(const NPVCube& shard, NPVCube& target, Size firstSample);
+
+//! Copy the scenario data of a range of samples into the target scenario data, starting at firstSample
+/*! \ingroup cube
+ */
+void copyScenarioDataShard(const AggregationScenarioData& shard, AggregationScenarioData& target, Size firstSample);
+
+//! Build an in memory cube holding the given range of samples of a cube, the inverse of copyCubeShard
+/*! The slice stores its values as T, float or double, whatever the precision of the source cube, so a slice of a
+    double precision cube with T = float is rounded to single precision. Code loading a saved slice has to use an
+    in memory cube of the same value type.
+
+    \ingroup cube
+*/
+template <typename T> boost::shared_ptr<NPVCube> sliceCube(const NPVCube& cube, Size firstSample, Size samples);
+
+//! Build in memory scenario data holding the given range of samples, the inverse of copyScenarioDataShard
+/*! \ingroup cube
+ */
+boost::shared_ptr<AggregationScenarioData> sliceScenarioData(const AggregationScenarioData& data, Size firstSample,
+                                                             Size samples);
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,312 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/amcswaptionkernel.hpp>
+#include <ored/portfolio/swaption.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/math/randomnumbers/rngtraits.hpp>
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace QuantLib;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+AmcSwaptionKernel::AmcSwaptionKernel(const boost::shared_ptr<Trade>& trade,
+                                     const boost::shared_ptr<VectorisedMarketState>& state,
+                                     const AmcParameters& parameters)
+    : VectorisedKernel(state), parameters_(parameters) {
+    auto swaption = boost::dynamic_pointer_cast<ore::data::Swaption>(trade);
+    QL_REQUIRE(swaption, "trade is not a Swaption");
+    generator_ =
+        boost::dynamic_pointer_cast<CrossAssetModelScenarioGenerator>(state_->simMarket()->scenarioGenerator());
+    QL_REQUIRE(generator_, "AMC valuation requires a CrossAssetModelScenarioGenerator");
+    QL_REQUIRE(!trade->legs().empty(), "no underlying legs");
+    const std::string& ccy = trade->legCurrencies().front();
+    for (auto const& c : trade->legCurrencies())
+        QL_REQUIRE(c == ccy, "underlying legs in different currencies not supported");
+
+    Size ccyIndex = generator_->model()->ccyIndex(parseCurrency(ccy));
+    model_ = generator_->model()->lgm(ccyIndex);
+    processIndex_ = generator_->model()->pIdx(QuantExt::CrossAssetModelTypes::IR, ccyIndex);
+    const OptionData& option = swaption->option();
+    multiplier_ = parsePositionType(option.longShort()) == Position::Long ? 1.0 : -1.0;
+    physical_ = parseSettlementType(option.settlement()) == Settlement::Physical;
+    fx_ = state_->fxId(ccy);
+    addPayments(trade->instrument(), premiums_);
+
+    // underlying flows, as seen from the option holder
+    const Date& today = state_->simMarket()->asofDate();
+    boost::shared_ptr<QuantExt::IrLgm1fParametrization> p = model_->parametrization();
+    Handle<YieldTermStructure> ts = p->termStructure();
+    Date lastAccrualStartDate = Date::minDate();
+    for (Size i = 0; i < trade->legs().size(); ++i) {
+        Real sign = trade->legPayers()[i] ? -1.0 : 1.0;
+        for (auto const& cf : trade->legs()[i]) {
+            auto cpn = boost::dynamic_pointer_cast<Coupon>(cf);
+            QL_REQUIRE(cpn, "underlying flow is not a coupon");
+            lastAccrualStartDate = std::max(lastAccrualStartDate, cpn->accrualStartDate());
+            // flows that can not be part of an exercised underlying are not needed
+            if (cpn->accrualStartDate() <= today)
+                continue;
+            ModelFlow f;
+            f.accrualStartDate = cpn->accrualStartDate();
+            Time T = ts->timeFromReference(cf->date());
+            f.discount = ts->discount(T);
+            f.H = p->H(T);
+            if (auto c = boost::dynamic_pointer_cast<IborCoupon>(cf)) {
+                QL_REQUIRE(typeid(*c) == typeid(IborCoupon), "derived ibor coupon not supported");
+                QL_REQUIRE(!c->isInArrears(), "in arrears ibor coupon not supported");
+                boost::shared_ptr<IborIndex> index = c->iborIndex();
+                std::pair<Date, Date> period = iborEstimationPeriod(c);
+                Handle<YieldTermStructure> fwd = index->forwardingTermStructure();
+                f.floating = true;
+                f.amount = sign * c->nominal() * c->accrualPeriod();
+                f.gearing = c->gearing();
+                f.spread = c->spread();
+                f.forwardRatio = fwd->discount(period.first) / fwd->discount(period.second);
+                f.Hstart = p->H(ts->timeFromReference(period.first));
+                f.Hend = p->H(ts->timeFromReference(period.second));
+                f.spanningTime = index->dayCounter().yearFraction(period.first, period.second);
+            } else {
+                QL_REQUIRE(boost::dynamic_pointer_cast<FixedRateCoupon>(cf), "coupon type not supported");
+                f.floating = false;
+                f.amount = sign * cf->amount();
+                f.gearing = f.spread = f.forwardRatio = f.Hstart = f.Hend = f.spanningTime = 0.0;
+            }
+            flows_.push_back(f);
+        }
+    }
+
+    // exercise dates as in ore::data::Swaption, i.e. only future dates exercising into whole accrual periods
+    for (auto const& e : option.exerciseDates()) {
+        Date d = parseDate(e);
+        if (d > today && d <= lastAccrualStartDate)
+            exerciseDates_.push_back(d);
+    }
+    QL_REQUIRE(!exerciseDates_.empty(), "no alive exercise dates");
+    std::sort(exerciseDates_.begin(), exerciseDates_.end());
+    for (Size k = 0; k < exerciseDates_.size(); ++k) {
+        exerciseTimes_.push_back(ts->timeFromReference(exerciseDates_[k]));
+        underlyingFlows_.push_back(std::vector<Size>());
+        for (Size n = 0; n < flows_.size(); ++n) {
+            if (flows_[n].accrualStartDate >= exerciseDates_[k])
+                underlyingFlows_.back().push_back(n);
+        }
+        if (physical_) {
+            std::vector<Leg> legs(trade->legs().size());
+            for (Size i = 0; i < legs.size(); ++i) {
+                for (auto const& cf : trade->legs()[i]) {
+                    if (boost::dynamic_pointer_cast<Coupon>(cf)->accrualStartDate() >= exerciseDates_[k])
+                        legs[i].push_back(cf);
+                }
+            }
+            underlyings_.push_back(boost::make_shared<DiscountedCashflowKernel>(
+                legs, trade->legCurrencies(), trade->legPayers(), multiplier_, state_));
+        }
+    }
+
+    // per date the exercise decisions and the recorded data
+    const std::vector<Date>& dates = state_->dates();
+    Size samples = state_->samples();
+    cubeTimes_.resize(dates.size());
+    exercisesDecided_.resize(dates.size());
+    states_.resize(dates.size());
+    exercised_.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i) {
+        cubeTimes_[i] = generator_->timeGrid()[i + 1];
+        for (Size k = 0; k < exerciseDates_.size(); ++k) {
+            if (vectorisedEventOccurred(exerciseDates_[k], dates[i]) &&
+                (i == 0 || !vectorisedEventOccurred(exerciseDates_[k], dates[i - 1])))
+                exercisesDecided_[i].push_back(k);
+        }
+        if (!vectorisedEventOccurred(exerciseDates_.back(), dates[i]) || !exercisesDecided_[i].empty())
+            states_[i].resize(samples, 0.0);
+        exercised_[i].resize(samples, Null<Size>());
+    }
+    currentExercise_.resize(samples, Null<Size>());
+
+    basis_ = LsmBasisSystem::pathBasisSystem(parameters_.polynomOrder, parameters_.polynomType);
+    train();
+}
+
+Real AmcSwaptionKernel::deflatedUnderlying(Size k, Time t, Real x) const {
+    Real zeta = model_->parametrization()->zeta(t);
+    Real result = 0.0;
+    for (Size n : underlyingFlows_[k]) {
+        const ModelFlow& f = flows_[n];
+        // reduced discount bond and fwd-fwd corrected forward as in QuantExt::NumericLgmSwaptionEngine
+        Real discount = f.discount * std::exp(-f.H * x - 0.5 * f.H * f.H * zeta);
+        if (f.floating) {
+            Real ratio = f.forwardRatio * std::exp(-(f.Hstart - f.Hend) * x -
+                                                   0.5 * (f.Hstart * f.Hstart - f.Hend * f.Hend) * zeta);
+            Real forward = (ratio - 1.0) / f.spanningTime;
+            result += f.amount * (f.gearing * forward + f.spread) * discount;
+        } else {
+            result += f.amount * discount;
+        }
+    }
+    return result;
+}
+
+void AmcSwaptionKernel::train() {
+    Size n = parameters_.trainingSamples;
+    QL_REQUIRE(n > basis_.size(), "AMC: number of training samples (" << n << ") must be greater than the number "
+                                                                       << "of basis functions (" << basis_.size()
+                                                                       << ")");
+
+    // training grid consisting of the exercise dates and the alive simulation dates; an exercise on a simulation
+    // date is seen by the simulation date if and only if the exercise has not occurred at the simulation date
+    struct Event {
+        Date date;
+        Time time;
+        bool exercise;
+        Size index;
+    };
+    std::vector<Event> events;
+    for (Size k = 0; k < exerciseDates_.size(); ++k) {
+        Event e = {exerciseDates_[k], exerciseTimes_[k], true, k};
+        events.push_back(e);
+    }
+    const std::vector<Date>& dates = state_->dates();
+    for (Size i = 0; i < dates.size(); ++i) {
+        if (!vectorisedEventOccurred(exerciseDates_.back(), dates[i])) {
+            Event e = {dates[i], cubeTimes_[i], false, i};
+            events.push_back(e);
+        }
+    }
+    bool exerciseFirst = vectorisedEventOccurred(dates.front(), dates.front());
+    std::stable_sort(events.begin(), events.end(), [exerciseFirst](const Event& a, const Event& b) {
+        if (a.date != b.date)
+            return a.date < b.date;
+        return a.exercise != b.exercise && a.exercise == exerciseFirst;
+    });
+
+    // LGM state paths, the state is a driftless Gaussian process with variance zeta in the LGM measure
+    boost::shared_ptr<QuantExt::IrLgm1fParametrization> p = model_->parametrization();
+    std::vector<std::vector<Real>> x(events.size(), std::vector<Real>(n, 0.0));
+    PseudoRandom::rsg_type rsg = PseudoRandom::make_sequence_generator(events.size(), parameters_.seed);
+    for (Size j = 0; j < n; ++j) {
+        const std::vector<Real>& z = rsg.nextSequence().value;
+        Real state = 0.0, zeta = 0.0;
+        for (Size e = 0; e < events.size(); ++e) {
+            Real zetaNext = p->zeta(events[e].time);
+            state += std::sqrt(std::max(zetaNext - zeta, 0.0)) * z[e];
+            zeta = std::max(zeta, zetaNext);
+            x[e][j] = state;
+        }
+    }
+
+    // backward induction on the deflated pathwise option values
+    continuation_.resize(exerciseDates_.size());
+    value_.resize(dates.size());
+    std::vector<Real> y(n, 0.0), u(n, 0.0);
+    for (Size e = events.size(); e > 0; --e) {
+        const Event& event = events[e - 1];
+        const std::vector<Real>& xe = x[e - 1];
+        if (event.exercise) {
+            std::vector<Real> xItm, yItm;
+            for (Size j = 0; j < n; ++j) {
+                u[j] = deflatedUnderlying(event.index, event.time, xe[j]);
+                if (u[j] > 0.0) {
+                    xItm.push_back(xe[j]);
+                    yItm.push_back(y[j]);
+                }
+            }
+            // fall back on all paths if there are too few paths in the money
+            boost::shared_ptr<QuantExt::StabilisedGLLS> ls =
+                xItm.size() > basis_.size() ? boost::make_shared<QuantExt::StabilisedGLLS>(xItm, yItm, basis_)
+                                            : boost::make_shared<QuantExt::StabilisedGLLS>(xe, y, basis_);
+            for (Size j = 0; j < n; ++j) {
+                if (u[j] > 0.0 && u[j] > ls->eval(xe[j], basis_))
+                    y[j] = u[j];
+            }
+            continuation_[event.index] = ls;
+        } else {
+            value_[event.index] = boost::make_shared<QuantExt::StabilisedGLLS>(xe, y, basis_);
+        }
+    }
+}
+
+void AmcSwaptionKernel::record(Size dateIndex, Size sample) {
+    Size& current = currentExercise_[sample];
+    if (dateIndex == 0)
+        current = Null<Size>();
+    if (!states_[dateIndex].empty()) {
+        Real x = generator_->modelState(processIndex_, dateIndex);
+        states_[dateIndex][sample] = x;
+        // exercise decision at the first simulation date on or after the exercise date
+        for (Size k : exercisesDecided_[dateIndex]) {
+            if (current != Null<Size>())
+                break;
+            Real u = deflatedUnderlying(k, exerciseTimes_[k], x);
+            if (u > 0.0 && u > continuation_[k]->eval(x, basis_))
+                current = k;
+        }
+    }
+    exercised_[dateIndex][sample] = current;
+    if (physical_ && current != Null<Size>())
+        underlyings_[current]->record(dateIndex, sample);
+}
+
+void AmcSwaptionKernel::price(Size dateIndex, std::vector<Real>& values) const {
+    Size samples = state_->samples();
+    values.assign(samples, 0.0);
+    const std::vector<Real>& fx = state_->fxSpot(fx_, dateIndex);
+    bool alive = !vectorisedEventOccurred(exerciseDates_.back(), state_->dates()[dateIndex]);
+    std::map<Size, std::vector<Real>> underlyingValues;
+    for (Size s = 0; s < samples; ++s) {
+        Size k = exercised_[dateIndex][s];
+        if (k == Null<Size>()) {
+            if (alive) {
+                Real x = states_[dateIndex][s];
+                Real v = std::max(value_[dateIndex]->eval(x, basis_), 0.0);
+                values[s] = multiplier_ * v * model_->numeraire(cubeTimes_[dateIndex], x) * fx[s];
+            }
+        } else if (physical_) {
+            auto it = underlyingValues.find(k);
+            if (it == underlyingValues.end()) {
+                it = underlyingValues.insert(std::make_pair(k, std::vector<Real>())).first;
+                underlyings_[k]->price(dateIndex, it->second);
+            }
+            values[s] = it->second[s];
+        }
+    }
+    addFixedFlows(premiums_, dateIndex, values);
+}
+
+boost::shared_ptr<VectorisedKernel> buildAmcKernel(const boost::shared_ptr<Trade>& trade,
+                                                   const boost::shared_ptr<VectorisedMarketState>& state,
+                                                   const AmcParameters& parameters) {
+    try {
+        if (trade->tradeType() == "Swaption")
+            return boost::make_shared<AmcSwaptionKernel>(trade, state, parameters);
+    } catch (const std::exception& e) {
+        DLOG("no AMC kernel for trade " << trade->id() << " (" << trade->tradeType() << "): " << e.what());
+    }
+    return boost::shared_ptr<VectorisedKernel>();
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/amcswaptionkernel.hpp
+    \brief American Monte Carlo valuation kernel for European and Bermudan swaptions
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/engine/vectorisedkernel.hpp>
+#include <orea/scenario/crossassetmodelscenariogenerator.hpp>
+
+#include <qle/math/stabilisedglls.hpp>
+#include <qle/models/lgm.hpp>
+
+#include <ql/methods/montecarlo/lsmbasissystem.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Parameters of the American Monte Carlo valuation
+/*! \ingroup simulation
+ */
+struct AmcParameters {
+    AmcParameters()
+        : trainingSamples(10000), polynomOrder(4), polynomType(QuantLib::LsmBasisSystem::Monomial), seed(42) {}
+    //! Number of training paths
+    Size trainingSamples;
+    //! Order and type of the regression basis functions
+    Size polynomOrder;
+    QuantLib::LsmBasisSystem::PolynomType polynomType;
+    //! Seed of the training path generator
+    QuantLib::BigNatural seed;
+};
+
+//! American Monte Carlo swaption kernel
+/*! Values a European or Bermudan swaption by backward regression (Longstaff-Schwartz) in the LGM component
+    of the cross asset model driving the simulation, instead of calling the swaption pricing engine for each
+    sample and date.
+
+    On construction the LGM state of the swaption currency is simulated for a set of training paths on the
+    union of the simulation dates and the exercise dates. The deflated exercise values are rolled back in
+    time, at each exercise date the continuation value is regressed on the LGM state (using the in the money
+    paths) to decide on exercise, at each simulation date the deflated option value is regressed on the
+    LGM state. The value function of the LGM state does not depend on the measure, so the regression
+    functions apply to the cross asset model paths of the simulation as well: the kernel records the LGM
+    state of the swaption currency per sample and evaluates the regression functions after the simulation.
+
+    Exercise on the simulation paths is decided at the first simulation date on or after an exercise date,
+    using the state at that simulation date, in the same way as ore::data::OptionWrapper does it. After a
+    physical exercise the underlying swap is valued by a DiscountedCashflowKernel, after a cash settled
+    exercise the trade has no value.
+
+    Requires the simulation to be driven by a CrossAssetModelScenarioGenerator. The underlying legs may
+    contain fixed rate and plain Ibor coupons only.
+
+    \ingroup simulation
+*/
+class AmcSwaptionKernel : public VectorisedKernel {
+public:
+    AmcSwaptionKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                      const boost::shared_ptr<VectorisedMarketState>& state, const AmcParameters& parameters);
+    void record(Size dateIndex, Size sample) override;
+    void price(Size dateIndex, std::vector<Real>& values) const override;
+
+private:
+    // an underlying flow, prepared for the valuation in the LGM model
+    struct ModelFlow {
+        Date accrualStartDate;
+        bool floating;
+        // signed amount for fixed flows, signed nominal times accrual for floating flows
+        Real amount;
+        Real gearing, spread;
+        // discount factor and H at the payment time
+        Real discount, H;
+        // ratio of the forwarding discount factors at start and end of the estimation period, H at both times
+        Real forwardRatio, Hstart, Hend;
+        Real spanningTime;
+    };
+    // deflated value of the underlying into which exercise number k exercises, at time t and state x
+    Real deflatedUnderlying(Size k, Time t, Real x) const;
+    void train();
+
+    AmcParameters parameters_;
+    boost::shared_ptr<CrossAssetModelScenarioGenerator> generator_;
+    boost::shared_ptr<QuantExt::LinearGaussMarkovModel> model_;
+    Size processIndex_;
+    Real multiplier_;
+    bool physical_;
+    Size fx_;
+    std::vector<Date> exerciseDates_;
+    std::vector<Time> exerciseTimes_;
+    std::vector<ModelFlow> flows_;
+    // per exercise date the indices of the flows in the underlying
+    std::vector<std::vector<Size>> underlyingFlows_;
+    // per exercise date the underlying kernel, only used for physical settlement
+    std::vector<boost::shared_ptr<DiscountedCashflowKernel>> underlyings_;
+    std::vector<FixedFlow> premiums_;
+    std::vector<Time> cubeTimes_;
+    // per date the exercise dates that are decided at this date
+    std::vector<std::vector<Size>> exercisesDecided_;
+
+#if QL_HEX_VERSION > 0x01150000
+    std::vector<QuantLib::ext::function<Real(Real)>> basis_;
+#else // QL 1.14 and below
+    std::vector<boost::function1<Real, Real>> basis_;
+#endif
+    // regression of the continuation value per exercise date and of the option value per date, both deflated
+    std::vector<boost::shared_ptr<QuantExt::StabilisedGLLS>> continuation_, value_;
+
+    // recorded state per date (for alive dates only) and the index of the exercise per date and sample
+    std::vector<std::vector<Real>> states_;
+    std::vector<std::vector<Size>> exercised_;
+    std::vector<Size> currentExercise_;
+};
+
+//! Build the AMC kernel for a trade, returns a null pointer if the trade is not supported
+boost::shared_ptr<VectorisedKernel> buildAmcKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                                                   const boost::shared_ptr<VectorisedMarketState>& state,
+                                                   const AmcParameters& parameters);
+
+} // namespace analytics
+} // namespace ore
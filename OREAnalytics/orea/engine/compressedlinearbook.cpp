@@ -0,0 +1,238 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/compressedlinearbook.hpp>
+
+#include <qle/instruments/currencyswap.hpp>
+#include <qle/instruments/fxforward.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/instruments/swap.hpp>
+
+#include <boost/tuple/tuple_comparison.hpp>
+
+#include <typeinfo>
+
+using namespace QuantLib;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+bool CompressedLinearBook::Bucket::operator<(const Bucket& b) const {
+    return boost::make_tuple(discountCurve, fx, payDate, forwardCurve, start, end, cutoff) <
+           boost::make_tuple(b.discountCurve, b.fx, b.payDate, b.forwardCurve, b.start, b.end, b.cutoff);
+}
+
+CompressedLinearBook::CompressedLinearBook(const boost::shared_ptr<VectorisedMarketState>& state)
+    : state_(state), numberOfFlows_(0), compressed_(false) {}
+
+void CompressedLinearBook::add(const boost::shared_ptr<Trade>& trade) {
+    QL_REQUIRE(!compressed_, "CompressedLinearBook: can not add trade " << trade->id() << " after compression");
+    const boost::shared_ptr<InstrumentWrapper>& wrapper = trade->instrument();
+    QL_REQUIRE(!wrapper->isOption(), "option wrapper not supported");
+    QL_REQUIRE(wrapper->additionalInstruments().empty(), "additional instruments not supported");
+    boost::shared_ptr<Instrument> inst = wrapper->qlInstrument();
+    QL_REQUIRE(boost::dynamic_pointer_cast<QuantLib::Swap>(inst) ||
+                   boost::dynamic_pointer_cast<QuantExt::CurrencySwap>(inst) ||
+                   boost::dynamic_pointer_cast<QuantExt::FxForward>(inst),
+               "instrument type not supported");
+
+    // decompose the legs first, the book is only updated if all flows are supported
+    Size tradeIndex = tradeIds_.size();
+    std::vector<std::pair<Bucket, Real>> terms;
+    std::vector<KnownFlow> knownFlows;
+    const Date& today = state_->dates().front();
+    Size numberOfFlows = 0;
+    for (Size i = 0; i < trade->legs().size(); ++i) {
+        const std::string& ccy = trade->legCurrencies()[i];
+        Size discountCurve = state_->curveId(state_->simMarket()->discountCurve(ccy));
+        Size fx = state_->fxId(ccy);
+        Real multiplier = (trade->legPayers()[i] ? -1.0 : 1.0) * wrapper->multiplier();
+        for (auto const& cf : trade->legs()[i]) {
+            if (vectorisedFlowOccurred(cf->date(), today))
+                continue;
+            ++numberOfFlows;
+            Bucket b = {discountCurve, fx, Null<Size>(), cf->date(), Date(), Date(), Date::maxDate()};
+            if (auto c = boost::dynamic_pointer_cast<IborCoupon>(cf)) {
+                QL_REQUIRE(typeid(*c) == typeid(IborCoupon), "derived ibor coupon not supported");
+                QL_REQUIRE(!c->isInArrears(), "in arrears ibor coupon not supported");
+                boost::shared_ptr<IborIndex> index = c->iborIndex();
+                std::pair<Date, Date> period = iborEstimationPeriod(c);
+                Real spanningTime = index->dayCounter().yearFraction(period.first, period.second);
+                Real nominalTimesAccrual = multiplier * c->nominal() * c->accrualPeriod();
+                // the projected part and the fixed part, both live until the fixing date
+                b.cutoff = c->fixingDate();
+                terms.push_back(std::make_pair(b, nominalTimesAccrual * (c->spread() - c->gearing() / spanningTime)));
+                b.forwardCurve = state_->curveId(index->forwardingTermStructure());
+                b.start = period.first;
+                b.end = period.second;
+                terms.push_back(std::make_pair(b, nominalTimesAccrual * c->gearing() / spanningTime));
+                KnownFlow k = {c, tradeIndex, multiplier, discountCurve, fx};
+                knownFlows.push_back(k);
+            } else if (boost::dynamic_pointer_cast<FixedRateCoupon>(cf) ||
+                       boost::dynamic_pointer_cast<SimpleCashFlow>(cf)) {
+                terms.push_back(std::make_pair(b, multiplier * cf->amount()));
+            } else {
+                QL_FAIL("cashflow type not supported");
+            }
+        }
+    }
+
+    std::vector<Term> tradeTerms;
+    for (auto const& t : terms) {
+        auto it = bucketIds_.find(t.first);
+        if (it == bucketIds_.end()) {
+            it = bucketIds_.insert(std::make_pair(t.first, buckets_.size())).first;
+            buckets_.push_back(t.first);
+        }
+        Term term = {it->second, t.second};
+        tradeTerms.push_back(term);
+    }
+    terms_.push_back(tradeTerms);
+    knownFlows_.insert(knownFlows_.end(), knownFlows.begin(), knownFlows.end());
+    tradeIds_.push_back(trade->id());
+    numberOfFlows_ += numberOfFlows;
+}
+
+bool CompressedLinearBook::live(const Bucket& b, const Date& d) const {
+    return b.cutoff > d && !vectorisedFlowOccurred(b.payDate, d);
+}
+
+void CompressedLinearBook::compress() {
+    QL_REQUIRE(!compressed_, "CompressedLinearBook: already compressed");
+    Size nb = buckets_.size();
+    rowStart_.assign(1, 0);
+    for (Size t = 0; t < terms_.size(); ++t) {
+        // merge the terms of a trade falling into the same bucket
+        std::map<Size, Real> row;
+        for (auto const& term : terms_[t])
+            row[term.bucket] += term.coefficient;
+        for (auto const& r : row) {
+            if (r.second == 0.0)
+                continue;
+            columns_.push_back(r.first);
+            coefficients_.push_back(r.second);
+        }
+        rowStart_.push_back(columns_.size());
+    }
+    terms_.clear();
+    bucketIds_.clear();
+
+    const std::vector<Date>& dates = state_->dates();
+    liveBuckets_.resize(dates.size());
+    knownFlowIds_.resize(dates.size());
+    knownAmounts_.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i) {
+        for (Size b = 0; b < nb; ++b) {
+            if (live(buckets_[b], dates[i]))
+                liveBuckets_[i].push_back(b);
+        }
+        for (Size k = 0; k < knownFlows_.size(); ++k) {
+            const boost::shared_ptr<IborCoupon>& c = knownFlows_[k].coupon;
+            if (c->fixingDate() <= dates[i] && !vectorisedFlowOccurred(c->date(), dates[i]))
+                knownFlowIds_[i].push_back(k);
+        }
+        knownAmounts_[i].resize(knownFlowIds_[i].size() * state_->samples(), 0.0);
+    }
+    compressed_ = true;
+}
+
+void CompressedLinearBook::record(Size dateIndex, Size sample) {
+    QL_REQUIRE(compressed_, "CompressedLinearBook: not compressed");
+    const std::vector<Size>& known = knownFlowIds_[dateIndex];
+    std::vector<Real>& amounts = knownAmounts_[dateIndex];
+    for (Size n = 0; n < known.size(); ++n)
+        amounts[n * state_->samples() + sample] = knownFlows_[known[n]].coupon->amount();
+}
+
+void CompressedLinearBook::bucketFactors(Size dateIndex, std::vector<std::vector<Real>>& factors) const {
+    // discount factors are shared between buckets with the same curve and date
+    std::map<std::pair<Size, Date>, std::vector<Real>> discounts;
+    auto discount = [this, dateIndex, &discounts](Size curve, const Date& d) -> const std::vector<Real>& {
+        std::vector<Real>& result = discounts[std::make_pair(curve, d)];
+        if (result.empty())
+            state_->discount(curve, dateIndex, d, result);
+        return result;
+    };
+    Size samples = state_->samples();
+    factors.resize(buckets_.size());
+    for (Size b : liveBuckets_[dateIndex]) {
+        const Bucket& bucket = buckets_[b];
+        const std::vector<Real>& fx = state_->fxSpot(bucket.fx, dateIndex);
+        const std::vector<Real>& payDiscount = discount(bucket.discountCurve, bucket.payDate);
+        std::vector<Real>& f = factors[b];
+        f.resize(samples);
+        for (Size s = 0; s < samples; ++s)
+            f[s] = payDiscount[s] * fx[s];
+        if (bucket.forwardCurve != Null<Size>()) {
+            const std::vector<Real>& start = discount(bucket.forwardCurve, bucket.start);
+            const std::vector<Real>& end = discount(bucket.forwardCurve, bucket.end);
+            for (Size s = 0; s < samples; ++s)
+                f[s] *= start[s] / end[s];
+        }
+    }
+}
+
+void CompressedLinearBook::addKnownFlows(Size dateIndex, std::vector<std::vector<Real>>& values) const {
+    Size samples = state_->samples();
+    const std::vector<Size>& known = knownFlowIds_[dateIndex];
+    const std::vector<Real>& amounts = knownAmounts_[dateIndex];
+    std::vector<Real> discount;
+    for (Size n = 0; n < known.size(); ++n) {
+        const KnownFlow& k = knownFlows_[known[n]];
+        state_->discount(k.discountCurve, dateIndex, k.coupon->date(), discount);
+        const std::vector<Real>& fx = state_->fxSpot(k.fx, dateIndex);
+        const Real* amount = &amounts[n * samples];
+        std::vector<Real>& v = values[k.trade];
+        for (Size s = 0; s < samples; ++s)
+            v[s] += k.multiplier * amount[s] * discount[s] * fx[s];
+    }
+}
+
+void CompressedLinearBook::price(Size dateIndex, std::vector<std::vector<Real>>& values) const {
+    QL_REQUIRE(compressed_, "CompressedLinearBook: not compressed");
+    Size samples = state_->samples();
+    // the factors of buckets that are not live at the date are left empty
+    std::vector<std::vector<Real>> factors;
+    bucketFactors(dateIndex, factors);
+    values.assign(tradeIds_.size(), std::vector<Real>(samples, 0.0));
+    for (Size t = 0; t < tradeIds_.size(); ++t) {
+        std::vector<Real>& v = values[t];
+        for (Size n = rowStart_[t]; n < rowStart_[t + 1]; ++n) {
+            const std::vector<Real>& f = factors[columns_[n]];
+            if (f.empty())
+                continue;
+            Real c = coefficients_[n];
+            for (Size s = 0; s < samples; ++s)
+                v[s] += c * f[s];
+        }
+    }
+    addKnownFlows(dateIndex, values);
+}
+
+Size CompressedLinearBook::memory() const {
+    Size result = coefficients_.size() * sizeof(Real) + (columns_.size() + rowStart_.size()) * sizeof(Size);
+    for (auto const& a : knownAmounts_)
+        result += a.size() * sizeof(Real);
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
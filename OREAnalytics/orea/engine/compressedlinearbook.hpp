@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/compressedlinearbook.hpp
+    \brief Cashflow compressed representation of the linear trades of a netting set
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/engine/vectorisedkernel.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Cashflow compressed linear book
+/*! Decomposes the legs of linear trades (swaps, cross currency swaps, FX forwards) into cashflow buckets
+    that are shared by all trades of the book, typically a netting set. A bucket is identified by its
+    discount curve, currency and payment date and, for projected Ibor coupons, by the forwarding curve and
+    the estimation period. Its value per sample is one of the factors
+    \f[
+      P_d(t, T_p) X(t) \quad \textrm{or} \quad P_d(t, T_p) X(t) \frac{P_f(t, T_s)}{P_f(t, T_e)}
+    \f]
+    so that the value of a forecast Ibor coupon with gearing \f$g\f$, spread \f$s\f$, nominal times accrual
+    \f$N\tau\f$ and index year fraction \f$\tau_I\f$ splits into the linear combination
+    \f[
+      \frac{gN\tau}{\tau_I} P_d X \frac{P_f(T_s)}{P_f(T_e)} + N\tau\left(s - \frac{g}{\tau_I}\right) P_d X
+    \f]
+    The book is then stored as a sparse matrix with one row of bucket coefficients per trade. The bucket
+    factors are computed from the VectorisedMarketState once per date and shared by all trades, the values
+    of all trades for all samples of a simulation date are obtained as the product of the sparse matrix with
+    the matrix of bucket factors. The cost per date is therefore proportional to the number of live buckets
+    plus the number of non-zero coefficients, rather than to the number of cashflows.
+
+    Buckets are keyed on the exact payment and estimation dates instead of being mapped onto the curve
+    pillars, since the simulated curves interpolate log-linearly and a redistribution onto the pillars
+    would change the trade values. Ibor coupons that are fixed but not yet paid at a simulation date carry
+    a path dependent amount, which is recorded per sample like in the DiscountedCashflowKernel.
+
+    \ingroup simulation
+*/
+class CompressedLinearBook {
+public:
+    CompressedLinearBook(const boost::shared_ptr<VectorisedMarketState>& state);
+
+    //! Add a trade to the book, throws if the trade is not supported, in which case the book is unchanged
+    void add(const boost::shared_ptr<ore::data::Trade>& trade);
+    //! Build the sparse coefficient rows, must be called after the last trade was added
+    void compress();
+
+    //! Record the fixed Ibor coupon amounts for the given date index and sample, the sim market is updated already
+    void record(Size dateIndex, Size sample);
+    //! Trade values in base currency (not deflated), stored as values[trade][sample]
+    void price(Size dateIndex, std::vector<std::vector<Real>>& values) const;
+
+    //! \name Inspectors
+    //@{
+    //! Ids of the trades in the book, in the order they were added
+    const std::vector<std::string>& tradeIds() const { return tradeIds_; }
+    //! Number of cashflows before compression
+    Size numberOfFlows() const { return numberOfFlows_; }
+    //! Number of buckets after compression
+    Size numberOfBuckets() const { return buckets_.size(); }
+    //! Memory used by the coefficients and recorded amounts in bytes
+    Size memory() const;
+    //@}
+
+private:
+    struct Bucket {
+        Size discountCurve, fx, forwardCurve;
+        Date payDate, start, end;
+        // the bucket is live while this date is after the simulation date (and the payment has not occurred)
+        Date cutoff;
+        bool operator<(const Bucket& b) const;
+    };
+    struct KnownFlow {
+        boost::shared_ptr<QuantLib::IborCoupon> coupon;
+        Size trade;
+        Real multiplier;
+        Size discountCurve, fx;
+    };
+    struct Term {
+        Size bucket;
+        Real coefficient;
+    };
+    bool live(const Bucket& b, const Date& d) const;
+    void bucketFactors(Size dateIndex, std::vector<std::vector<Real>>& factors) const;
+    void addKnownFlows(Size dateIndex, std::vector<std::vector<Real>>& values) const;
+
+    boost::shared_ptr<VectorisedMarketState> state_;
+    std::vector<std::string> tradeIds_;
+    Size numberOfFlows_;
+    bool compressed_;
+    std::map<Bucket, Size> bucketIds_;
+    std::vector<Bucket> buckets_;
+    // terms per trade, only used while the book is built
+    std::vector<std::vector<Term>> terms_;
+    // sparse coefficient rows, the terms of trade t are stored in [rowStart_[t], rowStart_[t + 1])
+    std::vector<Size> rowStart_, columns_;
+    std::vector<Real> coefficients_;
+    // per date the live buckets
+    std::vector<std::vector<Size>> liveBuckets_;
+    std::vector<KnownFlow> knownFlows_;
+    // per date the known flows and their amounts, stored as [flow * samples + sample]
+    std::vector<std::vector<Size>> knownFlowIds_;
+    std::vector<std::vector<Real>> knownAmounts_;
+};
+
+} // namespace analytics
+} // namespace ore
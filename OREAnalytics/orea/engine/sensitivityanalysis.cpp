@@ -16,12 +16,14 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <array>
 #include <boost/timer.hpp>
 #include <orea/cube/cubewriter.hpp>
 #include <orea/cube/sensicube.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
 #include <orea/engine/valuationengine.hpp>
-#include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
+#include <orea/scenario/scenariosimmarketcache.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -62,7 +64,8 @@ SensitivityAnalysis::SensitivityAnalysis(
     : market_(market), marketConfiguration_(marketConfiguration), asof_(market->asofDate()),
       simMarketData_(simMarketData), sensitivityData_(sensitivityData), conventions_(conventions),
       recalibrateModels_(recalibrateModels), curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams),
-      overrideTenors_(false), nonShiftedBaseCurrencyConversion_(nonShiftedBaseCurrencyConversion),
+      overrideTenors_(false), pruneCrossGamma_(false),
+      nonShiftedBaseCurrencyConversion_(nonShiftedBaseCurrencyConversion),
       extraEngineBuilders_(extraEngineBuilders), extraLegBuilders_(extraLegBuilders), continueOnError_(continueOnError),
       engineData_(engineData), portfolio_(portfolio), initialized_(false), computed_(false) {}
 
@@ -80,8 +83,16 @@ void SensitivityAnalysis::initialize(boost::shared_ptr<NPVSensiCube>& cube) {
     initializeSimMarket();
 
     LOG("Build Engine Factory and rebuild portfolio");
-    boost::shared_ptr<EngineFactory> factory = buildFactory(extraEngineBuilders_, extraLegBuilders_);
-    resetPortfolio(factory);
+    boost::shared_ptr<EngineFactory> factory;
+    if (ScenarioSimMarketCache::instance().enabled()) {
+        std::tie(portfolio_, factory) = ScenarioSimMarketCache::instance().portfolio(
+            simMarket_, portfolio_, engineData_, marketConfiguration_,
+            [this]() { return buildFactory(extraEngineBuilders_, extraLegBuilders_); }, extraEngineBuilders_,
+            extraLegBuilders_);
+    } else {
+        factory = buildFactory(extraEngineBuilders_, extraLegBuilders_);
+        resetPortfolio(factory);
+    }
     if (recalibrateModels_)
         modelBuilders_ = factory->modelBuilders();
     else
@@ -97,6 +108,59 @@ void SensitivityAnalysis::initialize(boost::shared_ptr<NPVSensiCube>& cube) {
     initialized_ = true;
 }
 
+namespace {
+/* Selects the trades valued in the cross gamma scenarios. A trade can only have a non-zero cross gamma if it is
+   sensitive to both factors, i.e. if its NPV changes in the up or down scenario of each of them. All other trades
+   are not valued, their cross scenario NPV is set to the up scenario NPV of the factor they are sensitive to (or
+   left at the base NPV), so that their cross gamma is zero. The up and down scenarios are generated before the
+   cross scenarios, if this does not hold for a scenario, all trades are valued. */
+class CrossGammaTradeSelection {
+public:
+    CrossGammaTradeSelection(const boost::shared_ptr<NPVSensiCube>& cube,
+                             const boost::shared_ptr<SensitivityCube>& sensiCube)
+        : cube_(cube) {
+        for (auto const& c : sensiCube->crossFactors()) {
+            std::array<Size, 4>& idx = crossScenarios_[std::get<2>(c.second)];
+            idx[0] = std::get<0>(c.second).index;
+            idx[1] = std::get<1>(c.second).index;
+            auto d1 = sensiCube->downFactors().find(c.first.first);
+            auto d2 = sensiCube->downFactors().find(c.first.second);
+            idx[2] = d1 == sensiCube->downFactors().end() ? Null<Size>() : d1->second.index;
+            idx[3] = d2 == sensiCube->downFactors().end() ? Null<Size>() : d2->second.index;
+        }
+    }
+
+    void operator()(Size sample, vector<bool>& valueTrade) const {
+        auto c = crossScenarios_.find(sample);
+        if (c == crossScenarios_.end())
+            return;
+        const std::array<Size, 4>& idx = c->second;
+        for (Size k = 0; k < 4; ++k) {
+            if (idx[k] != Null<Size>() && idx[k] >= sample)
+                return;
+        }
+        for (Size i = 0; i < valueTrade.size(); ++i) {
+            Real base = cube_->getT0(i, 0);
+            Real up1 = cube_->get(i, idx[0]), up2 = cube_->get(i, idx[1]);
+            bool sensitive1 = up1 != base || (idx[2] != Null<Size>() && cube_->get(i, idx[2]) != base);
+            bool sensitive2 = up2 != base || (idx[3] != Null<Size>() && cube_->get(i, idx[3]) != base);
+            if (sensitive1 && sensitive2)
+                continue;
+            valueTrade[i] = false;
+            if (sensitive1)
+                cube_->set(up1, i, sample);
+            else if (sensitive2)
+                cube_->set(up2, i, sample);
+        }
+    }
+
+private:
+    boost::shared_ptr<NPVSensiCube> cube_;
+    // cross scenario index => up index factor 1, up index factor 2, down index factor 1, down index factor 2
+    std::map<Size, std::array<Size, 4>> crossScenarios_;
+};
+} // namespace
+
 void SensitivityAnalysis::generateSensitivities(boost::shared_ptr<NPVSensiCube> cube) {
 
     QL_REQUIRE(!initialized_, "unexpected state of SensitivitiesAnalysis object");
@@ -109,6 +173,10 @@ void SensitivityAnalysis::generateSensitivities(boost::shared_ptr<NPVSensiCube>
     ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_);
     for (auto const& i : this->progressIndicators())
         engine.registerProgressIndicator(i);
+    if (pruneCrossGamma_ && !sensiCube_->crossFactors().empty()) {
+        LOG("Cross gamma scenarios are valued for trades sensitive to both factors only");
+        engine.setTradeSelection(CrossGammaTradeSelection(sensiCube_->npvCube(), sensiCube_));
+    }
     LOG("Run Sensitivity Scenarios");
     engine.buildCube(portfolio_, cube, calculators);
 
@@ -120,14 +188,20 @@ void SensitivityAnalysis::initializeSimMarket(boost::shared_ptr<ScenarioFactory>
 
     LOG("Initialise sim market for sensitivity analysis (continueOnError=" << std::boolalpha << continueOnError_
         << ")");
-    simMarket_ = boost::make_shared<ScenarioSimMarket>(market_, simMarketData_, conventions_, marketConfiguration_, curveConfigs_, todaysMarketParams_, continueOnError_);
+    if (ScenarioSimMarketCache::instance().enabled())
+        simMarket_ = ScenarioSimMarketCache::instance().simMarket(market_, simMarketData_, conventions_,
+                                                                  marketConfiguration_, curveConfigs_,
+                                                                  todaysMarketParams_, continueOnError_);
+    else
+        simMarket_ = boost::make_shared<ScenarioSimMarket>(market_, simMarketData_, conventions_, marketConfiguration_,
+                                                           curveConfigs_, todaysMarketParams_, continueOnError_);
 
     LOG("Sim market initialised for sensitivity analysis");
 
     LOG("Create scenario factory for sensitivity analysis");
     boost::shared_ptr<Scenario> baseScenario = simMarket_->baseScenario();
     boost::shared_ptr<ScenarioFactory> scenarioFactory =
-        scenFact ? scenFact : boost::make_shared<CloneScenarioFactory>(baseScenario);
+        scenFact ? scenFact : boost::make_shared<DeltaScenarioFactory>(baseScenario);
     LOG("Scenario factory created for sensitivity analysis");
 
     LOG("Create scenario generator for sensitivity analysis (continueOnError=" << std::boolalpha << continueOnError_
@@ -105,6 +105,10 @@ public:
     //! override shift tenors with sim market tenors
     void overrideTenors(const bool b) { overrideTenors_ = b; }
 
+    /*! value trades in cross gamma scenarios only if their NPV changes under the up or down shifts of both factors,
+        the cross gamma of all other trades is zero, disabled by default */
+    void pruneCrossGamma(const bool b) { pruneCrossGamma_ = b; }
+
     //! the portfolio of trades
     boost::shared_ptr<Portfolio> portfolio() const { return portfolio_; }
 
@@ -143,6 +147,7 @@ protected:
     //! Optional todays market parameters. Used in building the scenario sim market.
     ore::data::TodaysMarketParameters todaysMarketParams_;
     bool overrideTenors_;
+    bool pruneCrossGamma_;
 
     // if true, convert sensis to base currency using the original (non-shifted) FX rate
     bool nonShiftedBaseCurrencyConversion_;
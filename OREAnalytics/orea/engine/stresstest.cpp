@@ -21,7 +21,8 @@
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationengine.hpp>
-#include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
+#include <orea/scenario/scenariosimmarketcache.hpp>
 #include <ored/utilities/log.hpp>
 #include <ql/errors.hpp>
 #include <ql/instruments/forwardrateagreement.hpp>
@@ -61,12 +62,17 @@ StressTest::StressTest(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
 
     LOG("Build Simulation Market");
     boost::shared_ptr<ScenarioSimMarket> simMarket =
-        boost::make_shared<ScenarioSimMarket>(market, simMarketData, conventions, Market::defaultConfiguration, curveConfigs, todaysMarketParams, continueOnError);
+        ScenarioSimMarketCache::instance().enabled()
+            ? ScenarioSimMarketCache::instance().simMarket(market, simMarketData, conventions,
+                                                           Market::defaultConfiguration, curveConfigs,
+                                                           todaysMarketParams, continueOnError)
+            : boost::make_shared<ScenarioSimMarket>(market, simMarketData, conventions, Market::defaultConfiguration,
+                                                    curveConfigs, todaysMarketParams, continueOnError);
 
     LOG("Build Stress Scenario Generator");
     Date asof = market->asofDate();
     boost::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
-    scenarioFactory = scenarioFactory ? scenarioFactory : boost::make_shared<CloneScenarioFactory>(baseScenario);
+    scenarioFactory = scenarioFactory ? scenarioFactory : boost::make_shared<DeltaScenarioFactory>(baseScenario);
     boost::shared_ptr<StressScenarioGenerator> scenarioGenerator =
         boost::make_shared<StressScenarioGenerator>(stressData, baseScenario, simMarketData, scenarioFactory);
     simMarket->scenarioGenerator() = scenarioGenerator;
@@ -74,15 +80,24 @@ StressTest::StressTest(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     LOG("Build Engine Factory");
     map<MarketContext, string> configurations;
     configurations[MarketContext::pricing] = marketConfiguration;
-    boost::shared_ptr<EngineFactory> factory = boost::make_shared<EngineFactory>(engineData, simMarket, configurations);
+    auto buildFactory = [&engineData, &simMarket, &configurations]() {
+        return boost::make_shared<EngineFactory>(engineData, simMarket, configurations);
+    };
 
     LOG("Reset and Build Portfolio");
-    portfolio->reset();
-    portfolio->build(factory);
+    boost::shared_ptr<Portfolio> builtPortfolio = portfolio;
+    if (ScenarioSimMarketCache::instance().enabled()) {
+        builtPortfolio = ScenarioSimMarketCache::instance()
+                             .portfolio(simMarket, portfolio, engineData, marketConfiguration, buildFactory)
+                             .first;
+    } else {
+        portfolio->reset();
+        portfolio->build(buildFactory());
+    }
 
     LOG("Build the cube object to store sensitivities");
     boost::shared_ptr<NPVCube> cube = boost::make_shared<DoublePrecisionInMemoryCube>(
-        asof, portfolio->ids(), vector<Date>(1, asof), scenarioGenerator->samples());
+        asof, builtPortfolio->ids(), vector<Date>(1, asof), scenarioGenerator->samples());
 
     boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>(
         "1,0W"); // TODO - extend the DateGrid interface so that it can actually take a vector of dates as input
@@ -98,7 +113,7 @@ StressTest::StressTest(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     auto progressLog = boost::make_shared<ProgressLog>("Building scenarios...");
     engine.registerProgressIndicator(progressBar);
     engine.registerProgressIndicator(progressLog);*/
-    engine.buildCube(portfolio, cube, calculators);
+    engine.buildCube(builtPortfolio, cube, calculators);
 
     /*****************
      * Collect results
@@ -107,9 +122,9 @@ StressTest::StressTest(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     shiftedNPV_.clear();
     delta_.clear();
     labels_.clear();
-    for (Size i = 0; i < portfolio->size(); ++i) {
+    for (Size i = 0; i < builtPortfolio->size(); ++i) {
         Real npv0 = cube->getT0(i, 0);
-        string id = portfolio->trades()[i]->id();
+        string id = builtPortfolio->trades()[i]->id();
         trades_.insert(id);
         baseNPV_[id] = npv0;
         for (Size j = 0; j < scenarioGenerator->samples(); ++j) {
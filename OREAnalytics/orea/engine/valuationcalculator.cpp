@@ -25,24 +25,42 @@
 #include <ored/portfolio/optionwrapper.hpp>
 #include <ored/utilities/log.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 namespace ore {
 namespace analytics {
 
+void NPVCalculator::init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket) {
+    const auto& trades = portfolio->trades();
+    fxRates_.assign(trades.size(), QuantLib::Handle<QuantLib::Quote>());
+    for (Size i = 0; i < trades.size(); ++i) {
+        try {
+            fxRates_[i] = simMarket->fxSpot(trades[i]->npvCurrency() + baseCcyCode_);
+        } catch (...) {
+            // resolved again in npv(), where the error is logged
+        }
+    }
+}
+
 void NPVCalculator::calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                               const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
                               const Date& date, Size dateIndex, Size sample) {
-    outputCube->set(npv(trade, simMarket), tradeIndex, dateIndex, sample, index_);
+    outputCube->set(npv(trade, tradeIndex, simMarket), tradeIndex, dateIndex, sample, index_);
 }
 
 void NPVCalculator::calculateT0(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                                 const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube) {
-    outputCube->setT0(npv(trade, simMarket), tradeIndex, index_);
+    outputCube->setT0(npv(trade, tradeIndex, simMarket), tradeIndex, index_);
 }
 
-Real NPVCalculator::npv(const boost::shared_ptr<Trade>& trade, const boost::shared_ptr<SimMarket>& simMarket) {
+Real NPVCalculator::npv(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
+                        const boost::shared_ptr<SimMarket>& simMarket) {
     Real npv = 0;
     try {
-        Real fx = simMarket->fxSpot(trade->npvCurrency() + baseCcyCode_)->value();
+        Real fx = tradeIndex < fxRates_.size() && !fxRates_[tradeIndex].empty()
+                      ? fxRates_[tradeIndex]->value()
+                      : simMarket->fxSpot(trade->npvCurrency() + baseCcyCode_)->value();
         Real numeraire = simMarket->numeraire();
 
         npv = trade->instrument()->NPV() * fx / numeraire;
@@ -57,6 +75,49 @@ Real NPVCalculator::npv(const boost::shared_ptr<Trade>& trade, const boost::shar
     return npv;
 }
 
+void CashflowCalculator::init(const boost::shared_ptr<Portfolio>& portfolio,
+                              const boost::shared_ptr<SimMarket>& simMarket) {
+    const auto& trades = portfolio->trades();
+    const std::vector<Date>& dates = dateGrid_->dates();
+    tradeFlows_.assign(trades.size(), nullptr);
+    Size numFlows = 0;
+    for (Size i = 0; i < trades.size(); ++i) {
+        try {
+            auto tf = boost::make_shared<TradeFlows>();
+            // flows in (dates[k], dates[k+1]] belong to interval k, the last interval is always empty
+            std::vector<std::pair<Size, Size>> intervalAndLeg;
+            std::vector<boost::shared_ptr<QuantLib::CashFlow>> flows;
+            for (Size l = 0; l < trades[i]->legs().size(); ++l) {
+                tf->fxRates.push_back(simMarket->fxSpot(trades[i]->legCurrencies()[l] + baseCcyCode_));
+                for (auto const& flow : trades[i]->legs()[l]) {
+                    Size k = std::lower_bound(dates.begin(), dates.end(), flow->date()) - dates.begin();
+                    if (k > 0 && k < dates.size()) {
+                        intervalAndLeg.push_back(std::make_pair(k - 1, l));
+                        flows.push_back(flow);
+                    }
+                }
+            }
+            std::vector<Size> perm(flows.size());
+            std::iota(perm.begin(), perm.end(), 0);
+            std::stable_sort(perm.begin(), perm.end(),
+                             [&intervalAndLeg](Size a, Size b) { return intervalAndLeg[a] < intervalAndLeg[b]; });
+            tf->offsets.assign(dates.size() + 1, 0);
+            for (auto const& p : intervalAndLeg)
+                ++tf->offsets[p.first + 1];
+            std::partial_sum(tf->offsets.begin(), tf->offsets.end(), tf->offsets.begin());
+            for (Size n : perm) {
+                tf->legs.push_back(intervalAndLeg[n].second);
+                tf->flows.push_back(flows[n]);
+            }
+            numFlows += flows.size();
+            tradeFlows_[i] = tf;
+        } catch (const std::exception& e) {
+            DLOG("CashflowCalculator: no cached flows for trade " << trades[i]->id() << ": " << e.what());
+        }
+    }
+    DLOG("CashflowCalculator: cached " << numFlows << " flows on the date grid");
+}
+
 void CashflowCalculator::calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                                    const boost::shared_ptr<SimMarket>& simMarket,
                                    boost::shared_ptr<NPVCube>& outputCube, const Date& date, Size dateIndex,
@@ -84,19 +145,35 @@ void CashflowCalculator::calculate(const boost::shared_ptr<Trade>& trade, Size t
 
     try {
         if (!isOption || (isExercised && isPhysical)) {
-            for (Size i = 0; i < trade->legs().size(); i++) {
-                const Leg& leg = trade->legs()[i];
-                Real legFlow = 0;
-                for (auto flow : leg) {
-                    // Take flows in (t, t+1]
-                    if (startDate < flow->date() && flow->date() <= endDate)
-                        legFlow += flow->amount();
+            if (tradeIndex < tradeFlows_.size() && tradeFlows_[tradeIndex]) {
+                // flows in (t, t+1] are grouped by leg
+                const TradeFlows& tf = *tradeFlows_[tradeIndex];
+                Size end = tf.offsets[dateIndex + 1];
+                for (Size n = tf.offsets[dateIndex]; n < end;) {
+                    Size leg = tf.legs[n];
+                    Real legFlow = 0;
+                    for (; n < end && tf.legs[n] == leg; ++n)
+                        legFlow += tf.flows[n]->amount();
+                    if (legFlow != 0) {
+                        Real direction = trade->legPayers()[leg] ? -1.0 : 1.0;
+                        netFlow += legFlow * direction * longShort * tf.fxRates[leg]->value();
+                    }
                 }
-                if (legFlow != 0) {
-                    // Do FX conversion and add to netFlow
-                    Real fx = simMarket->fxSpot(trade->legCurrencies()[i] + baseCcyCode_)->value();
-                    Real direction = trade->legPayers()[i] ? -1.0 : 1.0;
-                    netFlow += legFlow * direction * longShort * fx;
+            } else {
+                for (Size i = 0; i < trade->legs().size(); i++) {
+                    const Leg& leg = trade->legs()[i];
+                    Real legFlow = 0;
+                    for (auto flow : leg) {
+                        // Take flows in (t, t+1]
+                        if (startDate < flow->date() && flow->date() <= endDate)
+                            legFlow += flow->amount();
+                    }
+                    if (legFlow != 0) {
+                        // Do FX conversion and add to netFlow
+                        Real fx = simMarket->fxSpot(trade->legCurrencies()[i] + baseCcyCode_)->value();
+                        Real direction = trade->legPayers()[i] ? -1.0 : 1.0;
+                        netFlow += legFlow * direction * longShort * fx;
+                    }
                 }
             }
         }
@@ -113,24 +190,42 @@ void CashflowCalculator::calculate(const boost::shared_ptr<Trade>& trade, Size t
     outputCube->set(netFlow / numeraire, tradeIndex, dateIndex, sample, index_);
 }
 
+void NPVCalculatorFXT0::init(const boost::shared_ptr<Portfolio>& portfolio,
+                             const boost::shared_ptr<SimMarket>& simMarket) {
+    const auto& trades = portfolio->trades();
+    fxRates_.assign(trades.size(), QuantLib::Null<Real>());
+    for (Size i = 0; i < trades.size(); ++i) {
+        try {
+            fxRates_[i] = trades[i]->npvCurrency() == baseCcyCode_
+                              ? 1.0
+                              : t0Market_->fxSpot(trades[i]->npvCurrency() + baseCcyCode_)->value();
+        } catch (...) {
+            // resolved again in npv(), where the error is logged
+        }
+    }
+}
+
 void NPVCalculatorFXT0::calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                                   const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
                                   const Date& date, Size dateIndex, Size sample) {
-    outputCube->set(npv(trade, simMarket), tradeIndex, dateIndex, sample, index_);
+    outputCube->set(npv(trade, tradeIndex, simMarket), tradeIndex, dateIndex, sample, index_);
 }
 
 void NPVCalculatorFXT0::calculateT0(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                                     const boost::shared_ptr<SimMarket>& simMarket,
                                     boost::shared_ptr<NPVCube>& outputCube) {
-    outputCube->setT0(npv(trade, simMarket), tradeIndex, index_);
+    outputCube->setT0(npv(trade, tradeIndex, simMarket), tradeIndex, index_);
 }
 
-Real NPVCalculatorFXT0::npv(const boost::shared_ptr<Trade>& trade, const boost::shared_ptr<SimMarket>& simMarket) {
+Real NPVCalculatorFXT0::npv(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
+                            const boost::shared_ptr<SimMarket>& simMarket) {
     Real npv = 0;
     try {
         // Real fx = simMarket->fxSpot(trade->npvCurrency() + baseCcyCode_)->value();
         Real fx = 1.0;
-        if (trade->npvCurrency() != baseCcyCode_)
+        if (tradeIndex < fxRates_.size() && fxRates_[tradeIndex] != QuantLib::Null<Real>())
+            fx = fxRates_[tradeIndex];
+        else if (trade->npvCurrency() != baseCcyCode_)
             fx = t0Market_->fxSpot(trade->npvCurrency() + baseCcyCode_)->value();
         Real numeraire = simMarket->numeraire();
 
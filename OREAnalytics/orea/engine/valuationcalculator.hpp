@@ -26,10 +26,12 @@
 #include <orea/cube/npvcube.hpp>
 #include <orea/simulation/dategrid.hpp>
 #include <orea/simulation/simmarket.hpp>
+#include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/trade.hpp>
 
 namespace ore {
 namespace analytics {
+using ore::data::Portfolio;
 using ore::data::Trade;
 using QuantLib::Date;
 using QuantLib::Size;
@@ -40,6 +42,12 @@ class ValuationCalculator {
 public:
     virtual ~ValuationCalculator() {}
 
+    //! Set up per trade state before the valuation loop
+    /*! Called once per cube run, before calculateT0(), with the portfolio whose trade indices are used in the
+        subsequent calls. Calculators can resolve market handles and other trade data here, so that calculate()
+        only does arithmetic. If init() is not called, calculators fall back to resolving on the fly. */
+    virtual void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket) {}
+
     virtual void calculate(
         //! The trade
         const boost::shared_ptr<Trade>& trade,
@@ -77,6 +85,9 @@ public:
     //! base ccy and index to write to
     NPVCalculator(const std::string& baseCcyCode, Size index = 0) : baseCcyCode_(baseCcyCode), index_(index) {}
 
+    //! resolves the FX conversion quote of each trade
+    virtual void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket);
+
     virtual void calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                            const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
                            const Date& date, Size dateIndex, Size sample);
@@ -84,11 +95,18 @@ public:
     virtual void calculateT0(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                              const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube);
 
+    //! base ccy
+    const std::string& baseCcyCode() const { return baseCcyCode_; }
+    //! index of the cube to write to
+    Size index() const { return index_; }
+
 private:
-    Real npv(const boost::shared_ptr<Trade>& trade, const boost::shared_ptr<SimMarket>& simMarket);
+    Real npv(const boost::shared_ptr<Trade>& trade, Size tradeIndex, const boost::shared_ptr<SimMarket>& simMarket);
 
     std::string baseCcyCode_;
     Size index_;
+    // npv currency to base currency quotes by trade index, empty handles are resolved on the fly
+    std::vector<QuantLib::Handle<QuantLib::Quote>> fxRates_;
 };
 
 //! CashflowCalculator
@@ -103,6 +121,9 @@ public:
                        Size index)
         : baseCcyCode_(baseCcyCode), t0Date_(t0Date), dateGrid_(dateGrid), index_(index) {}
 
+    //! buckets the cashflows of each trade by date grid interval and resolves the leg FX quotes
+    virtual void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket);
+
     virtual void calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                            const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
                            const Date& date, Size dateIndex, Size sample);
@@ -111,10 +132,20 @@ public:
                              const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube) {}
 
 private:
+    //! the flows of a trade sorted by date grid interval and leg, interval i is [offsets[i], offsets[i+1])
+    struct TradeFlows {
+        std::vector<Size> offsets;
+        std::vector<Size> legs;
+        std::vector<boost::shared_ptr<QuantLib::CashFlow>> flows;
+        std::vector<QuantLib::Handle<QuantLib::Quote>> fxRates;
+    };
+
     std::string baseCcyCode_;
     Date t0Date_;
     boost::shared_ptr<DateGrid> dateGrid_;
     Size index_;
+    // by trade index, trades without entry are handled by scanning their legs
+    std::vector<boost::shared_ptr<TradeFlows>> tradeFlows_;
 };
 
 //! NPVCalculatorFXT0
@@ -130,6 +161,9 @@ public:
     NPVCalculatorFXT0(const std::string& baseCcyCode, const boost::shared_ptr<Market>& t0Market, Size index = 0)
         : baseCcyCode_(baseCcyCode), t0Market_(t0Market), index_(index) {}
 
+    //! computes the static FX conversion rate of each trade
+    virtual void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket);
+
     virtual void calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
                            const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
                            const Date& date, Size dateIndex, Size sample);
@@ -138,11 +172,13 @@ public:
                              const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube);
 
 private:
-    Real npv(const boost::shared_ptr<Trade>& trade, const boost::shared_ptr<SimMarket>& simMarket);
+    Real npv(const boost::shared_ptr<Trade>& trade, Size tradeIndex, const boost::shared_ptr<SimMarket>& simMarket);
 
     std::string baseCcyCode_;
     boost::shared_ptr<Market> t0Market_;
     Size index_;
+    // t0 conversion rates by trade index, Null<Real>() if not available
+    std::vector<Real> fxRates_;
 };
 } // namespace analytics
 } // namespace ore
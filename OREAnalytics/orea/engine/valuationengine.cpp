@@ -16,15 +16,20 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <orea/engine/compressedlinearbook.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/engine/vectorisedkernel.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/simulation/simmarket.hpp>
+#include <ored/model/lgmbuilder.hpp>
 #include <ored/portfolio/optionwrapper.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/progressbar.hpp>
 
+#include <algorithm>
 #include <boost/timer.hpp>
 #include <ql/errors.hpp>
 
@@ -39,7 +44,8 @@ namespace analytics {
 ValuationEngine::ValuationEngine(const Date& today, const boost::shared_ptr<DateGrid>& dg,
                                  const boost::shared_ptr<SimMarket>& simMarket,
                                  const set<std::pair<string, boost::shared_ptr<ModelBuilder>>>& modelBuilders)
-    : today_(today), dg_(dg), simMarket_(simMarket), modelBuilders_(modelBuilders) {
+    : today_(today), dg_(dg), simMarket_(simMarket), modelBuilders_(modelBuilders), vectorised_(false),
+      compressLinearBooks_(false), amc_(false), firstSample_(0), startSample_(0), checkpointInterval_(0) {
 
     QL_REQUIRE(dg_->size() > 0, "Error, DateGrid size must be > 0");
     QL_REQUIRE(today <= dg_->dates().front(), "ValuationEngine: Error today ("
@@ -74,6 +80,10 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
     const auto& dates = dg_->dates();
     const auto& trades = portfolio->trades();
 
+    LOG("Initialise calculators...");
+    for (auto calc : calculators)
+        calc->init(portfolio, simMarket_);
+
     LOG("Initialise state objects...");
     Size numFRC = 0;
     // initialise state objects for each trade (required for path-dependent derivatives in particular)
@@ -108,17 +118,139 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
 
     simMarket_->fixingManager()->initialise(portfolio);
 
+    // set up the vectorised kernels, the NPV calculators are replaced by the kernels for the supported trades
+    boost::shared_ptr<VectorisedMarketState> state;
+    vector<boost::shared_ptr<VectorisedKernel>> kernels(trades.size());
+    // linear books per netting set and the trade indices in the order they were added to the book
+    map<string, boost::shared_ptr<CompressedLinearBook>> books;
+    map<string, vector<Size>> bookTrades;
+    vector<bool> inBook(trades.size(), false);
+    vector<boost::shared_ptr<NPVCalculator>> npvCalculators;
+    vector<boost::shared_ptr<ValuationCalculator>> flowCalculators;
+    if (vectorised_ || amc_) {
+        bool supported = true;
+        for (auto const& calc : calculators) {
+            if (auto npvCalc = boost::dynamic_pointer_cast<NPVCalculator>(calc)) {
+                supported = supported && (npvCalculators.empty() ||
+                                          npvCalc->baseCcyCode() == npvCalculators.front()->baseCcyCode());
+                npvCalculators.push_back(npvCalc);
+            } else if (boost::dynamic_pointer_cast<CashflowCalculator>(calc)) {
+                flowCalculators.push_back(calc);
+            } else {
+                supported = false;
+            }
+        }
+        auto scenarioSimMarket = boost::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_);
+        if (!supported || npvCalculators.empty() || !scenarioSimMarket) {
+            WLOG("Vectorised / AMC valuation not supported for the given calculators and sim market, "
+                 "fall back to per scenario valuation");
+        } else {
+            state = boost::make_shared<VectorisedMarketState>(
+                scenarioSimMarket, npvCalculators.front()->baseCcyCode(), dates, outputCube->samples());
+            Size numKernels = 0;
+            Size numAmcKernels = 0;
+            for (Size i = 0; i < trades.size(); ++i) {
+                if (amc_ && (kernels[i] = buildAmcKernel(trades[i], state, amcParameters_))) {
+                    ++numAmcKernels;
+                    continue;
+                }
+                if (!vectorised_)
+                    continue;
+                const string& type = trades[i]->tradeType();
+                if (compressLinearBooks_ && (type == "Swap" || type == "FxForward")) {
+                    const string& nettingSet = trades[i]->envelope().nettingSetId();
+                    boost::shared_ptr<CompressedLinearBook>& book = books[nettingSet];
+                    if (!book)
+                        book = boost::make_shared<CompressedLinearBook>(state);
+                    try {
+                        book->add(trades[i]);
+                        bookTrades[nettingSet].push_back(i);
+                        inBook[i] = true;
+                        ++numKernels;
+                        continue;
+                    } catch (const std::exception& e) {
+                        DLOG("trade " << trades[i]->id() << " not added to linear book: " << e.what());
+                    }
+                }
+                if ((kernels[i] = buildVectorisedKernel(trades[i], state)))
+                    ++numKernels;
+            }
+            Size bookMemory = 0;
+            for (auto const& b : books) {
+                b.second->compress();
+                bookMemory += b.second->memory();
+                DLOG("Linear book for netting set " << b.first << ": " << b.second->tradeIds().size() << " trades, "
+                                                    << b.second->numberOfFlows() << " flows compressed to "
+                                                    << b.second->numberOfBuckets() << " buckets");
+            }
+            LOG("AMC valuation for " << numAmcKernels << " out of " << trades.size() << " trades");
+            LOG("Vectorised valuation for " << numKernels << " out of " << trades.size() << " trades, market state "
+                                            << state->memory() / 1024 / 1024 << " MB, " << books.size()
+                                            << " linear books " << bookMemory / 1024 / 1024 << " MB");
+        }
+    }
+
+    auto scenarioSimMarket = boost::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_);
+    bool selectTrades = tradeSelection_ != nullptr;
+    if (selectTrades && state) {
+        WLOG("Trade selection is not supported with vectorised / AMC valuation, all trades are valued");
+        selectTrades = false;
+    }
+    vector<bool> valueTrade(trades.size(), true);
+    Size skippedSamples = 0, skippedValuations = 0;
+
+    set<string> kernelTradeIds;
+    for (Size i = 0; i < trades.size(); ++i) {
+        if (kernels[i] || inBook[i])
+            kernelTradeIds.insert(trades[i]->id());
+    }
+
+    // the vectorised kernels write the NPVs of all samples at the end, so partial builds can not be continued
+    QL_REQUIRE(!state || (startSample_ == 0 && !checkpoint_),
+               "ValuationEngine: checkpoint and resume are not supported with vectorised / AMC valuation");
+    bool checkpoint = checkpoint_ != nullptr && checkpointInterval_ > 0;
+
+    if (firstSample_ + startSample_ > 0) {
+        QL_REQUIRE(scenarioSimMarket && scenarioSimMarket->scenarioGenerator(),
+                   "ValuationEngine: first sample " << firstSample_ + startSample_
+                                                     << " requires a scenario generator");
+        LOG("Skip the first " << firstSample_ + startSample_ << " samples of the scenario generator");
+        scenarioSimMarket->scenarioGenerator()->skip(firstSample_ + startSample_, dates);
+    }
+    if (startSample_ > 0) {
+        LOG("Continue the cube build at sample " << startSample_);
+        if (scenarioSimMarket->aggregationScenarioData())
+            scenarioSimMarket->aggregationScenarioData()->moveTo(startSample_);
+    }
+
     boost::timer timer;
     boost::timer loopTimer;
 
     // We call Cube::samples() each time her to allow for dynamic stopping times
     // e.g. MC convergence tests
-    for (Size sample = 0; sample < outputCube->samples(); ++sample) {
+    Size sample = startSample_;
+    for (; sample < outputCube->samples(); ++sample) {
         updateProgress(sample, outputCube->samples());
+        if (checkpoint && sample > startSample_ && sample % checkpointInterval_ == 0)
+            checkpoint_(sample);
+        QL_REQUIRE(!state || sample < state->samples(), "ValuationEngine: number of samples exceeds vectorised state");
 
         for (auto& trade : trades)
             trade->instrument()->reset();
 
+        if (selectTrades) {
+            std::fill(valueTrade.begin(), valueTrade.end(), true);
+            tradeSelection_(sample, valueTrade);
+            Size n = std::count(valueTrade.begin(), valueTrade.end(), false);
+            skippedValuations += n * dates.size();
+            // without trades to value only the scenario generator is advanced, if we can access it
+            if (n == trades.size() && scenarioSimMarket && scenarioSimMarket->scenarioGenerator()) {
+                scenarioSimMarket->scenarioGenerator()->skip(1, dates);
+                ++skippedSamples;
+                continue;
+            }
+        }
+
         // loop over Dates
         for (Size i = 0; i < dates.size(); ++i) {
             Date d = dates[i];
@@ -127,20 +259,38 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
 
             simMarket_->update(d);
 
-            // recalibrate models
+            // recalibrate models, except for those used by the kernel trades only
             for (auto const& b : modelBuilders_) {
+                if (kernelTradeIds.count(b.first) > 0)
+                    continue;
                 if (om == ObservationMode::Mode::Disable)
                     b.second->recalculate();
                 b.second->recalibrate();
             }
 
+            if (state)
+                state->record(i, sample);
+            for (auto const& b : books)
+                b.second->record(i, sample);
+
             updateTime += timer.elapsed();
 
             // loop over trades
             timer.restart();
             for (Size j = 0; j < trades.size(); ++j) {
+                if (!valueTrade[j])
+                    continue;
                 auto trade = trades[j];
 
+                // vectorised trades only record their path dependent state, the NPVs are written below
+                if (kernels[j] || inBook[j]) {
+                    if (kernels[j])
+                        kernels[j]->record(i, sample);
+                    for (auto calc : flowCalculators)
+                        calc->calculate(trade, j, simMarket_, outputCube, d, i, sample);
+                    continue;
+                }
+
                 // We can avoid checking mode here and always call updateQlInstruments()
                 if (om == ObservationMode::Mode::Disable)
                     trade->instrument()->updateQlInstruments();
@@ -157,11 +307,68 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
     }
 
     simMarket_->reset();
+
+    // vectorised valuation for all samples generated above
+    Real vectorisedTime = 0.0;
+    if (state) {
+        timer.restart();
+        vector<Real> values;
+        vector<vector<Real>> bookValues;
+        Size numSamples = std::min(sample, state->samples());
+        for (Size i = 0; i < dates.size(); ++i) {
+            const vector<Real>& numeraire = state->numeraire(i);
+            for (Size j = 0; j < trades.size(); ++j) {
+                if (!kernels[j])
+                    continue;
+                try {
+                    kernels[j]->price(i, values);
+                } catch (std::exception& e) {
+                    ALOG("Failed to price trade " << trades[j]->id() << " at " << io::iso_date(dates[i]) << " : "
+                                                  << e.what());
+                    values.assign(state->samples(), 0.0);
+                }
+                for (auto const& calc : npvCalculators) {
+                    for (Size s = 0; s < numSamples; ++s)
+                        outputCube->set(values[s] / numeraire[s], j, i, s, calc->index());
+                }
+            }
+            for (auto const& b : books) {
+                const vector<Size>& tradeIndices = bookTrades[b.first];
+                try {
+                    b.second->price(i, bookValues);
+                } catch (std::exception& e) {
+                    ALOG("Failed to price linear book for netting set " << b.first << " at "
+                                                                        << io::iso_date(dates[i]) << " : " << e.what());
+                    bookValues.assign(tradeIndices.size(), vector<Real>(state->samples(), 0.0));
+                }
+                for (Size n = 0; n < tradeIndices.size(); ++n) {
+                    for (auto const& calc : npvCalculators) {
+                        for (Size s = 0; s < numSamples; ++s)
+                            outputCube->set(bookValues[n][s] / numeraire[s], tradeIndices[n], i, s, calc->index());
+                    }
+                }
+            }
+        }
+        vectorisedTime = timer.elapsed();
+    }
+
     updateProgress(outputCube->samples(), outputCube->samples());
     LOG("ValuationEngine completed: loop " << setprecision(2) << loopTimer.elapsed() << " sec, "
                                            << "pricing " << pricingTime << " sec, "
                                            << "update " << updateTime << " sec "
-                                           << "fixing " << fixingTime);
+                                           << "fixing " << fixingTime << " sec "
+                                           << "vectorised " << vectorisedTime << " sec");
+    if (selectTrades)
+        LOG("ValuationEngine trade selection: " << skippedValuations << " trade valuations and " << skippedSamples
+                                                << " scenarios skipped");
+
+    for (auto const& b : modelBuilders_) {
+        if (auto lgm = boost::dynamic_pointer_cast<LgmBuilder>(b.second)) {
+            DLOG("LGM model builder " << b.first << ": " << lgm->calibrations() << " calibrations, "
+                                      << lgm->skippedCalibrations() << " skipped, "
+                                      << lgm->totalFunctionEvaluations() << " function evaluations");
+        }
+    }
 }
 } // namespace analytics
 } // namespace ore
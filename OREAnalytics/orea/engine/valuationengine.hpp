@@ -24,6 +24,7 @@
 #pragma once
 
 #include <orea/cube/npvcube.hpp>
+#include <orea/engine/amcswaptionkernel.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/simulation/dategrid.hpp>
 #include <orea/simulation/simmarket.hpp>
@@ -31,6 +32,7 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/utilities/progressbar.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 
@@ -52,6 +54,30 @@ using std::set;
   In addition to storing the resulting NPVs it can be given any number of calculators
   that can store additional values in the cube.
 
+  If vectorised valuation is enabled, trades supported by a VectorisedKernel (swaps, FX forwards,
+  FRAs, European FX and equity options) are not repriced per scenario. Instead the required market
+  state is recorded for all samples and the kernels write the NPVs for all samples of a date in one
+  call once the simulation is done. This requires a ScenarioSimMarket and NPVCalculator and
+  CashflowCalculator instances only, otherwise and for all other trades the per scenario
+  valuation is used.
+
+  If in addition linear book compression is enabled, the swaps and FX forwards of each netting set are
+  collected in a CompressedLinearBook, which prices all of them as one sparse matrix product against cashflow
+  bucket factors shared by the trades of the netting set, instead of one kernel per trade.
+
+  If AMC valuation is enabled, swaptions (European and Bermudan) are valued by an AmcSwaptionKernel, i.e. by
+  backward regression on training paths of the cross asset model, using the same recording mechanism. The
+  model builders of these trades are not recalibrated during the simulation. AMC valuation can be used with
+  or without vectorised valuation of the other trades.
+
+  A trade selection can restrict the trades valued in each sample, e.g. to the trades that can have a non-zero
+  cross gamma in a sensitivity run. If no trade is selected in a sample, the scenario of this sample is not applied
+  to the market at all. The selection is not used together with vectorised or AMC valuation.
+
+  For a shard of a larger simulation the engine can start at a given sample of the scenario generator, the preceding
+  samples are generated and discarded, so that the cube holds exactly the paths of the corresponding samples of the
+  full run.
+
   \ingroup simulation
 */
 class ValuationEngine : public ore::data::ProgressReporter {
@@ -77,11 +103,47 @@ public:
         //! Calculators to use
         std::vector<boost::shared_ptr<ValuationCalculator>> calculators);
 
+    //! Enable or disable the vectorised valuation of supported trades, disabled by default
+    void enableVectorisedValuation(const bool enable = true) { vectorised_ = enable; }
+    //! Enable or disable the linear book compression per netting set, only used with vectorised valuation
+    void enableLinearBookCompression(const bool enable = true) { compressLinearBooks_ = enable; }
+    //! Enable the AMC valuation of supported trades with the given parameters, disabled by default
+    void enableAmcValuation(const AmcParameters& parameters = AmcParameters()) {
+        amc_ = true;
+        amcParameters_ = parameters;
+    }
+
+    /*! Set a function selecting the trades to value in a sample. It is called before each sample with the sample
+        index and flags that are all true on entry, and clears the flags of the trades that should not be valued.
+        The cube entries of these trades are not written by the engine for this sample. */
+    void setTradeSelection(const std::function<void(QuantLib::Size, std::vector<bool>&)>& selection) {
+        tradeSelection_ = selection;
+    }
+
+    //! Value the samples of the scenario generator starting at the given one, 0 by default
+    void setFirstSample(QuantLib::Size firstSample) { firstSample_ = firstSample; }
+
+    /*! Continue a previous build of the same cube at the given cube sample. The cube and aggregation scenario data
+        entries of the preceding samples are kept and the scenario generator is fast-forwarded past them. */
+    void setStartSample(QuantLib::Size startSample) { startSample_ = startSample; }
+
+    /*! Set a function that is called after each block of the given number of samples with the number of cube
+        samples completed so far, e.g. to checkpoint the cube and aggregation scenario data. */
+    void setCheckpoint(QuantLib::Size interval, const std::function<void(QuantLib::Size)>& checkpoint) {
+        checkpointInterval_ = interval;
+        checkpoint_ = checkpoint;
+    }
+
 private:
     QuantLib::Date today_;
     boost::shared_ptr<analytics::DateGrid> dg_;
     boost::shared_ptr<analytics::SimMarket> simMarket_;
     set<std::pair<string, boost::shared_ptr<data::ModelBuilder>>> modelBuilders_;
+    bool vectorised_, compressLinearBooks_, amc_;
+    AmcParameters amcParameters_;
+    std::function<void(QuantLib::Size, std::vector<bool>&)> tradeSelection_;
+    QuantLib::Size firstSample_, startSample_, checkpointInterval_;
+    std::function<void(QuantLib::Size)> checkpoint_;
 };
 } // namespace analytics
 } // namespace ore
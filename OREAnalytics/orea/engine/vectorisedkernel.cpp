@@ -0,0 +1,381 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/vectorisedkernel.hpp>
+#include <ored/portfolio/equityoption.hpp>
+#include <ored/portfolio/forwardrateagreement.hpp>
+#include <ored/portfolio/fxoption.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <qle/instruments/currencyswap.hpp>
+#include <qle/instruments/fxforward.hpp>
+#include <qle/instruments/payment.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/instruments/swap.hpp>
+#include <ql/pricingengines/blackformula.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace QuantLib;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+bool vectorisedFlowOccurred(const Date& flowDate, const Date& refDate) {
+    if (flowDate != refDate)
+        return flowDate < refDate;
+    boost::optional<bool> includeToday = Settings::instance().includeTodaysCashFlows();
+    return !(includeToday ? *includeToday : Settings::instance().includeReferenceDateEvents());
+}
+
+bool vectorisedEventOccurred(const Date& eventDate, const Date& refDate) {
+    return Settings::instance().includeReferenceDateEvents() ? eventDate < refDate : eventDate <= refDate;
+}
+
+std::pair<Date, Date> iborEstimationPeriod(const boost::shared_ptr<IborCoupon>& coupon) {
+    boost::shared_ptr<IborIndex> index = coupon->iborIndex();
+    Date start = index->fixingCalendar().advance(coupon->fixingDate(), index->fixingDays(), Days);
+#ifdef QL_USE_INDEXED_COUPON
+    Date end = index->maturityDate(start);
+#else
+    Date nextFixingDate =
+        index->fixingCalendar().advance(coupon->accrualEndDate(), -static_cast<Integer>(coupon->fixingDays()), Days);
+    Date end = index->fixingCalendar().advance(nextFixingDate, index->fixingDays(), Days);
+    end = std::max(end, start + 1);
+#endif
+    return std::make_pair(start, end);
+}
+
+void VectorisedKernel::addFixedFlows(const std::vector<FixedFlow>& flows, Size dateIndex,
+                                     std::vector<Real>& values) const {
+    const Date& d = state_->dates()[dateIndex];
+    std::vector<Real> discount;
+    for (auto const& f : flows) {
+        if (vectorisedFlowOccurred(f.date, d))
+            continue;
+        state_->discount(f.curve, dateIndex, f.date, discount);
+        const std::vector<Real>& fx = state_->fxSpot(f.fx, dateIndex);
+        for (Size s = 0; s < values.size(); ++s)
+            values[s] += f.amount * discount[s] * fx[s];
+    }
+}
+
+void VectorisedKernel::addPayments(const boost::shared_ptr<InstrumentWrapper>& wrapper,
+                                   std::vector<FixedFlow>& flows) {
+    for (Size i = 0; i < wrapper->additionalInstruments().size(); ++i) {
+        auto payment = boost::dynamic_pointer_cast<QuantExt::Payment>(wrapper->additionalInstruments()[i]);
+        QL_REQUIRE(payment, "additional instrument type not supported");
+        std::string ccy = payment->currency().code();
+        FixedFlow f = {payment->cashFlow()->date(), payment->cashFlow()->amount() * wrapper->additionalMultipliers()[i],
+                       state_->curveId(state_->simMarket()->discountCurve(ccy)), state_->fxId(ccy)};
+        flows.push_back(f);
+    }
+}
+
+DiscountedCashflowKernel::DiscountedCashflowKernel(const boost::shared_ptr<Trade>& trade,
+                                                   const boost::shared_ptr<VectorisedMarketState>& state)
+    : VectorisedKernel(state) {
+    const boost::shared_ptr<InstrumentWrapper>& wrapper = trade->instrument();
+    QL_REQUIRE(!wrapper->isOption(), "option wrapper not supported");
+    boost::shared_ptr<Instrument> inst = wrapper->qlInstrument();
+    QL_REQUIRE(boost::dynamic_pointer_cast<QuantLib::Swap>(inst) ||
+                   boost::dynamic_pointer_cast<QuantExt::CurrencySwap>(inst) ||
+                   boost::dynamic_pointer_cast<QuantExt::FxForward>(inst),
+               "instrument type not supported");
+
+    addLegs(trade->legs(), trade->legCurrencies(), trade->legPayers(), wrapper->multiplier());
+    addPayments(wrapper, fixedFlows_);
+    initialise();
+}
+
+DiscountedCashflowKernel::DiscountedCashflowKernel(const std::vector<Leg>& legs,
+                                                   const std::vector<std::string>& currencies,
+                                                   const std::vector<bool>& payers, Real multiplier,
+                                                   const boost::shared_ptr<VectorisedMarketState>& state)
+    : VectorisedKernel(state) {
+    addLegs(legs, currencies, payers, multiplier);
+    initialise();
+}
+
+void DiscountedCashflowKernel::addLegs(const std::vector<Leg>& legs, const std::vector<std::string>& currencies,
+                                       const std::vector<bool>& payers, Real tradeMultiplier) {
+    QL_REQUIRE(legs.size() == currencies.size() && legs.size() == payers.size(),
+               "number of legs (" << legs.size() << "), currencies (" << currencies.size() << ") and payers ("
+                                  << payers.size() << ") do not match");
+    const std::vector<Date>& dates = state_->dates();
+    for (Size i = 0; i < legs.size(); ++i) {
+        const std::string& ccy = currencies[i];
+        Size discountCurve = state_->curveId(state_->simMarket()->discountCurve(ccy));
+        Size fx = state_->fxId(ccy);
+        Real multiplier = (payers[i] ? -1.0 : 1.0) * tradeMultiplier;
+        for (auto const& cf : legs[i]) {
+            // skip flows that are not relevant for the simulation
+            if (vectorisedFlowOccurred(cf->date(), dates.front()))
+                continue;
+            if (auto c = boost::dynamic_pointer_cast<IborCoupon>(cf)) {
+                QL_REQUIRE(typeid(*c) == typeid(IborCoupon), "derived ibor coupon not supported");
+                QL_REQUIRE(!c->isInArrears(), "in arrears ibor coupon not supported");
+                boost::shared_ptr<IborIndex> index = c->iborIndex();
+                IborFlow f;
+                f.coupon = c;
+                f.multiplier = multiplier;
+                f.nominalTimesAccrual = c->nominal() * c->accrualPeriod();
+                f.discountCurve = discountCurve;
+                f.forwardCurve = state_->curveId(index->forwardingTermStructure());
+                f.fx = fx;
+                std::pair<Date, Date> period = iborEstimationPeriod(c);
+                f.fixingValueDate = period.first;
+                f.fixingEndDate = period.second;
+                f.spanningTime = index->dayCounter().yearFraction(f.fixingValueDate, f.fixingEndDate);
+                iborFlows_.push_back(f);
+            } else if (boost::dynamic_pointer_cast<FixedRateCoupon>(cf) ||
+                       boost::dynamic_pointer_cast<SimpleCashFlow>(cf)) {
+                FixedFlow f = {cf->date(), multiplier * cf->amount(), discountCurve, fx};
+                fixedFlows_.push_back(f);
+            } else {
+                QL_FAIL("cashflow type not supported");
+            }
+        }
+    }
+}
+
+void DiscountedCashflowKernel::initialise() {
+    const std::vector<Date>& dates = state_->dates();
+    knownFlows_.resize(dates.size());
+    knownAmounts_.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i) {
+        for (Size k = 0; k < iborFlows_.size(); ++k) {
+            const boost::shared_ptr<IborCoupon>& c = iborFlows_[k].coupon;
+            if (c->fixingDate() <= dates[i] && !vectorisedFlowOccurred(c->date(), dates[i]))
+                knownFlows_[i].push_back(k);
+        }
+        knownAmounts_[i].resize(knownFlows_[i].size() * state_->samples(), 0.0);
+    }
+}
+
+void DiscountedCashflowKernel::record(Size dateIndex, Size sample) {
+    const std::vector<Size>& known = knownFlows_[dateIndex];
+    std::vector<Real>& amounts = knownAmounts_[dateIndex];
+    for (Size n = 0; n < known.size(); ++n)
+        amounts[n * state_->samples() + sample] = iborFlows_[known[n]].coupon->amount();
+}
+
+void DiscountedCashflowKernel::price(Size dateIndex, std::vector<Real>& values) const {
+    const Date& d = state_->dates()[dateIndex];
+    Size samples = state_->samples();
+    values.assign(samples, 0.0);
+    addFixedFlows(fixedFlows_, dateIndex, values);
+
+    std::vector<Real> discount, start, end;
+    // coupons with known fixing
+    const std::vector<Size>& known = knownFlows_[dateIndex];
+    const std::vector<Real>& amounts = knownAmounts_[dateIndex];
+    for (Size n = 0; n < known.size(); ++n) {
+        const IborFlow& f = iborFlows_[known[n]];
+        state_->discount(f.discountCurve, dateIndex, f.coupon->date(), discount);
+        const std::vector<Real>& fx = state_->fxSpot(f.fx, dateIndex);
+        const Real* amount = &amounts[n * samples];
+        for (Size s = 0; s < samples; ++s)
+            values[s] += f.multiplier * amount[s] * discount[s] * fx[s];
+    }
+    // coupons to be forecast
+    for (auto const& f : iborFlows_) {
+        if (f.coupon->fixingDate() <= d)
+            continue;
+        state_->discount(f.discountCurve, dateIndex, f.coupon->date(), discount);
+        state_->discount(f.forwardCurve, dateIndex, f.fixingValueDate, start);
+        state_->discount(f.forwardCurve, dateIndex, f.fixingEndDate, end);
+        const std::vector<Real>& fx = state_->fxSpot(f.fx, dateIndex);
+        Real gearing = f.coupon->gearing(), spread = f.coupon->spread();
+        for (Size s = 0; s < samples; ++s) {
+            Real forward = (start[s] / end[s] - 1.0) / f.spanningTime;
+            values[s] += f.multiplier * f.nominalTimesAccrual * (gearing * forward + spread) * discount[s] * fx[s];
+        }
+    }
+}
+
+ForwardRateAgreementKernel::ForwardRateAgreementKernel(const boost::shared_ptr<Trade>& trade,
+                                                       const boost::shared_ptr<VectorisedMarketState>& state)
+    : VectorisedKernel(state) {
+    auto fra = boost::dynamic_pointer_cast<ore::data::ForwardRateAgreement>(trade);
+    QL_REQUIRE(fra, "trade is not a ForwardRateAgreement");
+    QL_REQUIRE(trade->instrument()->additionalInstruments().empty(), "additional instruments not supported");
+
+    // dates as in QuantLib::ForwardRateAgreement
+    index_ = *state_->simMarket()->iborIndex(fra->index());
+    const Calendar& cal = index_->fixingCalendar();
+    valueDate_ = cal.adjust(parseDate(fra->startDate()), index_->businessDayConvention());
+    maturityDate_ = cal.adjust(parseDate(fra->endDate()), index_->businessDayConvention());
+    fixingDate_ = cal.advance(valueDate_, -static_cast<Integer>(index_->fixingDays()), Days);
+    forecastStart_ = index_->valueDate(fixingDate_);
+    forecastEnd_ = index_->maturityDate(forecastStart_);
+    forecastTime_ = index_->dayCounter().yearFraction(forecastStart_, forecastEnd_);
+    tau_ = index_->dayCounter().yearFraction(valueDate_, maturityDate_);
+
+    Real sign = parsePositionType(fra->longShort()) == Position::Long ? 1.0 : -1.0;
+    notional_ = sign * fra->amount() * trade->instrument()->multiplier();
+    strike_ = fra->strike();
+    discountCurve_ = state_->curveId(state_->simMarket()->discountCurve(fra->currency()));
+    forwardCurve_ = state_->curveId(index_->forwardingTermStructure());
+    fx_ = state_->fxId(fra->currency());
+
+    const std::vector<Date>& dates = state_->dates();
+    fixings_.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i) {
+        if (alive(i) && fixingDate_ <= dates[i])
+            fixings_[i].resize(state_->samples(), 0.0);
+    }
+}
+
+bool ForwardRateAgreementKernel::alive(Size dateIndex) const {
+    // as in QuantLib::ForwardRateAgreement::isExpired()
+    Date settlementDate = index_->fixingCalendar().advance(state_->dates()[dateIndex], index_->fixingDays(), Days);
+#if defined(QL_TODAYS_PAYMENTS)
+    return valueDate_ >= settlementDate;
+#else
+    return valueDate_ > settlementDate;
+#endif
+}
+
+void ForwardRateAgreementKernel::record(Size dateIndex, Size sample) {
+    if (!fixings_[dateIndex].empty())
+        fixings_[dateIndex][sample] = index_->fixing(fixingDate_);
+}
+
+void ForwardRateAgreementKernel::price(Size dateIndex, std::vector<Real>& values) const {
+    Size samples = state_->samples();
+    values.assign(samples, 0.0);
+    if (!alive(dateIndex))
+        return;
+    std::vector<Real> discount, start, end;
+    state_->discount(discountCurve_, dateIndex, maturityDate_, discount);
+    const std::vector<Real>& fx = state_->fxSpot(fx_, dateIndex);
+    if (!fixings_[dateIndex].empty()) {
+        const std::vector<Real>& fixing = fixings_[dateIndex];
+        for (Size s = 0; s < samples; ++s)
+            values[s] = notional_ * (fixing[s] - strike_) * tau_ * discount[s] * fx[s];
+    } else {
+        state_->discount(forwardCurve_, dateIndex, forecastStart_, start);
+        state_->discount(forwardCurve_, dateIndex, forecastEnd_, end);
+        for (Size s = 0; s < samples; ++s) {
+            Real forward = (start[s] / end[s] - 1.0) / forecastTime_;
+            values[s] = notional_ * (forward - strike_) * tau_ * discount[s] * fx[s];
+        }
+    }
+}
+
+EuropeanOptionKernel::EuropeanOptionKernel(const boost::shared_ptr<Trade>& trade,
+                                           const boost::shared_ptr<VectorisedMarketState>& state)
+    : VectorisedKernel(state) {
+    const boost::shared_ptr<ScenarioSimMarket>& simMarket = state_->simMarket();
+    const OptionData* option = nullptr;
+    std::string ccy;
+    if (auto fxOption = boost::dynamic_pointer_cast<FxOption>(trade)) {
+        // see FxOptionEngineBuilder, the bought currency is the foreign, the sold currency the domestic one
+        std::string pair = fxOption->boughtCurrency() + fxOption->soldCurrency();
+        option = &fxOption->option();
+        ccy = fxOption->soldCurrency();
+        strike_ = fxOption->soldAmount() / fxOption->boughtAmount();
+        spot_ = simMarket->fxSpot(pair);
+        dividendCurve_ = simMarket->discountCurve(fxOption->boughtCurrency());
+        forecastCurve_ = simMarket->discountCurve(fxOption->soldCurrency());
+        discountCurve_ = forecastCurve_;
+        vol_ = simMarket->fxVol(pair);
+    } else if (auto eqOption = boost::dynamic_pointer_cast<EquityOption>(trade)) {
+        // see EquityOptionEngineBuilder
+        option = &eqOption->option();
+        ccy = eqOption->currency();
+        strike_ = eqOption->strike();
+        spot_ = simMarket->equitySpot(eqOption->equityName());
+        dividendCurve_ = simMarket->equityDividendCurve(eqOption->equityName());
+        forecastCurve_ = simMarket->equityForecastCurve(eqOption->equityName());
+        discountCurve_ = simMarket->discountCurve(ccy);
+        vol_ = simMarket->equityVol(eqOption->equityName());
+    } else {
+        QL_FAIL("trade is not an FxOption or EquityOption");
+    }
+    QL_REQUIRE(option->style() == "European" && option->exerciseDates().size() == 1,
+               "only European options with one exercise date supported");
+    type_ = parseOptionType(option->callPut());
+    expiry_ = parseDate(option->exerciseDates().front());
+    multiplier_ = trade->instrument()->multiplier();
+    fx_ = state_->fxId(ccy);
+    addPayments(trade->instrument(), premiums_);
+
+    const std::vector<Date>& dates = state_->dates();
+    forward_.resize(dates.size());
+    discount_.resize(dates.size());
+    variance_.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i) {
+        if (!vectorisedEventOccurred(expiry_, dates[i])) {
+            forward_[i].resize(state_->samples(), 0.0);
+            discount_[i].resize(state_->samples(), 0.0);
+            variance_[i].resize(state_->samples(), 0.0);
+        }
+    }
+}
+
+void EuropeanOptionKernel::record(Size dateIndex, Size sample) {
+    if (forward_[dateIndex].empty())
+        return;
+    // as in QuantLib::AnalyticEuropeanEngine
+    forward_[dateIndex][sample] =
+        spot_->value() * dividendCurve_->discount(expiry_) / forecastCurve_->discount(expiry_);
+    discount_[dateIndex][sample] = discountCurve_->discount(expiry_);
+    variance_[dateIndex][sample] = vol_->blackVariance(expiry_, strike_);
+}
+
+void EuropeanOptionKernel::price(Size dateIndex, std::vector<Real>& values) const {
+    Size samples = state_->samples();
+    values.assign(samples, 0.0);
+    if (!forward_[dateIndex].empty()) {
+        const std::vector<Real>& forward = forward_[dateIndex];
+        const std::vector<Real>& discount = discount_[dateIndex];
+        const std::vector<Real>& variance = variance_[dateIndex];
+        const std::vector<Real>& fx = state_->fxSpot(fx_, dateIndex);
+        for (Size s = 0; s < samples; ++s)
+            values[s] = multiplier_ * blackFormula(type_, strike_, forward[s], std::sqrt(variance[s]), discount[s]) *
+                        fx[s];
+    }
+    addFixedFlows(premiums_, dateIndex, values);
+}
+
+boost::shared_ptr<VectorisedKernel> buildVectorisedKernel(const boost::shared_ptr<Trade>& trade,
+                                                          const boost::shared_ptr<VectorisedMarketState>& state) {
+    try {
+        const std::string& type = trade->tradeType();
+        if (type == "Swap" || type == "FxForward")
+            return boost::make_shared<DiscountedCashflowKernel>(trade, state);
+        if (type == "ForwardRateAgreement")
+            return boost::make_shared<ForwardRateAgreementKernel>(trade, state);
+        if (type == "FxOption" || type == "EquityOption")
+            return boost::make_shared<EuropeanOptionKernel>(trade, state);
+    } catch (const std::exception& e) {
+        DLOG("no vectorised kernel for trade " << trade->id() << " (" << trade->tradeType() << "): " << e.what());
+    }
+    return boost::shared_ptr<VectorisedKernel>();
+}
+
+} // namespace analytics
+} // namespace ore
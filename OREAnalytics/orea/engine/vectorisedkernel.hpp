@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/vectorisedkernel.hpp
+    \brief Vectorised valuation kernels, pricing a trade for all samples of a simulation date in one call
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/engine/vectorisedmarketstate.hpp>
+#include <ored/portfolio/trade.hpp>
+
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/option.hpp>
+#include <ql/termstructures/volatility/equityfx/blackvoltermstructure.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Vectorised valuation kernel
+/*! A kernel prices one trade for all samples of a simulation date in one call, bypassing the pricing engine
+    and the observer / lazy object machinery of the per-scenario valuation. Market data is taken from the
+    VectorisedMarketState, path dependent data (e.g. fixings) is recorded by the kernel while the
+    ValuationEngine walks through the scenarios.
+
+    The constructors throw if the trade can not be handled by the kernel, in which case the ValuationEngine
+    falls back to the per-scenario valuation.
+
+    \ingroup simulation
+*/
+class VectorisedKernel {
+public:
+    VectorisedKernel(const boost::shared_ptr<VectorisedMarketState>& state) : state_(state) {}
+    virtual ~VectorisedKernel() {}
+
+    //! Record trade specific state for the given date index and sample, the sim market is updated already
+    virtual void record(Size dateIndex, Size sample) {}
+    //! Trade value in base currency (not deflated) for all samples at the given date index
+    virtual void price(Size dateIndex, std::vector<Real>& values) const = 0;
+
+protected:
+    //! A deterministic flow, discounted on a state curve and converted to base currency
+    struct FixedFlow {
+        Date date;
+        Real amount;
+        Size curve;
+        Size fx;
+    };
+    //! Add the value of the flows that have not occurred at the given date index
+    void addFixedFlows(const std::vector<FixedFlow>& flows, Size dateIndex, std::vector<Real>& values) const;
+    //! Add the trade's additional instruments (premium payments) as fixed flows
+    void addPayments(const boost::shared_ptr<ore::data::InstrumentWrapper>& wrapper, std::vector<FixedFlow>& flows);
+
+    boost::shared_ptr<VectorisedMarketState> state_;
+};
+
+//! Discounted cashflow kernel
+/*! Handles Swaps (including deposits represented as fixed legs with notional exchanges) and FX Forwards.
+    Supported cashflows are fixed rate coupons, simple cashflows and plain Ibor coupons fixed in advance.
+    Ibor coupons fixing on or before the valuation date are recorded during the simulation, later coupons
+    are forecast from the index curve in the same way as QuantLib::IborCoupon does.
+
+    \ingroup simulation
+*/
+class DiscountedCashflowKernel : public VectorisedKernel {
+public:
+    DiscountedCashflowKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                             const boost::shared_ptr<VectorisedMarketState>& state);
+    //! Kernel for the given legs, e.g. the underlying of an option, the multiplier applies to all legs
+    DiscountedCashflowKernel(const std::vector<QuantLib::Leg>& legs, const std::vector<std::string>& currencies,
+                             const std::vector<bool>& payers, Real multiplier,
+                             const boost::shared_ptr<VectorisedMarketState>& state);
+    void record(Size dateIndex, Size sample) override;
+    void price(Size dateIndex, std::vector<Real>& values) const override;
+
+private:
+    void addLegs(const std::vector<QuantLib::Leg>& legs, const std::vector<std::string>& currencies,
+                 const std::vector<bool>& payers, Real tradeMultiplier);
+    void initialise();
+
+    struct IborFlow {
+        boost::shared_ptr<QuantLib::IborCoupon> coupon;
+        // direction times trade multiplier
+        Real multiplier;
+        Real nominalTimesAccrual;
+        Size discountCurve;
+        Size forwardCurve;
+        Size fx;
+        Date fixingValueDate;
+        Date fixingEndDate;
+        Real spanningTime;
+    };
+    std::vector<FixedFlow> fixedFlows_;
+    std::vector<IborFlow> iborFlows_;
+    // per date the ibor flows with known fixing and their amounts, stored as [flow * samples + sample]
+    std::vector<std::vector<Size>> knownFlows_;
+    std::vector<std::vector<Real>> knownAmounts_;
+};
+
+//! Forward rate agreement kernel
+/*! Values the QuantLib::ForwardRateAgreement built by ore::data::ForwardRateAgreement, i.e. the notional
+    times the difference of forward and strike rate, discounted from the maturity date.
+
+    \ingroup simulation
+*/
+class ForwardRateAgreementKernel : public VectorisedKernel {
+public:
+    ForwardRateAgreementKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                               const boost::shared_ptr<VectorisedMarketState>& state);
+    void record(Size dateIndex, Size sample) override;
+    void price(Size dateIndex, std::vector<Real>& values) const override;
+
+private:
+    bool alive(Size dateIndex) const;
+
+    boost::shared_ptr<QuantLib::IborIndex> index_;
+    Date valueDate_, maturityDate_, fixingDate_, forecastStart_, forecastEnd_;
+    Real notional_, strike_, tau_, forecastTime_;
+    Size discountCurve_, forwardCurve_, fx_;
+    // recorded fixings per date, only used if the fixing date is reached before the FRA expires
+    std::vector<std::vector<Real>> fixings_;
+};
+
+//! European FX and equity option kernel
+/*! Forward, discount factor and Black variance are recorded per sample during the simulation, the
+    Black formula is evaluated for all samples in one go.
+
+    \ingroup simulation
+*/
+class EuropeanOptionKernel : public VectorisedKernel {
+public:
+    EuropeanOptionKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                         const boost::shared_ptr<VectorisedMarketState>& state);
+    void record(Size dateIndex, Size sample) override;
+    void price(Size dateIndex, std::vector<Real>& values) const override;
+
+private:
+    QuantLib::Option::Type type_;
+    Real strike_, multiplier_;
+    Date expiry_;
+    Size fx_;
+    QuantLib::Handle<QuantLib::Quote> spot_;
+    QuantLib::Handle<QuantLib::YieldTermStructure> dividendCurve_, forecastCurve_, discountCurve_;
+    QuantLib::Handle<QuantLib::BlackVolTermStructure> vol_;
+    std::vector<FixedFlow> premiums_;
+    // recorded forward, discount factor and variance per date, empty after expiry
+    std::vector<std::vector<Real>> forward_, discount_, variance_;
+};
+
+//! Same logic as QuantLib::CashFlow::hasOccurred() with the reference date being the evaluation date
+bool vectorisedFlowOccurred(const Date& flowDate, const Date& refDate);
+
+//! Same logic as QuantLib::Event::hasOccurred() with the reference date being the evaluation date
+bool vectorisedEventOccurred(const Date& eventDate, const Date& refDate);
+
+//! Start and end date of the forward rate estimation period of an Ibor coupon, as in QuantLib::IborCoupon
+std::pair<Date, Date> iborEstimationPeriod(const boost::shared_ptr<QuantLib::IborCoupon>& coupon);
+
+//! Build the vectorised kernel for a trade, returns a null pointer if the trade is not supported
+boost::shared_ptr<VectorisedKernel> buildVectorisedKernel(const boost::shared_ptr<ore::data::Trade>& trade,
+                                                          const boost::shared_ptr<VectorisedMarketState>& state);
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/vectorisedmarketstate.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <qle/termstructures/interpolateddiscountcurve.hpp>
+#include <qle/termstructures/interpolateddiscountcurve2.hpp>
+
+#include <algorithm>
+#include <functional>
+
+using namespace QuantLib;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+VectorisedMarketState::VectorisedMarketState(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+                                             const std::string& baseCcy, const std::vector<Date>& dates,
+                                             Size samples)
+    : simMarket_(simMarket), baseCcy_(baseCcy), dates_(dates), samples_(samples),
+      numeraire_(dates.size(), std::vector<Real>(samples, 1.0)), ones_(samples, 1.0) {
+    QL_REQUIRE(simMarket_, "VectorisedMarketState: no sim market given");
+    QL_REQUIRE(simMarket_->parameters(), "VectorisedMarketState: sim market has no parameters");
+}
+
+Size VectorisedMarketState::curveId(const Handle<YieldTermStructure>& curve) {
+    QL_REQUIRE(!curve.empty(), "VectorisedMarketState: empty curve");
+    const YieldTermStructure* ptr = curve.currentLink().get();
+    auto it = curveIds_.find(ptr);
+    if (it != curveIds_.end())
+        return it->second;
+
+    // only the log-linearly interpolated sim market curves can be represented by their pillars
+    QL_REQUIRE(boost::dynamic_pointer_cast<QuantExt::InterpolatedDiscountCurve>(curve.currentLink()) ||
+                   boost::dynamic_pointer_cast<QuantExt::InterpolatedDiscountCurve2>(curve.currentLink()),
+               "VectorisedMarketState: curve is not a sim market yield curve");
+
+    // find the sim market parameters key of the curve
+    const boost::shared_ptr<ScenarioSimMarketParameters>& parameters = simMarket_->parameters();
+    std::string key;
+    auto search = [ptr, &key](const std::vector<std::string>& names,
+                              const std::function<Handle<YieldTermStructure>(const std::string&)>& get) {
+        for (auto const& name : names) {
+            try {
+                Handle<YieldTermStructure> h = get(name);
+                if (!h.empty() && h.currentLink().get() == ptr) {
+                    key = name;
+                    return true;
+                }
+            } catch (...) {
+                // curve not available in the sim market, ignore
+            }
+        }
+        return false;
+    };
+    bool found =
+        search(parameters->discountCurveNames(),
+               [this](const std::string& n) { return simMarket_->discountCurve(n); }) ||
+        search(parameters->yieldCurveNames(), [this](const std::string& n) { return simMarket_->yieldCurve(n); }) ||
+        search(parameters->indices(),
+               [this](const std::string& n) { return simMarket_->iborIndex(n)->forwardingTermStructure(); });
+    QL_REQUIRE(found, "VectorisedMarketState: curve not found in sim market");
+
+    Curve c;
+    c.curve = curve;
+    c.dayCounter = curve->dayCounter();
+    // pillar times as set up in ScenarioSimMarket::addYieldCurve()
+    DayCounter dc = parseDayCounter(parameters->yieldCurveDayCounter(key));
+    Date asof = simMarket_->asofDate();
+    c.times.push_back(0.0);
+    for (auto const& tenor : parameters->yieldCurveTenors(key))
+        c.times.push_back(dc.yearFraction(asof, asof + tenor));
+    c.referenceDates.resize(dates_.size());
+    c.logDiscounts.resize(dates_.size(), std::vector<Real>(c.times.size() * samples_, 0.0));
+    curves_.push_back(c);
+    DLOG("VectorisedMarketState: added curve " << key << " with " << c.times.size() << " pillars");
+    return curveIds_[ptr] = curves_.size() - 1;
+}
+
+Size VectorisedMarketState::fxId(const std::string& ccy) {
+    auto it = fxIds_.find(ccy);
+    if (it != fxIds_.end())
+        return it->second;
+    Fx fx;
+    if (ccy != baseCcy_) {
+        fx.spot = simMarket_->fxSpot(ccy + baseCcy_);
+        QL_REQUIRE(!fx.spot.empty(), "VectorisedMarketState: no fx spot for " << ccy << baseCcy_);
+        fx.values.resize(dates_.size(), std::vector<Real>(samples_, 1.0));
+    }
+    fx_.push_back(fx);
+    return fxIds_[ccy] = fx_.size() - 1;
+}
+
+void VectorisedMarketState::record(Size dateIndex, Size sample) {
+    numeraire_[dateIndex][sample] = simMarket_->numeraire();
+    for (auto& c : curves_) {
+        c.referenceDates[dateIndex] = c.curve->referenceDate();
+        std::vector<Real>& logDiscounts = c.logDiscounts[dateIndex];
+        for (Size k = 1; k < c.times.size(); ++k)
+            logDiscounts[k * samples_ + sample] = std::log(c.curve->discount(c.times[k]));
+    }
+    for (auto& fx : fx_) {
+        if (!fx.spot.empty())
+            fx.values[dateIndex][sample] = fx.spot->value();
+    }
+}
+
+const std::vector<Real>& VectorisedMarketState::fxSpot(Size fxId, Size dateIndex) const {
+    const Fx& fx = fx_[fxId];
+    return fx.spot.empty() ? ones_ : fx.values[dateIndex];
+}
+
+void VectorisedMarketState::discount(Size curveId, Size dateIndex, const Date& d, std::vector<Real>& result) const {
+    const Curve& c = curves_[curveId];
+    result.resize(samples_);
+    // same interpolation as in QuantExt::InterpolatedDiscountCurve, this handles extrapolation as well
+    Time t = c.dayCounter.yearFraction(c.referenceDates[dateIndex], d);
+    std::vector<Time>::const_iterator it = std::upper_bound(c.times.begin(), c.times.end(), t);
+    Size i = std::max<Size>(std::min<Size>(it - c.times.begin(), c.times.size() - 1), 1);
+    Real w = (c.times[i] - t) / (c.times[i] - c.times[i - 1]);
+    const Real* lo = &c.logDiscounts[dateIndex][(i - 1) * samples_];
+    const Real* hi = &c.logDiscounts[dateIndex][i * samples_];
+    for (Size s = 0; s < samples_; ++s)
+        result[s] = std::exp((1.0 - w) * hi[s] + w * lo[s]);
+}
+
+Size VectorisedMarketState::memory() const {
+    Size n = dates_.size() * samples_;
+    for (auto const& c : curves_)
+        n += dates_.size() * c.times.size() * samples_;
+    for (auto const& fx : fx_)
+        n += fx.values.size() * samples_;
+    return n * sizeof(Real);
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/vectorisedmarketstate.hpp
+    \brief Simulated market state for all samples, used by the vectorised valuation kernels
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/scenario/scenariosimmarket.hpp>
+
+#include <ql/termstructures/yieldtermstructure.hpp>
+
+#include <map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+using QuantLib::Time;
+
+//! Vectorised market state
+/*! Stores the parts of the simulated market that the vectorised valuation kernels need, for all dates and
+    samples of a cube build. The state is recorded while the ValuationEngine walks through the scenarios and
+    is read by the kernels once all samples have been generated.
+
+    Yield curves are stored as log discount factors on the pillars of the ScenarioSimMarket curves. Since
+    the ScenarioSimMarket curves interpolate log-linearly between these pillars (with flat forward
+    extrapolation) discount factors can be reproduced exactly for all samples in one go.
+
+    Only curves, currencies and the numeraire are stored, trade specific state is kept by the kernels.
+
+    \ingroup simulation
+*/
+class VectorisedMarketState {
+public:
+    VectorisedMarketState(const boost::shared_ptr<ScenarioSimMarket>& simMarket, const std::string& baseCcy,
+                          const std::vector<Date>& dates, Size samples);
+
+    //! \name Registration
+    /*! These methods are called by the kernels before the simulation starts, they throw if the requested
+        data can not be represented by the state. */
+    //@{
+    //! Return the id of a sim market yield curve (discount, yield or index forwarding curve)
+    Size curveId(const QuantLib::Handle<QuantLib::YieldTermStructure>& curve);
+    //! Return the id of the FX spot ccy vs. base ccy
+    Size fxId(const std::string& ccy);
+    //@}
+
+    //! Record the sim market state for the given date index and sample, the sim market must be updated already
+    void record(Size dateIndex, Size sample);
+
+    //! \name Inspectors
+    //@{
+    const boost::shared_ptr<ScenarioSimMarket>& simMarket() const { return simMarket_; }
+    const std::string& baseCcy() const { return baseCcy_; }
+    const std::vector<Date>& dates() const { return dates_; }
+    Size samples() const { return samples_; }
+    //! Numeraire for all samples
+    const std::vector<Real>& numeraire(Size dateIndex) const { return numeraire_[dateIndex]; }
+    //! FX spot ccy vs. base ccy for all samples
+    const std::vector<Real>& fxSpot(Size fxId, Size dateIndex) const;
+    //! Discount factors P(t, d) for all samples where t is the date with index dateIndex
+    void discount(Size curveId, Size dateIndex, const Date& d, std::vector<Real>& result) const;
+    //! Memory used by the recorded data in bytes
+    Size memory() const;
+    //@}
+
+private:
+    struct Curve {
+        QuantLib::Handle<QuantLib::YieldTermStructure> curve;
+        std::vector<Time> times;
+        QuantLib::DayCounter dayCounter;
+        std::vector<Date> referenceDates;
+        // log discount factors per date, stored as [pillar * samples + sample]
+        std::vector<std::vector<Real>> logDiscounts;
+    };
+    struct Fx {
+        QuantLib::Handle<QuantLib::Quote> spot;
+        std::vector<std::vector<Real>> values;
+    };
+
+    boost::shared_ptr<ScenarioSimMarket> simMarket_;
+    std::string baseCcy_;
+    std::vector<Date> dates_;
+    Size samples_;
+    std::vector<std::vector<Real>> numeraire_;
+    std::vector<Curve> curves_;
+    std::map<const QuantLib::YieldTermStructure*, Size> curveIds_;
+    std::vector<Fx> fx_;
+    std::map<std::string, Size> fxIds_;
+    // base ccy fx spot, always one
+    std::vector<Real> ones_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -97,6 +97,12 @@ public:
         }
     }
 
+    //! Go to the first date of the given sample, e.g. to continue filling a partially filled cube
+    void moveTo(Size sampleIndex) {
+        dIndex_ = 0;
+        sIndex_ = sampleIndex;
+    }
+
 private:
     Size dIndex_, sIndex_;
 };
@@ -0,0 +1,213 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/binaryscenariostore.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+const char fileTag[8] = {'O', 'R', 'E', 'S', 'C', 'N', 'B', '1'};
+const std::uint32_t formatVersion = 1;
+
+template <class T> void put(std::vector<char>& buffer, const T& t) {
+    const char* p = reinterpret_cast<const char*>(&t);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+template <class T> T take(const char* data, Size size, Size& offset) {
+    QL_REQUIRE(offset + sizeof(T) <= size, "binary scenario file is truncated");
+    T t;
+    std::memcpy(&t, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return t;
+}
+
+} // namespace
+
+BinaryScenarioWriter::BinaryScenarioWriter(const boost::shared_ptr<ScenarioGenerator>& src,
+                                           const std::string& filename, bool singlePrecision)
+    : src_(src), filename_(filename), singlePrecision_(singlePrecision) {
+    QL_REQUIRE(src_, "BinaryScenarioWriter: no scenario generator given");
+    file_.open(filename_.c_str(), std::ios::binary | std::ios::trunc);
+    QL_REQUIRE(file_.is_open(), "Error opening file " << filename_ << " for binary scenarios");
+}
+
+BinaryScenarioWriter::~BinaryScenarioWriter() { close(); }
+
+void BinaryScenarioWriter::reset() {
+    src_->reset();
+    close();
+}
+
+void BinaryScenarioWriter::close() {
+    if (file_.is_open())
+        file_.close();
+}
+
+boost::shared_ptr<Scenario> BinaryScenarioWriter::next(const Date& d) {
+    boost::shared_ptr<Scenario> s = src_->next(d);
+    if (file_.is_open()) {
+        if (keys_.empty())
+            writeHeader(*s);
+        writeScenario(*s);
+    }
+    return s;
+}
+
+void BinaryScenarioWriter::writeHeader(const Scenario& s) {
+    // the key order is fixed once here, all blocks follow it
+    keys_ = s.keys();
+    QL_REQUIRE(keys_.size() > 0, "No keys in scenario");
+    std::sort(keys_.begin(), keys_.end());
+
+    std::vector<char> header(fileTag, fileTag + sizeof(fileTag));
+    put(header, formatVersion);
+    put(header, static_cast<std::uint32_t>(singlePrecision_ ? sizeof(float) : sizeof(double)));
+    put(header, static_cast<std::uint64_t>(keys_.size()));
+    for (auto const& k : keys_) {
+        put(header, static_cast<std::uint32_t>(k.keytype));
+        put(header, static_cast<std::uint64_t>(k.index));
+        put(header, static_cast<std::uint32_t>(k.name.size()));
+        header.insert(header.end(), k.name.begin(), k.name.end());
+    }
+    file_.write(header.data(), header.size());
+    block_.reserve(sizeof(std::int64_t) + sizeof(double) +
+                   keys_.size() * (singlePrecision_ ? sizeof(float) : sizeof(double)));
+}
+
+void BinaryScenarioWriter::writeScenario(const Scenario& s) {
+    QL_REQUIRE(s.keys().size() == keys_.size(),
+               "scenario for " << s.asof() << " has " << s.keys().size() << " keys, expected " << keys_.size());
+    block_.clear();
+    put(block_, static_cast<std::int64_t>(s.asof().serialNumber()));
+    put(block_, static_cast<double>(s.getNumeraire()));
+    for (auto const& k : keys_) {
+        if (singlePrecision_)
+            put(block_, static_cast<float>(s.get(k)));
+        else
+            put(block_, static_cast<double>(s.get(k)));
+    }
+    file_.write(block_.data(), block_.size());
+    QL_REQUIRE(file_.good(), "Error writing scenario to file " << filename_);
+}
+
+BinaryScenarioGenerator::BinaryScenarioGenerator(const std::string& filename,
+                                                 const boost::shared_ptr<ScenarioFactory>& scenarioFactory)
+    : scenarioFactory_(scenarioFactory) {
+    QL_REQUIRE(scenarioFactory_, "BinaryScenarioGenerator: no scenario factory given");
+    try {
+        file_ = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+        region_ = boost::interprocess::mapped_region(file_, boost::interprocess::read_only);
+    } catch (const std::exception& e) {
+        QL_FAIL("Error mapping binary scenario file " << filename << ": " << e.what());
+    }
+    data_ = static_cast<const char*>(region_.get_address());
+    Size size = region_.get_size();
+
+    QL_REQUIRE(size >= sizeof(fileTag) && std::memcmp(data_, fileTag, sizeof(fileTag)) == 0,
+               filename << " is not a binary scenario file");
+    Size offset = sizeof(fileTag);
+    std::uint32_t version = take<std::uint32_t>(data_, size, offset);
+    QL_REQUIRE(version == formatVersion, "binary scenario file version " << version << " not supported");
+    valueSize_ = take<std::uint32_t>(data_, size, offset);
+    QL_REQUIRE(valueSize_ == sizeof(float) || valueSize_ == sizeof(double),
+               "binary scenario file has unexpected value size " << valueSize_);
+    Size numberOfKeys = take<std::uint64_t>(data_, size, offset);
+    for (Size i = 0; i < numberOfKeys; ++i) {
+        auto keyType = static_cast<RiskFactorKey::KeyType>(take<std::uint32_t>(data_, size, offset));
+        Size index = take<std::uint64_t>(data_, size, offset);
+        Size length = take<std::uint32_t>(data_, size, offset);
+        QL_REQUIRE(offset + length <= size, "binary scenario file is truncated");
+        keys_.push_back(RiskFactorKey(keyType, std::string(data_ + offset, length), index));
+        offset += length;
+    }
+
+    dataOffset_ = offset;
+    blockSize_ = sizeof(std::int64_t) + sizeof(double) + keys_.size() * valueSize_;
+    QL_REQUIRE(size > dataOffset_, "binary scenario file " << filename << " contains no scenarios");
+    QL_REQUIRE((size - dataOffset_) % blockSize_ == 0, "binary scenario file " << filename << " is truncated");
+    Size blocks = (size - dataOffset_) / blockSize_;
+
+    // the first sample's blocks define the date grid
+    dates_.push_back(blockDate(0));
+    for (Size b = 1; b < blocks && blockDate(b) != dates_.front(); ++b)
+        dates_.push_back(blockDate(b));
+    QL_REQUIRE(blocks % dates_.size() == 0, "binary scenario file " << filename << " has " << blocks
+                                                                     << " scenarios for " << dates_.size() << " dates");
+    samples_ = blocks / dates_.size();
+    reset();
+
+    LOG("Binary scenario file " << filename << " mapped: " << keys_.size() << " keys, " << dates_.size()
+                                << " dates, " << samples_ << " samples");
+}
+
+Date BinaryScenarioGenerator::blockDate(Size block) const {
+    std::int64_t serial;
+    std::memcpy(&serial, data_ + dataOffset_ + block * blockSize_, sizeof(serial));
+    return Date(static_cast<Date::serial_type>(serial));
+}
+
+void BinaryScenarioGenerator::reset() {
+    sample_ = 0;
+    nextSample_ = 0;
+    step_ = dates_.size();
+}
+
+void BinaryScenarioGenerator::skip(Size samples, const std::vector<Date>& dates) {
+    QL_REQUIRE(dates == dates_, "skip dates do not match the scenario file grid");
+    QL_REQUIRE(nextSample_ + samples <= samples_, "binary scenario file holds " << samples_ << " samples only");
+    nextSample_ += samples;
+    step_ = dates_.size();
+}
+
+boost::shared_ptr<Scenario> BinaryScenarioGenerator::next(const Date& d) {
+    if (d == dates_.front()) { // new path
+        QL_REQUIRE(nextSample_ < samples_, "binary scenario file holds " << samples_ << " samples only");
+        sample_ = nextSample_++;
+        step_ = 0;
+    }
+    QL_REQUIRE(step_ < dates_.size() && d == dates_[step_], "date " << d << " does not match scenario file grid");
+
+    const char* block = data_ + dataOffset_ + (sample_ * dates_.size() + step_++) * blockSize_;
+    double numeraire;
+    std::memcpy(&numeraire, block + sizeof(std::int64_t), sizeof(numeraire));
+    boost::shared_ptr<Scenario> scenario = scenarioFactory_->buildScenario(d, "", numeraire);
+    const char* values = block + sizeof(std::int64_t) + sizeof(double);
+    for (Size i = 0; i < keys_.size(); ++i) {
+        if (valueSize_ == sizeof(float)) {
+            float v;
+            std::memcpy(&v, values + i * sizeof(float), sizeof(float));
+            scenario->add(keys_[i], v);
+        } else {
+            double v;
+            std::memcpy(&v, values + i * sizeof(double), sizeof(double));
+            scenario->add(keys_[i], v);
+        }
+    }
+    return scenario;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file scenario/binaryscenariostore.hpp
+    \brief Binary scenario file writer and replaying scenario generator
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenariofactory.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fstream>
+
+namespace ore {
+namespace analytics {
+
+//! Class for writing scenarios to a compact binary file
+/*! The file starts with a header holding the key dictionary, the sorted keys of the first scenario, followed by one
+    fixed size block per scenario in generation order, i.e. the dates of the first sample, then the dates of the second
+    sample and so on. The layout, in native byte order, is
+
+    - header: 8 byte tag "ORESCNB1", uint32 format version, uint32 value size (4 or 8), uint64 number of keys, then per
+      key uint32 key type, uint64 index, uint32 name length and the name characters
+    - block: int64 date serial number, double numeraire, one float or double value per key in dictionary order
+
+    The number of dates and samples follows from the blocks. All scenarios have to contain the keys of the first one.
+
+    \ingroup scenario
+*/
+class BinaryScenarioWriter : public ScenarioGenerator {
+public:
+    //! Constructor, store the values in single precision to halve the file size
+    BinaryScenarioWriter(const boost::shared_ptr<ScenarioGenerator>& src, const std::string& filename,
+                         bool singlePrecision = false);
+
+    //! Destructor
+    ~BinaryScenarioWriter();
+
+    //! Return the next scenario for the given date.
+    boost::shared_ptr<Scenario> next(const Date& d) override;
+
+    //! Reset the generator so calls to next() return the first scenario.
+    void reset() override;
+
+    //! Close the file if it is open, not normally needed by client code
+    void close();
+
+private:
+    void writeHeader(const Scenario& s);
+    void writeScenario(const Scenario& s);
+
+    boost::shared_ptr<ScenarioGenerator> src_;
+    std::string filename_;
+    bool singlePrecision_;
+    std::ofstream file_;
+    std::vector<RiskFactorKey> keys_;
+    std::vector<char> block_;
+};
+
+//! Scenario generator replaying the scenarios of a binary scenario file
+/*! The file written by BinaryScenarioWriter is memory mapped and the scenarios are built on demand, so that the
+    scenario generation can be run once and shared by several pricing runs or processes. The calls to next() must
+    follow the date grid of the file, as for any path generator.
+
+    \ingroup scenario
+*/
+class BinaryScenarioGenerator : public ScenarioGenerator {
+public:
+    //! Constructor
+    BinaryScenarioGenerator(const std::string& filename, const boost::shared_ptr<ScenarioFactory>& scenarioFactory);
+
+    //! Return the next scenario for the given date.
+    boost::shared_ptr<Scenario> next(const Date& d) override;
+
+    //! Reset the generator so calls to next() return the first scenario.
+    void reset() override;
+
+    //! Skip samples by moving the read position only
+    void skip(Size samples, const std::vector<Date>& dates) override;
+
+    //! Inspectors
+    //@{
+    const std::vector<RiskFactorKey>& keys() const { return keys_; }
+    const std::vector<Date>& dates() const { return dates_; }
+    Size samples() const { return samples_; }
+    bool singlePrecision() const { return valueSize_ == sizeof(float); }
+    //@}
+
+private:
+    Date blockDate(Size block) const;
+
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    const char* data_;
+    boost::shared_ptr<ScenarioFactory> scenarioFactory_;
+    std::vector<RiskFactorKey> keys_;
+    std::vector<Date> dates_;
+    Size dataOffset_, samples_, valueSize_, blockSize_;
+    Size sample_, nextSample_, step_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -175,6 +175,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
 std::vector<boost::shared_ptr<Scenario>> CrossAssetModelScenarioGenerator::nextPath() {
     std::vector<boost::shared_ptr<Scenario>> scenarios(dates_.size());
     Sample<MultiPath> sample = pathGenerator_->next();
+    modelPath_ = sample.value;
     Size n_ccy = model_->components(IR);
     Size n_eq = model_->components(EQ);
     Size n_inf = model_->components(INF);
@@ -67,6 +67,17 @@ public:
     std::vector<boost::shared_ptr<Scenario>> nextPath();
     void reset() { pathGenerator_->reset(); }
 
+    //! \name Inspectors
+    //@{
+    const boost::shared_ptr<QuantExt::CrossAssetModel>& model() const { return model_; }
+    //! Model state of the given process on the current path at the given date index
+    Real modelState(Size processIndex, Size dateIndex) const { return modelPath_[processIndex][dateIndex + 1]; }
+    //@}
+
+protected:
+    //! Draws the model path only, the random sequence advances exactly as in nextPath()
+    void skipPath() { pathGenerator_->next(); }
+
 private:
     boost::shared_ptr<QuantExt::CrossAssetModel> model_;
     boost::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGenerator_;
@@ -79,6 +90,8 @@ private:
     std::vector<RiskFactorKey> fxKeys_, eqKeys_, cpiKeys_;
     std::vector<boost::shared_ptr<QuantExt::CrossAssetModelImpliedFxVolTermStructure>> fxVols_;
     std::vector<boost::shared_ptr<QuantExt::CrossAssetModelImpliedEqVolTermStructure>> eqVols_;
+    // the model path underlying the current scenario path
+    QuantLib::MultiPath modelPath_;
     std::vector<std::vector<Period>> ten_dsc_, ten_idx_, ten_yc_, ten_efc_, ten_zinf_, ten_yinf_;
 };
 } // namespace analytics
@@ -0,0 +1,52 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/make_shared.hpp>
+#include <orea/scenario/deltascenario.hpp>
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+DeltaScenario::DeltaScenario(const boost::shared_ptr<Scenario>& baseScenario, const std::string& label,
+                             Real numeraire)
+    : baseScenario_(baseScenario), label_(label), numeraire_(numeraire) {
+    QL_REQUIRE(baseScenario_ != nullptr, "DeltaScenario: base scenario pointer must not be null");
+    if (numeraire_ == 0.0)
+        numeraire_ = baseScenario_->getNumeraire();
+}
+
+void DeltaScenario::add(const RiskFactorKey& key, Real value) {
+    // throws if the base scenario does not provide the key
+    if (baseScenario_->get(key) == value)
+        delta_.erase(key);
+    else
+        delta_[key] = value;
+}
+
+Real DeltaScenario::get(const RiskFactorKey& key) const {
+    auto it = delta_.find(key);
+    if (it != delta_.end())
+        return it->second;
+    return baseScenario_->get(key);
+}
+
+boost::shared_ptr<Scenario> DeltaScenario::clone() const { return boost::make_shared<DeltaScenario>(*this); }
+
+} // namespace analytics
+} // namespace ore
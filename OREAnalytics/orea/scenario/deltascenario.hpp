@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/scenario/deltascenario.hpp
+    \brief Scenario class storing only the differences to a base scenario
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenario.hpp>
+
+#include <map>
+
+namespace ore {
+namespace analytics {
+using std::string;
+
+//-----------------------------------------------------------------------------------------------
+//! Delta Scenario class
+/*! This implementation stores a pointer to a base scenario and only those market points that differ from
+  the base scenario. From the outside it looks like a full scenario, i.e. it provides data for all keys of
+  the base scenario. Sensitivity and stress scenarios typically shift a small number of market points, so
+  that many such scenarios can be held in memory at the cost of the shifted points only.
+
+  The ScenarioSimMarket recognises delta scenarios built on its own base scenario and only updates the
+  market points that differ from the base scenario when applying them.
+
+  \ingroup scenario
+*/
+class DeltaScenario : public Scenario {
+public:
+    //! Constructor
+    DeltaScenario(const boost::shared_ptr<Scenario>& baseScenario, const std::string& label = "",
+                  Real numeraire = 0.0);
+
+    //! Return the scenario asof date
+    const Date& asof() const override { return baseScenario_->asof(); }
+
+    //! Return the scenario label
+    const std::string& label() const override { return label_; }
+    //! set the label
+    void label(const string& s) override { label_ = s; }
+
+    //! Get Numeraire ratio n = N(t) / N(0) so that Price(0) = N(0) * E [Price(t) / N(t) ]
+    Real getNumeraire() const override { return numeraire_; }
+    //! Set the Numeraire ratio n = N(t) / N(0) so that Price(0) = N(0) * E [Price(t) / N(t) ]
+    void setNumeraire(Real n) override { numeraire_ = n; }
+
+    //! Check, get, add a single market point
+    bool has(const RiskFactorKey& key) const override { return baseScenario_->has(key); }
+    const std::vector<RiskFactorKey>& keys() const override { return baseScenario_->keys(); }
+    /*! The key must be provided by the base scenario. If the value equals the base value, the key is
+        removed from the delta. */
+    void add(const RiskFactorKey& key, Real value) override;
+    Real get(const RiskFactorKey& key) const override;
+
+    //! The clone shares the base scenario, the delta is copied
+    boost::shared_ptr<Scenario> clone() const override;
+
+    //! Inspectors
+    //@{
+    //! The scenario the delta is taken against
+    const boost::shared_ptr<Scenario>& baseScenario() const { return baseScenario_; }
+    //! The market points that differ from the base scenario
+    const std::map<RiskFactorKey, Real>& delta() const { return delta_; }
+    //@}
+
+private:
+    boost::shared_ptr<Scenario> baseScenario_;
+    std::string label_;
+    Real numeraire_;
+    std::map<RiskFactorKey, Real> delta_;
+};
+} // namespace analytics
+} // namespace ore
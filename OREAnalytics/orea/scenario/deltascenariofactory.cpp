@@ -0,0 +1,40 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/make_shared.hpp>
+#include <orea/scenario/deltascenario.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+DeltaScenarioFactory::DeltaScenarioFactory(const boost::shared_ptr<Scenario>& baseScenario)
+    : baseScenario_(baseScenario) {
+    QL_REQUIRE(baseScenario_ != nullptr, "base scenario pointer must not be null");
+}
+
+const boost::shared_ptr<Scenario> DeltaScenarioFactory::buildScenario(Date asof, const std::string& label,
+                                                                      Real numeraire) const {
+    QL_REQUIRE(asof == baseScenario_->asof(),
+               "unexpected asof date (" << asof << "), does not match base - " << baseScenario_->asof());
+    return boost::make_shared<DeltaScenario>(baseScenario_, label, numeraire);
+}
+
+} // namespace analytics
+} // namespace ore
@@ -60,6 +60,10 @@ public:
     std::vector<boost::shared_ptr<Scenario>> nextPath();
     void reset() { pathGenerator_->reset(); }
 
+protected:
+    //! Draws the model path only, the random sequence advances exactly as in nextPath()
+    void skipPath() { pathGenerator_->next(); }
+
 private:
     boost::shared_ptr<QuantExt::LGM> model_;
     boost::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGenerator_;
@@ -50,6 +50,14 @@ public:
     //! Reset the generator so calls to next() return the first scenario.
     /*! This allows re-generation of scenarios if required. */
     virtual void reset() = 0;
+
+    //! Skip the given number of samples along the given dates
+    /*! By default the scenarios are generated and discarded, derived classes can provide a faster fast-forward. */
+    virtual void skip(Size samples, const vector<Date>& dates) {
+        for (Size i = 0; i < samples; ++i)
+            for (auto const& d : dates)
+                next(d);
+    }
 };
 
 //! Scenario generator that generates an entire path
@@ -79,8 +87,22 @@ public:
         return path_[pathStep_++]; // post increment
     }
 
+    //! Skip the given number of paths, the scenarios on the skipped paths are not built
+    virtual void skip(Size samples, const vector<Date>& dates) {
+        QL_REQUIRE(dates == dates_, "skip dates do not match the generator's date grid");
+        for (Size i = 0; i < samples; ++i)
+            skipPath();
+        path_.clear();
+        pathStep_ = dates_.size();
+    }
+
+    //! Time grid associated to the dates, including t=0
+    const TimeGrid& timeGrid() const { return timeGrid_; }
+
 protected:
     virtual std::vector<boost::shared_ptr<Scenario>> nextPath() = 0;
+    //! Advance to the next path without building its scenarios, by default the path is generated and discarded
+    virtual void skipPath() { nextPath(); }
 
     Date today_;
     vector<Date> dates_;
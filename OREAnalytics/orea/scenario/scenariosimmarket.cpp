@@ -195,7 +195,7 @@ ScenarioSimMarket::ScenarioSimMarket(
     const std::string& configuration, const ore::data::CurveConfigurations& curveConfigs,
     const ore::data::TodaysMarketParameters& todaysMarketParams, const bool continueOnError)
     : SimMarket(conventions), parameters_(parameters), fixingManager_(fixingManager),
-      filter_(boost::make_shared<ScenarioFilter>()) {
+      filter_(boost::make_shared<ScenarioFilter>()), deltaKeysValid_(false) {
 
     LOG("building ScenarioSimMarket...");
     asof_ = initMarket->asofDate();
@@ -1605,13 +1605,25 @@ ScenarioSimMarket::ScenarioSimMarket(
     for (auto const& data : simData_) {
         baseScenario_->add(data.first, data.second->value());
     }
+    // the sim market is in the base state now
+    deltaKeysValid_ = true;
     LOG("building base scenario done");
 }
 
 void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenario) {
+
+    // delta scenarios against our base scenario only touch the market points that differ from the base
+    boost::shared_ptr<DeltaScenario> deltaScenario = boost::dynamic_pointer_cast<DeltaScenario>(scenario);
+    if (deltaScenario && deltaScenario->baseScenario() == baseScenario_ && deltaKeysValid_) {
+        applyDeltaScenario(*deltaScenario);
+        asof_ = scenario->asof();
+        return;
+    }
+
     const vector<RiskFactorKey>& keys = scenario->keys();
 
     Size count = 0;
+    bool complete = true;
     for (const auto& key : keys) {
         // Loop through the scenario keys and check which keys are present in simData_,
         // adding to the count when a match is identified
@@ -1624,6 +1636,8 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
         } else {
             if (filter_->allow(key))
                 it->second->setValue(scenario->get(key));
+            else
+                complete = false;
             count++;
         }
     }
@@ -1637,10 +1651,43 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
         QL_FAIL("mismatch between scenario and sim data size, exit.");
     }
 
+    // if all points were written, we know in which points the market differs from the base scenario
+    deltaKeys_.clear();
+    deltaKeysValid_ = complete && (scenario == baseScenario_ ||
+                                   (deltaScenario && deltaScenario->baseScenario() == baseScenario_));
+    if (deltaKeysValid_ && deltaScenario) {
+        for (auto const& d : deltaScenario->delta())
+            deltaKeys_.insert(d.first);
+    }
+
     // update market asof date
     asof_ = scenario->asof();
 }
 
+void ScenarioSimMarket::applyDeltaScenario(const DeltaScenario& scenario) {
+    const std::map<RiskFactorKey, Real>& delta = scenario.delta();
+
+    // revert the points shifted by the previous scenario that are not shifted by this one
+    for (auto k = deltaKeys_.begin(); k != deltaKeys_.end();) {
+        if (delta.find(*k) == delta.end() && filter_->allow(*k)) {
+            simData_.at(*k)->setValue(baseScenario_->get(*k));
+            k = deltaKeys_.erase(k);
+        } else {
+            ++k;
+        }
+    }
+
+    // apply the shifted points of this scenario
+    for (auto const& d : delta) {
+        if (!filter_->allow(d.first))
+            continue;
+        auto it = simData_.find(d.first);
+        QL_REQUIRE(it != simData_.end(), "simulation data point missing for key " << d.first);
+        it->second->setValue(d.second);
+        deltaKeys_.insert(d.first);
+    }
+}
+
 void ScenarioSimMarket::reset() {
     auto filterBackup = filter_;
     // no filter
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <orea/scenario/deltascenario.hpp>
 #include <orea/scenario/scenario.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
@@ -154,11 +155,16 @@ public:
     //! Return the fixing manager
     const boost::shared_ptr<FixingManager>& fixingManager() const override { return fixingManager_; }
 
+    //! Return the sim market parameters
+    const boost::shared_ptr<ScenarioSimMarketParameters>& parameters() const { return parameters_; }
+
     //! is risk factor key simulated by this sim market instance?
     bool isSimulated(const RiskFactorKey::KeyType& factor) const;
 
 private:
     void applyScenario(const boost::shared_ptr<Scenario>& scenario);
+    //! only updates the points that differ from the current state, requires deltaKeysValid_
+    void applyDeltaScenario(const DeltaScenario& scenario);
     void addYieldCurve(const boost::shared_ptr<Market>& initMarket, const std::string& configuration,
                        const RiskFactorKey::KeyType rf, const string& key, const vector<Period>& tenors,
                        const std::string& dc, bool simulate = true);
@@ -179,6 +185,10 @@ private:
 
     std::map<RiskFactorKey, boost::shared_ptr<SimpleQuote>> simData_;
     boost::shared_ptr<Scenario> baseScenario_;
+    // points in which the sim market currently differs from the base scenario, only known after applying
+    // the base scenario or a delta scenario on it without filtering
+    std::set<RiskFactorKey> deltaKeys_;
+    bool deltaKeysValid_;
 
     std::set<RiskFactorKey::KeyType> nonSimulatedFactors_;
 };
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/scenariosimmarketcache.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <sstream>
+
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+boost::shared_ptr<ScenarioSimMarket>
+ScenarioSimMarketCache::simMarket(const boost::shared_ptr<Market>& initMarket,
+                                  const boost::shared_ptr<ScenarioSimMarketParameters>& parameters,
+                                  const Conventions& conventions, const std::string& configuration,
+                                  const CurveConfigurations& curveConfigs,
+                                  const TodaysMarketParameters& todaysMarketParams, const bool continueOnError) {
+    // the log statements and builds run without the cache mutex, so that the log mutex is never taken while the
+    // cache mutex is held
+    boost::shared_ptr<ScenarioSimMarket> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto const& e : simMarkets_) {
+            if (e.initMarket == initMarket && e.configuration == configuration &&
+                e.continueOnError == continueOnError && (e.parameters == parameters || *e.parameters == *parameters)) {
+                cached = e.simMarket;
+                break;
+            }
+        }
+        if (cached)
+            ++hits_;
+        else
+            ++misses_;
+    }
+    if (cached) {
+        LOG("ScenarioSimMarketCache: reuse sim market for configuration " << configuration);
+        // back to the base scenario, the caller sets up its own generator and filter
+        cached->filter() = boost::make_shared<ScenarioFilter>();
+        cached->reset();
+        cached->scenarioGenerator() = boost::shared_ptr<ScenarioGenerator>();
+        cached->aggregationScenarioData() = boost::shared_ptr<AggregationScenarioData>();
+        return cached;
+    }
+
+    LOG("ScenarioSimMarketCache: build sim market for configuration " << configuration);
+    SimMarketEntry e;
+    e.initMarket = initMarket;
+    e.parameters = parameters;
+    e.configuration = configuration;
+    e.continueOnError = continueOnError;
+    e.simMarket = boost::make_shared<ScenarioSimMarket>(initMarket, parameters, conventions, configuration,
+                                                        curveConfigs, todaysMarketParams, continueOnError);
+    std::lock_guard<std::mutex> lock(mutex_);
+    simMarkets_.push_back(e);
+    return e.simMarket;
+}
+
+std::pair<boost::shared_ptr<Portfolio>, boost::shared_ptr<EngineFactory>>
+ScenarioSimMarketCache::portfolio(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+                                  const boost::shared_ptr<Portfolio>& portfolio,
+                                  const boost::shared_ptr<EngineData>& engineData,
+                                  const std::string& pricingConfiguration,
+                                  const std::function<boost::shared_ptr<EngineFactory>()>& buildFactory,
+                                  const std::vector<boost::shared_ptr<EngineBuilder>>& extraEngineBuilders,
+                                  const std::vector<boost::shared_ptr<LegBuilder>>& extraLegBuilders) {
+    XMLDocument doc;
+    XMLNode* node = doc.allocNode("Portfolio");
+    doc.appendNode(node);
+    for (auto const& t : portfolio->trades())
+        XMLUtils::appendNode(node, t->toXML(doc));
+    // the extra builders are identified by their instances, the cached factory keeps them alive
+    std::ostringstream builders;
+    for (auto const& b : extraEngineBuilders)
+        builders << "|" << b->model() << "/" << b->engine() << "@" << b.get();
+    for (auto const& b : extraLegBuilders)
+        builders << "|" << b->legType() << "@" << b.get();
+    auto key = std::make_tuple(simMarket.get(),
+                               engineData->toXMLString() + "|" + pricingConfiguration + builders.str(), doc.toString());
+
+    std::pair<boost::shared_ptr<Portfolio>, boost::shared_ptr<EngineFactory>> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto p = portfolios_.find(key);
+        if (p != portfolios_.end()) {
+            ++hits_;
+            result = p->second;
+        } else {
+            ++misses_;
+        }
+    }
+    if (result.first) {
+        LOG("ScenarioSimMarketCache: reuse portfolio of size " << result.first->size()
+                                                               << " built against the sim market");
+        return result;
+    }
+
+    boost::shared_ptr<EngineFactory> factory = buildFactory();
+    portfolio->reset();
+    portfolio->build(factory);
+    result = std::make_pair(portfolio, factory);
+    std::lock_guard<std::mutex> lock(mutex_);
+    portfolios_[key] = result;
+    return result;
+}
+
+Size ScenarioSimMarketCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+Size ScenarioSimMarketCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void ScenarioSimMarketCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    portfolios_.clear();
+    simMarkets_.clear();
+    hits_ = misses_ = 0;
+}
+
+} // namespace analytics
+} // namespace ore
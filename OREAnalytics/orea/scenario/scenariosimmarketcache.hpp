@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/scenario/scenariosimmarketcache.hpp
+    \brief Cache of scenario simulation markets and of the portfolios built against them
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+
+#include <ql/patterns/singleton.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace ore {
+namespace analytics {
+
+//! Cache of scenario simulation markets and of the portfolios built against them
+/*! Building a ScenarioSimMarket and building the portfolio against it are expensive. If several analytics in one
+    process use the same init market and simulation market parameters, e.g. sensitivity and stress test, they can
+    share one instance: the first request builds the market, later requests get the same instance reset to its base
+    scenario, with the scenario generator, aggregation scenario data and filter removed. The caller then sets its own
+    scenario generator and filter.
+
+    Portfolios are cached per sim market, keyed on the XML representation of their trades and of the engine data
+    together with the pricing configuration and the extra engine and leg builders, so that an analytic that loads the
+    same portfolio again gets the portfolio already built against the sim market and the engine factory used for the
+    build. Extra builders are identified by their instances, i.e. a portfolio built with other builder instances is
+    built again.
+
+    The cache is disabled by default. Its methods can be called from several threads, a sim market and portfolio
+    returned by the cache must however only be used by one analytic at a time. Builds run without holding the cache
+    lock, so that concurrent first requests for the same sim market or portfolio may each build it.
+
+    \ingroup scenario
+*/
+class ScenarioSimMarketCache : public QuantLib::Singleton<ScenarioSimMarketCache> {
+    friend class QuantLib::Singleton<ScenarioSimMarketCache>;
+
+private:
+    ScenarioSimMarketCache() : enabled_(false), hits_(0), misses_(0) {}
+
+public:
+    bool enabled() const { return enabled_; }
+    void setEnabled(const bool enabled) { enabled_ = enabled; }
+
+    /*! The sim market for the given init market, parameters and configuration, built on the first request. The
+        curve configurations and todays market parameters are only used for this build, they are assumed to be the
+        ones the init market was built from. */
+    boost::shared_ptr<ScenarioSimMarket>
+    simMarket(const boost::shared_ptr<ore::data::Market>& initMarket,
+              const boost::shared_ptr<ScenarioSimMarketParameters>& parameters,
+              const ore::data::Conventions& conventions,
+              const std::string& configuration = ore::data::Market::defaultConfiguration,
+              const ore::data::CurveConfigurations& curveConfigs = ore::data::CurveConfigurations(),
+              const ore::data::TodaysMarketParameters& todaysMarketParams = ore::data::TodaysMarketParameters(),
+              const bool continueOnError = false);
+
+    /*! The given portfolio built against the sim market with the engine factory returned by buildFactory, or a
+        portfolio with the same trades built before with the same engine data, pricing configuration and extra
+        builders. The extra builders must be the ones buildFactory adds to the factory. The returned factory is the
+        one used for the build. */
+    std::pair<boost::shared_ptr<ore::data::Portfolio>, boost::shared_ptr<ore::data::EngineFactory>>
+    portfolio(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+              const boost::shared_ptr<ore::data::Portfolio>& portfolio,
+              const boost::shared_ptr<ore::data::EngineData>& engineData, const std::string& pricingConfiguration,
+              const std::function<boost::shared_ptr<ore::data::EngineFactory>()>& buildFactory,
+              const std::vector<boost::shared_ptr<ore::data::EngineBuilder>>& extraEngineBuilders = {},
+              const std::vector<boost::shared_ptr<ore::data::LegBuilder>>& extraLegBuilders = {});
+
+    //! \name Statistics
+    //@{
+    //! number of requests served from the cache
+    Size hits() const;
+    //! number of sim market and portfolio builds
+    Size misses() const;
+    //@}
+
+    //! release all cached sim markets and portfolios
+    void clear();
+
+private:
+    struct SimMarketEntry {
+        boost::shared_ptr<ore::data::Market> initMarket;
+        boost::shared_ptr<ScenarioSimMarketParameters> parameters;
+        std::string configuration;
+        bool continueOnError;
+        boost::shared_ptr<ScenarioSimMarket> simMarket;
+    };
+
+    std::atomic<bool> enabled_;
+    mutable std::mutex mutex_;
+    Size hits_, misses_;
+    std::vector<SimMarketEntry> simMarkets_;
+    // sim market, engine data, pricing configuration and extra builders, trades => built portfolio and factory
+    std::map<std::tuple<ScenarioSimMarket*, std::string, std::string>,
+             std::pair<boost::shared_ptr<ore::data::Portfolio>, boost::shared_ptr<ore::data::EngineFactory>>>
+        portfolios_;
+};
+
+} // namespace analytics
+} // namespace ore
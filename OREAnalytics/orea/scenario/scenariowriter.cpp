@@ -65,9 +65,11 @@ boost::shared_ptr<Scenario> ScenarioWriter::next(const Date& d) {
 void ScenarioWriter::writeScenario(boost::shared_ptr<Scenario>& s, const bool writeHeader) {
     if (fp_) {
         const Date d = s->asof();
-        // take a copy of the keys here to ensure the order is preseved
-        keys_ = s->keys();
-        std::sort(keys_.begin(), keys_.end());
+        // take a copy of the keys here to ensure the order is preseved, sorted once for all scenarios
+        if (writeHeader || keys_.empty()) {
+            keys_ = s->keys();
+            std::sort(keys_.begin(), keys_.end());
+        }
         if (writeHeader) {
             QL_REQUIRE(keys_.size() > 0, "No keys in scenario");
             fprintf(fp_, "Date%cScenario%cNumeraire%c%s", sep_, sep_, sep_, to_string(keys_[0]).c_str());
@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <orea/scenario/deltascenario.hpp>
 #include <orea/scenario/sensitivityscenariogenerator.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
@@ -195,9 +196,14 @@ void SensitivityScenarioGenerator::generateScenarios() {
             continue;
 
         boost::shared_ptr<Scenario> iScenario = scenarios_[i];
+        boost::shared_ptr<DeltaScenario> iDelta = boost::dynamic_pointer_cast<DeltaScenario>(iScenario);
+        if (iDelta && iDelta->baseScenario() != baseScenario_)
+            iDelta = nullptr;
         vector<Real> iValues;
-        for (auto k : keys)
-            iValues.push_back(iScenario->get(k));
+        if (!iDelta) {
+            for (auto k : keys)
+                iValues.push_back(iScenario->get(k));
+        }
 
         for (Size j = i + 1; j < index; ++j) {
             ScenarioDescription jDesc = scenarioDescriptions_[j];
@@ -212,13 +218,30 @@ void SensitivityScenarioGenerator::generateScenarios() {
 
             boost::shared_ptr<Scenario> crossScenario = sensiScenarioFactory_->buildScenario(asof);
             boost::shared_ptr<Scenario> jScenario = scenarios_[j];
-            for (Size k = 0; k < keys.size(); k++) {
-                Real iValue = iValues[k];
-                Real jValue = jScenario->get(keys[k]);
-                Real baseValue = baseValues[k];
-                if (!close_enough(iValue, baseValue) || !close_enough(jValue, baseValue)) {
-                    Real newVal = iValue + jValue - baseValue;
-                    crossScenario->add(keys[k], newVal);
+            boost::shared_ptr<DeltaScenario> jDelta = boost::dynamic_pointer_cast<DeltaScenario>(jScenario);
+            if (iDelta && jDelta && jDelta->baseScenario() == baseScenario_) {
+                // only the points shifted in one of the two scenarios can differ from the base
+                std::set<RiskFactorKey> shiftedKeys;
+                for (auto const& d : iDelta->delta())
+                    shiftedKeys.insert(d.first);
+                for (auto const& d : jDelta->delta())
+                    shiftedKeys.insert(d.first);
+                for (auto const& k : shiftedKeys) {
+                    Real iValue = iDelta->get(k);
+                    Real jValue = jDelta->get(k);
+                    Real baseValue = baseScenario_->get(k);
+                    if (!close_enough(iValue, baseValue) || !close_enough(jValue, baseValue))
+                        crossScenario->add(k, iValue + jValue - baseValue);
+                }
+            } else {
+                for (Size k = 0; k < keys.size(); k++) {
+                    Real iValue = iDelta ? iDelta->get(keys[k]) : iValues[k];
+                    Real jValue = jScenario->get(keys[k]);
+                    Real baseValue = baseValues[k];
+                    if (!close_enough(iValue, baseValue) || !close_enough(jValue, baseValue)) {
+                        Real newVal = iValue + jValue - baseValue;
+                        crossScenario->add(keys[k], newVal);
+                    }
                 }
             }
 
@@ -113,6 +113,9 @@ void FixingManager::processCashFlows(const boost::shared_ptr<QuantLib::CashFlow>
         if (avon) {
             for (auto const& d : avon->fixingDates())
                 fixingMap_[avon->index()].insert(d);
+            // fixings are only appended as the simulation moves forward, so the accrued part can be extended
+            avon->enableAccruedStateCache(true);
+            averageONCoupons_.push_back(avon);
             return;
         }
         auto bma = boost::dynamic_pointer_cast<AverageBMACoupon>(frc);
@@ -179,6 +182,8 @@ void FixingManager::reset() {
             IndexManager::instance().setHistory(kv.first->name(), kv.second);
         modifiedFixingHistory_ = false;
     }
+    for (auto const& c : averageONCoupons_)
+        c->resetAccruedState();
     fixingsEnd_ = today_;
 }
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <ored/portfolio/portfolio.hpp>
+#include <qle/cashflows/averageonindexedcoupon.hpp>
 
 namespace ore {
 namespace analytics {
@@ -73,6 +74,8 @@ protected:
     };
     std::map<boost::shared_ptr<Index>, TimeSeries<Real>, indexComp> fixingCache_;
     std::map<boost::shared_ptr<Index>, std::set<Date>, indexComp> fixingMap_;
+    // coupons keeping an accrued state that is invalidated on reset()
+    std::vector<boost::shared_ptr<QuantExt::AverageONIndexedCoupon>> averageONCoupons_;
 };
 } // namespace analytics
 } // namespace ore
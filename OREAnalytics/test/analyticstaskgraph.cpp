@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analyticstaskgraph.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/errors.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace ore::analytics;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AnalyticsTaskGraphTest)
+
+BOOST_AUTO_TEST_CASE(testDependenciesRespected) {
+    BOOST_TEST_MESSAGE("Testing the order of tasks in the analytics task graph...");
+
+    for (QuantLib::Size threads : {1, 4}) {
+        mutex m;
+        vector<string> order;
+        auto record = [&m, &order](const string& name) {
+            return [&m, &order, name]() {
+                // give concurrent tasks a chance to overtake
+                this_thread::sleep_for(chrono::milliseconds(5));
+                lock_guard<mutex> lock(m);
+                order.push_back(name);
+            };
+        };
+        AnalyticsTaskGraph tasks(threads);
+        tasks.add("market", {}, record("market"));
+        tasks.add("load", {}, record("load"), true);
+        tasks.add("portfolio", {"market"}, record("portfolio"));
+        tasks.add("var", {"portfolio"}, record("var"), true);
+        tasks.add("stress", {"market"}, record("stress"));
+        tasks.add("xva", {"portfolio", "load"}, record("xva"));
+        tasks.run();
+
+        auto pos = [&order](const string& name) { return find(order.begin(), order.end(), name) - order.begin(); };
+        BOOST_REQUIRE_EQUAL(order.size(), 6UL);
+        BOOST_CHECK_LT(pos("market"), pos("portfolio"));
+        BOOST_CHECK_LT(pos("portfolio"), pos("var"));
+        BOOST_CHECK_LT(pos("market"), pos("stress"));
+        BOOST_CHECK_LT(pos("portfolio"), pos("xva"));
+        BOOST_CHECK_LT(pos("load"), pos("xva"));
+        // tasks on the calling thread keep the order they were added in
+        BOOST_CHECK_LT(pos("portfolio"), pos("stress"));
+        BOOST_CHECK_LT(pos("stress"), pos("xva"));
+        if (threads == 1) {
+            vector<string> expected = {"market", "load", "portfolio", "var", "stress", "xva"};
+            BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+        }
+        BOOST_CHECK_EQUAL(tasks.timings().size(), 6UL);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentTasksFinishLast) {
+    BOOST_TEST_MESSAGE("Testing an analytics task graph ending in concurrent tasks...");
+
+    for (QuantLib::Size threads : {1, 2, 4}) {
+        atomic<int> runs(0);
+        AnalyticsTaskGraph tasks(threads);
+        tasks.add("market", {}, [&runs]() { ++runs; });
+        auto load = [&runs]() {
+            this_thread::sleep_for(chrono::milliseconds(5));
+            ++runs;
+        };
+        // the calling thread has nothing left to do and waits for the workers to signal
+        for (QuantLib::Size i = 0; i < 10; ++i)
+            tasks.add("load" + to_string(i), {"market"}, load, true);
+        tasks.run();
+        BOOST_CHECK_EQUAL(runs.load(), 11);
+        BOOST_CHECK_EQUAL(tasks.timings().size(), 11UL);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testErrorStopsGraph) {
+    BOOST_TEST_MESSAGE("Testing error handling in the analytics task graph...");
+
+    for (QuantLib::Size threads : {1, 4}) {
+        atomic<int> runs(0);
+        AnalyticsTaskGraph tasks(threads);
+        tasks.add("market", {}, [&runs]() { ++runs; });
+        auto failing = [&runs]() {
+            ++runs;
+            QL_FAIL("cube file not found");
+        };
+        tasks.add("load", {}, failing, true);
+        tasks.add("xva", {"market", "load"}, [&runs]() { ++runs; });
+        BOOST_CHECK_THROW(tasks.run(), QuantLib::Error);
+        BOOST_CHECK_EQUAL(runs.load(), 2);
+    }
+
+    AnalyticsTaskGraph tasks;
+    BOOST_CHECK_THROW(tasks.add("xva", {"simulation"}, []() {}), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
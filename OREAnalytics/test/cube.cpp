@@ -19,6 +19,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <test/oreatoplevelfixture.hpp>
+#include <orea/cube/compressedcube.hpp>
+#include <orea/cube/cubemerge.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <oret/toplevelfixture.hpp>
 
@@ -200,6 +202,151 @@ BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     testCubeGetSetbyDateID(cube, 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testMergeCubes) {
+    Date asof(1, QuantLib::Jan, 2016);
+    vector<Date> dates = {asof + 1, asof + 2};
+    Size samples = 3, depth = 2;
+    boost::shared_ptr<NPVCube> base =
+        boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, vector<string>{"t1", "t2", "t3"}, dates, samples, depth);
+    boost::shared_ptr<NPVCube> update =
+        boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, vector<string>{"t4", "t2"}, dates, samples, depth);
+    initCube(*base);
+    for (Size d = 0; d < depth; ++d) {
+        for (Size i = 0; i < update->numIds(); ++i) {
+            update->setT0(-1.0 - i, i, d);
+            for (Size j = 0; j < update->numDates(); ++j)
+                for (Size k = 0; k < update->samples(); ++k)
+                    update->set(-100.0 * (i + 1) - k, i, j, k, d);
+        }
+    }
+
+    // t1 from the base cube, the amended t2 and the new t4 from the update, the removed t3 is left out
+    boost::shared_ptr<NPVCube> merged = mergeCubes({"t1", "t2", "t4"}, base, update);
+    BOOST_CHECK_EQUAL(merged->numIds(), 3UL);
+    BOOST_CHECK_EQUAL(merged->depth(), depth);
+    BOOST_CHECK(merged->dates() == dates);
+    for (Size d = 0; d < depth; ++d) {
+        BOOST_CHECK_CLOSE(merged->getT0(1, d), -2.0, 1e-5);
+        BOOST_CHECK_CLOSE(merged->getT0(2, d), -1.0, 1e-5);
+        for (Size j = 0; j < merged->numDates(); ++j) {
+            for (Size k = 0; k < merged->samples(); ++k) {
+                BOOST_CHECK_CLOSE(merged->get(0, j, k, d), base->get(0, j, k, d), 1e-5);
+                BOOST_CHECK_CLOSE(merged->get(1, j, k, d), -200.0 - k, 1e-5);
+                BOOST_CHECK_CLOSE(merged->get(2, j, k, d), -100.0 - k, 1e-5);
+            }
+        }
+    }
+
+    // a subset of the base cube, unknown ids and mismatching grids fail
+    boost::shared_ptr<NPVCube> subset = mergeCubes({"t3"}, base);
+    BOOST_CHECK_EQUAL(subset->numIds(), 1UL);
+    BOOST_CHECK_CLOSE(subset->get(0, 1, 2, 1), base->get(2, 1, 2, 1), 1e-5);
+    BOOST_CHECK_THROW(mergeCubes({"t5"}, base, update), std::exception);
+    boost::shared_ptr<NPVCube> other =
+        boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, vector<string>{"t4"}, dates, samples + 1, depth);
+    BOOST_CHECK_THROW(mergeCubes({"t1", "t4"}, base, other), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(testCopyShards) {
+    Date asof(1, QuantLib::Jan, 2016);
+    vector<Date> dates = {asof + 1, asof + 2};
+    DoublePrecisionInMemoryCube targetCube(asof, {"t1", "t2"}, dates, 5), shardCube(asof, {"t2"}, dates, 2);
+    NPVCube &target = targetCube, &shard = shardCube;
+    initCube(shard);
+    copyCubeShard(shard, target, 3);
+    for (Size j = 0; j < dates.size(); ++j) {
+        BOOST_CHECK_EQUAL(target.get(1, j, 2), 0.0);
+        BOOST_CHECK_EQUAL(target.get(1, j, 3), shard.get(0, j, 0));
+        BOOST_CHECK_EQUAL(target.get(1, j, 4), shard.get(0, j, 1));
+        BOOST_CHECK_EQUAL(target.get(0, j, 3), 0.0);
+    }
+    BOOST_CHECK_THROW(copyCubeShard(shard, target, 4), std::exception);
+    DoublePrecisionInMemoryCube unknown(asof, {"t3"}, dates, 2);
+    BOOST_CHECK_THROW(copyCubeShard(unknown, target, 0), std::exception);
+
+    InMemoryAggregationScenarioData data(2, 5), dataShard(2, 2);
+    dataShard.set(1, 1, 1.5, AggregationScenarioDataType::FXSpot, "USD");
+    dataShard.set(0, 0, 0.9, AggregationScenarioDataType::Numeraire);
+    copyScenarioDataShard(dataShard, data, 3);
+    BOOST_CHECK_EQUAL(data.get(1, 4, AggregationScenarioDataType::FXSpot, "USD"), 1.5);
+    BOOST_CHECK_EQUAL(data.get(0, 3, AggregationScenarioDataType::Numeraire), 0.9);
+    BOOST_CHECK_EQUAL(data.get(0, 0, AggregationScenarioDataType::Numeraire), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(testCompressedInMemoryCube) {
+    vector<string> ids(50, string("id"));
+    Date d(1, QuantLib::Jan, 2016);
+    vector<Date> dates(20, d);
+    Size samples = 200;
+    Size depth = 2;
+    // without quantisation the cube is as accurate as a single precision cube
+    CompressedInMemoryCube c(d, ids, dates, samples, depth, 0.0, 64);
+    testCube(c, "CompressedInMemoryCube", 1e-5);
+    CompressedInMemoryCube c2(d, ids, dates, samples, depth, 0.0, 64);
+    testCubeFileIO<CompressedInMemoryCube>(c2, "CompressedInMemoryCube", 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(testCompressedCubeQuantisation) {
+    BOOST_TEST_MESSAGE("Testing quantised cube blocks against the error bound");
+    vector<string> ids = {"swap", "matured", "fixed"};
+    Date d(1, QuantLib::Jan, 2016);
+    vector<Date> dates(10, d);
+    Size samples = 500;
+    Real maxError = 0.01;
+    CompressedInMemoryCube c(d, ids, dates, samples, 1, maxError, 128);
+    NPVCube& cube = c;
+    auto value = [](Size i, Size j, Size k) {
+        if (i == 0)
+            return 100.0 * std::sin(0.37 * k + j);
+        else if (i == 1)
+            return j < 3 ? 50.0 + k : 0.0;
+        else
+            return 42.0;
+    };
+    // fill sample by sample as the valuation engine does
+    for (Size k = 0; k < samples; ++k)
+        for (Size j = 0; j < dates.size(); ++j)
+            for (Size i = 0; i < ids.size(); ++i)
+                cube.set(value(i, j, k), i, j, k);
+
+    Real error = 0.0;
+    for (Size i = 0; i < ids.size(); ++i)
+        for (Size j = 0; j < dates.size(); ++j)
+            for (Size k = 0; k < samples; ++k)
+                error = std::max(error, std::fabs(cube.get(i, j, k) - value(i, j, k)));
+    // the bound applies to the single precision values
+    BOOST_CHECK_LE(error, maxError + 1.0E-4);
+    BOOST_CHECK_GT(c.quantisationError(), 0.0);
+    BOOST_CHECK_LE(c.quantisationError(), maxError);
+    // zero and constant rows are elided, the others take 16 bits per value
+    BOOST_TEST_MESSAGE("Compression ratio " << c.compressionRatio());
+    BOOST_CHECK_GT(c.compressionRatio(), 2.0);
+
+    // overwriting a value in an encoded block keeps the other values within the bound
+    cube.set(-25.0, 0, 0, 7);
+    BOOST_CHECK_SMALL(cube.get(0, 0, 7) + 25.0, 1.0E-4);
+    error = 0.0;
+    for (Size k = 0; k < 128; ++k) {
+        if (k != 7)
+            error = std::max(error, std::fabs(cube.get(0, 0, k) - value(0, 0, k)));
+    }
+    BOOST_CHECK_LE(error, maxError + 1.0E-4);
+    BOOST_CHECK_LE(c.quantisationError(), maxError);
+
+    // partially written cubes are encoded on saving, the missing values are zero
+    CompressedInMemoryCube partial(d, ids, dates, samples, 1, maxError, 128);
+    NPVCube& p = partial;
+    p.set(1.0, 1, 2, 3);
+    string filename = boost::filesystem::unique_path().string();
+    partial.save(filename);
+    CompressedInMemoryCube loaded;
+    loaded.load(filename);
+    boost::filesystem::remove(filename);
+    NPVCube& l = loaded;
+    BOOST_CHECK_EQUAL(l.get(1, 2, 3), 1.0);
+    BOOST_CHECK_EQUAL(l.get(1, 2, 4), 0.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
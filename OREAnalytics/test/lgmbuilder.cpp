@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "testmarket.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <ored/model/lgmbuilder.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/volatility/swaption/swaptionconstantvol.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+
+using testsuite::TestMarket;
+
+namespace {
+
+// test market with a EUR swaption vol that can be changed via a quote
+class LgmBuilderTestMarket : public TestMarket {
+public:
+    LgmBuilderTestMarket(Date asof, const boost::shared_ptr<SimpleQuote>& vol) : TestMarket(asof) {
+        swaptionCurves_[make_pair(Market::defaultConfiguration, "EUR")] =
+            Handle<SwaptionVolatilityStructure>(boost::make_shared<ConstantSwaptionVolatility>(
+                asof, NullCalendar(), ModifiedFollowing, Handle<Quote>(vol), ActualActual(), ShiftedLognormal, 0.0));
+    }
+};
+
+// EUR LGM with piecewise alpha bootstrapped to coterminal swaptions
+boost::shared_ptr<IrLgmData> lgmData() {
+    vector<string> swaptionExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y"};
+    vector<string> swaptionTerms(swaptionExpiries.size(), "5Y");
+    vector<string> swaptionStrikes(swaptionExpiries.size(), "ATM");
+    return boost::make_shared<IrLgmData>("EUR", CalibrationType::Bootstrap, LgmData::ReversionType::HullWhite,
+                                         LgmData::VolatilityType::Hagan, false, ParamType::Constant, vector<Time>(),
+                                         vector<Real>(1, 0.02), true, ParamType::Piecewise, vector<Time>(),
+                                         vector<Real>(1, 0.008), 0.0, 1.0, swaptionExpiries, swaptionTerms,
+                                         swaptionStrikes);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LgmBuilderTest)
+
+BOOST_AUTO_TEST_CASE(testSkipUnchangedCalibration) {
+    BOOST_TEST_MESSAGE("Testing that LgmBuilder skips the calibration for unchanged inputs...");
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<SimpleQuote> vol = boost::make_shared<SimpleQuote>(0.20);
+    boost::shared_ptr<Market> market = boost::make_shared<LgmBuilderTestMarket>(today, vol);
+
+    LgmBuilder builder(market, lgmData(), Market::defaultConfiguration, 0.001, true);
+    Array initial = builder.model()->params();
+    BOOST_CHECK_EQUAL(builder.calibrations(), 1);
+    BOOST_CHECK_EQUAL(builder.skippedCalibrations(), 0);
+
+    // moving the vol and back notifies the builder, but leaves the calibration inputs unchanged
+    vol->setValue(0.25);
+    vol->setValue(0.20);
+    Array params = builder.model()->params();
+    BOOST_CHECK_EQUAL(builder.calibrations(), 1);
+    BOOST_CHECK_EQUAL(builder.skippedCalibrations(), 1);
+    BOOST_REQUIRE_EQUAL(params.size(), initial.size());
+    for (Size i = 0; i < params.size(); ++i)
+        BOOST_CHECK_EQUAL(params[i], initial[i]);
+
+    // a changed vol triggers a calibration
+    vol->setValue(0.22);
+    builder.model();
+    BOOST_CHECK_EQUAL(builder.calibrations(), 2);
+    BOOST_CHECK_EQUAL(builder.skippedCalibrations(), 1);
+
+    // without continueCalibration the builder always recalibrates
+    LgmBuilder plainBuilder(market, lgmData(), Market::defaultConfiguration, 0.001, false);
+    plainBuilder.model();
+    vol->setValue(0.25);
+    vol->setValue(0.22);
+    plainBuilder.model();
+    BOOST_CHECK_EQUAL(plainBuilder.calibrations(), 2);
+    BOOST_CHECK_EQUAL(plainBuilder.skippedCalibrations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testWarmStartedCalibration) {
+    BOOST_TEST_MESSAGE("Testing warm started LgmBuilder calibration against a cold calibration...");
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<SimpleQuote> vol = boost::make_shared<SimpleQuote>(0.20);
+    boost::shared_ptr<Market> market = boost::make_shared<LgmBuilderTestMarket>(today, vol);
+
+    LgmBuilder warm(market, lgmData(), Market::defaultConfiguration, 0.001, true);
+    LgmBuilder cold(market, lgmData(), Market::defaultConfiguration, 0.001, false);
+    warm.model();
+    cold.model();
+
+    Real tolerance = 1.0E-6;
+    for (Real v : {0.21, 0.23, 0.18}) {
+        vol->setValue(v);
+        Array warmParams = warm.model()->params();
+        Array coldParams = cold.model()->params();
+        BOOST_TEST_MESSAGE("vol " << v << ": warm start used " << warm.functionEvaluations()
+                                  << " function evaluations, cold start " << cold.functionEvaluations());
+        BOOST_REQUIRE_EQUAL(warmParams.size(), coldParams.size());
+        for (Size i = 0; i < warmParams.size(); ++i) {
+            BOOST_CHECK_MESSAGE(std::fabs(warmParams[i] - coldParams[i]) < tolerance,
+                                "vol " << v << ": warm started parameter #" << i << " (" << warmParams[i]
+                                       << ") differs from cold started parameter (" << coldParams[i] << ")");
+        }
+        BOOST_CHECK_SMALL(warm.error(), 0.001);
+    }
+
+    BOOST_CHECK_EQUAL(warm.calibrations(), 4);
+    BOOST_CHECK_EQUAL(cold.calibrations(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,239 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <orea/app/oreserver.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// EUR and USD discount curves read from discount factors, the EURUSD spot and an empty portfolio
+const map<string, string> serverInput = {
+    {"ore.xml", "<ORE><Setup>"
+                "<Parameter name=\"asofDate\">2019-04-17</Parameter>"
+                "<Parameter name=\"inputPath\">{dir}</Parameter>"
+                "<Parameter name=\"outputPath\">{dir}</Parameter>"
+                "<Parameter name=\"logFile\">log.txt</Parameter>"
+                "<Parameter name=\"marketDataFile\">market.txt</Parameter>"
+                "<Parameter name=\"fixingDataFile\">fixings.txt</Parameter>"
+                "<Parameter name=\"implyTodaysFixings\">N</Parameter>"
+                "<Parameter name=\"curveConfigFile\">curveconfig.xml</Parameter>"
+                "<Parameter name=\"conventionsFile\">conventions.xml</Parameter>"
+                "<Parameter name=\"marketConfigFile\">todaysmarket.xml</Parameter>"
+                "<Parameter name=\"pricingEnginesFile\">pricingengine.xml</Parameter>"
+                "<Parameter name=\"portfolioFile\"></Parameter>"
+                "</Setup><Markets>"
+                "<Parameter name=\"lgmcalibration\">default</Parameter>"
+                "<Parameter name=\"fxcalibration\">default</Parameter>"
+                "<Parameter name=\"pricing\">default</Parameter>"
+                "</Markets></ORE>"},
+    {"market.txt", "20190417 DISCOUNT/RATE/EUR/EUR-DISC/1Y 0.99\n"
+                   "20190417 DISCOUNT/RATE/EUR/EUR-DISC/2Y 0.98\n"
+                   "20190417 DISCOUNT/RATE/USD/USD-DISC/1Y 0.97\n"
+                   "20190417 DISCOUNT/RATE/USD/USD-DISC/2Y 0.94\n"
+                   "20190417 FX/RATE/EUR/USD 1.2\n"},
+    {"fixings.txt", ""},
+    {"conventions.xml", "<Conventions/>"},
+    {"curveconfig.xml", "<CurveConfiguration><YieldCurves>"
+                        "<YieldCurve><CurveId>EUR-DISC</CurveId><CurveDescription/><Currency>EUR</Currency>"
+                        "<DiscountCurve/><Segments><Direct><Type>Discount</Type><Quotes>"
+                        "<Quote>DISCOUNT/RATE/EUR/EUR-DISC/1Y</Quote><Quote>DISCOUNT/RATE/EUR/EUR-DISC/2Y</Quote>"
+                        "</Quotes></Direct></Segments></YieldCurve>"
+                        "<YieldCurve><CurveId>USD-DISC</CurveId><CurveDescription/><Currency>USD</Currency>"
+                        "<DiscountCurve/><Segments><Direct><Type>Discount</Type><Quotes>"
+                        "<Quote>DISCOUNT/RATE/USD/USD-DISC/1Y</Quote><Quote>DISCOUNT/RATE/USD/USD-DISC/2Y</Quote>"
+                        "</Quotes></Direct></Segments></YieldCurve>"
+                        "</YieldCurves></CurveConfiguration>"},
+    {"todaysmarket.xml", "<TodaysMarket><DiscountingCurves id=\"default\">"
+                         "<DiscountingCurve currency=\"EUR\">Yield/EUR/EUR-DISC</DiscountingCurve>"
+                         "<DiscountingCurve currency=\"USD\">Yield/USD/USD-DISC</DiscountingCurve>"
+                         "</DiscountingCurves><FxSpots id=\"default\">"
+                         "<FxSpot pair=\"EURUSD\">FX/EUR/USD</FxSpot>"
+                         "</FxSpots></TodaysMarket>"},
+    {"pricingengine.xml", "<PricingEngines><Product type=\"FxForward\"><Model>DiscountedCashflows</Model>"
+                          "<ModelParameters/><Engine>DiscountingFxForwardEngine</Engine><EngineParameters/>"
+                          "</Product></PricingEngines>"}};
+
+// buy EUR 1m against USD 1.1m on the 1Y pillar of the discount curves
+const string fxForward = "<Portfolio><Trade id=\"FXFWD\"><TradeType>FxForward</TradeType><Envelope>"
+                         "<CounterParty>CPTY_A</CounterParty><NettingSetId>CPTY_A</NettingSetId><AdditionalFields/>"
+                         "</Envelope><FxForwardData><ValueDate>2020-04-17</ValueDate>"
+                         "<BoughtCurrency>EUR</BoughtCurrency><BoughtAmount>1000000</BoughtAmount>"
+                         "<SoldCurrency>USD</SoldCurrency><SoldAmount>1100000</SoldAmount>"
+                         "</FxForwardData></Trade></Portfolio>";
+
+// writes the server input to a temporary directory and removes it again
+class ServerInput {
+public:
+    ServerInput() : dir_(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()) {
+        boost::filesystem::create_directories(dir_);
+        for (auto const& f : serverInput) {
+            string content = f.second;
+            boost::replace_all(content, "{dir}", dir_.string());
+            ofstream((dir_ / f.first).string()) << content;
+        }
+    }
+    ~ServerInput() { boost::filesystem::remove_all(dir_); }
+    boost::shared_ptr<Parameters> parameters() const {
+        auto params = boost::make_shared<Parameters>();
+        params->fromFile((dir_ / "ore.xml").string());
+        return params;
+    }
+
+private:
+    boost::filesystem::path dir_;
+};
+
+// gives access to the market, so that the tests can tell whether it was rebuilt
+class TestServer : public OREServer {
+public:
+    TestServer(const boost::shared_ptr<Parameters>& params, ostream& out) : OREServer(params, out) {}
+    const boost::shared_ptr<Market>& market() const { return market_; }
+};
+
+// the reply to a single request
+string reply(OREServer& server, const string& request) {
+    ostringstream out;
+    server.process(request, out);
+    return out.str();
+}
+
+// whether the reply is a single error line with the given message
+bool isError(const string& reply, const string& message) {
+    return boost::starts_with(reply, "ERROR ") && boost::ends_with(reply, message + "\n") &&
+           reply.find('\n') == reply.size() - 1;
+}
+
+// the NPV of the given trade
+Real npv(OREServer& server, const string& id) {
+    istringstream in(reply(server, "npv " + id));
+    string tradeId, currency, status;
+    Real value = Null<Real>();
+    in >> tradeId >> currency >> value >> status;
+    BOOST_REQUIRE_EQUAL(status, "OK");
+    BOOST_CHECK_EQUAL(tradeId, id);
+    BOOST_CHECK_EQUAL(currency, "USD");
+    return value;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(OREServerTest)
+
+BOOST_AUTO_TEST_CASE(testReplies) {
+    BOOST_TEST_MESSAGE("Testing the replies of the ORE server...");
+
+    ServerInput input;
+    ostringstream log;
+    TestServer server(input.parameters(), log);
+    istringstream noRequests("");
+    ostringstream initialised;
+    BOOST_REQUIRE_EQUAL(server.serve(noRequests, initialised), 0);
+    BOOST_CHECK_EQUAL(initialised.str(), "OK\n");
+
+    BOOST_CHECK(isError(reply(server, "price"), "unknown request price"));
+    BOOST_CHECK(isError(reply(server, "quote FX/RATE/EUR/USD"), "usage: quote <name> <value>"));
+    BOOST_CHECK(isError(reply(server, "npv FXFWD"), "trade FXFWD not found"));
+    BOOST_CHECK_EQUAL(reply(server, "add " + fxForward), "FXFWD\nOK\n");
+    BOOST_CHECK_EQUAL(reply(server, "add " + fxForward), "FXFWD\nOK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.2 - 1.1E6 * 0.97, 1.0E-8);
+    BOOST_CHECK_EQUAL(reply(server, "remove FXFWD"), "OK\n");
+    BOOST_CHECK(isError(reply(server, "remove FXFWD"), "trade FXFWD not found"));
+
+    // the reply to quit is sent before the server stops
+    ostringstream out;
+    BOOST_CHECK(!server.process("quit", out));
+    BOOST_CHECK_EQUAL(out.str(), "OK\n");
+}
+
+BOOST_AUTO_TEST_CASE(testQuoteUpdates) {
+    BOOST_TEST_MESSAGE("Testing quote updates in the ORE server...");
+
+    ServerInput input;
+    ostringstream log;
+    TestServer server(input.parameters(), log);
+    istringstream noRequests("");
+    ostringstream initialised;
+    BOOST_REQUIRE_EQUAL(server.serve(noRequests, initialised), 0);
+    BOOST_REQUIRE_EQUAL(reply(server, "add " + fxForward), "FXFWD\nOK\n");
+    boost::shared_ptr<Market> market = server.market();
+
+    // the FX spot is updated in place and reaches the trade through the observers
+    BOOST_CHECK_EQUAL(reply(server, "quote FX/RATE/EUR/USD 1.25"), "OK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.25 - 1.1E6 * 0.97, 1.0E-8);
+    BOOST_CHECK(server.market() == market);
+
+    // the discount factors are copied into the curve, the market is rebuilt before the next valuation
+    BOOST_CHECK_EQUAL(reply(server, "quote DISCOUNT/RATE/USD/USD-DISC/1Y 0.96"), "OK\n");
+    BOOST_CHECK(server.market() == market);
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.25 - 1.1E6 * 0.96, 1.0E-8);
+    BOOST_CHECK(server.market() != market);
+    market = server.market();
+
+    // the rebuilt market keeps following the FX spot
+    BOOST_CHECK_EQUAL(reply(server, "quote FX/RATE/EUR/USD 1.15"), "OK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.15 - 1.1E6 * 0.96, 1.0E-8);
+    BOOST_CHECK(server.market() == market);
+
+    // a new quote may complete a curve, so that it triggers a rebuild
+    BOOST_CHECK_EQUAL(reply(server, "quote FX/RATE/EUR/GBP 0.85"), "OK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.15 - 1.1E6 * 0.96, 1.0E-8);
+    BOOST_CHECK(server.market() != market);
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyPortfolio) {
+    BOOST_TEST_MESSAGE("Testing market rebuilds in the ORE server without trades...");
+
+    ServerInput input;
+    ostringstream log;
+    TestServer server(input.parameters(), log);
+    istringstream noRequests("");
+    ostringstream initialised;
+    BOOST_REQUIRE_EQUAL(server.serve(noRequests, initialised), 0);
+
+    // a rebuild with an empty portfolio leaves the server usable
+    BOOST_CHECK_EQUAL(reply(server, "quote DISCOUNT/RATE/USD/USD-DISC/1Y 0.96"), "OK\n");
+    BOOST_CHECK_EQUAL(reply(server, "npv"), "OK\n");
+    BOOST_CHECK_EQUAL(reply(server, "add " + fxForward), "FXFWD\nOK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.2 - 1.1E6 * 0.96, 1.0E-8);
+
+    // also after the last trade was removed, and the trades added later are valued against the rebuilt market
+    BOOST_CHECK_EQUAL(reply(server, "remove FXFWD"), "OK\n");
+    BOOST_CHECK_EQUAL(reply(server, "quote DISCOUNT/RATE/USD/USD-DISC/1Y 0.95"), "OK\n");
+    BOOST_CHECK_EQUAL(reply(server, "npv"), "OK\n");
+    BOOST_CHECK_EQUAL(reply(server, "add " + fxForward), "FXFWD\nOK\n");
+    BOOST_CHECK_EQUAL(reply(server, "quote DISCOUNT/RATE/USD/USD-DISC/1Y 0.94"), "OK\n");
+    BOOST_CHECK_CLOSE(npv(server, "FXFWD"), 1.0E6 * 0.99 * 1.2 - 1.1E6 * 0.94, 1.0E-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,8 +16,10 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <test/oreatoplevelfixture.hpp>
+#include <orea/scenario/binaryscenariostore.hpp>
 #include <orea/scenario/crossassetmodelscenariogenerator.hpp>
 #include <orea/scenario/lgmscenariogenerator.hpp>
 #include <orea/scenario/scenariogeneratorbuilder.hpp>
@@ -438,6 +440,73 @@ void test_crossasset(bool sobol, bool antithetic, bool brownianBridge) {
     BOOST_TEST_MESSAGE("Simulation time " << elapsed);
 }
 
+BOOST_AUTO_TEST_CASE(testBinaryScenarioStore) {
+    BOOST_TEST_MESSAGE("Testing BinaryScenarioWriter and BinaryScenarioGenerator...");
+
+    TestData d;
+    std::vector<Period> tenorGrid = {1 * Years, 2 * Years, 5 * Years};
+    ore::analytics::DateGrid grid(tenorGrid);
+    boost::shared_ptr<ScenarioSimMarketParameters> simMarketConfig(new ScenarioSimMarketParameters);
+    simMarketConfig->setYieldCurveTenors("", {6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years});
+    simMarketConfig->setSimulateFXVols(false);
+    simMarketConfig->setSimulateEquityVols(false);
+    simMarketConfig->setYieldCurveDayCounters("", "ACT/ACT");
+    boost::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGen =
+        boost::make_shared<MultiPathGeneratorMersenneTwister>(d.lgm->stateProcess(), grid.timeGrid(), 42, false);
+    boost::shared_ptr<ScenarioFactory> scenarioFactory(new SimpleScenarioFactory);
+    boost::shared_ptr<ScenarioGenerator> scenGen = boost::make_shared<LgmScenarioGenerator>(
+        d.lgm, pathGen, scenarioFactory, simMarketConfig, d.referenceDate, grid);
+
+    Size samples = 50;
+    string filename = boost::filesystem::unique_path().string();
+    string floatFilename = boost::filesystem::unique_path().string();
+    vector<boost::shared_ptr<Scenario>> generated;
+    {
+        BinaryScenarioWriter writer(scenGen, filename);
+        for (Size i = 0; i < samples; ++i)
+            for (auto const& date : grid.dates())
+                generated.push_back(writer.next(date));
+        // the reset generator reproduces the paths, stored in single precision this time
+        writer.reset();
+        BinaryScenarioWriter floatWriter(scenGen, floatFilename, true);
+        for (Size i = 0; i < samples; ++i)
+            for (auto const& date : grid.dates())
+                floatWriter.next(date);
+    }
+
+    BinaryScenarioGenerator replay(filename, scenarioFactory);
+    BinaryScenarioGenerator floatReplay(floatFilename, scenarioFactory);
+    BOOST_CHECK_EQUAL(replay.samples(), samples);
+    BOOST_CHECK(replay.dates() == grid.dates());
+    BOOST_CHECK(!replay.singlePrecision());
+    BOOST_CHECK(floatReplay.singlePrecision());
+
+    // replay twice to check the reset
+    for (Size pass = 0; pass < 2; ++pass) {
+        Size n = 0;
+        for (Size i = 0; i < samples; ++i) {
+            for (auto const& date : grid.dates()) {
+                boost::shared_ptr<Scenario> s = replay.next(date), f = floatReplay.next(date), g = generated[n++];
+                BOOST_CHECK_EQUAL(s->asof(), g->asof());
+                BOOST_CHECK_EQUAL(s->getNumeraire(), g->getNumeraire());
+                BOOST_CHECK_EQUAL(f->getNumeraire(), g->getNumeraire());
+                BOOST_REQUIRE_EQUAL(s->keys().size(), g->keys().size());
+                for (auto const& k : g->keys()) {
+                    BOOST_CHECK_EQUAL(s->get(k), g->get(k));
+                    BOOST_CHECK_CLOSE(f->get(k), g->get(k), 1e-4);
+                }
+            }
+        }
+        BOOST_CHECK_THROW(replay.next(grid.dates().front()), std::exception);
+        replay.reset();
+        floatReplay.reset();
+    }
+    BOOST_CHECK_THROW(replay.next(grid.dates()[1]), std::exception);
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(floatFilename);
+}
+
 BOOST_AUTO_TEST_CASE(testCrossAssetMersenneTwister) {
     BOOST_TEST_MESSAGE("Testing CrossAssetScenarioGenerator with MersenneTwister...");
     test_crossasset(false, false, false);
@@ -18,7 +18,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include <test/oreatoplevelfixture.hpp>
+#include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketcache.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <ored/configuration/conventions.hpp>
 #include <ored/marketdata/market.hpp>
@@ -99,6 +102,37 @@ boost::shared_ptr<analytics::ScenarioSimMarketParameters> scenarioParameters() {
     parameters->setCorrelationPairs({"EUR-CMS-10Y:EUR-CMS-1Y", "USD-CMS-10Y:USD-CMS-1Y"});
     return parameters;
 }
+
+// returns a fixed sequence of scenarios
+class ScenarioSequence : public analytics::ScenarioGenerator {
+public:
+    ScenarioSequence(const vector<boost::shared_ptr<analytics::Scenario>>& scenarios)
+        : scenarios_(scenarios), counter_(0) {}
+    boost::shared_ptr<analytics::Scenario> next(const Date&) override { return scenarios_.at(counter_++); }
+    void reset() override { counter_ = 0; }
+
+private:
+    vector<boost::shared_ptr<analytics::Scenario>> scenarios_;
+    Size counter_;
+};
+
+// build a sequence of scenarios shifting a few points each
+vector<boost::shared_ptr<analytics::Scenario>> shiftedScenarios(const analytics::ScenarioFactory& factory,
+                                                                const boost::shared_ptr<analytics::Scenario>& base) {
+    using analytics::RiskFactorKey;
+    RiskFactorKey eur0(RiskFactorKey::KeyType::DiscountCurve, "EUR", 0);
+    RiskFactorKey eur1(RiskFactorKey::KeyType::DiscountCurve, "EUR", 1);
+    RiskFactorKey usd2(RiskFactorKey::KeyType::DiscountCurve, "USD", 2);
+    RiskFactorKey fx(RiskFactorKey::KeyType::FXSpot, "USDEUR");
+    vector<vector<RiskFactorKey>> shifts = {{eur0, eur1}, {usd2, fx}, {}, {eur0}, {eur1, usd2}};
+    vector<boost::shared_ptr<analytics::Scenario>> scenarios;
+    for (auto const& keys : shifts) {
+        scenarios.push_back(factory.buildScenario(base->asof()));
+        for (auto const& k : keys)
+            scenarios.back()->add(k, base->get(k) * 1.01);
+    }
+    return scenarios;
+}
 } // namespace
 
 void testFxSpot(boost::shared_ptr<ore::data::Market>& initMarket,
@@ -311,6 +345,92 @@ BOOST_AUTO_TEST_CASE(testScenarioSimMarket) {
     testToXML(parameters);
 }
 
+BOOST_AUTO_TEST_CASE(testDeltaScenarios) {
+    BOOST_TEST_MESSAGE("Testing ScenarioSimMarket with delta scenarios against cloned scenarios...");
+
+    SavedSettings backup;
+
+    Date today(20, Jan, 2015);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<TestMarket>(today);
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> parameters = scenarioParameters();
+    Conventions conventions = *convs();
+
+    boost::shared_ptr<analytics::ScenarioSimMarket> deltaMarket =
+        boost::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters, conventions);
+    boost::shared_ptr<analytics::ScenarioSimMarket> cloneMarket =
+        boost::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters, conventions);
+    vector<boost::shared_ptr<analytics::Scenario>> deltaScenarios = shiftedScenarios(
+        analytics::DeltaScenarioFactory(deltaMarket->baseScenario()), deltaMarket->baseScenario());
+    vector<boost::shared_ptr<analytics::Scenario>> cloneScenarios = shiftedScenarios(
+        analytics::CloneScenarioFactory(cloneMarket->baseScenario()), cloneMarket->baseScenario());
+    deltaMarket->scenarioGenerator() = boost::make_shared<ScenarioSequence>(deltaScenarios);
+    cloneMarket->scenarioGenerator() = boost::make_shared<ScenarioSequence>(cloneScenarios);
+
+    for (Size i = 0; i < deltaScenarios.size(); ++i) {
+        BOOST_CHECK_EQUAL(deltaScenarios[i]->keys().size(), cloneScenarios[i]->keys().size());
+        for (auto const& k : cloneScenarios[i]->keys())
+            BOOST_CHECK_EQUAL(deltaScenarios[i]->get(k), cloneScenarios[i]->get(k));
+        deltaMarket->update(today);
+        cloneMarket->update(today);
+        for (auto const& ccy : {"EUR", "USD"}) {
+            for (Time t : {0.25, 0.75, 1.5, 3.0})
+                BOOST_CHECK_EQUAL(deltaMarket->discountCurve(ccy)->discount(t),
+                                  cloneMarket->discountCurve(ccy)->discount(t));
+        }
+        BOOST_CHECK_EQUAL(deltaMarket->fxSpot("USDEUR")->value(), cloneMarket->fxSpot("USDEUR")->value());
+    }
+
+    // after a reset the delta market is back to the base state
+    deltaMarket->reset();
+    for (Time t : {0.25, 0.75, 1.5, 3.0})
+        BOOST_CHECK_EQUAL(deltaMarket->discountCurve("EUR")->discount(t),
+                          initMarket->discountCurve("EUR")->discount(t));
+}
+
+BOOST_AUTO_TEST_CASE(testScenarioSimMarketCache) {
+    BOOST_TEST_MESSAGE("Testing reuse of ScenarioSimMarket instances across runs...");
+
+    SavedSettings backup;
+
+    Date today(20, Jan, 2015);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<TestMarket>(today);
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> parameters = scenarioParameters();
+    Conventions conventions = *convs();
+
+    analytics::ScenarioSimMarketCache& cache = analytics::ScenarioSimMarketCache::instance();
+    cache.clear();
+    cache.setEnabled(true);
+
+    // first run, move the market away from its base scenario
+    boost::shared_ptr<analytics::ScenarioSimMarket> first = cache.simMarket(initMarket, parameters, conventions);
+    vector<boost::shared_ptr<analytics::Scenario>> scenarios = shiftedScenarios(
+        analytics::DeltaScenarioFactory(first->baseScenario()), first->baseScenario());
+    first->scenarioGenerator() = boost::make_shared<ScenarioSequence>(scenarios);
+    first->update(today);
+    BOOST_CHECK(first->discountCurve("EUR")->discount(1.5) != initMarket->discountCurve("EUR")->discount(1.5));
+
+    // second run with equal parameters gets the same market back in its base state
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> sameParameters = scenarioParameters();
+    boost::shared_ptr<analytics::ScenarioSimMarket> second = cache.simMarket(initMarket, sameParameters, conventions);
+    BOOST_CHECK(second == first);
+    BOOST_CHECK(!second->scenarioGenerator());
+    for (Time t : {0.25, 0.75, 1.5, 3.0})
+        BOOST_CHECK_EQUAL(second->discountCurve("EUR")->discount(t), initMarket->discountCurve("EUR")->discount(t));
+
+    // different parameters require a new market
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> otherParameters = scenarioParameters();
+    otherParameters->setYieldCurveTenors("", {1 * Years, 2 * Years, 5 * Years});
+    BOOST_CHECK(cache.simMarket(initMarket, otherParameters, conventions) != first);
+
+    BOOST_CHECK_EQUAL(cache.hits(), 1UL);
+    BOOST_CHECK_EQUAL(cache.misses(), 2UL);
+
+    cache.clear();
+    cache.setEnabled(false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
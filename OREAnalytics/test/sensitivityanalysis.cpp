@@ -1601,9 +1601,10 @@ BOOST_AUTO_TEST_CASE(testFxOptionDeltaGamma) {
     IndexManager::instance().clearHistories();
 }
 
-BOOST_AUTO_TEST_CASE(testCrossGamma) {
+void checkCrossGamma(bool pruneCrossGamma) {
 
-    BOOST_TEST_MESSAGE("Testing cross-gamma sensitivities against cached results");
+    BOOST_TEST_MESSAGE("Testing cross-gamma sensitivities against cached results (pruneCrossGamma = "
+                       << std::boolalpha << pruneCrossGamma << ")");
 
     SavedSettings backup;
 
@@ -1734,6 +1735,7 @@ BOOST_AUTO_TEST_CASE(testCrossGamma) {
     boost::shared_ptr<SensitivityAnalysis> sa =
         boost::make_shared<SensitivityAnalysis>(portfolio, initMarket, Market::defaultConfiguration, data,
                                                 simMarketData, sensiData, conventions, useOriginalFxForBaseCcyConv);
+    sa->pruneCrossGamma(pruneCrossGamma);
     sa->generateSensitivities();
 
     std::vector<ore::analytics::SensitivityScenarioGenerator::ScenarioDescription> scenDesc =
@@ -2005,6 +2007,11 @@ BOOST_AUTO_TEST_CASE(testCrossGamma) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testCrossGamma) { checkCrossGamma(false); }
+
+// trades not sensitive to both factors of a pair are not revalued, the cross gammas must not change
+BOOST_AUTO_TEST_CASE(testCrossGammaPruned) { checkCrossGamma(true); }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
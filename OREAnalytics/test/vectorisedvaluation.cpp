@@ -0,0 +1,465 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/cubemerge.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/observationmode.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/crossassetmodelscenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/lgmdata.hpp>
+#include <ored/portfolio/builders/fxforward.hpp>
+#include <ored/portfolio/builders/fxoption.hpp>
+#include <ored/portfolio/builders/swap.hpp>
+#include <ored/portfolio/builders/swaption.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/to_string.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/pricingengines/numericlgmswaptionengine.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::TestConfigurationObjects;
+using testsuite::TestMarket;
+
+namespace {
+
+// build an EUR / USD cross asset model and a sim market driven by it
+boost::shared_ptr<ScenarioSimMarket> buildSimMarket(const boost::shared_ptr<DateGrid>& dg,
+                                                    boost::shared_ptr<QuantExt::CrossAssetModel>& model) {
+    Date today = Settings::instance().evaluationDate();
+    boost::shared_ptr<Market> initMarket = boost::make_shared<TestMarket>(today);
+
+    // sim market parameters
+    boost::shared_ptr<ScenarioSimMarketParameters> parameters(new ScenarioSimMarketParameters());
+    parameters->baseCcy() = "EUR";
+    parameters->setDiscountCurveNames({"EUR", "USD"});
+    parameters->setYieldCurveTenors("",
+                                    {1 * Months, 6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years, 20 * Years});
+    parameters->setIndices({"EUR-EURIBOR-6M", "USD-LIBOR-3M"});
+    parameters->interpolation() = "LogLinear";
+    parameters->extrapolate() = true;
+    parameters->swapVolTerms() = {6 * Months, 1 * Years};
+    parameters->swapVolExpiries() = {1 * Years, 2 * Years};
+    parameters->setSwapVolCcys({"EUR", "USD"});
+    parameters->swapVolDecayMode() = "ForwardVariance";
+    parameters->setSimulateSwapVols(false);
+    parameters->fxVolExpiries() = {1 * Months, 3 * Months, 6 * Months, 2 * Years, 3 * Years, 4 * Years, 5 * Years};
+    parameters->fxVolDecayMode() = "ConstantVariance";
+    parameters->setSimulateFXVols(false);
+    parameters->setFxVolCcyPairs({"USDEUR"});
+    parameters->setFxCcyPairs({"USDEUR"});
+    parameters->setYieldCurveDayCounters("", "ACT/ACT");
+    parameters->swapIndices()["EUR-CMS-2Y"] = "EUR-EURIBOR-6M";
+    parameters->swapIndices()["EUR-CMS-30Y"] = "EUR-EURIBOR-6M";
+
+    // cross asset model
+    vector<string> swaptionExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y", "15Y", "20Y", "30Y"};
+    vector<string> swaptionTerms(swaptionExpiries.size(), "5Y");
+    vector<string> swaptionStrikes(swaptionExpiries.size(), "ATM");
+    vector<boost::shared_ptr<IrLgmData>> irConfigs;
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "EUR", CalibrationType::Bootstrap, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+        ParamType::Constant, vector<Time>(), vector<Real>(1, 0.02), true, ParamType::Piecewise, vector<Time>(),
+        vector<Real>(1, 0.008), 0.0, 1.0, swaptionExpiries, swaptionTerms, swaptionStrikes));
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "USD", CalibrationType::Bootstrap, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+        ParamType::Constant, vector<Time>(), vector<Real>(1, 0.03), true, ParamType::Piecewise, vector<Time>(),
+        vector<Real>(1, 0.009), 0.0, 1.0, swaptionExpiries, swaptionTerms, swaptionStrikes));
+    vector<string> optionExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y"};
+    vector<string> optionStrikes(optionExpiries.size(), "ATMF");
+    vector<boost::shared_ptr<FxBsData>> fxConfigs;
+    fxConfigs.push_back(boost::make_shared<FxBsData>("USD", "EUR", CalibrationType::Bootstrap, true,
+                                                     ParamType::Piecewise, vector<Time>(), vector<Real>(1, 0.15),
+                                                     optionExpiries, optionStrikes));
+    map<pair<string, string>, Real> corr;
+    corr[make_pair("IR:EUR", "IR:USD")] = 0.6;
+    boost::shared_ptr<CrossAssetModelData> config =
+        boost::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, corr);
+    model = CrossAssetModelBuilder(initMarket).build(config);
+
+    // sim market and scenario generator, the seed is fixed so both runs see the same scenarios
+    boost::shared_ptr<MultiPathGeneratorBase> pathGen =
+        boost::make_shared<MultiPathGeneratorMersenneTwister>(model->stateProcess(), dg->timeGrid(), 42, false);
+    boost::shared_ptr<ScenarioSimMarket> simMarket =
+        boost::make_shared<ScenarioSimMarket>(initMarket, parameters, *TestConfigurationObjects::conv());
+    simMarket->scenarioGenerator() = boost::make_shared<CrossAssetModelScenarioGenerator>(
+        model, pathGen, boost::make_shared<SimpleScenarioFactory>(), parameters, today, dg, initMarket);
+    return simMarket;
+}
+
+// small EUR / USD portfolio of swaps, FX options and an FX forward
+boost::shared_ptr<Portfolio> buildPortfolio(const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
+    Date today = Settings::instance().evaluationDate();
+    boost::shared_ptr<EngineData> data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("FxForward") = "DiscountedCashflows";
+    data->engine("FxForward") = "DiscountingFxForwardEngine";
+    data->model("FxOption") = "GarmanKohlhagen";
+    data->engine("FxOption") = "AnalyticEuropeanEngine";
+    boost::shared_ptr<EngineFactory> factory = boost::make_shared<EngineFactory>(data, simMarket);
+    factory->registerBuilder(boost::make_shared<SwapEngineBuilder>());
+    factory->registerBuilder(boost::make_shared<FxForwardEngineBuilder>());
+    factory->registerBuilder(boost::make_shared<FxOptionEngineBuilder>());
+
+    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildSwap("EUR_SWAP", "EUR", true, 10000000.0, 0, 10, 0.02, 0.0, "1Y", "30/360", "6M",
+                                        "A360", "EUR-EURIBOR-6M"));
+    portfolio->add(testsuite::buildSwap("EUR_SWAP_2", "EUR", false, 5000000.0, 0, 10, 0.021, 0.0, "1Y", "30/360",
+                                        "6M", "A360", "EUR-EURIBOR-6M"));
+    portfolio->add(testsuite::buildSwap("USD_SWAP", "USD", false, 10000000.0, 1, 5, 0.025, 0.001, "6M", "30/360",
+                                        "3M", "A360", "USD-LIBOR-3M"));
+    portfolio->add(testsuite::buildFxOption("FX_CALL", "Long", "Call", 3, "USD", 10000000.0, "EUR", 9000000.0));
+    portfolio->add(testsuite::buildFxOption("FX_PUT", "Short", "Put", 1, "USD", 10000000.0, "EUR", 8000000.0));
+    Envelope env("CP");
+    boost::shared_ptr<Trade> fxForward = boost::make_shared<ore::data::FxForward>(
+        env, ore::data::to_string(today + 2 * Years), "USD", 10000000.0, "EUR", 8500000.0);
+    fxForward->id() = "FX_FWD";
+    portfolio->add(fxForward);
+    portfolio->build(factory);
+    return portfolio;
+}
+
+// build the NPV cube for a small EUR / USD portfolio, with or without vectorised valuation
+boost::shared_ptr<NPVCube> buildCube(const string& dateGridString, Size samples, bool vectorised, bool compressed,
+                                     vector<string>& ids, Size firstSample = 0) {
+    Date today = Settings::instance().evaluationDate();
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>(dateGridString);
+    boost::shared_ptr<QuantExt::CrossAssetModel> model;
+    boost::shared_ptr<ScenarioSimMarket> simMarket = buildSimMarket(dg, model);
+
+    boost::shared_ptr<Portfolio> portfolio = buildPortfolio(simMarket);
+    ids = portfolio->ids();
+
+    // cube
+    boost::shared_ptr<NPVCube> cube =
+        boost::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dg->dates(), samples);
+    vector<boost::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(boost::make_shared<NPVCalculator>("EUR"));
+    ValuationEngine engine(today, dg, simMarket);
+    if (vectorised)
+        engine.enableVectorisedValuation();
+    if (compressed)
+        engine.enableLinearBookCompression();
+    engine.setFirstSample(firstSample);
+    engine.buildCube(portfolio, cube, calculators);
+    return cube;
+}
+
+// AMC exposure of a physically settled Bermudan swaption, the mean of the deflated NPVs at a simulation date before
+// the first exercise must reproduce the t0 price of the swaption in the EUR LGM component of the cross asset model
+void checkAmcBermudanSwaption(const string& settlement) {
+    Date today = Settings::instance().evaluationDate();
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>("10,1Y");
+    boost::shared_ptr<QuantExt::CrossAssetModel> model;
+    boost::shared_ptr<ScenarioSimMarket> simMarket = buildSimMarket(dg, model);
+
+    boost::shared_ptr<EngineData> data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("BermudanSwaption") = "LGM";
+    data->modelParameters("BermudanSwaption")["Calibration"] = "Bootstrap";
+    data->modelParameters("BermudanSwaption")["CalibrationStrategy"] = "CoterminalATM";
+    data->modelParameters("BermudanSwaption")["Reversion"] = "0.02";
+    data->modelParameters("BermudanSwaption")["ReversionType"] = "HullWhite";
+    data->modelParameters("BermudanSwaption")["Volatility"] = "0.008";
+    data->modelParameters("BermudanSwaption")["VolatilityType"] = "Hagan";
+    data->modelParameters("BermudanSwaption")["Tolerance"] = "0.0001";
+    data->engine("BermudanSwaption") = "Grid";
+    data->engineParameters("BermudanSwaption")["sy"] = "3.0";
+    data->engineParameters("BermudanSwaption")["ny"] = "10";
+    data->engineParameters("BermudanSwaption")["sx"] = "3.0";
+    data->engineParameters("BermudanSwaption")["nx"] = "10";
+    boost::shared_ptr<EngineFactory> factory = boost::make_shared<EngineFactory>(data, simMarket);
+    factory->registerBuilder(boost::make_shared<SwapEngineBuilder>());
+    factory->registerBuilder(boost::make_shared<LGMGridBermudanSwaptionEngineBuilder>());
+
+    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildBermudanSwaption("BERMUDAN", "Long", "EUR", true, 10000000.0, 5, 2, 8, 0.02, 0.0,
+                                                    "1Y", "30/360", "6M", "A360", "EUR-EURIBOR-6M", settlement));
+    portfolio->build(factory);
+    BOOST_REQUIRE_EQUAL(portfolio->size(), 1);
+
+    Size samples = 2000;
+    boost::shared_ptr<NPVCube> cube =
+        boost::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dg->dates(), samples);
+    vector<boost::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(boost::make_shared<NPVCalculator>("EUR"));
+    ValuationEngine engine(today, dg, simMarket);
+    AmcParameters amcParameters;
+    amcParameters.trainingSamples = 5000;
+    engine.enableAmcValuation(amcParameters);
+    engine.buildCube(portfolio, cube, calculators);
+
+    // reference price in the cross asset model's EUR LGM
+    boost::shared_ptr<QuantLib::Swaption> swaption =
+        boost::dynamic_pointer_cast<QuantLib::Swaption>(portfolio->trades().front()->instrument()->qlInstrument());
+    BOOST_REQUIRE(swaption);
+    swaption->setPricingEngine(boost::make_shared<NumericLgmSwaptionEngine>(model->lgm(0), 7.0, 16, 7.0, 32));
+    Real reference = swaption->NPV();
+
+    // statistics of the deflated NPVs at the first simulation date (1Y, the first exercise is in 2Y)
+    Real sum = 0.0, sum2 = 0.0;
+    for (Size k = 0; k < samples; ++k) {
+        Real v = cube->get(0, 0, k);
+        BOOST_CHECK(v >= 0.0);
+        sum += v;
+        sum2 += v * v;
+    }
+    Real mean = sum / samples;
+    Real error = std::sqrt((sum2 / samples - mean * mean) / samples);
+    BOOST_TEST_MESSAGE("AMC Bermudan swaption (" << settlement << "): mean " << mean << " +- " << error
+                                                 << ", reference " << reference);
+    // allow for the Monte Carlo error and the low bias of the regression based exercise strategy
+    BOOST_CHECK_SMALL(mean - reference, 4.0 * error + 0.02 * reference);
+}
+
+// forwards to a calculator without calling its init(), so that everything is resolved on the fly
+class NoInitCalculator : public ValuationCalculator {
+public:
+    NoInitCalculator(const boost::shared_ptr<ValuationCalculator>& calc) : calc_(calc) {}
+    void calculate(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
+                   const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube,
+                   const Date& date, Size dateIndex, Size sample) override {
+        calc_->calculate(trade, tradeIndex, simMarket, outputCube, date, dateIndex, sample);
+    }
+    void calculateT0(const boost::shared_ptr<Trade>& trade, Size tradeIndex,
+                     const boost::shared_ptr<SimMarket>& simMarket, boost::shared_ptr<NPVCube>& outputCube) override {
+        calc_->calculateT0(trade, tradeIndex, simMarket, outputCube);
+    }
+
+private:
+    boost::shared_ptr<ValuationCalculator> calc_;
+};
+
+// NPV and cashflow cube, with or without the calculators' per trade setup
+boost::shared_ptr<NPVCube> buildFlowCube(const string& dateGridString, Size samples, bool preResolved) {
+    Date today = Settings::instance().evaluationDate();
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>(dateGridString);
+    boost::shared_ptr<QuantExt::CrossAssetModel> model;
+    boost::shared_ptr<ScenarioSimMarket> simMarket = buildSimMarket(dg, model);
+    boost::shared_ptr<Portfolio> portfolio = buildPortfolio(simMarket);
+
+    boost::shared_ptr<NPVCube> cube =
+        boost::make_shared<DoublePrecisionInMemoryCubeN>(today, portfolio->ids(), dg->dates(), samples, 2);
+    vector<boost::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(boost::make_shared<NPVCalculator>("EUR", 0));
+    calculators.push_back(boost::make_shared<CashflowCalculator>("EUR", today, dg, 1));
+    if (!preResolved) {
+        for (auto& c : calculators)
+            c = boost::make_shared<NoInitCalculator>(c);
+    }
+    ValuationEngine engine(today, dg, simMarket);
+    engine.buildCube(portfolio, cube, calculators);
+    return cube;
+}
+
+void compareCubes(const string& dateGridString, bool compressed = false) {
+    Size samples = 50;
+    vector<string> ids;
+    boost::shared_ptr<NPVCube> reference = buildCube(dateGridString, samples, false, false, ids);
+    boost::shared_ptr<NPVCube> vectorised = buildCube(dateGridString, samples, true, compressed, ids);
+
+    // NPVs are in the order of 1E5 - 1E6, so this is a relative tolerance of about 1E-10
+    Real tolerance = 1.0E-4;
+    for (Size i = 0; i < ids.size(); ++i) {
+        BOOST_CHECK_CLOSE(reference->getT0(i), vectorised->getT0(i), 1.0E-10);
+        for (Size j = 0; j < reference->numDates(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                Real ref = reference->get(i, j, k), vec = vectorised->get(i, j, k);
+                if (std::fabs(ref - vec) > tolerance)
+                    BOOST_ERROR("vectorised NPV for trade " << ids[i] << ", date " << j << ", sample " << k << " ("
+                                                            << vec << ") differs from reference (" << ref << ")");
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(VectorisedValuationTest)
+
+BOOST_AUTO_TEST_CASE(testVectorisedValuationNone) {
+    BOOST_TEST_MESSAGE("Testing vectorised valuation against per scenario valuation, observation mode None");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    compareCubes("10,1Y");
+    compareCubes("20,3M");
+}
+
+BOOST_AUTO_TEST_CASE(testVectorisedValuationDisable) {
+    BOOST_TEST_MESSAGE("Testing vectorised valuation against per scenario valuation, observation mode Disable");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+    compareCubes("10,1Y");
+}
+
+BOOST_AUTO_TEST_CASE(testCompressedLinearBooks) {
+    BOOST_TEST_MESSAGE("Testing vectorised valuation with compressed linear books against per scenario valuation");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    compareCubes("10,1Y", true);
+    compareCubes("20,3M", true);
+}
+
+BOOST_AUTO_TEST_CASE(testPreResolvedCalculators) {
+    BOOST_TEST_MESSAGE("Testing NPV and cashflow calculators with pre-resolved trade state");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    Size samples = 20;
+    boost::shared_ptr<NPVCube> reference = buildFlowCube("20,3M", samples, false);
+    boost::shared_ptr<NPVCube> cube = buildFlowCube("20,3M", samples, true);
+    Real sumFlows = 0.0;
+    for (Size i = 0; i < reference->numIds(); ++i) {
+        BOOST_CHECK_SMALL(reference->getT0(i, 0) - cube->getT0(i, 0), 1.0E-6);
+        for (Size j = 0; j < reference->numDates(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                for (Size d = 0; d < 2; ++d) {
+                    Real ref = reference->get(i, j, k, d), val = cube->get(i, j, k, d);
+                    if (std::fabs(ref - val) > 1.0E-6)
+                        BOOST_ERROR("value for trade " << reference->ids()[i] << ", date " << j << ", sample " << k
+                                                       << ", depth " << d << " (" << val << ") differs from reference ("
+                                                       << ref << ")");
+                }
+                sumFlows += std::fabs(cube->get(i, j, k, 1));
+            }
+        }
+    }
+    // make sure the flows are actually tested
+    BOOST_CHECK(sumFlows > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(testShardedValuation) {
+    BOOST_TEST_MESSAGE("Testing cube shards starting at a given sample against the full cube");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    vector<string> ids;
+    Size samples = 30, split = 12;
+    boost::shared_ptr<NPVCube> full = buildCube("10,1Y", samples, false, false, ids);
+    DoublePrecisionInMemoryCube mergedCube(full->asof(), ids, full->dates(), samples);
+    NPVCube& merged = mergedCube;
+    copyCubeShard(*buildCube("10,1Y", split, false, false, ids), merged, 0);
+    copyCubeShard(*buildCube("10,1Y", samples - split, false, false, ids, split), merged, split);
+    for (Size i = 0; i < ids.size(); ++i) {
+        BOOST_CHECK_CLOSE(full->getT0(i), merged.getT0(i), 1.0E-10);
+        for (Size j = 0; j < full->numDates(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                if (std::fabs(full->get(i, j, k) - merged.get(i, j, k)) > 1.0E-6)
+                    BOOST_ERROR("sharded NPV for trade " << ids[i] << ", date " << j << ", sample " << k << " ("
+                                                         << merged.get(i, j, k) << ") differs from full run ("
+                                                         << full->get(i, j, k) << ")");
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCheckpointResume) {
+    BOOST_TEST_MESSAGE("Testing a cube build resumed from a checkpoint against the full cube");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    Date today = Settings::instance().evaluationDate();
+    vector<string> ids;
+    Size samples = 30, interval = 7;
+    boost::shared_ptr<NPVCube> full = buildCube("10,1Y", samples, false, false, ids);
+
+    // first run, keep the slices saved up to the second checkpoint
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>("10,1Y");
+    boost::shared_ptr<QuantExt::CrossAssetModel> model;
+    boost::shared_ptr<ScenarioSimMarket> simMarket = buildSimMarket(dg, model);
+    boost::shared_ptr<Portfolio> portfolio = buildPortfolio(simMarket);
+    vector<boost::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(boost::make_shared<NPVCalculator>("EUR"));
+    boost::shared_ptr<NPVCube> cube =
+        boost::make_shared<DoublePrecisionInMemoryCube>(today, ids, dg->dates(), samples);
+    vector<boost::shared_ptr<NPVCube>> slices;
+    Size checkpointed = 0;
+    ValuationEngine engine(today, dg, simMarket);
+    engine.setCheckpoint(interval, [&](Size completed) {
+        if (completed <= 2 * interval) {
+            slices.push_back(sliceCube<double>(*cube, checkpointed, completed - checkpointed));
+            checkpointed = completed;
+        }
+    });
+    engine.buildCube(portfolio, cube, calculators);
+    BOOST_REQUIRE_EQUAL(checkpointed, 2 * interval);
+
+    // second run, load the checkpoint and value the remaining samples only
+    simMarket = buildSimMarket(dg, model);
+    portfolio = buildPortfolio(simMarket);
+    boost::shared_ptr<NPVCube> resumed =
+        boost::make_shared<DoublePrecisionInMemoryCube>(today, ids, dg->dates(), samples);
+    Size first = 0;
+    for (auto const& slice : slices) {
+        copyCubeShard(*slice, *resumed, first);
+        first += slice->samples();
+    }
+    ValuationEngine resumedEngine(today, dg, simMarket);
+    resumedEngine.setStartSample(checkpointed);
+    resumedEngine.buildCube(portfolio, resumed, calculators);
+
+    for (Size i = 0; i < ids.size(); ++i) {
+        BOOST_CHECK_EQUAL(full->getT0(i), resumed->getT0(i));
+        for (Size j = 0; j < full->numDates(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                if (full->get(i, j, k) != resumed->get(i, j, k))
+                    BOOST_ERROR("resumed NPV for trade " << ids[i] << ", date " << j << ", sample " << k << " ("
+                                                         << resumed->get(i, j, k) << ") differs from full run ("
+                                                         << full->get(i, j, k) << ")");
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testAmcBermudanSwaption) {
+    BOOST_TEST_MESSAGE("Testing AMC valuation of Bermudan swaptions against the LGM grid price");
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    checkAmcBermudanSwaption("Physical");
+    checkAmcBermudanSwaption("Cash");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
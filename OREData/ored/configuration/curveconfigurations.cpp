@@ -188,6 +188,71 @@ std::set<string> CurveConfigurations::quotes() const {
     return quotes;
 }
 
+std::set<string> CurveConfigurations::quotes(const CurveSpec::CurveType curveType) const {
+
+    set<string> quotes;
+    switch (curveType) {
+    case CurveSpec::CurveType::Yield:
+        addQuotes(quotes, yieldCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::CapFloorVolatility:
+        addQuotes(quotes, capFloorVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::SwaptionVolatility:
+        addQuotes(quotes, swaptionVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::YieldVolatility:
+        addQuotes(quotes, yieldVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::FX:
+        addQuotes(quotes, fxSpotConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::FXVolatility:
+        addQuotes(quotes, fxVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Default:
+        addQuotes(quotes, defaultCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::CDSVolatility:
+        addQuotes(quotes, cdsVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Inflation:
+        addQuotes(quotes, inflationCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::InflationCapFloorPrice:
+        addQuotes(quotes, inflationCapFloorPriceSurfaceConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::InflationCapFloorVolatility:
+        addQuotes(quotes, inflationCapFloorVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Equity:
+        addQuotes(quotes, equityCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::EquityVolatility:
+        addQuotes(quotes, equityVolCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Security:
+        addQuotes(quotes, securityConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::BaseCorrelation:
+        addQuotes(quotes, baseCorrelationCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Commodity:
+        addQuotes(quotes, commodityCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::CommodityVolatility:
+        addQuotes(quotes, commodityVolatilityCurveConfigs_, curveType);
+        break;
+    case CurveSpec::CurveType::Correlation:
+        addQuotes(quotes, correlationCurveConfigs_, curveType);
+        break;
+    default:
+        QL_FAIL("unknown curve type");
+    }
+
+    return quotes;
+}
+
 std::set<string> CurveConfigurations::conventions(const boost::shared_ptr<TodaysMarketParameters> todaysMarketParams,
                                              const set<string>& configurations) const {
                                              
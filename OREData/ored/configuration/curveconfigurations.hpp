@@ -175,6 +175,8 @@ public:
     */
     std::set<string> quotes(const boost::shared_ptr<TodaysMarketParameters> todaysMarketParams, const std::set<std::string>& configurations = {""}) const;
     std::set<string> quotes() const;
+    //! Return the set of quotes that are required by the CurveConfig elements of the given curve type
+    std::set<string> quotes(const CurveSpec::CurveType curveType) const;
 
     std::set<string> conventions(const boost::shared_ptr<TodaysMarketParameters> todaysMarketParams, const std::set<std::string>& configurations = {""}) const;
     std::set<string> conventions() const;
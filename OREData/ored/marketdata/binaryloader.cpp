@@ -0,0 +1,330 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/binaryloader.cpp
+    \brief Market Datum Loader backed by a memory mapped binary file
+    \ingroup marketdata
+*/
+
+#include <ored/marketdata/binaryloader.hpp>
+#include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <ql/settings.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace QuantLib;
+
+namespace ore {
+namespace data {
+
+const char BinaryLoader::magic[8] = {'O', 'R', 'E', 'M', 'K', 'T', 'D', 'B'};
+const std::uint32_t BinaryLoader::version;
+
+namespace {
+
+// copy a (possibly unaligned) object from the mapped region
+template <class T> T readAt(const char* base, std::size_t size, std::uint64_t offset) {
+    QL_REQUIRE(offset + sizeof(T) <= size, "BinaryLoader: read beyond end of file at offset " << offset);
+    T t;
+    std::memcpy(&t, base + offset, sizeof(T));
+    return t;
+}
+
+template <class T> void write(std::ofstream& out, const T& t) {
+    out.write(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+} // namespace
+
+BinaryLoader::BinaryLoader(const string& filename, bool implyTodaysFixings)
+    : implyTodaysFixings_(implyTodaysFixings), fixingsLoaded_(false) {
+
+    LOG("BinaryLoader mapping " << filename);
+
+    try {
+        file_ = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+        region_ = boost::interprocess::mapped_region(file_, boost::interprocess::read_only);
+    } catch (const std::exception& e) {
+        QL_FAIL("BinaryLoader: error mapping file " << filename << ": " << e.what());
+    }
+    base_ = static_cast<const char*>(region_.get_address());
+    size_ = region_.get_size();
+
+    Header header = readAt<Header>(base_, size_, 0);
+    QL_REQUIRE(std::memcmp(header.magic, magic, sizeof(magic)) == 0,
+               "BinaryLoader: " << filename << " is not a binary market data file");
+    QL_REQUIRE(header.version == version, "BinaryLoader: file version " << header.version << " not supported, expected "
+                                                                        << version);
+
+    // interned names
+    std::uint64_t offset = header.namesOffset;
+    names_.reserve(header.numNames);
+    for (std::uint32_t i = 0; i < header.numNames; ++i) {
+        std::uint32_t length = readAt<std::uint32_t>(base_, size_, offset);
+        offset += sizeof(std::uint32_t);
+        QL_REQUIRE(offset + length <= size_, "BinaryLoader: name table exceeds file size");
+        names_.push_back(string(base_ + offset, length));
+        nameIds_[names_.back()] = i;
+        offset += length;
+    }
+
+    // date indices, the records themselves are only read on demand
+    for (std::uint32_t i = 0; i < header.numQuoteDates; ++i) {
+        DateIndexEntry e = readAt<DateIndexEntry>(base_, size_, header.quoteIndexOffset + i * sizeof(DateIndexEntry));
+        QL_REQUIRE(e.offset + e.count * sizeof(Record) <= size_, "BinaryLoader: quote records exceed file size");
+        quotePartitions_[Date(static_cast<BigInteger>(e.date))] = {e.offset, e.count};
+    }
+    for (std::uint32_t i = 0; i < header.numFixingDates; ++i) {
+        DateIndexEntry e = readAt<DateIndexEntry>(base_, size_, header.fixingIndexOffset + i * sizeof(DateIndexEntry));
+        QL_REQUIRE(e.offset + e.count * sizeof(Record) <= size_, "BinaryLoader: fixing records exceed file size");
+        fixingPartitions_[Date(static_cast<BigInteger>(e.date))] = {e.offset, e.count};
+    }
+
+    LOG("BinaryLoader mapped " << names_.size() << " names, " << quotePartitions_.size() << " quote dates and "
+                               << fixingPartitions_.size() << " fixing dates");
+}
+
+const BinaryLoader::Record* BinaryLoader::records(const DatePartition& p) const {
+    // records are written 8 byte aligned, and the mapped region is page aligned
+    return reinterpret_cast<const Record*>(base_ + p.offset);
+}
+
+const BinaryLoader::DatePartition* BinaryLoader::quotePartition(const Date& d) const {
+    auto it = quotePartitions_.find(d);
+    return it == quotePartitions_.end() ? nullptr : &it->second;
+}
+
+bool BinaryLoader::findName(const string& name, std::uint32_t& id) const {
+    auto it = nameIds_.find(name);
+    if (it == nameIds_.end())
+        return false;
+    id = it->second;
+    return true;
+}
+
+const vector<boost::shared_ptr<MarketDatum>>& BinaryLoader::loadQuotes(const Date& d) const {
+    auto it = data_.find(d);
+    if (it != data_.end())
+        return it->second;
+
+    const DatePartition* p = quotePartition(d);
+    QL_REQUIRE(p != nullptr, "BinaryLoader has no data for date " << d);
+
+    vector<boost::shared_ptr<MarketDatum>>& data = data_[d];
+    vector<std::uint32_t>& ids = dataIds_[d];
+    data.reserve(p->count);
+    ids.reserve(p->count);
+    const Record* r = records(*p);
+    for (std::uint32_t i = 0; i < p->count; ++i) {
+        QL_REQUIRE(r[i].nameId < names_.size(), "BinaryLoader: invalid name id " << r[i].nameId);
+        try {
+            data.push_back(parseMarketDatum(d, names_[r[i].nameId], r[i].value));
+            ids.push_back(r[i].nameId);
+        } catch (std::exception& e) {
+            WLOG("Failed to parse MarketDatum " << names_[r[i].nameId] << ": " << e.what());
+        }
+    }
+    LOG("BinaryLoader built " << data.size() << " market data points for " << d);
+    return data;
+}
+
+const boost::shared_ptr<MarketDatum>& BinaryLoader::get(const string& name, const Date& d) const {
+    std::uint32_t id;
+    if (findName(name, id)) {
+        const vector<boost::shared_ptr<MarketDatum>>& data = loadQuotes(d);
+        const vector<std::uint32_t>& ids = dataIds_.at(d);
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id)
+            return data[it - ids.begin()];
+    }
+    QL_FAIL("No MarketDatum for name " << name << " and date " << d);
+}
+
+bool BinaryLoader::has(const string& name, const Date& d) const {
+    std::uint32_t id;
+    const DatePartition* p = quotePartition(d);
+    if (p == nullptr || !findName(name, id))
+        return false;
+    const Record* r = records(*p);
+    const Record* it = std::lower_bound(r, r + p->count, id,
+                                        [](const Record& rec, std::uint32_t n) { return rec.nameId < n; });
+    return it != r + p->count && it->nameId == id;
+}
+
+const vector<Fixing>& BinaryLoader::loadFixings() const {
+    if (fixingsLoaded_)
+        return fixings_;
+
+    Date today = Settings::instance().evaluationDate();
+    for (auto const& f : fixingPartitions_) {
+        const Date& date = f.first;
+        if (date > today || (date == today && implyTodaysFixings_))
+            break;
+        const Record* r = records(f.second);
+        for (std::uint32_t i = 0; i < f.second.count; ++i) {
+            QL_REQUIRE(r[i].nameId < names_.size(), "BinaryLoader: invalid name id " << r[i].nameId);
+            fixings_.emplace_back(Fixing(date, names_[r[i].nameId], r[i].value));
+        }
+    }
+    fixingsLoaded_ = true;
+    LOG("BinaryLoader loaded " << fixings_.size() << " fixings");
+    return fixings_;
+}
+
+vector<Date> BinaryLoader::quoteDates() const {
+    vector<Date> dates;
+    for (auto const& p : quotePartitions_)
+        dates.push_back(p.first);
+    return dates;
+}
+
+void writeBinaryMarketData(const vector<string>& marketFiles, const vector<string>& fixingFiles,
+                           const string& filename) {
+
+    vector<string> names;
+    unordered_map<string, std::uint32_t> nameIds;
+    map<Date, vector<BinaryLoader::Record>> quotes, fixings;
+
+    auto intern = [&names, &nameIds](const string& name) -> std::uint32_t {
+        auto it = nameIds.find(name);
+        if (it != nameIds.end())
+            return it->second;
+        std::uint32_t id = static_cast<std::uint32_t>(names.size());
+        names.push_back(name);
+        nameIds[name] = id;
+        return id;
+    };
+
+    auto readFile = [&intern, &quotes, &fixings](const string& file, bool isMarket) {
+        LOG("writeBinaryMarketData: reading " << file);
+        ifstream in(file.c_str());
+        QL_REQUIRE(in.is_open(), "error opening file " << file);
+        string line;
+        Size n = 0;
+        while (getline(in, line)) {
+            // skip blank and comment lines
+            if (line.size() == 0 || line[0] == '#')
+                continue;
+            vector<string> tokens;
+            boost::trim(line);
+            boost::split(tokens, line, boost::is_any_of(",;\t "), boost::token_compress_on);
+            QL_REQUIRE(tokens.size() == 3, "Invalid market data line, 3 tokens expected " << line);
+            Date date = parseDate(tokens[0]);
+            const string& key = tokens[1];
+            Real value = parseReal(tokens[2]);
+            if (isMarket) {
+                // validate the quote once here, so that it does not fail when it is loaded
+                try {
+                    parseMarketDatum(date, key, value);
+                } catch (std::exception& e) {
+                    WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
+                    continue;
+                }
+            }
+            (isMarket ? quotes : fixings)[date].push_back({intern(key), 0, value});
+            ++n;
+        }
+        LOG("writeBinaryMarketData: read " << n << (isMarket ? " quotes" : " fixings") << " from " << file);
+    };
+
+    for (auto const& f : marketFiles)
+        readFile(f, true);
+    for (auto const& f : fixingFiles)
+        readFile(f, false);
+
+    ofstream out(filename.c_str(), ios::binary);
+    QL_REQUIRE(out.is_open(), "error opening file " << filename);
+
+    // pad the stream to a multiple of 8 bytes, so that records are aligned in the mapped file
+    auto align = [&out]() -> std::uint64_t {
+        static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        std::uint64_t pos = static_cast<std::uint64_t>(out.tellp());
+        if (pos % 8 != 0)
+            out.write(zeros, 8 - pos % 8);
+        return static_cast<std::uint64_t>(out.tellp());
+    };
+
+    auto writeIndex = [&out](const map<Date, vector<BinaryLoader::Record>>& data, std::uint64_t offset) {
+        for (auto const& d : data) {
+            BinaryLoader::DateIndexEntry e = {static_cast<std::int32_t>(d.first.serialNumber()),
+                                              static_cast<std::uint32_t>(d.second.size()), offset};
+            write(out, e);
+            offset += d.second.size() * sizeof(BinaryLoader::Record);
+        }
+    };
+
+    auto writeRecords = [&out](map<Date, vector<BinaryLoader::Record>>& data) {
+        for (auto& d : data) {
+            // stable sort, so that duplicate names keep their input order as in the CSVLoader
+            std::stable_sort(d.second.begin(), d.second.end(),
+                             [](const BinaryLoader::Record& a, const BinaryLoader::Record& b) {
+                                 return a.nameId < b.nameId;
+                             });
+            out.write(reinterpret_cast<const char*>(d.second.data()), d.second.size() * sizeof(BinaryLoader::Record));
+        }
+    };
+
+    // header (rewritten with the actual offsets at the end)
+    BinaryLoader::Header header = BinaryLoader::Header();
+    std::memcpy(header.magic, BinaryLoader::magic, sizeof(header.magic));
+    header.version = BinaryLoader::version;
+    header.numNames = static_cast<std::uint32_t>(names.size());
+    header.numQuoteDates = static_cast<std::uint32_t>(quotes.size());
+    header.numFixingDates = static_cast<std::uint32_t>(fixings.size());
+    write(out, header);
+
+    header.namesOffset = align();
+    for (auto const& n : names) {
+        std::uint32_t length = static_cast<std::uint32_t>(n.size());
+        write(out, length);
+        out.write(n.data(), length);
+    }
+
+    header.quoteIndexOffset = align();
+    std::uint64_t quoteRecordsOffset =
+        header.quoteIndexOffset + quotes.size() * sizeof(BinaryLoader::DateIndexEntry);
+    writeIndex(quotes, quoteRecordsOffset);
+    QL_REQUIRE(align() == quoteRecordsOffset, "writeBinaryMarketData: unexpected quote records offset");
+    writeRecords(quotes);
+
+    header.fixingIndexOffset = align();
+    std::uint64_t fixingRecordsOffset =
+        header.fixingIndexOffset + fixings.size() * sizeof(BinaryLoader::DateIndexEntry);
+    writeIndex(fixings, fixingRecordsOffset);
+    QL_REQUIRE(align() == fixingRecordsOffset, "writeBinaryMarketData: unexpected fixing records offset");
+    writeRecords(fixings);
+
+    out.seekp(0);
+    write(out, header);
+    out.close();
+    QL_REQUIRE(!out.fail(), "error writing file " << filename);
+
+    LOG("writeBinaryMarketData: wrote " << names.size() << " names, " << quotes.size() << " quote dates and "
+                                        << fixings.size() << " fixing dates to " << filename);
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/binaryloader.hpp
+    \brief Market Datum Loader backed by a memory mapped binary file
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/loader.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Loader reading market quotes and fixings from a binary market data file
+/*!
+  The binary file is produced from the usual csv market and fixing files by
+  writeBinaryMarketData(), see below. It contains
+
+  - a header with the file layout,
+  - a table of interned quote and fixing names,
+  - a date index for the quotes and one for the fixings, and
+  - the quote and fixing records, partitioned by date and within each date
+    sorted by name id; each record consists of the name id and the value.
+
+  All quotes are validated when the file is written, i.e. only quotes that can
+  be parsed into a MarketDatum are stored. The file is memory mapped, MarketDatum
+  instances are only created for the dates that are actually requested, and the
+  fixings are only materialised on the first call to loadFixings(). The records
+  are stored in native byte order, the file is not meant to be portable between
+  platforms with different endianness.
+
+  \ingroup marketdata
+ */
+class BinaryLoader : public Loader {
+public:
+    //! Constructor
+    BinaryLoader( //! Binary market data file name
+        const std::string& filename,
+        //! Enable/disable implying today's fixings
+        bool implyTodaysFixings = false);
+
+    //! \name Inspectors
+    //@{
+    //! Load market quotes
+    const std::vector<boost::shared_ptr<MarketDatum>>& loadQuotes(const QuantLib::Date&) const override;
+
+    //! Get a particular quote by its unique name
+    const boost::shared_ptr<MarketDatum>& get(const std::string& name, const QuantLib::Date&) const override;
+
+    //! Check if a quote is available without building the market data for the date
+    bool has(const std::string& name, const QuantLib::Date& d) const override;
+
+    //! Load fixings
+    const std::vector<Fixing>& loadFixings() const override;
+
+    //! Dates for which quotes are available
+    std::vector<QuantLib::Date> quoteDates() const;
+    //@}
+
+    //! \name Binary file layout
+    //@{
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t numNames;
+        std::uint32_t numQuoteDates;
+        std::uint32_t numFixingDates;
+        std::uint64_t namesOffset;
+        std::uint64_t quoteIndexOffset;
+        std::uint64_t fixingIndexOffset;
+    };
+
+    struct DateIndexEntry {
+        std::int32_t date;
+        std::uint32_t count;
+        std::uint64_t offset;
+    };
+
+    struct Record {
+        std::uint32_t nameId;
+        std::uint32_t reserved;
+        double value;
+    };
+
+    static const char magic[8];
+    static const std::uint32_t version = 1;
+    //@}
+
+private:
+    struct DatePartition {
+        std::uint64_t offset;
+        std::uint32_t count;
+    };
+
+    const Record* records(const DatePartition& p) const;
+    const DatePartition* quotePartition(const QuantLib::Date& d) const;
+    bool findName(const std::string& name, std::uint32_t& id) const;
+
+    bool implyTodaysFixings_;
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    const char* base_;
+    std::size_t size_;
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, std::uint32_t> nameIds_;
+    std::map<QuantLib::Date, DatePartition> quotePartitions_;
+    std::map<QuantLib::Date, DatePartition> fixingPartitions_;
+
+    // market data built on demand, with the name ids of the built quotes in the same order
+    mutable std::map<QuantLib::Date, std::vector<boost::shared_ptr<MarketDatum>>> data_;
+    mutable std::map<QuantLib::Date, std::vector<std::uint32_t>> dataIds_;
+    mutable std::vector<Fixing> fixings_;
+    mutable bool fixingsLoaded_;
+};
+
+//! Convert csv market and fixing files to a binary market data file that can be read by the BinaryLoader
+/*! The csv files have the same format as the ones read by the CSVLoader. Quotes that can not be parsed are
+    skipped with a warning. Fixings are stored without filtering on the evaluation date, the filtering is
+    done by the BinaryLoader when loading the fixings. */
+void writeBinaryMarketData(const std::vector<std::string>& marketFiles, const std::vector<std::string>& fixingFiles,
+                           const std::string& filename);
+
+} // namespace data
+} // namespace ore
@@ -22,6 +22,10 @@
 #include <ql/quotes/compositequote.hpp>
 #include <ql/quotes/derivedquote.hpp>
 #include <ql/quotes/simplequote.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <deque>
+#include <set>
 
 using namespace QuantLib;
 using std::string;
@@ -29,115 +33,151 @@ using std::string;
 namespace {
 // helper classes to enable the building
 // of composite cross-currency fx quotes
-class Triangulation {
-public:
-    Triangulation() {}
-    Real operator()(Real a, Real b) const { return a / b; }
-};
-
 class Product {
 public:
     Product() {}
     Real operator()(Real a, Real b) const { return a * b; }
 };
 
-class InverseProduct {
-public:
-    InverseProduct() {}
-    Real operator()(Real a, Real b) const { return 1.0 / (a * b); }
-};
-
 // Inverse a single quote
 class Inverse {
 public:
     Inverse() {}
     Real operator()(Real a) const { return 1.0 / a; }
 };
+
+const Handle<Quote>& unity() {
+    static Handle<Quote> unity(boost::make_shared<SimpleQuote>(1.0));
+    return unity;
+}
 } // namespace
 
 namespace ore {
 namespace data {
 
-Handle<Quote> FXTriangulation::getQuote(const string& pair) const {
-    // First, look for the pair in the map
-    auto it = map_.find(pair);
-    if (it != map_.end())
-        return it->second;
+FXTriangulation::FXTriangulation(const FXTriangulation& other) {
+    // the copy builds its own quote table on request
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    map_ = other.map_;
+}
+
+FXTriangulation& FXTriangulation::operator=(const FXTriangulation& other) {
+    if (this != &other) {
+        std::map<string, Handle<Quote>> map;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            map = other.map_;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_.swap(map);
+        table_.reset();
+    }
+    return *this;
+}
+
+void FXTriangulation::addQuote(const string& pair, const Handle<Quote>& spot) {
+    QL_REQUIRE(pair.size() == 6, "Invalid ccypair " << pair);
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_[pair] = spot;
+    table_.reset();
+}
 
-    // Now we have to break the pair up and search for it.
+Handle<Quote> FXTriangulation::getQuote(const string& pair) const {
     QL_REQUIRE(pair.size() == 6, "Invalid ccypair " << pair);
     string domestic = pair.substr(0, 3);
     string foreign = pair.substr(3);
 
-    // check reverse
-    string reverse = foreign + domestic;
-    it = map_.find(reverse);
-    if (it != map_.end()) {
-        Handle<Quote> invertedQuote(boost::make_shared<DerivedQuote<Inverse>>(it->second, Inverse()));
-        map_[pair] = invertedQuote;
-        return invertedQuote;
-    }
+    // check EUREUR, also for currencies without quotes
+    if (foreign == domestic)
+        return unity();
 
-    // check EUREUR
-    if (foreign == domestic) {
-        static Handle<Quote> unity(boost::make_shared<SimpleQuote>(1.0));
-        return unity;
+    std::lock_guard<std::mutex> lock(mutex_);
+    QuoteTable& t = table();
+    auto d = t.currencies.find(domestic);
+    auto f = t.currencies.find(foreign);
+    if (d != t.currencies.end() && f != t.currencies.end() &&
+        t.predecessors[d->second * t.currencies.size() + f->second] != Null<Size>())
+        return quote(t, d->second, f->second);
+
+    QL_FAIL("Unable to build FXQuote for ccy pair " << pair);
+}
+
+std::vector<Handle<Quote>> FXTriangulation::derivedQuotes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Handle<Quote>> result;
+    if (table_) {
+        for (auto const& q : table_->quotes)
+            result.push_back(q.second);
     }
+    return result;
+}
 
-    // Now we search for a pair of quotes that we can combine to construct the quote required.
-    // We only search for a pair of quotes a single step apart.
-    //
-    // Suppose we want a USDJPY quote and we have EUR based data, there are 4 combinations to
-    // consider:
-    // EURUSD, EURJPY  => we want EURJPY / EURUSD [Triangulation]
-    // EURUSD, JPYEUR  => we want 1 / (EURUSD * JPYEUR) [InverseProduct]
-    // USDEUR, EURJPY  => we want USDEUR * EURJPY [Product]
-    // USDEUR, JPYEUR  => we want USDEUR / JPYEUR [Triangulation (but in the reverse order)]
-    //
-    // Loop over the map, look for domestic then use the map to find the other side of the pair.
-    for (const auto& kv : map_) {
-        string keyDomestic = kv.first.substr(0, 3);
-        string keyForeign = kv.first.substr(3);
-        const Handle<Quote>& q1 = kv.second;
-
-        if (domestic == keyDomestic) {
-            // we have domestic, now look for foreign/keyForeign
-            // USDEUR, JPYEUR  => we want USDEUR / JPYEUR [Triangulation (but in the reverse order)]
-            it = map_.find(foreign + keyForeign);
-            if (it != map_.end()) {
-                // Here q1 is USDEUR and it->second is JPYEUR
-                map_[pair] =
-                    Handle<Quote>(boost::make_shared<CompositeQuote<Triangulation>>(q1, it->second, Triangulation()));
-                return map_[pair];
-            }
-            // USDEUR, EURJPY  => we want USDEUR * EURJPY [Product]
-            it = map_.find(keyForeign + foreign);
-            if (it != map_.end()) {
-                map_[pair] = Handle<Quote>(boost::make_shared<CompositeQuote<Product>>(q1, it->second, Product()));
-                return map_[pair];
-            }
-        }
+FXTriangulation::QuoteTable& FXTriangulation::table() const {
+    if (table_)
+        return *table_;
+    table_ = boost::make_shared<QuoteTable>();
+    QuoteTable& t = *table_;
+
+    // intern the currencies, in alphabetical order so that the chosen paths do not depend on the order of addQuote()
+    std::set<string> ccys;
+    for (auto const& kv : map_) {
+        ccys.insert(kv.first.substr(0, 3));
+        ccys.insert(kv.first.substr(3));
+    }
+    for (auto const& c : ccys)
+        t.currencies.emplace(c, t.currencies.size());
+    Size n = ccys.size();
+
+    // edges of the graph, an added quote for ij or ji connects i and j in both directions
+    std::vector<std::set<Size>> neighbours(n);
+    for (auto const& kv : map_) {
+        Size i = t.currencies[kv.first.substr(0, 3)], j = t.currencies[kv.first.substr(3)];
+        t.added[i * n + j] = kv.second;
+        neighbours[i].insert(j);
+        neighbours[j].insert(i);
+    }
 
-        if (domestic == keyForeign) {
-            // EURUSD, JPYEUR  => we want 1 / (EURUSD * JPYEUR) [InverseProduct]
-            it = map_.find(foreign + keyDomestic);
-            if (it != map_.end()) {
-                map_[pair] =
-                    Handle<Quote>(boost::make_shared<CompositeQuote<InverseProduct>>(q1, it->second, InverseProduct()));
-                return map_[pair];
-            }
-            // EURUSD, EURJPY  => we want EURJPY / EURUSD [Triangulation]
-            it = map_.find(keyDomestic + foreign);
-            if (it != map_.end()) {
-                // Here q1 is EURUSD and it->second is EURJPY
-                map_[pair] =
-                    Handle<Quote>(boost::make_shared<CompositeQuote<Triangulation>>(it->second, q1, Triangulation()));
-                return map_[pair];
+    // breadth first search from each currency for the predecessors on the shortest paths
+    t.predecessors.assign(n * n, Null<Size>());
+    for (Size i = 0; i < n; ++i) {
+        Size* row = &t.predecessors[i * n];
+        row[i] = i;
+        std::deque<Size> queue(1, i);
+        while (!queue.empty()) {
+            Size k = queue.front();
+            queue.pop_front();
+            for (Size j : neighbours[k]) {
+                if (row[j] != Null<Size>())
+                    continue;
+                row[j] = k;
+                queue.push_back(j);
             }
         }
     }
+    return t;
+}
 
-    QL_FAIL("Unable to build FXQuote for ccy pair " << pair);
+const Handle<Quote>& FXTriangulation::quote(QuoteTable& t, Size i, Size j) const {
+    Size n = t.currencies.size();
+    auto q = t.quotes.find(i * n + j);
+    if (q != t.quotes.end())
+        return q->second;
+
+    // the quote for ij is the quote for ik times the edge kj, where k is the predecessor of j on the path from i, an
+    // edge is the added quote for kj or the inverse of the added quote for jk
+    Handle<Quote> result;
+    Size k = t.predecessors[i * n + j];
+    auto added = t.added.find(k * n + j);
+    Handle<Quote> edge =
+        added != t.added.end()
+            ? added->second
+            : Handle<Quote>(boost::make_shared<DerivedQuote<Inverse>>(t.added.at(j * n + k), Inverse()));
+    if (k == i)
+        result = edge;
+    else
+        result = Handle<Quote>(boost::make_shared<CompositeQuote<Product>>(quote(t, i, k), edge, Product()));
+    return t.quotes.emplace(i * n + j, result).first->second;
 }
+
 } // namespace data
 } // namespace ore
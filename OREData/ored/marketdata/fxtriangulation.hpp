@@ -23,10 +23,14 @@
 
 #pragma once
 
+#include <boost/shared_ptr.hpp>
 #include <map>
+#include <mutex>
 #include <ql/handle.hpp>
 #include <ql/quote.hpp>
 #include <ql/types.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace ore {
 namespace data {
@@ -36,14 +40,19 @@ using QuantLib::Handle;
 //! Intelligent FX price repository
 /*! FX Triangulation is an intelligent price repository that will attempt to calculate FX spot values
  *
- *  As quotes for currency pairs are added to the repository they are stored in an internal map
- *  If the repository is asked for the FX spot price for a given pair it will attempt the following:
- *  1) Look in the map for the pair
- *  2) Look for the reverse quote (EURUSD -> USDEUR), if found it will return an inverse quote.
- *  3) Look through the map and attempt to find a bridging pair (e.g EURUSD and EURJPY for USDJPY)
- *     and return the required composite quote.
+ *  As quotes for currency pairs are added to the repository they are stored in an internal map. On the first
+ *  request for a quote the repository builds a graph with the currencies as nodes and the added quotes as edges
+ *  and derives a quote for every pair of connected currencies along a path with the minimal number of hops, e.g.
+ *  1) the added quote for the pair
+ *  2) an inverse quote if the reverse pair was added (EURUSD -> USDEUR)
+ *  3) a composite quote over a bridging currency (e.g EURUSD and EURJPY for USDJPY)
+ *  4) a composite quote over several bridging currencies (e.g. EURUSD, EURAUD and AUDNZD for USDNZD)
  *
- *  In cases (2) and (3) the constructed quote is then stored in the map so subsequent calls will hit (1).
+ *  The shortest paths are stored in a dense table of predecessors indexed by currency. The quote for a pair is
+ *  built from the path on its first request only and kept for later requests, so that only the quotes that were
+ *  handed out exist. Lookups can be done concurrently from several threads. Adding a quote discards the table and
+ *  the quotes built so far, they are rebuilt on the next request. Quotes are expected to be added while the market
+ *  is built only.
  *
  *  The constructed quotes all reference the original quotes which are added by the addQuote() method
  *  and so if these original quotes change in the future, the constructed quotes will reflect the new
@@ -55,18 +64,39 @@ class FXTriangulation {
 public:
     //! Default ctor, once built the repo is empty
     FXTriangulation() {}
+    FXTriangulation(const FXTriangulation& other);
+    FXTriangulation& operator=(const FXTriangulation& other);
 
     //! Add a quote to the repo
-    void addQuote(const std::string& pair, const Handle<Quote>& spot) { map_[pair] = spot; }
+    void addQuote(const std::string& pair, const Handle<Quote>& spot);
 
     //! Get a quote from the repo, this will follow the algorithm described above
     Handle<Quote> getQuote(const std::string&) const;
 
-    //! Get all quotes currently stored in the triangulation
+    //! Get all quotes added to the triangulation
     const std::map<std::string, Handle<Quote>>& quotes() const { return map_; }
 
+    //! Get the quotes derived from the added quotes that were handed out by getQuote() so far
+    std::vector<Handle<Quote>> derivedQuotes() const;
+
 private:
-    mutable std::map<std::string, Handle<Quote>> map_;
+    struct QuoteTable {
+        std::unordered_map<std::string, QuantLib::Size> currencies;
+        // added quotes keyed on i * n + j for the pair (i,j), where n is the number of currencies
+        std::unordered_map<QuantLib::Size, Handle<Quote>> added;
+        // predecessor of j on a shortest path from i at i * n + j, null if the currencies are not connected
+        std::vector<QuantLib::Size> predecessors;
+        // quotes built on request, keyed on i * n + j
+        std::unordered_map<QuantLib::Size, Handle<Quote>> quotes;
+    };
+
+    // the following methods must be called with the mutex locked
+    QuoteTable& table() const;
+    const Handle<Quote>& quote(QuoteTable& t, QuantLib::Size i, QuantLib::Size j) const;
+
+    std::map<std::string, Handle<Quote>> map_;
+    mutable boost::shared_ptr<QuoteTable> table_;
+    mutable std::mutex mutex_;
 };
 } // namespace data
 } // namespace ore
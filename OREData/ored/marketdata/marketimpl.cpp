@@ -404,6 +404,12 @@ void MarketImpl::refresh(const string& configuration) {
             if (dq != nullptr)
                 dq->update();
         }
+        // only the triangulated quotes handed out so far exist, the others are built from the current spots later
+        for (auto& x : fxSpots->second.derivedQuotes()) {
+            auto dq = boost::dynamic_pointer_cast<Observer>(*x);
+            if (dq != nullptr)
+                dq->update();
+        }
     }
 
 } // refresh
@@ -43,6 +43,7 @@
 #include <qle/termstructures/tenorbasisswaphelper.hpp>
 
 #include <ored/marketdata/yieldcurve.hpp>
+#include <ored/marketdata/yieldcurvewarmstarts.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
@@ -163,34 +164,45 @@ YieldCurve::YieldCurve(Date asof, YieldCurveSpec curveSpec, const CurveConfigura
     LOG("Yield curve " << curveSpec_.name() << " built");
 }
 
+template <class Traits, class Interpolator>
+boost::shared_ptr<YieldTermStructure>
+YieldCurve::piecewiseYieldCurve(const vector<boost::shared_ptr<RateHelper>>& instruments,
+                                const Interpolator& interpolator) {
+    if (warmStart_) {
+        typedef PiecewiseYieldCurve<Traits, Interpolator, WarmStartBootstrap> Curve;
+        return boost::make_shared<Curve>(asofDate_, instruments, zeroDayCounter_, accuracy_, interpolator,
+                                         WarmStartBootstrap<Curve>(warmStart_));
+    }
+    return boost::make_shared<PiecewiseYieldCurve<Traits, Interpolator>>(asofDate_, instruments, zeroDayCounter_,
+                                                                         accuracy_, interpolator);
+}
+
 boost::shared_ptr<YieldTermStructure>
 YieldCurve::piecewisecurve(const vector<boost::shared_ptr<RateHelper>>& instruments) {
 
+    if (YieldCurveWarmStarts::instance().enabled())
+        warmStart_ = YieldCurveWarmStarts::instance().warmStart(curveSpec_.name());
+
     boost::shared_ptr<YieldTermStructure> yieldts;
     switch (interpolationVariable_) {
     case InterpolationVariable::Zero:
         switch (interpolationMethod_) {
         case InterpolationMethod::Linear:
-            yieldts.reset(new PiecewiseYieldCurve<ZeroYield, QuantLib::Linear>(asofDate_, instruments, zeroDayCounter_,
-                                                                               accuracy_));
+            yieldts = piecewiseYieldCurve<ZeroYield, QuantLib::Linear>(instruments);
             break;
         case InterpolationMethod::LogLinear:
-            yieldts.reset(new PiecewiseYieldCurve<ZeroYield, QuantLib::LogLinear>(asofDate_, instruments,
-                                                                                  zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<ZeroYield, QuantLib::LogLinear>(instruments);
             break;
         case InterpolationMethod::NaturalCubic:
-            yieldts.reset(new PiecewiseYieldCurve<ZeroYield, Cubic>(asofDate_, instruments, zeroDayCounter_, accuracy_,
-                                                                    Cubic(CubicInterpolation::Kruger, true)));
+            yieldts = piecewiseYieldCurve<ZeroYield, Cubic>(instruments, Cubic(CubicInterpolation::Kruger, true));
             break;
         case InterpolationMethod::FinancialCubic:
-            yieldts.reset(new PiecewiseYieldCurve<ZeroYield, Cubic>(asofDate_, instruments, zeroDayCounter_, accuracy_,
-                                                                    Cubic(CubicInterpolation::Kruger, true,
-                                                                          CubicInterpolation::SecondDerivative, 0.0,
-                                                                          CubicInterpolation::FirstDerivative)));
+            yieldts = piecewiseYieldCurve<ZeroYield, Cubic>(
+                instruments, Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
+                                   CubicInterpolation::FirstDerivative));
             break;
         case InterpolationMethod::ConvexMonotone:
-            yieldts.reset(
-                new PiecewiseYieldCurve<ZeroYield, ConvexMonotone>(asofDate_, instruments, zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<ZeroYield, ConvexMonotone>(instruments);
             break;
         default:
             QL_FAIL("Interpolation method not recognised.");
@@ -199,26 +211,22 @@ YieldCurve::piecewisecurve(const vector<boost::shared_ptr<RateHelper>>& instrume
     case InterpolationVariable::Discount:
         switch (interpolationMethod_) {
         case InterpolationMethod::Linear:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::Discount, QuantLib::Linear>(asofDate_, instruments,
-                                                                                        zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::Discount, QuantLib::Linear>(instruments);
             break;
         case InterpolationMethod::LogLinear:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::Discount, QuantLib::LogLinear>(asofDate_, instruments,
-                                                                                           zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::Discount, QuantLib::LogLinear>(instruments);
             break;
         case InterpolationMethod::NaturalCubic:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::Discount, Cubic>(
-                asofDate_, instruments, zeroDayCounter_, accuracy_, Cubic(CubicInterpolation::Kruger, true)));
+            yieldts = piecewiseYieldCurve<QuantLib::Discount, Cubic>(
+                instruments, Cubic(CubicInterpolation::Kruger, true));
             break;
         case InterpolationMethod::FinancialCubic:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::Discount, Cubic>(
-                asofDate_, instruments, zeroDayCounter_, accuracy_,
-                Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
-                      CubicInterpolation::FirstDerivative)));
+            yieldts = piecewiseYieldCurve<QuantLib::Discount, Cubic>(
+                instruments, Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
+                                   CubicInterpolation::FirstDerivative));
             break;
         case InterpolationMethod::ConvexMonotone:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::Discount, ConvexMonotone>(asofDate_, instruments,
-                                                                                      zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::Discount, ConvexMonotone>(instruments);
             break;
         default:
             QL_FAIL("Interpolation method not recognised.");
@@ -227,26 +235,22 @@ YieldCurve::piecewisecurve(const vector<boost::shared_ptr<RateHelper>>& instrume
     case InterpolationVariable::Forward:
         switch (interpolationMethod_) {
         case InterpolationMethod::Linear:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::ForwardRate, QuantLib::Linear>(asofDate_, instruments,
-                                                                                           zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::ForwardRate, QuantLib::Linear>(instruments);
             break;
         case InterpolationMethod::LogLinear:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::ForwardRate, QuantLib::LogLinear>(
-                asofDate_, instruments, zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::ForwardRate, QuantLib::LogLinear>(instruments);
             break;
         case InterpolationMethod::NaturalCubic:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::ForwardRate, Cubic>(
-                asofDate_, instruments, zeroDayCounter_, accuracy_, Cubic(CubicInterpolation::Kruger, true)));
+            yieldts = piecewiseYieldCurve<QuantLib::ForwardRate, Cubic>(
+                instruments, Cubic(CubicInterpolation::Kruger, true));
             break;
         case InterpolationMethod::FinancialCubic:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::ForwardRate, Cubic>(
-                asofDate_, instruments, zeroDayCounter_, accuracy_,
-                Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
-                      CubicInterpolation::FirstDerivative)));
+            yieldts = piecewiseYieldCurve<QuantLib::ForwardRate, Cubic>(
+                instruments, Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
+                                   CubicInterpolation::FirstDerivative));
             break;
         case InterpolationMethod::ConvexMonotone:
-            yieldts.reset(new PiecewiseYieldCurve<QuantLib::ForwardRate, ConvexMonotone>(asofDate_, instruments,
-                                                                                         zeroDayCounter_, accuracy_));
+            yieldts = piecewiseYieldCurve<QuantLib::ForwardRate, ConvexMonotone>(instruments);
             break;
         default:
             QL_FAIL("Interpolation method not recognised.");
@@ -278,6 +282,14 @@ YieldCurve::piecewisecurve(const vector<boost::shared_ptr<RateHelper>>& instrume
     }
     zeros[0] = zeros[1];
     forwards[0] = forwards[1];
+
+    if (warmStart_) {
+        DLOG("Bootstrap of " << curveSpec_.name() << " used "
+                             << (warmStart_->usedGlobalNewton() ? "global Newton" : "pillar by pillar") << " solver, "
+                             << warmStart_->iterations() << " iterations, " << warmStart_->evaluations()
+                             << " helper evaluations, build " << warmStart_->builds());
+    }
+
     if (interpolationVariable_ == InterpolationVariable::Zero)
         p_ = zerocurve(dates, zeros, zeroDayCounter_);
     else if (interpolationVariable_ == InterpolationVariable::Discount)
@@ -29,6 +29,7 @@
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
+#include <qle/termstructures/warmstartbootstrap.hpp>
 //#include <ql/termstructures/yield/zeroyieldstructure.hpp>
 #include <ql/termstructures/yield/ratehelpers.hpp>
 
@@ -114,6 +115,12 @@ private:
 
     boost::shared_ptr<YieldTermStructure> piecewisecurve(const vector<boost::shared_ptr<RateHelper>>& instruments);
 
+    //! Piecewise yield curve, using the warm start bootstrap if warmStart_ is set
+    template <class Traits, class Interpolator>
+    boost::shared_ptr<YieldTermStructure> piecewiseYieldCurve(const vector<boost::shared_ptr<RateHelper>>& instruments,
+                                                              const Interpolator& interpolator = Interpolator());
+    boost::shared_ptr<QuantExt::BootstrapWarmStart> warmStart_;
+
     boost::shared_ptr<YieldTermStructure> zerocurve(const vector<Date>& dates, const vector<Rate>& yields,
                                                     const DayCounter& dayCounter);
 
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/yieldcurvewarmstarts.hpp
+    \brief Singleton holding the bootstrap warm start states of the yield curves
+    \ingroup curves
+*/
+
+#pragma once
+
+#include <qle/termstructures/warmstartbootstrap.hpp>
+
+#include <ql/patterns/singleton.hpp>
+
+#include <map>
+#include <string>
+
+namespace ore {
+namespace data {
+
+//! Bootstrap warm starts of the yield curves
+/*! If enabled, bootstrapped yield curves are built with the QuantExt::WarmStartBootstrap, using the pillar values
+    (and, if the global Newton mode is active, the Jacobian) of the last build of the curve with the same name as a
+    starting point. This speeds up repeated builds of nearly identical curves, e.g. intraday market refreshes,
+    multi date runs or par rate bump runs. The states persist until clear() is called.
+
+    \ingroup curves
+*/
+class YieldCurveWarmStarts : public QuantLib::Singleton<YieldCurveWarmStarts> {
+    friend class QuantLib::Singleton<YieldCurveWarmStarts>;
+
+private:
+    YieldCurveWarmStarts() : enabled_(false), globalNewton_(true) {}
+
+public:
+    bool enabled() const { return enabled_; }
+    bool globalNewton() const { return globalNewton_; }
+
+    void setEnabled(const bool enabled) { enabled_ = enabled; }
+    //! only affects states created after the call
+    void setGlobalNewton(const bool globalNewton) { globalNewton_ = globalNewton; }
+
+    //! the warm start state for the given curve, created on first use
+    const boost::shared_ptr<QuantExt::BootstrapWarmStart>& warmStart(const std::string& curveName) {
+        boost::shared_ptr<QuantExt::BootstrapWarmStart>& w = warmStarts_[curveName];
+        if (!w)
+            w = boost::make_shared<QuantExt::BootstrapWarmStart>(globalNewton_);
+        return w;
+    }
+
+    //! remove all states
+    void clear() { warmStarts_.clear(); }
+
+private:
+    bool enabled_, globalNewton_;
+    std::map<std::string, boost::shared_ptr<QuantExt::BootstrapWarmStart>> warmStarts_;
+};
+
+} // namespace data
+} // namespace ore
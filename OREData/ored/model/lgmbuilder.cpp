@@ -41,8 +41,10 @@ using namespace data;
 namespace data {
 
 LgmBuilder::LgmBuilder(const boost::shared_ptr<ore::data::Market>& market, const boost::shared_ptr<IrLgmData>& data,
-                       const std::string& configuration, Real bootstrapTolerance)
+                       const std::string& configuration, Real bootstrapTolerance, const bool continueCalibration)
     : market_(market), configuration_(configuration), data_(data), bootstrapTolerance_(bootstrapTolerance),
+      continueCalibration_(continueCalibration), calibrated_(false), calibrations_(0), skippedCalibrations_(0),
+      functionEvaluations_(0), totalFunctionEvaluations_(0),
       optimizationMethod_(boost::shared_ptr<OptimizationMethod>(new LevenbergMarquardt(1E-8, 1E-8, 1E-8))),
       endCriteria_(EndCriteria(1000, 500, 1E-8, 1E-8, 1E-8)),
       calibrationErrorType_(BlackCalibrationHelper::RelativePriceError) {
@@ -125,6 +127,8 @@ LgmBuilder::LgmBuilder(const boost::shared_ptr<ore::data::Market>& market, const
     model_ = boost::make_shared<QuantExt::LGM>(parametrization_);
     params_ = model_->params();
     swaptionEngine_ = boost::make_shared<QuantExt::AnalyticLgmSwaptionEngine>(model_);
+    // the engine's cache is cleared on each recalibration, i.e. it is only used within one calibration
+    swaptionEngine_->enableCache();
 
     if (data_->calibrateA() || data_->calibrateH()) {
         registerWith(svts_);
@@ -143,19 +147,35 @@ void LgmBuilder::performCalculations() const {
 
     DLOG("Recalibrate LGM model for currency " << data_->ccy());
 
-    parametrization_->shift() = 0.0;
-    parametrization_->scaling() = 1.0;
-
     if (data_->calibrateA() || data_->calibrateH())
         buildSwaptionBasket();
 
+    // the basket may have been rebuilt, its helpers need the engine also if the calibration is skipped below
+    swaptionEngine_->clearCache();
     for (Size j = 0; j < swaptionBasket_.size(); j++)
         swaptionBasket_[j]->setPricingEngine(swaptionEngine_);
 
+    // if the calibration inputs are unchanged, the model (including shift and scaling) is still calibrated
+    std::vector<Real> inputs;
+    if (continueCalibration_) {
+        inputs = calibrationInputs();
+        if (calibrated_ && inputs == calibrationInputs_) {
+            ++skippedCalibrations_;
+            DLOG("Skip LGM calibration for currency " << data_->ccy() << ", calibration inputs are unchanged");
+            return;
+        }
+    }
+
+    parametrization_->shift() = 0.0;
+    parametrization_->scaling() = 1.0;
+
     // reset model parameters, this ensures that a calibration gives the same
-    // result if the input market data is the same
-    model_->setParams(params_);
+    // result if the input market data is the same; when continuing a calibration
+    // we start from the previous solution instead
+    if (!continueCalibration_ || !calibrated_)
+        model_->setParams(params_);
 
+    functionEvaluations_ = 0;
     if (data_->calibrationType() != CalibrationType::None) {
         if (data_->calibrateA() && !data_->calibrateH()) {
             if (data_->aParamType() == ParamType::Piecewise && data_->calibrationType() == CalibrationType::Bootstrap) {
@@ -165,12 +185,14 @@ void LgmBuilder::performCalculations() const {
                 LOG("call calibrateGlobal for alpha calibration");
                 model_->calibrate(swaptionBasket_, *optimizationMethod_, endCriteria_);
             }
+            functionEvaluations_ = model_->functionEvaluation();
         } else {
             if (!data_->calibrateA() && !data_->calibrateH()) {
                 LOG("skip LGM calibration (both calibrate volatility and reversion are false)");
             } else {
                 LOG("call calibrateGlobal");
                 model_->calibrate(swaptionBasket_, *optimizationMethod_, endCriteria_);
+                functionEvaluations_ = model_->functionEvaluation();
             }
         }
         LOG("LGM " << data_->ccy() << " calibration errors:");
@@ -202,6 +224,27 @@ void LgmBuilder::performCalculations() const {
         LOG("Apply scaling " << data_->scaling() << " to the " << data_->ccy() << " LGM model");
         parametrization_->scaling() = data_->scaling();
     }
+
+    calibrated_ = true;
+    calibrationInputs_ = inputs;
+    ++calibrations_;
+    totalFunctionEvaluations_ += functionEvaluations_;
+    DLOG("LGM " << data_->ccy() << " calibration #" << calibrations_ << " used " << functionEvaluations_
+                << " function evaluations (total " << totalFunctionEvaluations_ << ", skipped calibrations "
+                << skippedCalibrations_ << ")");
+}
+
+std::vector<Real> LgmBuilder::calibrationInputs() const {
+    // the basket market values capture the swaption vols and the curves attached to the helpers, the model's
+    // discount curve is captured by its discount factors at the basket expiries and maturities
+    std::vector<Real> inputs;
+    for (auto const& h : swaptionBasket_)
+        inputs.push_back(h->marketValue());
+    for (Size j = 0; j < swaptionExpiries_.size(); ++j)
+        inputs.push_back(discountCurve_->discount(swaptionExpiries_[j]));
+    for (Size j = 0; j < swaptionMaturities_.size(); ++j)
+        inputs.push_back(discountCurve_->discount(swaptionMaturities_[j]));
+    return inputs;
 }
 
 void LgmBuilder::buildSwaptionBasket() const {
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include <qle/models/lgm.hpp>
+#include <qle/pricingengines/analyticlgmswaptionengine.hpp>
 
 #include <ored/model/irlgmdata.hpp>
 #include <ored/model/modelbuilder.hpp>
@@ -48,9 +49,16 @@ class LgmBuilder : public ModelBuilder {
 public:
     /*! The configuration should refer to the calibration configuration here,
       alternative discounting curves are then usually set in the pricing
-      engines for swaptions etc. */
+      engines for swaptions etc.
+
+      If continueCalibration is true, a recalibration starts from the previous
+      solution instead of the initial parameters, and it is skipped entirely if
+      the calibration basket market values and the relevant discount factors
+      are unchanged since the last calibration. This is intended for repeated
+      recalibrations e.g. in sensitivity or exposure simulation runs. */
     LgmBuilder(const boost::shared_ptr<ore::data::Market>& market, const boost::shared_ptr<IrLgmData>& data,
-               const std::string& configuration = Market::defaultConfiguration, Real bootstrapTolerance = 0.001);
+               const std::string& configuration = Market::defaultConfiguration, Real bootstrapTolerance = 0.001,
+               const bool continueCalibration = false);
     //! Return calibration error
     Real error() {
         calculate();
@@ -71,24 +79,44 @@ public:
         return swaptionBasket_;
     }
     //@}
+
+    //! \name Calibration statistics
+    //@{
+    //! Number of calibrations performed
+    Size calibrations() const { return calibrations_; }
+    //! Number of calibrations skipped because the calibration inputs were unchanged
+    Size skippedCalibrations() const { return skippedCalibrations_; }
+    //! Number of cost function evaluations of the last calibration
+    Integer functionEvaluations() const { return functionEvaluations_; }
+    //! Number of cost function evaluations summed over all calibrations
+    Integer totalFunctionEvaluations() const { return totalFunctionEvaluations_; }
+    //@}
+
 private:
     void performCalculations() const override;
     void buildSwaptionBasket() const;
+    std::vector<Real> calibrationInputs() const;
 
     boost::shared_ptr<ore::data::Market> market_;
     const std::string configuration_;
     boost::shared_ptr<IrLgmData> data_;
     Real bootstrapTolerance_;
+    bool continueCalibration_;
     mutable Real error_;
     boost::shared_ptr<QuantExt::LGM> model_;
     Array params_;
-    boost::shared_ptr<QuantLib::PricingEngine> swaptionEngine_;
+    boost::shared_ptr<QuantExt::AnalyticLgmSwaptionEngine> swaptionEngine_;
     boost::shared_ptr<QuantExt::IrLgm1fParametrization> parametrization_;
     RelinkableHandle<YieldTermStructure> discountCurve_;
     mutable std::vector<boost::shared_ptr<BlackCalibrationHelper>> swaptionBasket_;
     mutable Array swaptionExpiries_;
     mutable Array swaptionMaturities_;
 
+    mutable bool calibrated_;
+    mutable std::vector<Real> calibrationInputs_;
+    mutable Size calibrations_, skippedCalibrations_;
+    mutable Integer functionEvaluations_, totalFunctionEvaluations_;
+
     Handle<QuantLib::SwaptionVolatilityStructure> svts_;
     Handle<SwapIndex> swapIndex_, shortSwapIndex_;
 
@@ -62,6 +62,7 @@ boost::shared_ptr<QuantExt::LGM> LGMBermudanSwaptionEngineBuilder::model(const s
                                                                                          << ") for n volatility times ("
                                                                                          << sigmaTimes.size() << ")");
     Real tolerance = parseReal(modelParameter("Tolerance"));
+    bool continueCalibration = parseBool(modelParameter("ContinueCalibration", "", false, "false"));
     auto reversionType = parseReversionType(modelParameter("ReversionType"));
     auto volatilityType = parseVolatilityType(modelParameter("VolatilityType"));
 
@@ -142,7 +143,8 @@ boost::shared_ptr<QuantExt::LGM> LGMBermudanSwaptionEngineBuilder::model(const s
     // Build and calibrate model
     DLOG("Build LGM model");
     boost::shared_ptr<LgmBuilder> calib =
-        boost::make_shared<LgmBuilder>(market_, data, configuration(MarketContext::irCalibration), tolerance);
+        boost::make_shared<LgmBuilder>(market_, data, configuration(MarketContext::irCalibration), tolerance,
+                                       continueCalibration);
 
     // In some cases, we do not want to calibrate the model
     boost::shared_ptr<QuantExt::LGM> model;
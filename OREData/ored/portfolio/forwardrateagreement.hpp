@@ -48,6 +48,17 @@ public:
         return {};
     }
 
+    //! \name Inspectors
+    //@{
+    const string& longShort() const { return longShort_; }
+    const string& currency() const { return currency_; }
+    const string& startDate() const { return startDate_; }
+    const string& endDate() const { return endDate_; }
+    const string& index() const { return index_; }
+    double strike() const { return strike_; }
+    double amount() const { return amount_; }
+    //@}
+
     virtual void fromXML(XMLNode* node) override;
     virtual XMLNode* toXML(XMLDocument& doc) override;
 
@@ -90,6 +90,12 @@ public:
     boost::shared_ptr<QuantLib::Instrument> qlInstrument() const { return instrument_; }
     /*! The multiplier */
     const Real& multiplier() const { return multiplier_; }
+    /*! The additional instruments, e.g. premium payments */
+    const std::vector<boost::shared_ptr<QuantLib::Instrument>>& additionalInstruments() const {
+        return additionalInstruments_;
+    }
+    /*! The multipliers of the additional instruments */
+    const std::vector<Real>& additionalMultipliers() const { return additionalMultipliers_; }
     //@}
 
 protected:
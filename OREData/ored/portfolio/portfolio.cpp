@@ -18,6 +18,7 @@
 
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/schedule.hpp>
 #include <ored/portfolio/swap.hpp>
 #include <ored/portfolio/swaption.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
@@ -124,6 +125,7 @@ void Portfolio::removeMatured(const Date& asof) {
 
 void Portfolio::build(const boost::shared_ptr<EngineFactory>& engineFactory) {
     LOG("Building Portfolio of size " << trades_.size());
+    Size scheduleHits = ScheduleCache::instance().hits(), scheduleMisses = ScheduleCache::instance().misses();
     auto trade = trades_.begin();
     while (trade != trades_.end()) {
         try {
@@ -135,6 +137,12 @@ void Portfolio::build(const boost::shared_ptr<EngineFactory>& engineFactory) {
         }
     }
     LOG("Built Portfolio. Size now " << trades_.size());
+    if (ScheduleCache::instance().enabled()) {
+        scheduleHits = ScheduleCache::instance().hits() - scheduleHits;
+        scheduleMisses = ScheduleCache::instance().misses() - scheduleMisses;
+        LOG("Schedule cache: " << scheduleHits << " hits, " << scheduleMisses << " misses, "
+                               << ScheduleCache::instance().size() << " schedules cached");
+    }
 
     QL_REQUIRE(trades_.size() > 0, "Portfolio does not contain any built trades");
 }
@@ -158,7 +158,106 @@ void updateData(const std::string& s, T& t, bool& hasT, bool& hasConsistentT, co
 }
 } // namespace
 
+namespace {
+// content key of the schedule data, the fields are separated by characters that do not occur in the data
+void appendKey(std::string& key, const std::string& s) {
+    key += s;
+    key += '|';
+}
+
+std::string scheduleKey(const ScheduleData& data) {
+    std::string key;
+    for (auto& d : data.dates()) {
+        key += "D|";
+        appendKey(key, d.calendar());
+        appendKey(key, d.convention());
+        appendKey(key, d.tenor());
+        for (auto& date : d.dates())
+            appendKey(key, date);
+    }
+    for (auto& r : data.rules()) {
+        key += "R|";
+        appendKey(key, r.startDate());
+        appendKey(key, r.endDate());
+        appendKey(key, r.tenor());
+        appendKey(key, r.calendar());
+        appendKey(key, r.convention());
+        appendKey(key, r.termConvention());
+        appendKey(key, r.rule());
+        appendKey(key, r.endOfMonth());
+        appendKey(key, r.firstDate());
+        appendKey(key, r.lastDate());
+    }
+    return key;
+}
+
+Schedule buildSchedule(const ScheduleData& data);
+} // namespace
+
+Schedule ScheduleCache::schedule(const ScheduleData& data) {
+    std::string key = scheduleKey(data);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = schedules_.find(key);
+        if (it != schedules_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+    }
+    // build outside the lock, if another thread builds the same schedule meanwhile, the first one is kept
+    Schedule schedule = buildSchedule(data);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (schedules_.size() >= maxSize_) {
+        DLOG("ScheduleCache reached its maximum size " << maxSize_ << ", clear the cached schedules");
+        schedules_.clear();
+    }
+    schedules_.insert(std::make_pair(key, schedule));
+    return schedule;
+}
+
+Size ScheduleCache::maxSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxSize_;
+}
+
+void ScheduleCache::setMaxSize(const Size maxSize) {
+    QL_REQUIRE(maxSize > 0, "ScheduleCache: maximum size must be positive");
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxSize_ = maxSize;
+    if (schedules_.size() > maxSize_)
+        schedules_.clear();
+}
+
+Size ScheduleCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+Size ScheduleCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+Size ScheduleCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return schedules_.size();
+}
+
+void ScheduleCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedules_.clear();
+    hits_ = misses_ = 0;
+}
+
 Schedule makeSchedule(const ScheduleData& data) {
+    if (ScheduleCache::instance().enabled())
+        return ScheduleCache::instance().schedule(data);
+    return buildSchedule(data);
+}
+
+namespace {
+Schedule buildSchedule(const ScheduleData& data) {
     // build all the date and rule based sub-schedules we have
     vector<Schedule> schedules;
     for (auto& d : data.dates())
@@ -181,6 +280,8 @@ Schedule makeSchedule(const ScheduleData& data) {
         BusinessDayConvention convention = Null<BusinessDayConvention>(),
                               termConvention = Unadjusted; // initialization prevents gcc warning
         Calendar calendar;
+        // parseCalendar has a defaulted second parameter, so it can not be converted to the parser function directly
+        std::function<Calendar(string)> calendarParser = [](const string& s) { return parseCalendar(s); };
         Period tenor;
         DateGeneration::Rule rule = DateGeneration::Zero; // initialization prevents gcc warning
         bool endOfMonth = false;                          // initialization prevents gcc warning
@@ -188,13 +289,13 @@ Schedule makeSchedule(const ScheduleData& data) {
              hasEndOfMonth = false, hasConsistentCalendar = true, hasConsistentConvention = true,
              hasConsistentTenor = true, hasConsistentRule = true, hasConsistentEndOfMonth = true;
         for (auto& d : data.dates()) {
-            updateData<Calendar>(d.calendar(), calendar, hasCalendar, hasConsistentCalendar, parseCalendar);
+            updateData<Calendar>(d.calendar(), calendar, hasCalendar, hasConsistentCalendar, calendarParser);
             updateData<BusinessDayConvention>(d.convention(), convention, hasConvention, hasConsistentConvention,
                                               parseBusinessDayConvention);
             updateData<Period>(d.tenor(), tenor, hasTenor, hasConsistentTenor, parsePeriod);
         }
         for (auto& d : data.rules()) {
-            updateData<Calendar>(d.calendar(), calendar, hasCalendar, hasConsistentCalendar, parseCalendar);
+            updateData<Calendar>(d.calendar(), calendar, hasCalendar, hasConsistentCalendar, calendarParser);
             updateData<BusinessDayConvention>(d.convention(), convention, hasConvention, hasConsistentConvention,
                                               parseBusinessDayConvention);
             updateData<Period>(d.tenor(), tenor, hasTenor, hasConsistentTenor, parsePeriod);
@@ -246,5 +347,7 @@ Schedule makeSchedule(const ScheduleData& data) {
                         isRegular);
     }
 }
+} // namespace
+
 } // namespace data
 } // namespace ore
@@ -24,8 +24,13 @@
 #pragma once
 
 #include <ored/utilities/xmlutils.hpp>
+#include <ql/patterns/singleton.hpp>
 #include <ql/time/schedule.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 namespace ore {
 namespace data {
 
@@ -145,7 +150,56 @@ private:
     vector<ScheduleRules> rules_;
 };
 
+//! Cache of schedules built from ScheduleData
+/*! Trades often share identical schedule data, e.g. spot starting schedules with the same tenor and calendar. The
+    schedules are cached keyed on the content of the schedule data, so that identical schedules are generated only
+    once, also across portfolio builds. A QuantLib::Schedule only depends on the schedule data and is a value type,
+    so that it can be shared safely. The legs built on a schedule are not cached, since their coupons are bound to
+    the market indices and pricers of the trade.
+
+    The cache is enabled by default and can be used from several threads. To bound its memory in a long running
+    process, the cache is emptied when it reaches the maximum size (100000 schedules by default).
+
+    \ingroup tradedata
+*/
+class ScheduleCache : public QuantLib::Singleton<ScheduleCache> {
+    friend class QuantLib::Singleton<ScheduleCache>;
+
+private:
+    ScheduleCache() : enabled_(true), maxSize_(100000), hits_(0), misses_(0) {}
+
+public:
+    bool enabled() const { return enabled_; }
+    void setEnabled(const bool enabled) { enabled_ = enabled; }
+
+    //! maximum number of cached schedules, the cache is emptied when this is reached
+    QuantLib::Size maxSize() const;
+    void setMaxSize(const QuantLib::Size maxSize);
+
+    //! the schedule for the given data, built on the first request
+    QuantLib::Schedule schedule(const ScheduleData& data);
+
+    //! \name Statistics
+    //@{
+    QuantLib::Size hits() const;
+    QuantLib::Size misses() const;
+    //! number of cached schedules
+    QuantLib::Size size() const;
+    //@}
+
+    //! remove all schedules and reset the statistics
+    void clear();
+
+private:
+    std::atomic<bool> enabled_;
+    mutable std::mutex mutex_;
+    QuantLib::Size maxSize_;
+    std::unordered_map<std::string, QuantLib::Schedule> schedules_;
+    QuantLib::Size hits_, misses_;
+};
+
 //! Functions
+/*! The schedule for ScheduleData is taken from the ScheduleCache if that is enabled */
 QuantLib::Schedule makeSchedule(const ScheduleData& data);
 QuantLib::Schedule makeSchedule(const ScheduleDates& dates);
 QuantLib::Schedule makeSchedule(const ScheduleRules& rules);
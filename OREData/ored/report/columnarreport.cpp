@@ -0,0 +1,333 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/make_shared.hpp>
+#include <ored/report/columnarreport.hpp>
+#include <ored/report/csvreport.hpp>
+#include <ored/utilities/log.hpp>
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+const char magic[8] = {'O', 'R', 'E', 'R', 'P', 'T', 'C', '1'};
+const std::uint32_t version = 1;
+
+template <class T> void write(FILE* fp, const T* data, Size n) {
+    if (n > 0)
+        QL_REQUIRE(fwrite(data, sizeof(T), n, fp) == n, "Error writing columnar report");
+}
+
+template <class T> void write(FILE* fp, const T& value) { write(fp, &value, 1); }
+
+void write(FILE* fp, const string& s) {
+    write(fp, static_cast<std::uint32_t>(s.size()));
+    write(fp, s.data(), s.size());
+}
+
+template <class T> void read(FILE* fp, T* data, Size n) {
+    if (n > 0)
+        QL_REQUIRE(fread(data, sizeof(T), n, fp) == n, "Error reading columnar report, unexpected end of file");
+}
+
+template <class T> T read(FILE* fp) {
+    T value;
+    read(fp, &value, 1);
+    return value;
+}
+
+string readString(FILE* fp) {
+    string s(read<std::uint32_t>(fp), ' ');
+    if (!s.empty())
+        read(fp, &s[0], s.size());
+    return s;
+}
+
+} // namespace
+
+ColumnarFileReport::ColumnarFileReport(const string& filename, const Size groupSize)
+    : filename_(filename), groupSize_(groupSize), rows_(0), i_(0), header_(false), fp_(NULL) {
+    QL_REQUIRE(groupSize_ > 0, "ColumnarFileReport: group size must be positive");
+    fp_ = fopen(filename_.c_str(), "wb");
+    QL_REQUIRE(fp_, "Error opening file " << filename_);
+}
+
+ColumnarFileReport::~ColumnarFileReport() {
+    try {
+        end();
+    } catch (const std::exception& e) {
+        ALOG("Error writing columnar report " << filename_ << ": " << e.what());
+    }
+}
+
+Report& ColumnarFileReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    QL_REQUIRE(!header_, "Cannot add column " << name << " after the first row");
+    names_.push_back(name);
+    precisions_.push_back(precision);
+    columns_.push_back(Column());
+    columns_.back().type = rt.which();
+    i_++;
+    return *this;
+}
+
+Report& ColumnarFileReport::next() {
+    QL_REQUIRE(i_ == columns_.size(), "Cannot go to next line, only " << i_ << " entries filled");
+    if (!header_)
+        writeHeader();
+    if (rows_ >= groupSize_)
+        writeGroup();
+    rows_++;
+    i_ = 0;
+    return *this;
+}
+
+Report& ColumnarFileReport::add(const ReportType& rt) {
+    QL_REQUIRE(header_ && i_ < columns_.size(), "No column to add [" << rt << "] to.");
+    Column& c = columns_[i_];
+    QL_REQUIRE(rt.which() == c.type, "Cannot add value " << rt << " of type " << rt.which() << " to column " << i_
+                                                         << " of type " << c.type);
+    switch (c.type) {
+    case 0:
+        c.sizes.push_back(boost::get<Size>(rt));
+        break;
+    case 1:
+        c.reals.push_back(boost::get<Real>(rt));
+        break;
+    case 2:
+        c.strings.push_back(boost::get<string>(rt));
+        break;
+    case 3:
+        c.dates.push_back(static_cast<std::int32_t>(boost::get<Date>(rt).serialNumber()));
+        break;
+    default:
+        c.periods.push_back(boost::get<Period>(rt));
+    }
+    i_++;
+    return *this;
+}
+
+void ColumnarFileReport::end() {
+    if (!fp_)
+        return;
+    FILE* fp = fp_;
+    try {
+        if (!header_)
+            writeHeader();
+        if (rows_ > 0 && i_ < columns_.size()) {
+            // drop an incomplete last row, so that all columns have the same length
+            WLOG("Columnar report " << filename_ << ": incomplete last row dropped");
+            Size n = rows_ - 1;
+            for (auto& c : columns_) {
+                c.sizes.resize(std::min(c.sizes.size(), n));
+                c.reals.resize(std::min(c.reals.size(), n));
+                c.strings.resize(std::min(c.strings.size(), n));
+                c.dates.resize(std::min(c.dates.size(), n));
+                c.periods.resize(std::min(c.periods.size(), n));
+            }
+            rows_ = n;
+        }
+        writeGroup();
+    } catch (...) {
+        fclose(fp);
+        fp_ = NULL;
+        throw;
+    }
+    fp_ = NULL;
+    QL_REQUIRE(fclose(fp) == 0, "Error closing file " << filename_);
+}
+
+void ColumnarFileReport::writeHeader() {
+    write(fp_, magic, sizeof(magic));
+    write(fp_, version);
+    write(fp_, static_cast<std::uint32_t>(columns_.size()));
+    for (Size i = 0; i < columns_.size(); ++i) {
+        write(fp_, names_[i]);
+        write(fp_, static_cast<std::uint8_t>(columns_[i].type));
+        write(fp_, static_cast<std::uint32_t>(precisions_[i]));
+    }
+    header_ = true;
+}
+
+void ColumnarFileReport::writeGroup() {
+    if (rows_ == 0)
+        return;
+    write(fp_, static_cast<std::uint64_t>(rows_));
+    for (auto& c : columns_) {
+        switch (c.type) {
+        case 0:
+            write(fp_, c.sizes.data(), rows_);
+            c.sizes.clear();
+            break;
+        case 1:
+            write(fp_, c.reals.data(), rows_);
+            c.reals.clear();
+            break;
+        case 2: {
+            // dictionary of the distinct strings in order of appearance and an index per row
+            std::map<string, std::uint32_t> dictionary;
+            std::vector<const string*> entries;
+            std::vector<std::uint32_t> index(rows_);
+            for (Size r = 0; r < rows_; ++r) {
+                auto d = dictionary.insert(std::make_pair(c.strings[r], static_cast<std::uint32_t>(entries.size())));
+                if (d.second)
+                    entries.push_back(&d.first->first);
+                index[r] = d.first->second;
+            }
+            write(fp_, static_cast<std::uint32_t>(entries.size()));
+            for (auto e : entries)
+                write(fp_, *e);
+            write(fp_, index.data(), rows_);
+            c.strings.clear();
+            break;
+        }
+        case 3:
+            write(fp_, c.dates.data(), rows_);
+            c.dates.clear();
+            break;
+        default: {
+            std::vector<std::int32_t> lengths(rows_), units(rows_);
+            for (Size r = 0; r < rows_; ++r) {
+                lengths[r] = c.periods[r].length();
+                units[r] = static_cast<std::int32_t>(c.periods[r].units());
+            }
+            write(fp_, lengths.data(), rows_);
+            write(fp_, units.data(), rows_);
+            c.periods.clear();
+        }
+        }
+    }
+    rows_ = 0;
+}
+
+void readColumnarReport(const string& filename, Report& report) {
+    FILE* fp = fopen(filename.c_str(), "rb");
+    QL_REQUIRE(fp, "Error opening file " << filename);
+    try {
+        char tag[sizeof(magic)];
+        read(fp, tag, sizeof(tag));
+        QL_REQUIRE(std::memcmp(tag, magic, sizeof(magic)) == 0, "File " << filename << " is not a columnar report");
+        std::uint32_t v = read<std::uint32_t>(fp);
+        QL_REQUIRE(v == version, "Columnar report " << filename << " has unsupported version " << v);
+
+        std::vector<int> types(read<std::uint32_t>(fp));
+        for (auto& type : types) {
+            string name = readString(fp);
+            type = read<std::uint8_t>(fp);
+            Size precision = read<std::uint32_t>(fp);
+            switch (type) {
+            case 0:
+                report.addColumn(name, Size(), precision);
+                break;
+            case 1:
+                report.addColumn(name, Real(), precision);
+                break;
+            case 2:
+                report.addColumn(name, string(), precision);
+                break;
+            case 3:
+                report.addColumn(name, Date(), precision);
+                break;
+            case 4:
+                report.addColumn(name, Period(), precision);
+                break;
+            default:
+                QL_FAIL("Columnar report " << filename << " has unknown column type " << type);
+            }
+        }
+
+        std::uint64_t rows;
+        while (fread(&rows, sizeof(rows), 1, fp) == 1) {
+            // read the group column by column, then replay it row by row
+            std::vector<std::vector<Report::ReportType>> values(types.size(), std::vector<Report::ReportType>(rows));
+            for (Size i = 0; i < types.size(); ++i) {
+                switch (types[i]) {
+                case 0: {
+                    std::vector<std::uint64_t> data(rows);
+                    read(fp, data.data(), rows);
+                    for (Size r = 0; r < rows; ++r)
+                        values[i][r] = static_cast<Size>(data[r]);
+                    break;
+                }
+                case 1: {
+                    std::vector<double> data(rows);
+                    read(fp, data.data(), rows);
+                    for (Size r = 0; r < rows; ++r)
+                        values[i][r] = static_cast<Real>(data[r]);
+                    break;
+                }
+                case 2: {
+                    std::vector<string> entries(read<std::uint32_t>(fp));
+                    for (auto& e : entries)
+                        e = readString(fp);
+                    std::vector<std::uint32_t> index(rows);
+                    read(fp, index.data(), rows);
+                    for (Size r = 0; r < rows; ++r) {
+                        QL_REQUIRE(index[r] < entries.size(), "Columnar report " << filename << " is corrupt");
+                        values[i][r] = entries[index[r]];
+                    }
+                    break;
+                }
+                case 3: {
+                    std::vector<std::int32_t> data(rows);
+                    read(fp, data.data(), rows);
+                    for (Size r = 0; r < rows; ++r)
+                        values[i][r] = Date(static_cast<Date::serial_type>(data[r]));
+                    break;
+                }
+                default: {
+                    std::vector<std::int32_t> lengths(rows), units(rows);
+                    read(fp, lengths.data(), rows);
+                    read(fp, units.data(), rows);
+                    for (Size r = 0; r < rows; ++r)
+                        values[i][r] = Period(lengths[r], static_cast<QuantLib::TimeUnit>(units[r]));
+                }
+                }
+            }
+            for (Size r = 0; r < rows; ++r) {
+                report.next();
+                for (Size i = 0; i < types.size(); ++i)
+                    report.add(values[i][r]);
+            }
+        }
+    } catch (...) {
+        fclose(fp);
+        throw;
+    }
+    fclose(fp);
+    report.end();
+}
+
+boost::shared_ptr<Report> makeFileReport(const string& filename, const bool binary) {
+    if (binary) {
+        string binaryFileName = filename;
+        if (boost::algorithm::ends_with(filename, ".csv"))
+            binaryFileName = filename.substr(0, filename.size() - 4) + ".bin";
+        return boost::make_shared<ColumnarFileReport>(binaryFileName);
+    }
+    return boost::make_shared<CSVFileReport>(filename);
+}
+
+} // namespace data
+} // namespace ore
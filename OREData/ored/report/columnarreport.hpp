@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/report/columnarreport.hpp
+    \brief Binary columnar report class
+    \ingroup report
+*/
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <ored/report/report.hpp>
+
+#include <cstdint>
+#include <stdio.h>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+/*! Binary columnar report class
+
+    The report is written as a typed schema taken from addColumn (name, type and precision of each column) followed
+    by row groups of up to groupSize rows, in which the values of each column are stored contiguously in native byte
+    order: Size as 64 bit integers, Real as doubles without rounding, Date as serial numbers, Period as length and
+    units, and strings dictionary encoded per row group. This avoids the text formatting of CSVFileReport for large
+    reports and keeps the files compact. readColumnarReport() replays such a file into any other report, e.g. a
+    CSVFileReport for conversion or an InMemoryReport.
+
+    \ingroup report
+*/
+class ColumnarFileReport : public Report {
+public:
+    //! Create a report with the given filename, will throw if it cannot open the file
+    ColumnarFileReport(const string& filename, const Size groupSize = 65536);
+    ~ColumnarFileReport();
+
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
+    Report& next() override;
+    Report& add(const ReportType& rt) override;
+    void end() override;
+
+private:
+    struct Column {
+        int type;
+        std::vector<std::uint64_t> sizes;
+        std::vector<double> reals;
+        std::vector<string> strings;
+        std::vector<std::int32_t> dates;
+        std::vector<Period> periods;
+    };
+
+    void writeHeader();
+    void writeGroup();
+
+    std::vector<string> names_;
+    std::vector<Size> precisions_;
+    std::vector<Column> columns_;
+    string filename_;
+    Size groupSize_;
+    Size rows_, i_;
+    bool header_;
+    FILE* fp_;
+};
+
+//! Replay the columns and rows of a file written by ColumnarFileReport into the given report, and end it
+/*! \ingroup report
+ */
+void readColumnarReport(const string& filename, Report& report);
+
+//! Create a ColumnarFileReport if binary is true, with a file name ending in .csv changed to .bin, else a CSVFileReport
+/*! \ingroup report
+ */
+boost::shared_ptr<Report> makeFileReport(const string& filename, const bool binary);
+
+} // namespace data
+} // namespace ore
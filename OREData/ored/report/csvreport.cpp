@@ -16,81 +16,189 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
-#include <boost/variant/static_visitor.hpp>
+#include <boost/make_shared.hpp>
 #include <ored/report/csvreport.hpp>
+#include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/math/rounding.hpp>
 
+#include <cmath>
+
 namespace ore {
 namespace data {
 
-// Local class for printing each report type via fprintf
-class ReportTypePrinter : public boost::static_visitor<> {
+namespace {
+void appendUnsigned(string& out, unsigned long long n, int minDigits = 1) {
+    char buf[24];
+    int i = sizeof(buf);
+    do {
+        buf[--i] = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n > 0 || static_cast<int>(sizeof(buf)) - i < minDigits);
+    out.append(buf + i, sizeof(buf) - i);
+}
+} // namespace
+
+// Local class for printing each report type into a buffer
+class ReportTypePrinter {
 public:
-    ReportTypePrinter(FILE* fp, int prec) : fp_(fp), rounding_(prec, QuantLib::Rounding::Closest), null_("#N/A") {}
+    ReportTypePrinter(int prec)
+        : rounding_(prec, QuantLib::Rounding::Closest), mult_(std::pow(10.0, prec)), null_("#N/A") {}
 
-    void operator()(const Size i) const {
-        if (i == QuantLib::Null<Size>()) {
-            fprintNull();
-        } else {
-            fprintf(fp_, "%zu", i);
+    void print(string& out, const Report::ReportType& rt) const {
+        switch (rt.which()) {
+        case 0:
+            print(out, boost::get<Size>(rt));
+            break;
+        case 1:
+            print(out, boost::get<Real>(rt));
+            break;
+        case 2:
+            out += boost::get<string>(rt);
+            break;
+        case 3:
+            print(out, boost::get<Date>(rt));
+            break;
+        default:
+            out += to_string(boost::get<Period>(rt));
         }
     }
-    void operator()(const Real d) const {
+
+private:
+    void print(string& out, const Size i) const {
+        if (i == QuantLib::Null<Size>())
+            out += null_;
+        else
+            appendUnsigned(out, i);
+    }
+    void print(string& out, const Real d) const {
         if (d == QuantLib::Null<Real>()) {
-            fprintNull();
+            out += null_;
+            return;
+        }
+        Real r = rounding_(d);
+        if (QuantLib::close_enough(r, 0.0))
+            r = 0.0;
+        // the rounded value is an integer multiple of 10^-precision, below 10^15 such multiples are printed from
+        // the integer directly, with the same digits as a printf with the given precision
+        Real scaled = std::fabs(r) * mult_;
+        int precision = rounding_.precision();
+        if (precision <= 15 && scaled < 1.0E15) {
+            if (r < 0.0)
+                out += '-';
+            appendUnsigned(out, static_cast<unsigned long long>(std::llround(scaled)), precision + 1);
+            if (precision > 0)
+                out.insert(out.end() - precision, '.');
         } else {
-            Real r = rounding_(d);
-            fprintf(fp_, "%.*f", rounding_.precision(), QuantLib::close_enough(r, 0.0) ? 0.0 : r);
+            int n = snprintf(NULL, 0, "%.*f", precision, r);
+            Size pos = out.size();
+            out.resize(pos + n + 1);
+            snprintf(&out[pos], n + 1, "%.*f", precision, r);
+            out.resize(pos + n);
         }
     }
-    void operator()(const string& s) const { fprintf(fp_, "%s", s.c_str()); }
-    void operator()(const Date& d) const {
+    void print(string& out, const Date& d) const {
         if (d == QuantLib::Null<Date>()) {
-            fprintNull();
+            out += null_;
         } else {
-            string s = to_string(d);
-            fprintf(fp_, "%s", s.c_str());
+            appendUnsigned(out, d.year(), 4);
+            out += '-';
+            appendUnsigned(out, static_cast<int>(d.month()), 2);
+            out += '-';
+            appendUnsigned(out, d.dayOfMonth(), 2);
         }
     }
-    void operator()(const Period& p) const {
-        string s = to_string(p);
-        fprintf(fp_, "%s", s.c_str());
+
+    QuantLib::Rounding rounding_;
+    Real mult_;
+    string null_;
+};
+
+// Rows of a partition, formatted with copies of the column types and printers of the parent report, so that the
+// partition stays valid if it outlives the parent
+class CSVReportPartition : public Report {
+public:
+    CSVReportPartition(const std::vector<Report::ReportType>& columnTypes,
+                       const std::vector<ReportTypePrinter>& printers, char sep)
+        : columnTypes_(columnTypes), printers_(printers), sep_(sep), i_(columnTypes.size()), ended_(false) {}
+
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override {
+        QL_FAIL("Cannot add column " << name << " to a report partition");
+    }
+    Report& next() override {
+        QL_REQUIRE(!ended_, "Cannot add a line to a report partition after its report ended");
+        QL_REQUIRE(i_ == columnTypes_.size(), "Cannot go to next line, only " << i_ << " entries filled");
+        buffer_ += '\n';
+        i_ = 0;
+        return *this;
+    }
+    Report& add(const ReportType& rt) override {
+        QL_REQUIRE(!ended_, "Cannot add [" << rt << "] to a report partition after its report ended");
+        QL_REQUIRE(i_ < columnTypes_.size(), "No column to add [" << rt << "] to.");
+        QL_REQUIRE(rt.which() == columnTypes_[i_].which(), "Cannot add value " << rt << " of type " << rt.which()
+                                                                               << " to column " << i_ << " of type "
+                                                                               << columnTypes_[i_].which());
+        if (i_ != 0)
+            buffer_ += sep_;
+        printers_[i_].print(buffer_, rt);
+        i_++;
+        return *this;
     }
+    void end() override {}
 
-private:
-    void fprintNull() const { fprintf(fp_, "%s", null_.c_str()); }
+    const string& buffer() const { return buffer_; }
+    //! called when the parent report ends, the rows are written then and no rows can be added afterwards
+    void close() {
+        ended_ = true;
+        string().swap(buffer_);
+    }
 
-    FILE* fp_;
-    QuantLib::Rounding rounding_;
-    const string null_;
+private:
+    std::vector<Report::ReportType> columnTypes_;
+    std::vector<ReportTypePrinter> printers_;
+    char sep_;
+    Size i_;
+    string buffer_;
+    bool ended_;
 };
 
-CSVFileReport::CSVFileReport(const string& filename, const char sep, const bool commentCharacter)
-    : filename_(filename), sep_(sep), commentCharacter_(commentCharacter), i_(0), fp_(NULL) {
+CSVFileReport::CSVFileReport(const string& filename, const char sep, const bool commentCharacter,
+                             const Size bufferSize)
+    : filename_(filename), sep_(sep), commentCharacter_(commentCharacter), bufferSize_(bufferSize), i_(0),
+      fp_(NULL) {
     fp_ = fopen(filename_.c_str(), "w+");
     QL_REQUIRE(fp_, "Error opening file " << filename_);
+    buffer_.reserve(bufferSize_ + 4096);
 }
 
-CSVFileReport::~CSVFileReport() { end(); }
+CSVFileReport::~CSVFileReport() {
+    try {
+        end();
+    } catch (const std::exception& e) {
+        ALOG("Error writing CSV report " << filename_ << ": " << e.what());
+    }
+}
 
 Report& CSVFileReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    QL_REQUIRE(partitions_.empty(), "Cannot add column " << name << " after creating report partitions");
     columnTypes_.push_back(rt);
-    printers_.push_back(ReportTypePrinter(fp_, precision));
+    printers_.push_back(ReportTypePrinter(precision));
     if (i_ == 0 && commentCharacter_)
-        fprintf(fp_, "#");
+        buffer_ += '#';
     if (i_ > 0)
-        fprintf(fp_, "%c", sep_);
-    fprintf(fp_, "%s", name.c_str());
+        buffer_ += sep_;
+    buffer_ += name;
     i_++;
     return *this;
 }
 
 Report& CSVFileReport::next() {
     QL_REQUIRE(i_ == columnTypes_.size(), "Cannot go to next line, only " << i_ << " entries filled");
-    fprintf(fp_, "\n");
+    if (buffer_.size() >= bufferSize_)
+        flush();
+    buffer_ += '\n';
     i_ = 0;
     return *this;
 }
@@ -102,17 +210,43 @@ Report& CSVFileReport::add(const ReportType& rt) {
                                                                            << columnTypes_[i_].which());
 
     if (i_ != 0)
-        fprintf(fp_, "%c", sep_);
-    boost::apply_visitor(printers_[i_], rt);
+        buffer_ += sep_;
+    printers_[i_].print(buffer_, rt);
     i_++;
     return *this;
 }
+
+boost::shared_ptr<Report> CSVFileReport::partition() {
+    QL_REQUIRE(fp_, "Cannot create a partition of report " << filename_ << " after it ended");
+    partitions_.push_back(boost::make_shared<CSVReportPartition>(columnTypes_, printers_, sep_));
+    return partitions_.back();
+}
+
+void CSVFileReport::flush() {
+    if (!buffer_.empty()) {
+        size_t n = fwrite(buffer_.data(), 1, buffer_.size(), fp_);
+        QL_REQUIRE(n == buffer_.size(), "Error writing to file " << filename_);
+        buffer_.clear();
+    }
+}
+
 void CSVFileReport::end() {
-    if (fp_) {
-        fprintf(fp_, "\n");
-        fclose(fp_);
-        fp_ = NULL;
+    if (!fp_)
+        return;
+    // the file is closed and the partitions are closed also if a write fails
+    bool ok = fwrite(buffer_.data(), 1, buffer_.size(), fp_) == buffer_.size();
+    buffer_.clear();
+    for (auto const& p : partitions_) {
+        if (ok)
+            ok = fwrite(p->buffer().data(), 1, p->buffer().size(), fp_) == p->buffer().size();
+        p->close();
     }
+    partitions_.clear();
+    if (ok)
+        ok = fputc('\n', fp_) != EOF;
+    ok = fclose(fp_) == 0 && ok;
+    fp_ = NULL;
+    QL_REQUIRE(ok, "Error writing to file " << filename_);
 }
 } // namespace data
 } // namespace ore
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <boost/shared_ptr.hpp>
 #include <ored/report/report.hpp>
 #include <stdio.h>
 #include <vector>
@@ -31,8 +32,12 @@ namespace ore {
 namespace data {
 
 class ReportTypePrinter;
+class CSVReportPartition;
 /*! CSV Report class
 
+    The rows are formatted into a user-space buffer which is written to the file whenever it exceeds bufferSize
+    bytes and when the report ends.
+
 \ingroup report
 */
 class CSVFileReport : public Report {
@@ -40,20 +45,33 @@ public:
     /*! Create a report with the given filename, will throw if it cannot open the file.
      *  sep is the separator which defaults to a comma
      */
-    CSVFileReport(const string& filename, const char sep = ',', const bool commentCharacter = true);
+    CSVFileReport(const string& filename, const char sep = ',', const bool commentCharacter = true,
+                  const Size bufferSize = 1 << 20);
     ~CSVFileReport();
 
     Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
     Report& next() override;
     Report& add(const ReportType& rt) override;
+    //! Write the remaining rows and close the file, throws if a write fails, errors in the destructor are logged
     void end() override;
 
+    /*! Create a partition of this report, i.e. a report with the same columns whose rows are kept in memory and
+        appended to this report's rows when it ends, in the order in which the partitions were created. All columns
+        have to be added before, and the partitions have to be complete when this report ends, adding rows to a
+        partition afterwards throws. */
+    boost::shared_ptr<Report> partition();
+
 private:
+    void flush();
+
     std::vector<ReportType> columnTypes_;
     std::vector<ReportTypePrinter> printers_;
+    std::vector<boost::shared_ptr<CSVReportPartition>> partitions_;
     string filename_;
     char sep_;
     bool commentCharacter_;
+    Size bufferSize_;
+    string buffer_;
     Size i_;
     FILE* fp_;
 };
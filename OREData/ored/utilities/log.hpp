@@ -41,6 +41,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/shared_ptr.hpp>
 #include <map>
+#include <mutex>
 #include <ql/qldefines.hpp>
 #include <queue>
 
@@ -262,6 +263,8 @@ public:
     std::ostream& logStream() { return ls_; }
     //! macro utility function - do not use directly
     void log(unsigned m);
+    //! macro utility function - do not use directly, serialises messages logged from several threads
+    std::recursive_mutex& mutex() { return mutex_; }
 
     // Avoid a large number of warnings in VS by adding 0 !=
     bool filter(unsigned mask) { return 0 != (mask & mask_); }
@@ -279,6 +282,7 @@ private:
     bool enabled_;
     unsigned mask_;
     std::ostringstream ls_;
+    std::recursive_mutex mutex_;
 };
 
 /*!
@@ -286,6 +290,7 @@ private:
  */
 #define MLOG(mask, text)                                                                                               \
     if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(mask)) {                             \
+        std::lock_guard<std::recursive_mutex> lock(ore::data::Log::instance().mutex());                                \
         ore::data::Log::instance().header(mask, __FILE__, __LINE__);                                                   \
         ore::data::Log::instance().logStream() << text;                                                                \
         ore::data::Log::instance().log(mask);                                                                          \
@@ -309,6 +314,7 @@ private:
 //! Logging macro specifically for logging memory usage
 #define MEM_LOG                                                                                                        \
     if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(ORE_MEMORY)) {                       \
+        std::lock_guard<std::recursive_mutex> lock(ore::data::Log::instance().mutex());                                \
         ore::data::Log::instance().header(ORE_MEMORY, __FILE__, __LINE__);                                             \
         ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getPeakMemoryUsageBytes()) << "|";     \
         ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getMemoryUsageBytes());                \
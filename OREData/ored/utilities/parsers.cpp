@@ -23,6 +23,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <map>
+#include <mutex>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/currencies/all.hpp>
@@ -32,6 +33,7 @@
 #include <ql/time/daycounters/all.hpp>
 #include <ql/utilities/dataparsers.hpp>
 #include <ql/version.hpp>
+#include <qle/calendars/cachedcalendar.hpp>
 #include <qle/calendars/chile.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/france.hpp>
@@ -154,7 +156,21 @@ bool parseBool(const string& s) {
     }
 }
 
-Calendar parseCalendar(const string& s) {
+Calendar parseCalendar(const string& s, bool cached) {
+    if (cached) {
+        // the business days are precomputed on the first request of a calendar, the map is shared by all threads
+        static map<string, Calendar> c;
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = c.find(s);
+        if (it != c.end())
+            return it->second;
+        // returned as a plain Calendar, so only isBusinessDay() uses the precomputed business days
+        Calendar cal = QuantExt::CachedCalendar(parseCalendar(s, false));
+        c[s] = cal;
+        return cal;
+    }
+
     static map<string, Calendar> m = {{"TGT", TARGET()},
                                       {"TARGET", TARGET()},
                                       {"EUR", TARGET()},
@@ -287,7 +303,7 @@ Calendar parseCalendar(const string& s) {
         for (Size i = 0; i < calendarNames.size(); i++) {
             boost::trim(calendarNames[i]);
             try {
-                calendars.push_back(parseCalendar(calendarNames[i]));
+                calendars.push_back(parseCalendar(calendarNames[i], false));
             } catch (std::exception& e) {
                 QL_FAIL("Cannot convert " << s << " to Calendar [exception:" << e.what() << "]");
             } catch (...) {
@@ -87,9 +87,16 @@ bool parseBool(const string& s);
 
   For a joint calendar, the separate calendar names should be
   comma-delimited.
+
+  If cached is true, a QuantExt::CachedCalendar wrapping the calendar
+  is returned, with the business days precomputed on the first call
+  for a given string. The result is a plain QuantLib::Calendar, i.e.
+  isBusinessDay() and therefore adjust(), advance() and
+  businessDaysBetween() use the precomputed business days, but not the
+  CachedCalendar versions of the latter.
   \ingroup utilities
 */
-QuantLib::Calendar parseCalendar(const string& s);
+QuantLib::Calendar parseCalendar(const string& s, bool cached = true);
 
 //! Convert text to QuantLib::Period
 /*!
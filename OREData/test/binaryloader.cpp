@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/binaryloader.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+void checkFixings(const vector<Fixing>& expected, const vector<Fixing>& actual) {
+    // the binary loader orders the fixings by date, the order within a date is not relevant
+    auto key = [](const Fixing& f) { return make_tuple(f.date, f.name, f.fixing); };
+    vector<tuple<Date, string, Real>> e, a;
+    for (auto const& f : expected)
+        e.push_back(key(f));
+    for (auto const& f : actual)
+        a.push_back(key(f));
+    sort(e.begin(), e.end());
+    sort(a.begin(), a.end());
+    BOOST_REQUIRE_EQUAL(e.size(), a.size());
+    for (Size i = 0; i < e.size(); ++i) {
+        BOOST_CHECK_EQUAL(get<0>(e[i]), get<0>(a[i]));
+        BOOST_CHECK_EQUAL(get<1>(e[i]), get<1>(a[i]));
+        BOOST_CHECK_EQUAL(get<2>(e[i]), get<2>(a[i]));
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BinaryLoaderTests)
+
+BOOST_AUTO_TEST_CASE(testBinaryLoaderAgainstCsvLoader) {
+
+    BOOST_TEST_MESSAGE("Testing binary market data loader against csv loader...");
+
+    Settings::instance().evaluationDate() = Date(17, Apr, 2019);
+
+    vector<string> marketFiles = {TEST_INPUT_FILE("market.txt")};
+    vector<string> fixingFiles = {TEST_INPUT_FILE("fixings.txt")};
+    string binaryFile = TEST_OUTPUT_FILE("marketdata.bin");
+
+    writeBinaryMarketData(marketFiles, fixingFiles, binaryFile);
+
+    for (bool implyTodaysFixings : {false, true}) {
+
+        CSVLoader csvLoader(marketFiles, fixingFiles, implyTodaysFixings);
+        BinaryLoader binaryLoader(binaryFile, implyTodaysFixings);
+
+        vector<Date> dates = binaryLoader.quoteDates();
+        BOOST_REQUIRE_EQUAL(dates.size(), 2);
+        BOOST_CHECK_EQUAL(dates[0], Date(16, Apr, 2019));
+        BOOST_CHECK_EQUAL(dates[1], Date(17, Apr, 2019));
+
+        for (auto const& d : dates) {
+            auto const& csvQuotes = csvLoader.loadQuotes(d);
+            auto const& binaryQuotes = binaryLoader.loadQuotes(d);
+            BOOST_REQUIRE_EQUAL(csvQuotes.size(), binaryQuotes.size());
+            for (auto const& q : csvQuotes) {
+                BOOST_REQUIRE(binaryLoader.has(q->name(), d));
+                auto const& b = binaryLoader.get(q->name(), d);
+                BOOST_CHECK_EQUAL(b->name(), q->name());
+                BOOST_CHECK_EQUAL(b->asofDate(), q->asofDate());
+                BOOST_CHECK_EQUAL(b->quote()->value(), q->quote()->value());
+                BOOST_CHECK(b->instrumentType() == q->instrumentType());
+                BOOST_CHECK(b->quoteType() == q->quoteType());
+            }
+        }
+
+        BOOST_CHECK(!binaryLoader.has("FX/RATE/EUR/GBP", Date(16, Apr, 2019)));
+        BOOST_CHECK(!binaryLoader.has("NOT/A/VALID/QUOTE", Date(17, Apr, 2019)));
+        BOOST_CHECK(!binaryLoader.has("FX/RATE/EUR/USD", Date(18, Apr, 2019)));
+        BOOST_CHECK_THROW(binaryLoader.get("FX/RATE/EUR/GBP", Date(16, Apr, 2019)), Error);
+        BOOST_CHECK_THROW(binaryLoader.loadQuotes(Date(18, Apr, 2019)), Error);
+
+        checkFixings(csvLoader.loadFixings(), binaryLoader.loadFixings());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBinaryLoaderInvalidFile) {
+
+    BOOST_TEST_MESSAGE("Testing binary market data loader with a file that is not a binary market data file...");
+
+    BOOST_CHECK_THROW(BinaryLoader(TEST_INPUT_FILE("market.txt")), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
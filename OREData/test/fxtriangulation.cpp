@@ -22,6 +22,8 @@
 #include <oret/toplevelfixture.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <algorithm>
+
 using namespace ore::data;
 using namespace QuantLib;
 using namespace std;
@@ -113,13 +115,57 @@ BOOST_AUTO_TEST_CASE(testMoreThanOneStep) {
     // Larger tolerance for multiple steps
     Real tol = 1e-8;
 
-    // Check that we don't handle more than one step
     // EURUSD + EURAUD + AUDNZD => USDNZD
-    BOOST_CHECK_THROW(fx.getQuote("USDNZD"), QuantLib::Error);
-    // but if we cache EURNZD first....
-    BOOST_CHECK_CLOSE(fx.getQuote("EURNZD")->value(), 1.6450, tol);
-    // then we should be able to get it with one step
     BOOST_CHECK_CLOSE(fx.getQuote("USDNZD")->value(), 1.6450 / 1.0861, tol);
+    BOOST_CHECK_CLOSE(fx.getQuote("NZDUSD")->value(), 1.0861 / 1.6450, tol);
+    // ZZZEUR + EURAUD + AUDNZD => ZZZNZD
+    BOOST_CHECK_CLOSE(fx.getQuote("ZZZNZD")->value(), 3.141 * 1.6450, tol);
+}
+
+BOOST_AUTO_TEST_CASE(testQuotesFollowSpots) {
+
+    Real tol = 1e-12;
+
+    FXTriangulation tri;
+    boost::shared_ptr<SimpleQuote> eurUsd = boost::make_shared<SimpleQuote>(1.2);
+    tri.addQuote("EURUSD", Handle<Quote>(eurUsd));
+    tri.addQuote("EURGBP", Handle<Quote>(boost::make_shared<SimpleQuote>(0.8)));
+    Handle<Quote> usdGbp = tri.getQuote("USDGBP");
+    BOOST_CHECK_CLOSE(usdGbp->value(), 0.8 / 1.2, tol);
+
+    // derived quotes reference the added quotes
+    eurUsd->setValue(1.25);
+    BOOST_CHECK_CLOSE(usdGbp->value(), 0.8 / 1.25, tol);
+    BOOST_CHECK(tri.getQuote("USDGBP") == usdGbp);
+
+    // a new currency is connected once its quote is added, copies keep their own quotes
+    FXTriangulation copy = tri;
+    BOOST_CHECK_THROW(tri.getQuote("USDCHF"), QuantLib::Error);
+    tri.addQuote("GBPCHF", Handle<Quote>(boost::make_shared<SimpleQuote>(1.2)));
+    BOOST_CHECK_CLOSE(tri.getQuote("USDCHF")->value(), 0.8 / 1.25 * 1.2, tol);
+    BOOST_CHECK_THROW(copy.getQuote("USDCHF"), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testQuotesBuiltOnRequest) {
+
+    FXTriangulation tri;
+    tri.addQuote("EURUSD", Handle<Quote>(boost::make_shared<SimpleQuote>(1.2)));
+    tri.addQuote("EURGBP", Handle<Quote>(boost::make_shared<SimpleQuote>(0.8)));
+    tri.addQuote("GBPCHF", Handle<Quote>(boost::make_shared<SimpleQuote>(1.2)));
+    BOOST_CHECK(tri.derivedQuotes().empty());
+
+    // USDCHF needs USDEUR and USDGBP on its path, nothing else is built
+    Handle<Quote> usdChf = tri.getQuote("USDCHF");
+    std::vector<Handle<Quote>> derived = tri.derivedQuotes();
+    BOOST_CHECK_EQUAL(derived.size(), 3);
+    BOOST_CHECK(std::find(derived.begin(), derived.end(), usdChf) != derived.end());
+
+    // repeated lookups and unity do not add quotes, a new quote discards the built ones
+    tri.getQuote("USDCHF");
+    tri.getQuote("CHFCHF");
+    BOOST_CHECK_EQUAL(tri.derivedQuotes().size(), 3);
+    tri.addQuote("EURJPY", Handle<Quote>(boost::make_shared<SimpleQuote>(130.0)));
+    BOOST_CHECK(tri.derivedQuotes().empty());
 }
 
 BOOST_AUTO_TEST_CASE(testBadInputsThrow) {
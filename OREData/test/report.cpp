@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <ored/report/columnarreport.hpp>
+#include <ored/report/csvreport.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+string readFile(const string& fileName) {
+    ifstream file(fileName);
+    ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+void addColumns(Report& report) {
+    report.addColumn("Id", string())
+        .addColumn("Count", Size())
+        .addColumn("Value", Real(), 2)
+        .addColumn("Date", Date())
+        .addColumn("Tenor", Period());
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ReportTests)
+
+BOOST_AUTO_TEST_CASE(testCsvReportFormatting) {
+    BOOST_TEST_MESSAGE("Testing CSV report formatting");
+    string fileName = boost::filesystem::unique_path().string();
+    {
+        // a small buffer, so that the rows are written in several chunks
+        CSVFileReport report(fileName, ',', true, 16);
+        addColumns(report);
+        report.next().add("a").add(Size(1)).add(1.125).add(Date(5, Feb, 2016)).add(6 * Months);
+        report.next().add("b").add(Null<Size>()).add(-0.004).add(Null<Date>()).add(1 * Years);
+        report.next().add("c").add(Size(123456789)).add(-1234567.875).add(Date(31, Dec, 2099)).add(2 * Weeks);
+        report.next().add("d").add(Size(0)).add(Null<Real>()).add(Date(1, Jan, 2000)).add(0 * Days);
+        report.next().add("e").add(Size(7)).add(1.0E20).add(Date(1, Jan, 2000)).add(3 * Days);
+        report.end();
+    }
+    ostringstream expected;
+    expected << "#Id,Count,Value,Date,Tenor\n"
+             << "a,1,1.13,2016-02-05,6M\n"
+             << "b,#N/A,0.00,#N/A,1Y\n"
+             << "c,123456789,-1234567.88,2099-12-31,2W\n"
+             << "d,0,#N/A,2000-01-01,0D\n"
+             << "e,7,100000000000000000000.00,2000-01-01,3D\n";
+    BOOST_CHECK_EQUAL(readFile(fileName), expected.str());
+    boost::filesystem::remove(fileName);
+}
+
+BOOST_AUTO_TEST_CASE(testCsvReportPartitions) {
+    BOOST_TEST_MESSAGE("Testing CSV report partitions");
+    string fileName = boost::filesystem::unique_path().string();
+    boost::shared_ptr<Report> p2;
+    {
+        CSVFileReport report(fileName);
+        report.addColumn("Id", string()).addColumn("Value", Real(), 1);
+        report.next().add("main").add(1.0);
+        boost::shared_ptr<Report> p1 = report.partition();
+        p2 = report.partition();
+        // filled in reverse order, written in the order of creation
+        p2->next().add("p2").add(3.0);
+        p1->next().add("p1").add(2.0);
+        p1->next().add("p1").add(2.5);
+        BOOST_CHECK_THROW(p1->add(2.0), std::exception);
+        BOOST_CHECK_THROW(report.addColumn("Other", string()), std::exception);
+    }
+    // the partition outlives its report, it does not accept rows anymore
+    BOOST_CHECK_THROW(p2->next(), std::exception);
+    BOOST_CHECK_THROW(p2->add("p2"), std::exception);
+    BOOST_CHECK_EQUAL(readFile(fileName), "#Id,Value\nmain,1.0\np1,2.0\np1,2.5\np2,3.0\n");
+    boost::filesystem::remove(fileName);
+}
+
+BOOST_AUTO_TEST_CASE(testColumnarReport) {
+    BOOST_TEST_MESSAGE("Testing binary columnar report round trip");
+    string fileName = boost::filesystem::unique_path().string();
+    Size rows = 25;
+    {
+        // several row groups, the last one incomplete
+        ColumnarFileReport report(fileName, 10);
+        addColumns(report);
+        for (Size i = 0; i < rows; ++i)
+            report.next()
+                .add(i % 3 == 0 ? string("x") : string("y") + std::to_string(i))
+                .add(i)
+                .add(i * 1.0E6 / 7.0)
+                .add(Date(1, Jan, 2020) + i)
+                .add(Period(i, Months));
+        BOOST_CHECK_THROW(report.next().add(Size(1)), std::exception);
+    }
+
+    InMemoryReport loaded;
+    readColumnarReport(fileName, loaded);
+    boost::filesystem::remove(fileName);
+
+    BOOST_REQUIRE_EQUAL(loaded.columns(), 5);
+    BOOST_CHECK_EQUAL(loaded.header(2), "Value");
+    BOOST_CHECK_EQUAL(loaded.columnPrecision(2), 2);
+    // the incomplete row is dropped
+    BOOST_REQUIRE_EQUAL(loaded.data(0).size(), rows);
+    for (Size i = 0; i < rows; ++i) {
+        BOOST_CHECK_EQUAL(boost::get<string>(loaded.data(0)[i]), i % 3 == 0 ? string("x") : "y" + std::to_string(i));
+        BOOST_CHECK_EQUAL(boost::get<Size>(loaded.data(1)[i]), i);
+        // values are stored without rounding
+        BOOST_CHECK_EQUAL(boost::get<Real>(loaded.data(2)[i]), i * 1.0E6 / 7.0);
+        BOOST_CHECK_EQUAL(boost::get<Date>(loaded.data(3)[i]), Date(1, Jan, 2020) + i);
+        BOOST_CHECK_EQUAL(boost::get<Period>(loaded.data(4)[i]), Period(i, Months));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMakeFileReport) {
+    BOOST_TEST_MESSAGE("Testing creation of file reports in csv and binary format");
+    string stem = boost::filesystem::unique_path().string();
+    {
+        boost::shared_ptr<Report> csv = makeFileReport(stem + ".csv", false);
+        BOOST_CHECK(boost::dynamic_pointer_cast<CSVFileReport>(csv));
+        boost::shared_ptr<Report> binary = makeFileReport(stem + ".csv", true);
+        BOOST_CHECK(boost::dynamic_pointer_cast<ColumnarFileReport>(binary));
+        csv->end();
+        binary->end();
+    }
+    BOOST_CHECK(boost::filesystem::exists(stem + ".csv"));
+    BOOST_CHECK(boost::filesystem::exists(stem + ".bin"));
+    boost::filesystem::remove(stem + ".csv");
+    boost::filesystem::remove(stem + ".bin");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -69,6 +69,61 @@ BOOST_AUTO_TEST_CASE(testScheduleData) {
         BOOST_CHECK_EQUAL(s[i], s3[i]);
 }
 
+BOOST_AUTO_TEST_CASE(testScheduleCache) {
+
+    BOOST_TEST_MESSAGE("Testing ScheduleCache...");
+
+    ScheduleCache& cache = ScheduleCache::instance();
+    bool enabled = cache.enabled();
+    cache.clear();
+
+    ScheduleRules rules1("2015-01-09", "2015-04-09", "1M", "TARGET", "MF", "MF", "Forward");
+    ScheduleRules rules2("2015-01-09", "2015-04-09", "1M", "TARGET", "F", "MF", "Forward");
+    ScheduleDates dates1("TARGET", "", "", {"2015-01-09", "2015-02-09"});
+
+    cache.setEnabled(false);
+    QuantLib::Schedule ref1 = makeSchedule(ScheduleData(rules1));
+    QuantLib::Schedule ref2 = makeSchedule(ScheduleData(rules2));
+    BOOST_CHECK_EQUAL(cache.size(), 0UL);
+
+    cache.setEnabled(true);
+    QuantLib::Schedule s1 = makeSchedule(ScheduleData(rules1));
+    QuantLib::Schedule s1Cached = makeSchedule(ScheduleData(rules1));
+    QuantLib::Schedule s2 = makeSchedule(ScheduleData(rules2));
+    makeSchedule(ScheduleData(dates1));
+    BOOST_CHECK_EQUAL(cache.misses(), 3UL);
+    BOOST_CHECK_EQUAL(cache.hits(), 1UL);
+    BOOST_CHECK_EQUAL(cache.size(), 3UL);
+
+    BOOST_REQUIRE_EQUAL(s1.size(), ref1.size());
+    BOOST_REQUIRE_EQUAL(s1Cached.size(), ref1.size());
+    for (Size i = 0; i < ref1.size(); i++) {
+        BOOST_CHECK_EQUAL(s1[i], ref1[i]);
+        BOOST_CHECK_EQUAL(s1Cached[i], ref1[i]);
+    }
+    // differs from the first schedule in the convention only, so must not be served from its cache entry
+    BOOST_REQUIRE_EQUAL(s2.size(), ref2.size());
+    for (Size i = 0; i < ref2.size(); i++)
+        BOOST_CHECK_EQUAL(s2[i], ref2[i]);
+
+    // the cache is emptied when it reaches its maximum size
+    Size maxSize = cache.maxSize();
+    cache.setMaxSize(2);
+    BOOST_CHECK_EQUAL(cache.size(), 0UL);
+    makeSchedule(ScheduleData(rules1));
+    makeSchedule(ScheduleData(rules2));
+    BOOST_CHECK_EQUAL(cache.size(), 2UL);
+    QuantLib::Schedule d1 = makeSchedule(ScheduleData(dates1));
+    BOOST_CHECK_EQUAL(cache.size(), 1UL);
+    BOOST_CHECK_EQUAL(d1.size(), 2UL);
+    cache.setMaxSize(maxSize);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0UL);
+    BOOST_CHECK_EQUAL(cache.hits(), 0UL);
+    cache.setEnabled(enabled);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/calendars/cachedcalendar.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+namespace QuantExt {
+
+namespace {
+inline Size bitCount(const boost::uint64_t w) { return std::bitset<64>(w).count(); }
+} // namespace
+
+CachedCalendar::Impl::Impl(const Calendar& calendar, const Year firstYear, const Year lastYear)
+    : calendar_(calendar), firstYear_(firstYear), lastYear_(lastYear) {
+    QL_REQUIRE(!calendar_.empty(), "CachedCalendar: no calendar given");
+    QL_REQUIRE(firstYear_ <= lastYear_,
+               "CachedCalendar: first year (" << firstYear_ << ") must not be after last year (" << lastYear_ << ")");
+    Date first(1, January, firstYear_), last(31, December, lastYear_);
+    firstSerial_ = first.serialNumber();
+    size_ = last.serialNumber() - firstSerial_ + 1;
+    Size nWords = static_cast<Size>(size_ + 63) / 64;
+    words_.resize(nWords, 0);
+    counts_.resize(nWords + 1, 0);
+    Date d = first;
+    for (Date::serial_type i = 0; i < size_; ++i, ++d) {
+        if (calendar_.isBusinessDay(d))
+            words_[i / 64] |= boost::uint64_t(1) << (i % 64);
+    }
+    for (Size k = 0; k < nWords; ++k)
+        counts_[k + 1] = counts_[k] + bitCount(words_[k]);
+}
+
+bool CachedCalendar::Impl::isBusinessDay(const Date& d) const {
+    Date::serial_type i = d.serialNumber() - firstSerial_;
+    if (i < 0 || i >= size_)
+        return calendar_.isBusinessDay(d);
+    return ((words_[i / 64] >> (i % 64)) & 1) != 0;
+}
+
+Date::serial_type CachedCalendar::Impl::index(const Date& d) const {
+    Date::serial_type i = d.serialNumber() - firstSerial_;
+    return i < 0 || i >= size_ ? -1 : i;
+}
+
+Date::serial_type CachedCalendar::Impl::count(const Date::serial_type i) const {
+    Date::serial_type k = i / 64, b = i % 64;
+    if (b == 0)
+        return counts_[k];
+    return counts_[k] + bitCount(words_[k] & ((boost::uint64_t(1) << b) - 1));
+}
+
+Date::serial_type CachedCalendar::Impl::select(const Date::serial_type rank) const {
+    if (rank < 0 || rank >= counts_.back())
+        return -1;
+    // the word containing the business day, i.e. the last k with counts_[k] <= rank
+    Date::serial_type k = std::upper_bound(counts_.begin(), counts_.end(), rank) - counts_.begin() - 1;
+    Date::serial_type r = rank - counts_[k];
+    boost::uint64_t w = words_[k];
+    for (Date::serial_type b = 0; b < 64; ++b) {
+        if ((w >> b) & 1) {
+            if (r == 0)
+                return 64 * k + b;
+            --r;
+        }
+    }
+    QL_FAIL("CachedCalendar: internal error, business day with rank " << rank << " not found");
+}
+
+Date::serial_type CachedCalendar::Impl::next(Date::serial_type i) const {
+    Date::serial_type k = i / 64;
+    // bits >= i in the first word, then skip words without business days
+    boost::uint64_t w = words_[k] >> (i % 64);
+    while (w == 0) {
+        if (++k >= static_cast<Date::serial_type>(words_.size()))
+            return -1;
+        w = words_[k];
+        i = 64 * k;
+    }
+    while ((w & 1) == 0) {
+        w >>= 1;
+        ++i;
+    }
+    return i < size_ ? i : -1;
+}
+
+Date::serial_type CachedCalendar::Impl::previous(Date::serial_type i) const {
+    Date::serial_type k = i / 64;
+    // bits <= i in the first word, then skip words without business days
+    boost::uint64_t w = words_[k] << (63 - i % 64);
+    while (w == 0) {
+        if (--k < 0)
+            return -1;
+        w = words_[k];
+        i = 64 * k + 63;
+    }
+    while ((w & (boost::uint64_t(1) << 63)) == 0) {
+        w <<= 1;
+        --i;
+    }
+    return i;
+}
+
+CachedCalendar::CachedCalendar(const Calendar& calendar, const Year firstYear, const Year lastYear)
+    : cachedImpl_(boost::make_shared<Impl>(calendar, firstYear, lastYear)) {
+    impl_ = cachedImpl_;
+}
+
+Date CachedCalendar::adjust(const Date& d, BusinessDayConvention c) const {
+    QL_REQUIRE(d != Date(), "null date");
+    Date::serial_type i = cachedImpl_->index(d);
+    if (i < 0 || !useCache() || (c != Following && c != ModifiedFollowing && c != Preceding &&
+                                 c != ModifiedPreceding))
+        return Calendar::adjust(d, c);
+
+    if (c == Following || c == ModifiedFollowing) {
+        Date::serial_type j = cachedImpl_->next(i);
+        if (j < 0)
+            return Calendar::adjust(d, c);
+        Date d1 = date(j);
+        if (c == ModifiedFollowing && d1.month() != d.month())
+            return adjust(d, Preceding);
+        return d1;
+    } else {
+        Date::serial_type j = cachedImpl_->previous(i);
+        if (j < 0)
+            return Calendar::adjust(d, c);
+        Date d1 = date(j);
+        if (c == ModifiedPreceding && d1.month() != d.month())
+            return adjust(d, Following);
+        return d1;
+    }
+}
+
+Date CachedCalendar::advance(const Date& d, Integer n, TimeUnit unit, BusinessDayConvention c,
+                             bool endOfMonth) const {
+    QL_REQUIRE(d != Date(), "null date");
+    Date::serial_type i = cachedImpl_->index(d);
+    if (n == 0)
+        return adjust(d, c);
+    if (unit != Days || i < 0 || !useCache())
+        return Calendar::advance(d, n, unit, c, endOfMonth);
+    // the n-th business day after resp. before d
+    Date::serial_type rank = n > 0 ? cachedImpl_->count(i + 1) + n - 1 : cachedImpl_->count(i) + n;
+    Date::serial_type j = cachedImpl_->select(rank);
+    if (j < 0)
+        return Calendar::advance(d, n, unit, c, endOfMonth);
+    return date(j);
+}
+
+BigInteger CachedCalendar::businessDaysBetween(const Date& from, const Date& to, bool includeFirst,
+                                               bool includeLast) const {
+    Date::serial_type i = cachedImpl_->index(from), j = cachedImpl_->index(to);
+    if (i < 0 || j < 0 || !useCache())
+        return Calendar::businessDaysBetween(from, to, includeFirst, includeLast);
+    BigInteger wd = 0;
+    if (from != to) {
+        // business days in [min(from, to), max(from, to)]
+        wd = cachedImpl_->count(std::max(i, j) + 1) - cachedImpl_->count(std::min(i, j));
+        if (isBusinessDay(from) && !includeFirst)
+            wd--;
+        if (isBusinessDay(to) && !includeLast)
+            wd--;
+        if (from > to)
+            wd = -wd;
+    }
+    return wd;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file cachedcalendar.hpp
+    \brief calendar wrapper with precomputed business days
+*/
+
+#ifndef quantext_cached_calendar_hpp
+#define quantext_cached_calendar_hpp
+
+#include <ql/time/calendar.hpp>
+
+#include <boost/cstdint.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Calendar wrapper with precomputed business days
+/*! The business days of the wrapped calendar in the years firstYear to lastYear are stored in a bitset together with
+    the cumulative number of business days per 64 day block. Within this range isBusinessDay() is a bit test instead
+    of the evaluation of the holiday rules (of all calendars for a joint calendar), outside the range the wrapped
+    calendar is used.
+
+    The QuantLib::Calendar methods adjust(), advance() and businessDaysBetween() are not virtual and benefit from the
+    cheaper isBusinessDay() only. If called on a CachedCalendar object they are replaced by versions that scan the
+    bitset word by word resp. use the cumulative counts, so that advancing by n business days and counting business
+    days does not depend on n resp. the length of the period. The results are identical to the QuantLib::Calendar
+    methods. A CachedCalendar copied to a QuantLib::Calendar keeps the precomputed isBusinessDay(), but calls to
+    adjust(), advance() and businessDaysBetween() on the copy use the QuantLib::Calendar versions.
+
+    The name is the name of the wrapped calendar, so that the cached calendar compares equal to it.
+
+    \warning Holidays added to or removed from the wrapped calendar after the construction of the cached calendar are
+             not reflected. Holidays added to or removed from the cached calendar itself are taken into account.
+
+    \ingroup calendars
+*/
+class CachedCalendar : public Calendar {
+private:
+    class Impl : public Calendar::Impl {
+    public:
+        Impl(const Calendar& calendar, const Year firstYear, const Year lastYear);
+        std::string name() const { return calendar_.name(); }
+        bool isBusinessDay(const Date& d) const;
+        bool isWeekend(Weekday w) const { return calendar_.isWeekend(w); }
+
+        //! index of d in the bitset, or -1 if outside the range
+        Date::serial_type index(const Date& d) const;
+        //! number of business days with index < i, 0 <= i <= size
+        Date::serial_type count(const Date::serial_type i) const;
+        //! index of the business day with the given rank (0 based), or -1
+        Date::serial_type select(const Date::serial_type rank) const;
+        //! index of the first business day >= i resp. the last business day <= i, or -1
+        Date::serial_type next(Date::serial_type i) const;
+        Date::serial_type previous(Date::serial_type i) const;
+
+        Calendar calendar_;
+        Year firstYear_, lastYear_;
+        Date::serial_type firstSerial_, size_;
+        std::vector<boost::uint64_t> words_;
+        std::vector<Date::serial_type> counts_;
+    };
+    boost::shared_ptr<Impl> cachedImpl_;
+    bool useCache() const { return cachedImpl_->addedHolidays.empty() && cachedImpl_->removedHolidays.empty(); }
+    Date date(const Date::serial_type i) const { return Date(cachedImpl_->firstSerial_ + i); }
+
+public:
+    CachedCalendar(const Calendar& calendar, const Year firstYear = 1950, const Year lastYear = 2150);
+
+    //! \name Inspectors
+    //@{
+    const Calendar& underlying() const { return cachedImpl_->calendar_; }
+    Year firstYear() const { return cachedImpl_->firstYear_; }
+    Year lastYear() const { return cachedImpl_->lastYear_; }
+    //@}
+
+    //! \name Calendar methods using the precomputed business days
+    //@{
+    using Calendar::advance;
+    Date adjust(const Date& d, BusinessDayConvention convention = Following) const;
+    Date advance(const Date& d, Integer n, TimeUnit unit, BusinessDayConvention convention = Following,
+                 bool endOfMonth = false) const;
+    BigInteger businessDaysBetween(const Date& from, const Date& to, bool includeFirst = true,
+                                   bool includeLast = false) const;
+    //@}
+};
+
+} // namespace QuantExt
+
+#endif
@@ -33,7 +33,7 @@ AverageONIndexedCoupon::AverageONIndexedCoupon(const Date& paymentDate, Real nom
                                                Spread spread, Natural rateCutoff, const DayCounter& dayCounter)
     : FloatingRateCoupon(paymentDate, nominal, startDate, endDate, overnightIndex->fixingDays(), overnightIndex,
                          gearing, spread, Date(), Date(), dayCounter, false),
-      rateCutoff_(rateCutoff) {
+      rateCutoff_(rateCutoff), cacheAccruedState_(false), accruedPeriods_(0), accruedRate_(0.0) {
 
     // Populate the value dates.
     Schedule sch = MakeSchedule()
@@ -82,6 +82,17 @@ const std::vector<Rate>& AverageONIndexedCoupon::indexFixings() const {
 
 Date AverageONIndexedCoupon::fixingDate() const { return fixingDates_[fixingDates_.size() - 1 - rateCutoff_]; }
 
+void AverageONIndexedCoupon::enableAccruedStateCache(bool enable) {
+    cacheAccruedState_ = enable;
+    resetAccruedState();
+}
+
+void AverageONIndexedCoupon::resetAccruedState() const {
+    accruedPeriods_ = 0;
+    accruedRate_ = 0.0;
+    accruedDate_ = Date();
+}
+
 void AverageONIndexedCoupon::accept(AcyclicVisitor& v) {
     Visitor<AverageONIndexedCoupon>* v1 = dynamic_cast<Visitor<AverageONIndexedCoupon>*>(&v);
     if (v1 != 0) {
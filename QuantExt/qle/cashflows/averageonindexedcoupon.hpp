@@ -72,12 +72,29 @@ public:
     //@{
     void accept(AcyclicVisitor&);
     //@}
+    //! \name Accrued state
+    //@{
+    /*! If enabled, the pricer keeps the sum of the past fixings times their accrual periods between calls and only
+        adds the fixings that became past since the last call, as long as the evaluation date does not move
+        backwards. This requires that fixings are only added for dates on or after the last evaluation date, as
+        done by a simulation stepping forward in time, and that resetAccruedState() is called whenever the
+        fixing history is restored, e.g. at the start of a new path. */
+    void enableAccruedStateCache(bool enable);
+    //! discard the cached accrued state
+    void resetAccruedState() const;
+    //@}
 private:
+    friend class AverageONIndexedCouponPricer;
     std::vector<Date> valueDates_, fixingDates_;
     mutable std::vector<Rate> fixings_;
     Size numPeriods_;
     std::vector<Time> dt_;
     Natural rateCutoff_;
+    // number of periods with past fixings, their accrued rate and the evaluation date they were collected for
+    bool cacheAccruedState_;
+    mutable Size accruedPeriods_;
+    mutable Real accruedRate_;
+    mutable Date accruedDate_;
 };
 
 //! helper class building a sequence of overnight coupons
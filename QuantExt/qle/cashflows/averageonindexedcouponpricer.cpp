@@ -35,20 +35,31 @@ void AverageONIndexedCouponPricer::initialize(const FloatingRateCoupon& coupon)
 
 Rate AverageONIndexedCouponPricer::swapletRate() const {
 
-    std::vector<Date> fixingDates = coupon_->fixingDates();
-    std::vector<Time> accrualFractions = coupon_->dt();
+    const std::vector<Date>& fixingDates = coupon_->fixingDates();
+    const std::vector<Time>& accrualFractions = coupon_->dt();
     Size numPeriods = accrualFractions.size();
     Real accumulatedRate = 0;
 
     if (approximationType_ == Takada) {
         Size i = 0;
         Date valuationDate = Settings::instance().evaluationDate();
+        // Start from the past fixings collected in the last call, if the evaluation date did not move backwards
+        bool cache = coupon_->cacheAccruedState_;
+        if (cache && coupon_->accruedDate_ != Date() && valuationDate >= coupon_->accruedDate_) {
+            i = coupon_->accruedPeriods_;
+            accumulatedRate = coupon_->accruedRate_;
+        }
         // Deal with past fixings.
         while (i < numPeriods && fixingDates[i] < valuationDate) {
             Rate pastFixing = overnightIndex_->fixing(fixingDates[i]);
             accumulatedRate += pastFixing * accrualFractions[i];
             ++i;
         }
+        if (cache) {
+            coupon_->accruedPeriods_ = i;
+            coupon_->accruedRate_ = accumulatedRate;
+            coupon_->accruedDate_ = valuationDate;
+        }
         // Use valuation date's fixing also if available.
         if (i < numPeriods && fixingDates[i] == valuationDate) {
             Rate valuationDateFixing = IndexManager::instance().getHistory(overnightIndex_->name())[valuationDate];
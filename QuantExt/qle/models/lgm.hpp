@@ -60,14 +60,16 @@ public:
                             Handle<YieldTermStructure> discountCurve = Handle<YieldTermStructure>()) const;
 
     /*! calibrate volatilities to a sequence of ir options with
-        expiry times equal to step times in the parametrization */
+        expiry times equal to step times in the parametrization,
+        functionEvaluation() returns the total over all steps */
     void calibrateVolatilitiesIterative(const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helpers,
                                         OptimizationMethod& method, const EndCriteria& endCriteria,
                                         const Constraint& constraint = Constraint(),
                                         const std::vector<Real>& weights = std::vector<Real>());
 
     /*! calibrate reversion to a sequence of ir options with
-        maturities equal to step times in the parametrization */
+        maturities equal to step times in the parametrization,
+        functionEvaluation() returns the total over all steps */
     void calibrateReversionsIterative(const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helpers,
                                       OptimizationMethod& method, const EndCriteria& endCriteria,
                                       const Constraint& constraint = Constraint(),
@@ -170,19 +172,25 @@ inline Real LinearGaussMarkovModel::discountBondOption(Option::Type type, const
 inline void LinearGaussMarkovModel::calibrateVolatilitiesIterative(
     const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helpers, OptimizationMethod& method,
     const EndCriteria& endCriteria, const Constraint& constraint, const std::vector<Real>& weights) {
+    Integer evaluations = 0;
     for (Size i = 0; i < helpers.size(); ++i) {
         std::vector<boost::shared_ptr<BlackCalibrationHelper> > h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights, MoveVolatility(i));
+        evaluations += functionEvaluation_;
     }
+    functionEvaluation_ = evaluations;
 }
 
 inline void LinearGaussMarkovModel::calibrateReversionsIterative(
     const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helpers, OptimizationMethod& method,
     const EndCriteria& endCriteria, const Constraint& constraint, const std::vector<Real>& weights) {
+    Integer evaluations = 0;
     for (Size i = 0; i < helpers.size(); ++i) {
         std::vector<boost::shared_ptr<BlackCalibrationHelper> > h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights, MoveReversion(i));
+        evaluations += functionEvaluation_;
     }
+    functionEvaluation_ = evaluations;
 }
 
 } // namespace QuantExt
@@ -31,7 +31,7 @@ void no_deletion(void*) {}
 } // namespace
 
 LinkableCalibratedModel::LinkableCalibratedModel()
-    : constraint_(new PrivateConstraint(arguments_)), endCriteria_(EndCriteria::None) {}
+    : constraint_(new PrivateConstraint(arguments_)), endCriteria_(EndCriteria::None), functionEvaluation_(0) {}
 
 class LinkableCalibratedModel::CalibrationFunction : public CostFunction {
 public:
@@ -105,6 +105,7 @@ void LinkableCalibratedModel::calibrate(const vector<shared_ptr<CalibrationHelpe
     Array result(prob.currentValue());
     setParams(proj.include(result));
     problemValues_ = prob.values(result);
+    functionEvaluation_ = prob.functionEvaluation();
 
     notifyObservers();
 }
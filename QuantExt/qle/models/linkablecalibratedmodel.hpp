@@ -74,6 +74,9 @@ public:
     //! Returns the problem values
     const Array& problemValues() const { return problemValues_; }
 
+    //! Returns the number of cost function evaluations of the last calibration
+    Integer functionEvaluation() const { return functionEvaluation_; }
+
     //! Returns array of arguments on which calibration is done
     Disposable<Array> params() const;
 
@@ -85,6 +88,7 @@ protected:
     boost::shared_ptr<Constraint> constraint_;
     EndCriteria::Type endCriteria_;
     Array problemValues_;
+    Integer functionEvaluation_;
 
 private:
     //! Constraint imposed on arguments
@@ -28,7 +28,8 @@ AnalyticLgmSwaptionEngine::AnalyticLgmSwaptionEngine(const boost::shared_ptr<Lin
                                                      const Handle<YieldTermStructure>& discountCurve,
                                                      const FloatSpreadMapping floatSpreadMapping)
     : GenericEngine<Swaption::arguments, Swaption::results>(), p_(model->parametrization()),
-      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping) {
+      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping),
+      caching_(false) {
     registerWith(model);
     registerWith(c_);
 }
@@ -37,7 +38,8 @@ AnalyticLgmSwaptionEngine::AnalyticLgmSwaptionEngine(const boost::shared_ptr<Cro
                                                      const Handle<YieldTermStructure>& discountCurve,
                                                      const FloatSpreadMapping floatSpreadMapping)
     : GenericEngine<Swaption::arguments, Swaption::results>(), p_(model->irlgm1f(ccy)),
-      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping) {
+      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping),
+      caching_(false) {
     registerWith(model);
     registerWith(c_);
 }
@@ -46,34 +48,30 @@ AnalyticLgmSwaptionEngine::AnalyticLgmSwaptionEngine(const boost::shared_ptr<IrL
                                                      const Handle<YieldTermStructure>& discountCurve,
                                                      const FloatSpreadMapping floatSpreadMapping)
     : GenericEngine<Swaption::arguments, Swaption::results>(), p_(irlgm1f),
-      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping) {
+      c_(discountCurve.empty() ? p_->termStructure() : discountCurve), floatSpreadMapping_(floatSpreadMapping),
+      caching_(false) {
     registerWith(c_);
 }
 
-void AnalyticLgmSwaptionEngine::calculate() const {
-
-    QL_REQUIRE(arguments_.settlementType == Settlement::Physical, "cash-settled swaptions are not supported ...");
+void AnalyticLgmSwaptionEngine::enableCache(const bool enable) {
+    caching_ = enable;
+    if (!caching_)
+        clearCache();
+}
 
-    Date reference = p_->termStructure()->referenceDate();
+void AnalyticLgmSwaptionEngine::clearCache() { cache_.clear(); }
 
-    Date expiry = arguments_.exercise->dates().back();
-
-    if (expiry <= reference) {
-        // swaption is expired, possibly generated swap is not
-        // valued by this engine, so we set the npv to zero
-        results_.value = 0.0;
-        return;
-    }
+void AnalyticLgmSwaptionEngine::computeTerms(const Date& expiry, CachedTerms& terms) const {
 
     VanillaSwap swap = *arguments_.swap;
-    Option::Type type = arguments_.type == VanillaSwap::Payer ? Option::Call : Option::Put;
     Schedule fixedSchedule = swap.fixedSchedule();
     Schedule floatSchedule = swap.floatingSchedule();
 
-    j1_ = std::lower_bound(fixedSchedule.dates().begin(), fixedSchedule.dates().end(), expiry) -
-          fixedSchedule.dates().begin();
-    k1_ = std::lower_bound(floatSchedule.dates().begin(), floatSchedule.dates().end(), expiry) -
-          floatSchedule.dates().begin();
+    terms.j1 = std::lower_bound(fixedSchedule.dates().begin(), fixedSchedule.dates().end(), expiry) -
+               fixedSchedule.dates().begin();
+    terms.k1 = std::lower_bound(floatSchedule.dates().begin(), floatSchedule.dates().end(), expiry) -
+               floatSchedule.dates().begin();
+    Size j1 = terms.j1, k1 = terms.k1;
 
     // compute S_i, i.e. equivalent fixed rate spreads compensating for
     // a) a possibly non-zero float spread and
@@ -83,20 +81,17 @@ void AnalyticLgmSwaptionEngine::calculate() const {
     // with this multiplied by the nominal and accrual basis,
     // so S_i is really an amount correction.
 
-    S_.resize(arguments_.fixedCoupons.size() - j1_);
-    for (Size i = 0; i < S_.size(); ++i) {
-        S_[i] = 0.0;
-    }
-    S_m1 = 0.0;
+    terms.S = std::vector<Real>(arguments_.fixedCoupons.size() - j1, 0.0);
+    terms.S_m1 = 0.0;
     Size ratio = static_cast<Size>(
         static_cast<Real>(arguments_.floatingCoupons.size()) / static_cast<Real>(arguments_.fixedCoupons.size()) + 0.5);
     QL_REQUIRE(ratio >= 1, "floating leg's payment frequency must be equal or "
                            "higher than fixed leg's payment frequency in "
                            "analytic lgm swaption engine");
 
-    Size k = k1_;
+    Size k = k1;
     boost::shared_ptr<IborIndex> flatIbor = swap.iborIndex()->clone(c_);
-    for (Size j = j1_; j < arguments_.fixedCoupons.size(); ++j) {
+    for (Size j = j1; j < arguments_.fixedCoupons.size(); ++j) {
         Real sum1 = 0.0, sum2 = 0.0;
         for (Size rr = 0; rr < ratio && k < arguments_.floatingCoupons.size(); ++rr, ++k) {
             Real amount = arguments_.floatingCoupons[k];
@@ -126,14 +121,67 @@ void AnalyticLgmSwaptionEngine::calculate() const {
                 sum2 += lambda2 * correction;
             }
         }
-        if (j > j1_) {
-            S_[j - j1_ - 1] += sum1 / c_->discount(arguments_.fixedPayDates[j - 1]);
+        if (j > j1) {
+            terms.S[j - j1 - 1] += sum1 / c_->discount(arguments_.fixedPayDates[j - 1]);
         } else {
-            S_m1 += sum1 / c_->discount(arguments_.floatingResetDates[k1_]);
+            terms.S_m1 += sum1 / c_->discount(arguments_.floatingResetDates[k1]);
         }
-        S_[j - j1_] += sum2 / c_->discount(arguments_.fixedPayDates[j]);
+        terms.S[j - j1] += sum2 / c_->discount(arguments_.fixedPayDates[j]);
     }
 
+    // discount factors and times entering the model dependent part of the pricing
+
+    terms.tex = p_->termStructure()->timeFromReference(expiry);
+    terms.t0 = p_->termStructure()->timeFromReference(arguments_.floatingResetDates[k1]);
+    terms.D0 = c_->discount(arguments_.floatingResetDates[k1]);
+    terms.tj.resize(arguments_.fixedCoupons.size() - j1);
+    terms.Dj.resize(arguments_.fixedCoupons.size() - j1);
+    for (Size j = j1; j < arguments_.fixedCoupons.size(); ++j) {
+        terms.tj[j - j1] = p_->termStructure()->timeFromReference(arguments_.fixedPayDates[j]);
+        terms.Dj[j - j1] = c_->discount(arguments_.fixedPayDates[j - j1]);
+    }
+}
+
+void AnalyticLgmSwaptionEngine::calculate() const {
+
+    QL_REQUIRE(arguments_.settlementType == Settlement::Physical, "cash-settled swaptions are not supported ...");
+
+    Date reference = p_->termStructure()->referenceDate();
+
+    Date expiry = arguments_.exercise->dates().back();
+
+    if (expiry <= reference) {
+        // swaption is expired, possibly generated swap is not
+        // valued by this engine, so we set the npv to zero
+        results_.value = 0.0;
+        return;
+    }
+
+    Option::Type type = arguments_.type == VanillaSwap::Payer ? Option::Call : Option::Put;
+
+    // model independent terms, possibly from the cache
+
+    CachedTerms localTerms;
+    const CachedTerms* terms = &localTerms;
+    if (caching_) {
+        auto key = std::make_pair(static_cast<const VanillaSwap*>(arguments_.swap.get()), expiry);
+        auto c = cache_.find(key);
+        if (c == cache_.end()) {
+            c = cache_.insert(std::make_pair(key, CachedTerms())).first;
+            computeTerms(expiry, c->second);
+        }
+        terms = &c->second;
+    } else {
+        computeTerms(expiry, localTerms);
+    }
+
+    j1_ = terms->j1;
+    k1_ = terms->k1;
+    S_ = terms->S;
+    S_m1 = terms->S_m1;
+    D0_ = terms->D0;
+    Dj_ = terms->Dj;
+
     Real w = type == Option::Call ? -1.0 : 1.0;
 
     // it is a requirement that H' does not change its sign,
@@ -142,14 +190,11 @@ void AnalyticLgmSwaptionEngine::calculate() const {
 
     // do the actual pricing
 
-    zetaex_ = p_->zeta(p_->termStructure()->timeFromReference(expiry));
-    H0_ = p_->H(p_->termStructure()->timeFromReference(arguments_.floatingResetDates[k1_]));
-    D0_ = c_->discount(arguments_.floatingResetDates[k1_]);
-    Hj_.resize(arguments_.fixedCoupons.size() - j1_);
-    Dj_.resize(arguments_.fixedCoupons.size() - j1_);
-    for (Size j = j1_; j < arguments_.fixedCoupons.size(); ++j) {
-        Hj_[j - j1_] = p_->H(p_->termStructure()->timeFromReference(arguments_.fixedPayDates[j]));
-        Dj_[j - j1_] = c_->discount(arguments_.fixedPayDates[j - j1_]);
+    zetaex_ = p_->zeta(terms->tex);
+    H0_ = p_->H(terms->t0);
+    Hj_.resize(terms->tj.size());
+    for (Size j = 0; j < terms->tj.size(); ++j) {
+        Hj_[j] = p_->H(terms->tj[j]);
     }
 
     Brent b;
@@ -28,6 +28,8 @@
 #include <ql/instruments/swaption.hpp>
 #include <qle/models/crossassetmodel.hpp>
 
+#include <map>
+
 namespace QuantExt {
 
 //! Analytic LGM swaption engine for european exercise
@@ -85,11 +87,27 @@ public:
 
     void calculate() const;
 
+    /*! If enabled, the model independent quantities (discount factors, spread corrections
+        and times) are cached per underlying swap, so that repeated pricings of the same
+        swaptions during a calibration only evaluate the model dependent terms. The cache
+        is not invalidated by notifications, it must be cleared explicitly via clearCache()
+        whenever the curves change or the priced instruments are rebuilt. */
+    void enableCache(const bool enable = true);
+    void clearCache();
+
 private:
+    struct CachedTerms {
+        Size j1, k1;
+        Real S_m1, D0, t0, tex;
+        std::vector<Real> S, Dj, tj;
+    };
+    void computeTerms(const Date& expiry, CachedTerms& terms) const;
     Real yStarHelper(const Real y) const;
     const boost::shared_ptr<IrLgm1fParametrization> p_;
     const Handle<YieldTermStructure> c_;
     const FloatSpreadMapping floatSpreadMapping_;
+    bool caching_;
+    mutable std::map<std::pair<const VanillaSwap*, Date>, CachedTerms> cache_;
     mutable Real H0_, D0_, zetaex_, S_m1;
     mutable std::vector<Real> S_, Hj_, Dj_;
     mutable Size j1_, k1_;
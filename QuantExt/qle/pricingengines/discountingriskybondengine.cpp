@@ -22,9 +22,9 @@
 #include <ql/cashflows/cashflows.hpp>
 #include <ql/cashflows/coupon.hpp>
 #include <ql/cashflows/simplecashflow.hpp>
-#include <ql/termstructures/credit/flathazardrate.hpp>
 #include <ql/termstructures/yield/zerospreadedtermstructure.hpp>
 #include <qle/pricingengines/discountingriskybondengine.hpp>
+#include <qle/termstructures/batchevaluation.hpp>
 
 using namespace std;
 using namespace QuantLib;
@@ -87,15 +87,22 @@ Real DiscountingRiskyBondEngine::calculateNpv(Date npvDate, const Leg& cashflows
     // i.e. credit curve term structure (and recovery) have not been specified
     // we set the default probability and recovery rate to zero in this instance (issuer credit worthiness already
     // captured within security spread)
-    boost::shared_ptr<DefaultProbabilityTermStructure> creditCurvePtr =
-        defaultCurve_.empty()
-            ? boost::make_shared<QuantLib::FlatHazardRate>(results_.valuationDate, 0.0, discountCurve_->dayCounter())
-            : defaultCurve_.currentLink();
+    bool hasCreditCurve = !defaultCurve_.empty();
     Rate recoveryVal = recoveryRate_.empty() ? 0.0 : recoveryRate_->value();
 
-    // compounding factors for npv date
-    Real dfSettl = discountCurve_->discount(npvDate);
-    Real spSettl = creditCurvePtr->survivalProbability(npvDate);
+    /* Collect the dates on which the curves are needed first, so that each curve is evaluated once per distinct
+       date in one batch below. Without a credit curve all survival probabilities are one and the recovery
+       terms vanish. */
+    std::vector<Date> survivalDates(1, npvDate), discountDates(1, npvDate);
+    Date creditRefDate = hasCreditCurve ? defaultCurve_->referenceDate() : Date::minDate();
+    auto addPeriod = [&survivalDates, &discountDates, &creditRefDate](const Date& start, const Date& end,
+                                                                     const Date& defaultDate) {
+        // the default probability between two dates is the difference of the survival probabilities, where the
+        // survival probability is one before the reference date
+        survivalDates.push_back(std::max(start, creditRefDate));
+        survivalDates.push_back(end);
+        discountDates.push_back(defaultDate);
+    };
 
     Size numCoupons = 0;
     bool hasLiveCashFlow = false;
@@ -104,25 +111,16 @@ Real DiscountingRiskyBondEngine::calculateNpv(Date npvDate, const Leg& cashflows
         if (cf->hasOccurred(npvDate, includeSettlementDateFlows_))
             continue;
         hasLiveCashFlow = true;
-
-        // Coupon value is discounted future payment times the survival probability
-        Probability S = creditCurvePtr->survivalProbability(cf->date()) / spSettl;
-        npvValue += cf->amount() * S * discountCurve_->discount(cf->date()) / dfSettl;
-
-        /* The amount recovered in the case of default is the recoveryrate*Notional*Probability of
-           Default; this is added to the NPV value. For coupon bonds the coupon periods are taken
-           as the timesteps for integrating over the probability of default.
-        */
+        survivalDates.push_back(cf->date());
+        discountDates.push_back(cf->date());
         boost::shared_ptr<Coupon> coupon = boost::dynamic_pointer_cast<Coupon>(cf);
-        if (coupon) {
+        if (coupon)
             numCoupons++;
+        if (coupon && hasCreditCurve) {
             Date startDate = coupon->accrualStartDate();
             Date endDate = coupon->accrualEndDate();
             Date effectiveStartDate = (startDate <= npvDate && npvDate <= endDate) ? npvDate : startDate;
-            Date defaultDate = effectiveStartDate + (endDate - effectiveStartDate) / 2;
-            Probability P = creditCurvePtr->defaultProbability(effectiveStartDate, endDate) / spSettl;
-
-            npvValue += coupon->nominal() * recoveryVal * P * discountCurve_->discount(defaultDate) / dfSettl;
+            addPeriod(effectiveStartDate, endDate, effectiveStartDate + (endDate - effectiveStartDate) / 2);
         }
     }
 
@@ -139,19 +137,65 @@ Real DiscountingRiskyBondEngine::calculateNpv(Date npvDate, const Leg& cashflows
        maturity. The timestepPeriod specified is used as provide the steps for the integration. This only applies
        to bonds with 1 cashflow, identified as a final redemption payment.
     */
-    if (cashflows.size() == 1) {
-        boost::shared_ptr<Redemption> redemption = boost::dynamic_pointer_cast<Redemption>(cashflows[0]);
-        if (redemption) {
-            Date startDate = npvDate;
-            while (startDate < redemption->date()) {
-                Date stepDate = startDate + timestepPeriod_;
-                Date endDate = (stepDate > redemption->date()) ? redemption->date() : stepDate;
-                Date defaultDate = startDate + (endDate - startDate) / 2;
-                Probability P = creditCurvePtr->defaultProbability(startDate, endDate) / spSettl;
-
-                npvValue += redemption->amount() * recoveryVal * P * discountCurve_->discount(defaultDate) / dfSettl;
-                startDate = stepDate;
-            }
+    boost::shared_ptr<Redemption> redemption;
+    if (cashflows.size() == 1)
+        redemption = boost::dynamic_pointer_cast<Redemption>(cashflows[0]);
+    if (redemption && hasCreditCurve) {
+        for (Date startDate = npvDate; startDate < redemption->date(); startDate += timestepPeriod_) {
+            Date stepDate = startDate + timestepPeriod_;
+            Date endDate = (stepDate > redemption->date()) ? redemption->date() : stepDate;
+            addPeriod(startDate, endDate, startDate + (endDate - startDate) / 2);
+        }
+    }
+
+    sortUniqueDates(discountDates);
+    std::vector<Real> df, sp;
+    QuantExt::discounts(**discountCurve_, discountDates, df);
+    if (hasCreditCurve) {
+        sortUniqueDates(survivalDates);
+        QuantExt::survivalProbabilities(**defaultCurve_, survivalDates, sp);
+    }
+    auto S = [hasCreditCurve, &survivalDates, &sp](const Date& d) {
+        return hasCreditCurve ? sp[dateIndex(survivalDates, d)] : 1.0;
+    };
+    auto D = [&discountDates, &df](const Date& d) { return df[dateIndex(discountDates, d)]; };
+    auto P = [&S, &creditRefDate](const Date& start, const Date& end) {
+        return S(std::max(start, creditRefDate)) - S(end);
+    };
+
+    // compounding factors for npv date
+    Real dfSettl = D(npvDate);
+    Real spSettl = S(npvDate);
+
+    for (Size i = 0; i < cashflows.size(); i++) {
+        boost::shared_ptr<CashFlow> cf = cashflows[i];
+        if (cf->hasOccurred(npvDate, includeSettlementDateFlows_))
+            continue;
+
+        // Coupon value is discounted future payment times the survival probability
+        npvValue += cf->amount() * S(cf->date()) / spSettl * D(cf->date()) / dfSettl;
+
+        /* The amount recovered in the case of default is the recoveryrate*Notional*Probability of
+           Default; this is added to the NPV value. For coupon bonds the coupon periods are taken
+           as the timesteps for integrating over the probability of default.
+        */
+        boost::shared_ptr<Coupon> coupon = boost::dynamic_pointer_cast<Coupon>(cf);
+        if (coupon && hasCreditCurve) {
+            Date startDate = coupon->accrualStartDate();
+            Date endDate = coupon->accrualEndDate();
+            Date effectiveStartDate = (startDate <= npvDate && npvDate <= endDate) ? npvDate : startDate;
+            Date defaultDate = effectiveStartDate + (endDate - effectiveStartDate) / 2;
+            npvValue += coupon->nominal() * recoveryVal * P(effectiveStartDate, endDate) / spSettl *
+                        D(defaultDate) / dfSettl;
+        }
+    }
+
+    if (redemption && hasCreditCurve) {
+        for (Date startDate = npvDate; startDate < redemption->date(); startDate += timestepPeriod_) {
+            Date stepDate = startDate + timestepPeriod_;
+            Date endDate = (stepDate > redemption->date()) ? redemption->date() : stepDate;
+            Date defaultDate = startDate + (endDate - startDate) / 2;
+            npvValue += redemption->amount() * recoveryVal * P(startDate, endDate) / spSettl * D(defaultDate) / dfSettl;
         }
     }
 
@@ -36,6 +36,7 @@
 */
 
 #include <qle/pricingengines/midpointcdsengine.hpp>
+#include <qle/termstructures/batchevaluation.hpp>
 
 #include <ql/cashflows/fixedratecoupon.hpp>
 #include <ql/instruments/claim.hpp>
@@ -54,13 +55,13 @@ MidPointCdsEngine::MidPointCdsEngine(const Handle<DefaultProbabilityTermStructur
 
 Real MidPointCdsEngine::survivalProbability(const Date& d) const { return probability_->survivalProbability(d); }
 
-Real MidPointCdsEngine::defaultProbability(const Date& d1, const Date& d2) const {
-    return probability_->defaultProbability(d1, d2);
+void MidPointCdsEngine::survivalProbabilities(const std::vector<Date>& dates, std::vector<Real>& result) const {
+    QuantExt::survivalProbabilities(**probability_, dates, result);
 }
 
-Real MidPointCdsEngine::expectedLoss(const Date& defaultDate, const Date& d1, const Date& d2,
+Real MidPointCdsEngine::expectedLoss(const Date& defaultDate, const Probability defaultProbability,
                                      const Real notional) const {
-    return arguments_.claim->amount(defaultDate, notional, recoveryRate_) * probability_->defaultProbability(d1, d2);
+    return arguments_.claim->amount(defaultDate, notional, recoveryRate_) * defaultProbability;
 }
 
 void MidPointCdsEngine::calculate() const {
@@ -69,72 +70,120 @@ void MidPointCdsEngine::calculate() const {
     MidPointCdsEngineBase::calculate(probability_->referenceDate(), arguments_, results_);
 }
 
+void MidPointCdsEngineBase::survivalProbabilities(const std::vector<Date>& dates, std::vector<Real>& result) const {
+    result.resize(dates.size());
+    for (Size i = 0; i < dates.size(); ++i)
+        result[i] = survivalProbability(dates[i]);
+}
+
+namespace {
+struct CouponPeriod {
+    boost::shared_ptr<FixedRateCoupon> coupon;
+    Date paymentDate, effectiveStartDate, endDate, defaultDate;
+};
+} // namespace
+
 void MidPointCdsEngineBase::calculate(const Date& refDate, const CreditDefaultSwap::arguments& arguments,
                                       CreditDefaultSwap::results& results) const {
     Date today = Settings::instance().evaluationDate();
     Date settlementDate = discountCurve_->referenceDate();
 
-    // Upfront Flow NPV and accrual rebate NPV. Either we are on-the-run (no flow)
-    // or we are forward start
+    // Collect the dates on which the curves are needed, so that each curve is evaluated in one batch below
 
     // date determining the probability survival so we have to pay
     // the upfront flows (did not knock out)
     Date effectiveProtectionStart = arguments.protectionStart > refDate ? arguments.protectionStart : refDate;
-    Probability nonKnockOut = survivalProbability(effectiveProtectionStart);
+    std::vector<Date> survivalDates(1, effectiveProtectionStart), discountDates;
+
+    // Upfront Flow NPV and accrual rebate NPV. Either we are on-the-run (no flow)
+    // or we are forward start
+    bool liveUpfront = arguments.upfrontPayment &&
+                       !arguments.upfrontPayment->hasOccurred(settlementDate, includeSettlementDateFlows_);
+    bool liveRebate =
+        arguments.accrualRebate && !arguments.accrualRebate->hasOccurred(settlementDate, includeSettlementDateFlows_);
+    if (liveUpfront)
+        discountDates.push_back(arguments.upfrontPayment->date());
+    if (liveRebate)
+        discountDates.push_back(arguments.accrualRebate->date());
+
+    std::vector<CouponPeriod> periods;
+    periods.reserve(arguments.leg.size());
+    for (Size i = 0; i < arguments.leg.size(); ++i) {
+        if (arguments.leg[i]->hasOccurred(settlementDate, includeSettlementDateFlows_))
+            continue;
+
+        CouponPeriod p;
+        p.coupon = boost::dynamic_pointer_cast<FixedRateCoupon>(arguments.leg[i]);
+        p.paymentDate = p.coupon->date();
+        p.endDate = p.coupon->accrualEndDate();
+        Date startDate = p.coupon->accrualStartDate();
+        // this is the only point where it might not coincide
+        if (i == 0)
+            startDate = arguments.protectionStart;
+        p.effectiveStartDate = (startDate <= today && today <= p.endDate) ? today : startDate;
+        p.defaultDate = // mid-point
+            p.effectiveStartDate + (p.endDate - p.effectiveStartDate) / 2;
+
+        // the default probability between two dates is the difference of the survival probabilities, where the
+        // survival probability is one before the reference date
+        survivalDates.push_back(p.paymentDate);
+        survivalDates.push_back(std::max(p.effectiveStartDate, refDate));
+        survivalDates.push_back(p.endDate);
+        discountDates.push_back(p.paymentDate);
+        discountDates.push_back(p.defaultDate);
+        periods.push_back(p);
+    }
+
+    sortUniqueDates(survivalDates);
+    sortUniqueDates(discountDates);
+    std::vector<Real> sp, df;
+    survivalProbabilities(survivalDates, sp);
+    QuantExt::discounts(**discountCurve_, discountDates, df);
+    auto S = [&survivalDates, &sp](const Date& d) { return sp[dateIndex(survivalDates, d)]; };
+    auto D = [&discountDates, &df](const Date& d) { return df[dateIndex(discountDates, d)]; };
+
+    Probability nonKnockOut = S(effectiveProtectionStart);
 
     Real upfPVO1 = 0.0;
     results.upfrontNPV = 0.0;
-    if (arguments.upfrontPayment &&
-        !arguments.upfrontPayment->hasOccurred(settlementDate, includeSettlementDateFlows_)) {
-        upfPVO1 = nonKnockOut * discountCurve_->discount(arguments.upfrontPayment->date());
+    if (liveUpfront) {
+        upfPVO1 = nonKnockOut * D(arguments.upfrontPayment->date());
         results.upfrontNPV = upfPVO1 * arguments.upfrontPayment->amount();
     }
 
     results.accrualRebateNPV = 0.;
-    if (arguments.accrualRebate && !arguments.accrualRebate->hasOccurred(settlementDate, includeSettlementDateFlows_)) {
+    if (liveRebate) {
         results.accrualRebateNPV =
-            nonKnockOut * discountCurve_->discount(arguments.accrualRebate->date()) * arguments.accrualRebate->amount();
+            nonKnockOut * D(arguments.accrualRebate->date()) * arguments.accrualRebate->amount();
     }
 
     results.couponLegNPV = 0.0;
     results.defaultLegNPV = 0.0;
-    for (Size i = 0; i < arguments.leg.size(); ++i) {
-        if (arguments.leg[i]->hasOccurred(settlementDate, includeSettlementDateFlows_))
-            continue;
-
-        boost::shared_ptr<FixedRateCoupon> coupon = boost::dynamic_pointer_cast<FixedRateCoupon>(arguments.leg[i]);
-
+    for (auto const& p : periods) {
         // In order to avoid a few switches, we calculate the NPV
         // of both legs as a positive quantity. We'll give them
         // the right sign at the end.
 
-        Date paymentDate = coupon->date(), startDate = coupon->accrualStartDate(), endDate = coupon->accrualEndDate();
-        // this is the only point where it might not coincide
-        if (i == 0)
-            startDate = arguments.protectionStart;
-        Date effectiveStartDate = (startDate <= today && today <= endDate) ? today : startDate;
-        Date defaultDate = // mid-point
-            effectiveStartDate + (endDate - effectiveStartDate) / 2;
-
-        Probability S = survivalProbability(paymentDate);
-        Probability P = defaultProbability(effectiveStartDate, endDate);
+        Probability survival = S(p.paymentDate);
+        Probability P = S(std::max(p.effectiveStartDate, refDate)) - S(p.endDate);
+        Real dfPayment = D(p.paymentDate), dfDefault = D(p.defaultDate);
 
         // on one side, we add the fixed rate payments in case of
         // survival...
-        results.couponLegNPV += S * coupon->amount() * discountCurve_->discount(paymentDate);
+        results.couponLegNPV += survival * p.coupon->amount() * dfPayment;
         // ...possibly including accrual in case of default.
         if (arguments.settlesAccrual) {
             if (arguments.paysAtDefaultTime) {
-                results.couponLegNPV += P * coupon->accruedAmount(defaultDate) * discountCurve_->discount(defaultDate);
+                results.couponLegNPV += P * p.coupon->accruedAmount(p.defaultDate) * dfDefault;
             } else {
                 // pays at the end
-                results.couponLegNPV += P * coupon->amount() * discountCurve_->discount(paymentDate);
+                results.couponLegNPV += P * p.coupon->amount() * dfPayment;
             }
         }
 
         // on the other side, we add the payment in case of default.
-        results.defaultLegNPV += expectedLoss(defaultDate, effectiveStartDate, endDate, arguments.notional) *
-                                 discountCurve_->discount(arguments.paysAtDefaultTime ? defaultDate : paymentDate);
+        results.defaultLegNPV +=
+            expectedLoss(p.defaultDate, P, arguments.notional) * (arguments.paysAtDefaultTime ? dfDefault : dfPayment);
     }
 
     Real upfrontSign = 1.0;
@@ -58,8 +58,13 @@ public:
 
 protected:
     virtual Real survivalProbability(const Date& d) const = 0;
-    virtual Real defaultProbability(const Date& d1, const Date& d2) const = 0;
-    virtual Real expectedLoss(const Date& defaultDate, const Date& d1, const Date& d2, const Real notional) const = 0;
+    //! survival probabilities on a batch of dates, by default survivalProbability() is called for each date
+    virtual void survivalProbabilities(const std::vector<Date>& dates, std::vector<Real>& result) const;
+    //! expected loss for a default on the given date, which has the given probability
+    virtual Real expectedLoss(const Date& defaultDate, const Probability defaultProbability,
+                              const Real notional) const = 0;
+    /*! The dates of the live coupon periods are collected first, so that the survival probabilities and discount
+        factors are evaluated once per distinct date in one batch for each curve. */
     void calculate(const Date& refDate, const CreditDefaultSwap::arguments& arguments,
                    CreditDefaultSwap::results& results) const;
 
@@ -78,8 +83,8 @@ public:
 
 protected:
     virtual Real survivalProbability(const Date& d) const;
-    virtual Real defaultProbability(const Date& d1, const Date& d2) const;
-    virtual Real expectedLoss(const Date& defaultDate, const Date& d1, const Date& d2, const Real notional) const;
+    virtual void survivalProbabilities(const std::vector<Date>& dates, std::vector<Real>& result) const;
+    virtual Real expectedLoss(const Date& defaultDate, const Probability defaultProbability, const Real notional) const;
 
     Handle<DefaultProbabilityTermStructure> probability_;
     Real recoveryRate_;
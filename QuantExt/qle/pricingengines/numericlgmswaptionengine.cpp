@@ -19,7 +19,12 @@
 #include <qle/pricingengines/numericlgmswaptionengine.hpp>
 
 #include <ql/exercise.hpp>
+#include <ql/indexes/ibor/libor.hpp>
+#include <ql/math/comparison.hpp>
 #include <ql/payoff.hpp>
+#include <ql/settings.hpp>
+
+#include <typeinfo>
 
 using std::vector;
 
@@ -31,6 +36,12 @@ Real NumericLgmSwaptionEngineBase::calculate() const {
 
     iborIndexCorrected_ = iborIndex_->clone(Handle<YieldTermStructure>(iborModelCurve_));
 
+    // the slice evaluation of the forwards reproduces IborIndex::forecastFixing(), so it is only used for index
+    // types known not to override it (e.g. BMAIndexWrapper or BRLCdi do), all other indices are evaluated pointwise
+    const IborIndex& correctedIndex = *iborIndexCorrected_;
+    plainForecastFixing_ = typeid(correctedIndex) == typeid(IborIndex) ||
+                           typeid(correctedIndex) == typeid(OvernightIndex) || typeid(correctedIndex) == typeid(Libor);
+
     Date settlement = model_->parametrization()->termStructure()->referenceDate();
 
     if (exercise_->dates().back() <= settlement) { // swaption is expired, possibly generated swap is not
@@ -57,10 +68,12 @@ Real NumericLgmSwaptionEngineBase::calculate() const {
         te[j] = model_->parametrization()->termStructure()->timeFromReference(exercise_->dates()[minIdxAlive + j]);
         sigma[j] = sqrt(model_->parametrization()->zeta(te[j]));
         dx[j] = sigma[j] / nx_;
-        for (int k = 0; k <= 2 * mx_; k++) {
+        for (int k = 0; k <= 2 * mx_; k++)
             x[j][k] = dx[j] * (k - mx_);
-            // Payoff goes here
-            u[j][k] = conditionalSwapValue(x[j][k], te[j], exercise_->dates()[minIdxAlive + j]);
+        // Payoff goes here, evaluated for the whole grid slice
+        conditionalSwapValues(x.row_begin(j), 2 * mx_ + 1, te[j], exercise_->dates()[minIdxAlive + j],
+                              u.row_begin(j));
+        for (int k = 0; k <= 2 * mx_; k++) {
             // Continuation value is zero at final expiry.
             // This will be updated for j < jmax in the rollback loop
             v[j][k] = std::max(u[j][k], 0.0);
@@ -69,6 +82,7 @@ Real NumericLgmSwaptionEngineBase::calculate() const {
 
     // roll back
 
+    vector<Real> yStd(2 * my_ + 1); // y-grid scaled with the standard deviation of the x increment
     for (int j = options - 1; j >= 0; j--) {
         if (j == 0) {
             Real value = 0.0;
@@ -94,30 +108,36 @@ Real NumericLgmSwaptionEngineBase::calculate() const {
         // intermediate rollback
         else {
             Real std = sqrt(model_->parametrization()->zeta(te[j]) - model_->parametrization()->zeta(te[j - 1]));
+            // the y grid offsets do not depend on k, work on the matrix rows directly
+            for (int i = 0; i <= 2 * my_; i++)
+                yStd[i] = y_[i] * std;
+            const Real* vj = v.row_begin(j);
+            const Real* uj = u.row_begin(j - 1);
+            Real* vjm = v.row_begin(j - 1);
             for (int k = 0; k <= 2 * mx_; k++) {
-                int imin = 0;
-                int imax = 2 * my_;
+                Real xk = dx[j - 1] * (k - mx_);
                 Real value = 0.0;
-                for (int i = imin; i <= imax; i++) {
+                for (int i = 0; i <= 2 * my_; i++) {
                     // Map y index to x index, not integer in general
-                    Real kp = (dx[j - 1] * (k - mx_) + y_[i] * std) / dx[j] + mx_;
+                    Real kp = (xk + yStd[i]) / dx[j] + mx_;
                     // Adjacent integer x index <= k
                     int kk = int(floor(kp));
                     // Get value at kp by linear interpolation on
                     // kk <= kp <= kk + 1 with flat extrapolation
                     Real vp;
                     if (kk < 0)
-                        vp = v[j][0];
+                        vp = vj[0];
                     else if (kk + 1 > 2 * mx_)
-                        vp = v[j][2 * mx_];
+                        vp = vj[2 * mx_];
                     else
-                        vp = (kp - kk) * v[j][kk + 1] + (1.0 + kk - kp) * v[j][kk];
+                        vp = (kp - kk) * vj[kk + 1] + (1.0 + kk - kp) * vj[kk];
 
                     value += w_[i] * vp;
-                    QL_REQUIRE(vp >= 0, "negative value in rollback");
                 }
+                // the weights and values are non-negative
+                QL_REQUIRE(value >= 0, "negative value in rollback");
                 // choose: continue (value) or exercise (u[j-1][k])
-                v[j - 1][k] = std::max(value, u[j - 1][k]);
+                vjm[k] = std::max(value, uj[k]);
             }
         }
     } // for options
@@ -126,6 +146,112 @@ Real NumericLgmSwaptionEngineBase::calculate() const {
 
 } // NumericLgmSwaptionEngineBase::calculate
 
+void NumericLgmSwaptionEngineBase::conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0,
+                                                         Real* u) const {
+    for (Size k = 0; k < n; ++k)
+        u[k] = conditionalSwapValue(x[k], t, expiry0);
+}
+
+const vector<NumericLgmSwaptionEngineBase::FixingPeriod>&
+NumericLgmSwaptionEngineBase::fixingPeriods(const vector<Date>& fixingDates) const {
+    // the calendar adjustments only depend on the index conventions and the fixing dates
+    if (fixingPeriodsIndex_ != iborIndex_->name() || fixingPeriodsDates_ != fixingDates) {
+        fixingPeriods_.resize(fixingDates.size());
+        for (Size i = 0; i < fixingDates.size(); ++i) {
+            FixingPeriod& p = fixingPeriods_[i];
+            p.valid = iborIndex_->isValidFixingDate(fixingDates[i]);
+            if (p.valid) {
+                p.start = iborIndex_->valueDate(fixingDates[i]);
+                p.end = iborIndex_->maturityDate(p.start);
+                p.accrual = iborIndex_->dayCounter().yearFraction(p.start, p.end);
+                p.valid = p.accrual > 0.0;
+            }
+        }
+        fixingPeriodsIndex_ = iborIndex_->name();
+        fixingPeriodsDates_ = fixingDates;
+    }
+    return fixingPeriods_;
+}
+
+NumericLgmSwaptionEngineBase::MovedCurve NumericLgmSwaptionEngineBase::movedCurve(const Date& expiry0) const {
+    // see LgmImpliedYieldTermStructure::update()
+    MovedCurve curve;
+    curve.expiry = expiry0;
+    curve.relativeTime = iborModelCurve_->dayCounter().yearFraction(
+        model_->parametrization()->termStructure()->referenceDate(), expiry0);
+    curve.zeta = model_->parametrization()->zeta(curve.relativeTime);
+    curve.targetDiscount = iborIndex_->forwardingTermStructure()->discount(curve.relativeTime);
+    curve.modelDiscount = model_->parametrization()->termStructure()->discount(curve.relativeTime);
+    return curve;
+}
+
+bool NumericLgmSwaptionEngineBase::movedCurveDiscount(const MovedCurve& curve, const Date& d,
+                                                      MovedCurveDiscount& discount) const {
+    // see LgmImpliedYtsFwdFwdCorrected::discountImpl() and LinearGaussMarkovModel::discountBond()
+    Time t = iborModelCurve_->dayCounter().yearFraction(curve.expiry, d);
+    if (t < 0.0)
+        return false;
+    Time T = curve.relativeTime + t;
+    discount.unit = close_enough(curve.relativeTime, T);
+    if (!discount.unit) {
+        if (!(T >= curve.relativeTime && curve.relativeTime >= 0.0))
+            return false;
+        Real Ht = model_->parametrization()->H(curve.relativeTime);
+        Real HT = model_->parametrization()->H(T);
+        discount.ratio = model_->parametrization()->termStructure()->discount(T) /
+                         model_->parametrization()->termStructure()->discount(curve.relativeTime);
+        discount.dH = HT - Ht;
+        discount.c = 0.5 * (HT * HT - Ht * Ht) * curve.zeta;
+    }
+    discount.targetDiscount = iborIndex_->forwardingTermStructure()->discount(T);
+    discount.modelDiscount = model_->parametrization()->termStructure()->discount(T);
+    return true;
+}
+
+Real NumericLgmSwaptionEngineBase::discount(const MovedCurve& curve, const MovedCurveDiscount& discount,
+                                            const Real x) const {
+    Real d = discount.unit ? 1.0 : discount.ratio * std::exp(-discount.dH * x - discount.c);
+    return d * discount.targetDiscount / curve.targetDiscount * curve.modelDiscount / discount.modelDiscount;
+}
+
+bool NumericLgmSwaptionEngineBase::movedCurveForward(const MovedCurve& curve, const Date& fixingDate,
+                                                     const FixingPeriod& period, MovedCurveForward& forward) const {
+    // historical and today's fixings are left to the index
+    if (!plainForecastFixing_ || !period.valid || fixingDate <= Settings::instance().evaluationDate())
+        return false;
+    forward.accrual = period.accrual;
+    return movedCurveDiscount(curve, period.start, forward.start) &&
+           movedCurveDiscount(curve, period.end, forward.end);
+}
+
+Real NumericLgmSwaptionEngineBase::forward(const MovedCurve& curve, const MovedCurveForward& forward,
+                                           const Real x) const {
+    // see IborIndex::forecastFixing()
+    return (discount(curve, forward.start, x) / discount(curve, forward.end, x) - 1.0) / forward.accrual;
+}
+
+NumericLgmSwaptionEngineBase::ReducedDiscountBond
+NumericLgmSwaptionEngineBase::reducedDiscountBond(const Time t, const Time T, const Real zeta) const {
+    // see LinearGaussMarkovModel::reducedDiscountBond()
+    ReducedDiscountBond bond;
+    bond.t = t;
+    bond.T = T;
+    bond.useModel = close_enough(t, T) || !(T >= t && t >= 0.0);
+    if (!bond.useModel) {
+        bond.discount = discountCurve_.empty() ? model_->parametrization()->termStructure()->discount(T)
+                                               : discountCurve_->discount(T);
+        bond.H = model_->parametrization()->H(T);
+        bond.c = 0.5 * bond.H * bond.H * zeta;
+    }
+    return bond;
+}
+
+Real NumericLgmSwaptionEngineBase::reducedDiscountBond(const ReducedDiscountBond& bond, const Real x) const {
+    if (bond.useModel)
+        return model_->reducedDiscountBond(bond.t, bond.T, x, discountCurve_);
+    return bond.discount * std::exp(-bond.H * x - bond.c);
+}
+
 void NumericLgmSwaptionEngine::calculate() const {
     // TODO ParYieldCurve cash-settled swaptions are priced as if CollateralizedCashPrice, this can be refined
     iborIndex_ = arguments_.swap->iborIndex();
@@ -164,6 +290,52 @@ Real NumericLgmSwaptionEngine::conditionalSwapValue(Real x, Real t, const Date e
     return exerciseValue;
 } // NumericLgmSwaptionEngine::conditionalSwapValue
 
+void NumericLgmSwaptionEngine::conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0,
+                                                     Real* u) const {
+    const Schedule& fixedSchedule = arguments_.swap->fixedSchedule();
+    const Schedule& floatSchedule = arguments_.swap->floatingSchedule();
+    Size j1 = std::upper_bound(fixedSchedule.dates().begin(), fixedSchedule.dates().end(), expiry0 - 1) -
+              fixedSchedule.dates().begin();
+    Size k1 = std::upper_bound(floatSchedule.dates().begin(), floatSchedule.dates().end(), expiry0 - 1) -
+              floatSchedule.dates().begin();
+
+    Real zeta = model_->parametrization()->zeta(t);
+    MovedCurve curve = movedCurve(expiry0);
+    const vector<FixingPeriod>& periods = fixingPeriods(arguments_.floatingFixingDates);
+
+    vector<MovedCurveForward> forwards;
+    vector<ReducedDiscountBond> floatingBonds, fixedBonds;
+    for (Size l = k1; l < arguments_.floatingCoupons.size(); l++) {
+        MovedCurveForward f;
+        if (!movedCurveForward(curve, arguments_.floatingFixingDates[l], periods[l], f)) {
+            NumericLgmSwaptionEngineBase::conditionalSwapValues(x, n, t, expiry0, u);
+            return;
+        }
+        forwards.push_back(f);
+        Real T = model_->parametrization()->termStructure()->timeFromReference(arguments_.floatingPayDates[l]);
+        floatingBonds.push_back(reducedDiscountBond(t, T, zeta));
+    }
+    for (Size l = j1; l < arguments_.fixedCoupons.size(); l++) {
+        Real T = model_->parametrization()->termStructure()->timeFromReference(arguments_.fixedPayDates[l]);
+        fixedBonds.push_back(reducedDiscountBond(t, T, zeta));
+    }
+
+    Option::Type type = arguments_.type == VanillaSwap::Payer ? Option::Call : Option::Put;
+
+    for (Size k = 0; k < n; ++k) {
+        Real floatingLegNpv = 0.0;
+        for (Size l = k1; l < arguments_.floatingCoupons.size(); l++) {
+            floatingLegNpv += arguments_.nominal * arguments_.floatingAccrualTimes[l] *
+                              (arguments_.floatingSpreads[l] + forward(curve, forwards[l - k1], x[k])) *
+                              reducedDiscountBond(floatingBonds[l - k1], x[k]);
+        }
+        Real fixedLegNpv = 0.0;
+        for (Size l = j1; l < arguments_.fixedCoupons.size(); l++)
+            fixedLegNpv += arguments_.fixedCoupons[l] * reducedDiscountBond(fixedBonds[l - j1], x[k]);
+        u[k] = (type == Option::Call ? 1.0 : -1.0) * (floatingLegNpv - fixedLegNpv);
+    }
+} // NumericLgmSwaptionEngine::conditionalSwapValues
+
 void NumericLgmNonstandardSwaptionEngine::calculate() const {
     iborIndex_ = arguments_.swap->iborIndex();
     exercise_ = arguments_.exercise;
@@ -207,4 +379,56 @@ Real NumericLgmNonstandardSwaptionEngine::conditionalSwapValue(Real x, Real t, c
     return exerciseValue;
 } // NumericLgmSwaptionEngine::conditionalSwapValue
 
+void NumericLgmNonstandardSwaptionEngine::conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0,
+                                                                Real* u) const {
+    Size j1 = std::upper_bound(arguments_.fixedResetDates.begin(), arguments_.fixedResetDates.end(), expiry0 - 1) -
+              arguments_.fixedResetDates.begin();
+    Size k1 =
+        std::upper_bound(arguments_.floatingResetDates.begin(), arguments_.floatingResetDates.end(), expiry0 - 1) -
+        arguments_.floatingResetDates.begin();
+
+    Real zeta = model_->parametrization()->zeta(t);
+    MovedCurve curve = movedCurve(expiry0);
+    const vector<FixingPeriod>& periods = fixingPeriods(arguments_.floatingFixingDates);
+
+    // redemption flows do not need a forward, their entry is not used
+    vector<MovedCurveForward> forwards;
+    vector<ReducedDiscountBond> floatingBonds, fixedBonds;
+    for (Size l = k1; l < arguments_.floatingCoupons.size(); l++) {
+        MovedCurveForward f;
+        if (!arguments_.floatingIsRedemptionFlow[l] &&
+            !movedCurveForward(curve, arguments_.floatingFixingDates[l], periods[l], f)) {
+            NumericLgmSwaptionEngineBase::conditionalSwapValues(x, n, t, expiry0, u);
+            return;
+        }
+        forwards.push_back(f);
+        Real T = model_->parametrization()->termStructure()->timeFromReference(arguments_.floatingPayDates[l]);
+        floatingBonds.push_back(reducedDiscountBond(t, T, zeta));
+    }
+    for (Size l = j1; l < arguments_.fixedCoupons.size(); l++) {
+        Real T = model_->parametrization()->termStructure()->timeFromReference(arguments_.fixedPayDates[l]);
+        fixedBonds.push_back(reducedDiscountBond(t, T, zeta));
+    }
+
+    Option::Type type = arguments_.type == VanillaSwap::Payer ? Option::Call : Option::Put;
+
+    for (Size k = 0; k < n; ++k) {
+        Real floatingLegNpv = 0.0;
+        for (Size l = k1; l < arguments_.floatingCoupons.size(); l++) {
+            if (arguments_.floatingIsRedemptionFlow[l]) {
+                floatingLegNpv += arguments_.floatingCoupons[l] * reducedDiscountBond(floatingBonds[l - k1], x[k]);
+            } else {
+                floatingLegNpv += arguments_.floatingNominal[l] * arguments_.floatingAccrualTimes[l] *
+                                  (arguments_.floatingSpreads[l] +
+                                   arguments_.floatingGearings[l] * forward(curve, forwards[l - k1], x[k])) *
+                                  reducedDiscountBond(floatingBonds[l - k1], x[k]);
+            }
+        }
+        Real fixedLegNpv = 0.0;
+        for (Size l = j1; l < arguments_.fixedCoupons.size(); l++)
+            fixedLegNpv += arguments_.fixedCoupons[l] * reducedDiscountBond(fixedBonds[l - j1], x[k]);
+        u[k] = (type == Option::Call ? 1.0 : -1.0) * (floatingLegNpv - fixedLegNpv);
+    }
+} // NumericLgmNonstandardSwaptionEngine::conditionalSwapValues
+
 } // namespace QuantExt
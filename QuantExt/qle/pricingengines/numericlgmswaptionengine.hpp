@@ -96,6 +96,55 @@ protected:
 
     virtual Real conditionalSwapValue(Real x, Real t, const Date expiry0) const = 0;
 
+    /*! conditional swap values u[k] for the states x[k], k=0,...,n-1 of the x grid of an exercise date, the
+        default implementation calls conditionalSwapValue() for each grid point */
+    virtual void conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0, Real* u) const;
+
+    /*! The following helpers evaluate the forwards of iborIndexCorrected_ and the reduced discount bonds
+        on a whole grid slice. The state independent terms are computed once per slice, the remaining
+        arithmetic is term by term the same as in LgmImpliedYtsFwdFwdCorrected, IborIndex and
+        LinearGaussMarkovModel, so that the results are unchanged. */
+    //@{
+    //! ibor fixing period, only depends on the fixing date, cached across calls
+    struct FixingPeriod {
+        bool valid;
+        Date start, end;
+        Time accrual;
+    };
+    //! fwd-fwd corrected model curve moved to an expiry date
+    struct MovedCurve {
+        Date expiry;
+        Time relativeTime;
+        Real zeta, targetDiscount, modelDiscount;
+    };
+    //! state independent terms of a discount factor on a moved curve
+    struct MovedCurveDiscount {
+        bool unit;
+        Real ratio, dH, c, targetDiscount, modelDiscount;
+    };
+    //! state independent terms of a forward on a moved curve
+    struct MovedCurveForward {
+        MovedCurveDiscount start, end;
+        Time accrual;
+    };
+    //! state independent terms of a reduced discount bond, if useModel is true the model is called
+    struct ReducedDiscountBond {
+        bool useModel;
+        Time t, T;
+        Real discount, H, c;
+    };
+
+    const std::vector<FixingPeriod>& fixingPeriods(const std::vector<Date>& fixingDates) const;
+    MovedCurve movedCurve(const Date& expiry0) const;
+    /*! returns false if the forward can not be computed on the moved curve, e.g. because it is already fixed or
+        the index overrides forecastFixing() */
+    bool movedCurveForward(const MovedCurve& curve, const Date& fixingDate, const FixingPeriod& period,
+                           MovedCurveForward& forward) const;
+    Real forward(const MovedCurve& curve, const MovedCurveForward& forward, const Real x) const;
+    ReducedDiscountBond reducedDiscountBond(const Time t, const Time T, const Real zeta) const;
+    Real reducedDiscountBond(const ReducedDiscountBond& bond, const Real x) const;
+    //@}
+
     mutable boost::shared_ptr<Exercise> exercise_;
     mutable boost::shared_ptr<IborIndex> iborIndex_, iborIndexCorrected_;
     boost::shared_ptr<LinearGaussMarkovModel> model_;
@@ -104,6 +153,15 @@ protected:
     const Handle<YieldTermStructure> discountCurve_;
     Real h_;
     std::vector<Real> y_, w_;
+
+private:
+    bool movedCurveDiscount(const MovedCurve& curve, const Date& d, MovedCurveDiscount& discount) const;
+    Real discount(const MovedCurve& curve, const MovedCurveDiscount& discount, const Real x) const;
+
+    mutable bool plainForecastFixing_;
+    mutable std::string fixingPeriodsIndex_;
+    mutable std::vector<Date> fixingPeriodsDates_;
+    mutable std::vector<FixingPeriod> fixingPeriods_;
 }; // NnumercLgmSwaptionEngineBase
 
 //! Engine for Swaption instrument
@@ -126,6 +184,7 @@ public:
 
 protected:
     Real conditionalSwapValue(Real x, Real t, const Date expiry0) const;
+    void conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0, Real* u) const;
 };
 
 //! Engine for NonstandardSwaption
@@ -148,6 +207,7 @@ public:
 
 protected:
     Real conditionalSwapValue(Real x, Real t, const Date expiry0) const;
+    void conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0, Real* u) const;
 };
 
 } // namespace QuantExt
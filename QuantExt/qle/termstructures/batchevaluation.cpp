@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/termstructures/batchevaluation.hpp>
+
+#include <algorithm>
+
+namespace QuantExt {
+
+void sortUniqueDates(std::vector<Date>& dates) {
+    std::sort(dates.begin(), dates.end());
+    dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+}
+
+Size dateIndex(const std::vector<Date>& sortedDates, const Date& d) {
+    auto it = std::lower_bound(sortedDates.begin(), sortedDates.end(), d);
+    QL_REQUIRE(it != sortedDates.end() && *it == d, "dateIndex: date " << d << " not found");
+    return static_cast<Size>(it - sortedDates.begin());
+}
+
+namespace {
+template <class F>
+void evaluate(const TermStructure& ts, const std::vector<Date>& dates, std::vector<Real>& result, F f) {
+    result.resize(dates.size());
+    Date last;
+    Real lastValue = 0.0;
+    for (Size i = 0; i < dates.size(); ++i) {
+        if (i == 0 || dates[i] != last) {
+            last = dates[i];
+            lastValue = f(ts.timeFromReference(last));
+        }
+        result[i] = lastValue;
+    }
+}
+} // namespace
+
+void discounts(const YieldTermStructure& curve, const std::vector<Date>& dates, std::vector<Real>& result,
+               bool extrapolate) {
+    evaluate(curve, dates, result, [&curve, extrapolate](Time t) { return curve.discount(t, extrapolate); });
+}
+
+void survivalProbabilities(const DefaultProbabilityTermStructure& curve, const std::vector<Date>& dates,
+                           std::vector<Real>& result, bool extrapolate) {
+    evaluate(curve, dates, result,
+             [&curve, extrapolate](Time t) { return curve.survivalProbability(t, extrapolate); });
+}
+
+} // namespace QuantExt
@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/termstructures/batchevaluation.hpp
+    \brief evaluation of term structures on a batch of dates
+    \ingroup termstructures
+*/
+
+#ifndef quantext_batch_evaluation_hpp
+#define quantext_batch_evaluation_hpp
+
+#include <ql/termstructures/defaulttermstructure.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! sort the dates and remove duplicates
+void sortUniqueDates(std::vector<Date>& dates);
+
+//! index of a date in a vector of sorted, distinct dates
+/*! The date must be contained in the vector. */
+Size dateIndex(const std::vector<Date>& sortedDates, const Date& d);
+
+//! discount factors on a batch of dates
+/*! The dates are converted to times in one pass and consecutive equal dates are evaluated once only, so that the
+    cost is one virtual discount call per distinct date. Passing sorted distinct dates gives the fewest calls.
+    \ingroup termstructures
+*/
+void discounts(const YieldTermStructure& curve, const std::vector<Date>& dates, std::vector<Real>& result,
+               bool extrapolate = false);
+
+//! survival probabilities on a batch of dates
+/*! Same as discounts() for a default probability term structure.
+    \ingroup termstructures
+*/
+void survivalProbabilities(const DefaultProbabilityTermStructure& curve, const std::vector<Date>& dates,
+                           std::vector<Real>& result, bool extrapolate = false);
+
+} // namespace QuantExt
+
+#endif
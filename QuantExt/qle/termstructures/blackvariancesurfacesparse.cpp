@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <algorithm>
 #include <boost/make_shared.hpp>
 #include <iostream>
 #include <ql/math/interpolations/bilinearinterpolation.hpp>
@@ -49,9 +50,8 @@ BlackVarianceSurfaceSparse::BlackVarianceSurfaceSparse(const QuantLib::Date& ref
     expiries_ = vector<Date>(datesSet.begin(), datesSet.end());
     vector<bool> dateDone(expiries_.size(), false);
     times_ = vector<Time>(expiries_.size());
-    interpolations_ = vector<Interpolation>(expiries_.size());
-    variances_ = vector<vector<Real> >(expiries_.size());
-    strikes_ = vector<vector<Real> >(expiries_.size());
+    vector<vector<Real> > sliceVariances(expiries_.size());
+    vector<vector<Real> > sliceStrikes(expiries_.size());
 
     // Populate expiry info. (Except interpolation obj members)
     for (Size i = 0; i < dates.size(); i++) {
@@ -65,24 +65,24 @@ BlackVarianceSurfaceSparse::BlackVarianceSurfaceSparse(const QuantLib::Date& ref
             QL_REQUIRE(dates[i] > referenceDate,
                        "Expiry date:" << dates[i] << " not after asof date: " << referenceDate);
             times_[ii] = timeFromReference(dates[i]);
-            strikes_[ii].push_back(strikes[i]);
-            variances_[ii].push_back(volatilities[i] * volatilities[i] * times_[ii]);
+            sliceStrikes[ii].push_back(strikes[i]);
+            sliceVariances[ii].push_back(volatilities[i] * volatilities[i] * times_[ii]);
             dateDone[ii] = true;
         } else {
             // expiry found => add if strike not found
             Real tmpStrike = strikes[i];
             vector<Real>::iterator fnd =
-                find_if(strikes_[ii].begin(), strikes_[ii].end(), CloseEnoughComparator(tmpStrike));
-            if (fnd == strikes_[ii].end()) {
+                find_if(sliceStrikes[ii].begin(), sliceStrikes[ii].end(), CloseEnoughComparator(tmpStrike));
+            if (fnd == sliceStrikes[ii].end()) {
                 // add strike/var pairs if strike not found for this expiry
-                strikes_[ii].push_back(strikes[i]);
-                variances_[ii].push_back(volatilities[i] * volatilities[i] * times_[ii]);
+                sliceStrikes[ii].push_back(strikes[i]);
+                sliceVariances[ii].push_back(volatilities[i] * volatilities[i] * times_[ii]);
             }
         }
     }
 
     for (Size i = 1; i < expiries_.size(); i++) {
-        QL_REQUIRE(strikes_[i].size() == variances_[i].size(),
+        QL_REQUIRE(sliceStrikes[i].size() == sliceVariances[i].size(),
                    "different number of variances and strikes for date: " << expiries_[i]);
     }
 
@@ -97,79 +97,113 @@ BlackVarianceSurfaceSparse::BlackVarianceSurfaceSparse(const QuantLib::Date& ref
     tmpStrkVect.push_back(100.0);
     tmpVarVect.push_back(0.0);
     tmpVarVect.push_back(0.0);
-    strikes_[0] = tmpStrkVect;
-    variances_[0] = tmpVarVect;
+    sliceStrikes[0] = tmpStrkVect;
+    sliceVariances[0] = tmpVarVect;
 
-    // set expiries' interpolations.
+    // sort the strikes of each expiry
     for (Size i = 0; i < expiries_.size(); i++) {
         // sort strikes within this expiry
-        vector<pair<Real, Real> > tmpPairs(strikes_[i].size());
+        vector<pair<Real, Real> > tmpPairs(sliceStrikes[i].size());
         vector<Real> sortedStrikes; //(itr->second.expStrikes_.size());
         vector<Real> sortedVars;    // (sortedStrikes)
-        for (Size j = 0; j < strikes_[i].size(); j++) {
-            tmpPairs[j] = pair<Real, Real>(strikes_[i][j], variances_[i][j]);
+        for (Size j = 0; j < sliceStrikes[i].size(); j++) {
+            tmpPairs[j] = pair<Real, Real>(sliceStrikes[i][j], sliceVariances[i][j]);
         }
         sort(tmpPairs.begin(), tmpPairs.end());         // sorts according to frist. (strikes)
         for (vector<pair<Real, Real> >::iterator it = tmpPairs.begin(); it != tmpPairs.end(); it++) {
             sortedStrikes.push_back(it->first);
             sortedVars.push_back(it->second);
         }
-        strikes_[i] = sortedStrikes;
-        variances_[i] = sortedVars;
+        sliceStrikes[i] = sortedStrikes;
+        sliceVariances[i] = sortedVars;
     
-        // set interpolation
-        if (strikes_[i].size() == 1) {
+        // ensure two strikes per expiry
+        if (sliceStrikes[i].size() == 1) {
             // if only one strike => add different strike with same value for interpolation object.
-            strikes_[i].push_back(strikes_[i][0] + strikes_[i][0] * 2);
-            variances_[i].push_back(variances_[i][0]);
+            sliceStrikes[i].push_back(sliceStrikes[i][0] + sliceStrikes[i][0] * 2);
+            sliceVariances[i].push_back(sliceVariances[i][0]);
         }
-        LinearInterpolation tmpInterpolation(strikes_[i].begin(), strikes_[i].end(), variances_[i].begin());
-        interpolations_[i] = tmpInterpolation;
     }
 
-} // namespace QuantExt
-
-Real BlackVarianceSurfaceSparse::getVarForStrike(Real strike, const vector<Real>& strks, const vector<Real>& vars,
-                                                 const Interpolation& intrp) const {
-
-    Real retVar;
-    if (strike > strks.back()) {
-        retVar = vars.back(); // flat extrapolate far stirke
-    } else if (strike < strks.front()) {
-        retVar = vars.front(); // flat extrapolate near stirke
-    } else {
-        retVar = intrp(strike); // interpolate between strikes
+    // store the slices in flat arrays together with the slopes of the linear interpolation between the strikes
+    sliceOffsets_.push_back(0);
+    for (Size i = 0; i < expiries_.size(); i++) {
+        for (Size j = 0; j < sliceStrikes[i].size(); j++) {
+            strikes_.push_back(sliceStrikes[i][j]);
+            variances_.push_back(sliceVariances[i][j]);
+            slopes_.push_back(j + 1 < sliceStrikes[i].size()
+                                  ? (sliceVariances[i][j + 1] - sliceVariances[i][j]) /
+                                        (sliceStrikes[i][j + 1] - sliceStrikes[i][j])
+                                  : 0.0);
+        }
+        sliceOffsets_.push_back(strikes_.size());
     }
-    return retVar;
 }
 
-Real BlackVarianceSurfaceSparse::blackVarianceImpl(Time t, Real strike) const {
+namespace {
+// index i with x[i] <= v < x[i + 1], restricted to [0, n - 2], the search starts at the given hint
+Size locate(const Real* x, const Size n, const Real v, Size& hint) {
+    Size i = hint;
+    if (i + 1 < n && x[i] <= v && v < x[i + 1])
+        return i;
+    if (i + 2 < n && x[i + 1] <= v && v < x[i + 2])
+        return hint = i + 1;
+    i = static_cast<Size>(std::upper_bound(x, x + n, v) - x);
+    return hint = (i == 0 ? 0 : std::min(i - 1, n - 2));
+}
+} // namespace
+
+Real BlackVarianceSurfaceSparse::getVarForStrike(Real strike, Size expiry, SearchHints& hints) const {
+    const Size offset = sliceOffsets_[expiry], n = sliceOffsets_[expiry + 1] - offset;
+    const Real* strk = &strikes_[offset];
+    const Real* vars = &variances_[offset];
+    if (strike >= strk[n - 1])
+        return vars[n - 1]; // flat extrapolate far strike
+    if (strike <= strk[0])
+        return vars[0]; // flat extrapolate near strike
+    // interpolate between strikes
+    Size noHint = 0;
+    Size j = locate(strk, n, strike, hints.strikes.empty() ? noHint : hints.strikes[expiry]);
+    return vars[j] + (strike - strk[j]) * slopes_[offset + j];
+}
+
+Real BlackVarianceSurfaceSparse::variance(Time t, Real strike, SearchHints& hints) const {
 
     QL_REQUIRE(t >= 0, "Variance requested for date before reference date: " << this->referenceDate());
     Real varReturn;
     if (t == 0.0) {
-        //requested at reference date
-        varReturn = variances_[0][0];
+        // requested at reference date
+        varReturn = variances_[0];
     } else if (t <= times_.back()) {
-        //requested between existing expiries (interpolate between expiries)
-        ptrdiff_t dt;       // index for point after requested
-        ptrdiff_t dtPrev;   // index for point before requested
-        dt = distance(times_.begin(), lower_bound(times_.begin(), times_.end(), t));
-        dtPrev = (dt != 0) ? dt - 1 : 0;
-        // interpolate between expiries
-        vector<Real> tmpVars(2);
-        vector<Time> xAxis;
-        xAxis.push_back(times_[dtPrev]);
-        xAxis.push_back(times_[dt]);
-        tmpVars[1] = getVarForStrike(strike, strikes_[dt], variances_[dt], interpolations_[dt]);
-        tmpVars[0] = getVarForStrike(strike, strikes_[dtPrev], variances_[dtPrev], interpolations_[dtPrev]);
-        LinearInterpolation tmpInterpolation(xAxis.begin(), xAxis.end(), tmpVars.begin());
-        varReturn = tmpInterpolation(t);
+        // requested between existing expiries (interpolate linearly between expiries)
+        Size i = locate(&times_[0], times_.size(), t, hints.expiry);
+        Real v0 = getVarForStrike(strike, i, hints), v1 = getVarForStrike(strike, i + 1, hints);
+        varReturn = v0 + (t - times_[i]) / (times_[i + 1] - times_[i]) * (v1 - v0);
     } else {
         // far end of expiries
-        varReturn = getVarForStrike(strike, strikes_.back(), variances_.back(), interpolations_.back());
+        varReturn = getVarForStrike(strike, times_.size() - 1, hints);
         varReturn = varReturn * t / times_.back(); // scale
-    } 
+    }
     return varReturn;
 }
+
+Real BlackVarianceSurfaceSparse::blackVarianceImpl(Time t, Real strike) const {
+    SearchHints hints;
+    return variance(t, strike, hints);
+}
+
+void BlackVarianceSurfaceSparse::blackVariance(const std::vector<Time>& times, const std::vector<Real>& strikes,
+                                               std::vector<Real>& variances, bool extrapolate) const {
+    QL_REQUIRE(times.size() == strikes.size(),
+               "BlackVarianceSurfaceSparse: times (" << times.size() << ") and strikes (" << strikes.size()
+                                                     << ") must have the same size");
+    variances.resize(times.size());
+    SearchHints hints(expiries_.size());
+    for (Size i = 0; i < times.size(); ++i) {
+        checkRange(times[i], extrapolate);
+        checkStrike(strikes[i], extrapolate);
+        variances[i] = variance(times[i], strikes[i], hints);
+    }
+}
+
 } // namespace QuantExt
\ No newline at end of file
@@ -26,7 +26,6 @@
 #include <ql/math/interpolations/interpolation2d.hpp>
 #include <ql/termstructures/volatility/equityfx/blackvoltermstructure.hpp>
 #include <ql/time/daycounters/actual365fixed.hpp>
-#include <ql/math/interpolation.hpp>
 
 namespace QuantExt {
 using namespace QuantLib;
@@ -50,6 +49,13 @@ public:
     Real minStrike() const { return 0; }
     Real maxStrike() const { return QL_MAX_REAL; }
 
+    //@}
+    //! \name Batch evaluation
+    //@{
+    using BlackVolTermStructure::blackVariance;
+    //! black variances for the pairs (times[i], strikes[i]), evaluating them in order of time makes best use of hints
+    void blackVariance(const std::vector<Time>& times, const std::vector<Real>& strikes, std::vector<Real>& variances,
+                       bool extrapolate = false) const;
     //@}
     //! \name Visitability
     //@{
@@ -59,15 +65,24 @@ protected:
     virtual Real blackVarianceImpl(Time t, Real strike) const;
 
 private:
-    Real getVarForStrike(Real strike, const std::vector<Real>& strks, const std::vector<Real>& vars,
-                         const QuantLib::Interpolation& intrp) const;
+    /* The last expiry and strike brackets found, successive lookups usually hit the same or the next bracket. The
+       hints are only starting points for the search, they do not affect the results. They live for one lookup resp.
+       one batch only, so that the surface can be shared between threads. Empty strike hints are not used. */
+    struct SearchHints {
+        explicit SearchHints(Size expiries = 0) : expiry(0), strikes(expiries, 0) {}
+        Size expiry;
+        std::vector<Size> strikes;
+    };
+    Real variance(Time t, Real strike, SearchHints& hints) const;
+    Real getVarForStrike(Real strike, Size expiry, SearchHints& hints) const;
 
     DayCounter dayCounter_;
-    std::vector<Date> expiries_;                            // expiries
-    std::vector<Time> times_;                               // times
-    std::vector<Interpolation> interpolations_;             // strike interpolations for each expiry
-    std::vector<std::vector<Real> > strikes_;               // strikes for each expiry
-    std::vector<std::vector<Real> > variances_;
+    std::vector<Date> expiries_; // expiries
+    std::vector<Time> times_;    // times
+    /* The strikes, variances and the slopes of the linear strike interpolation of all expiries are stored in flat
+       arrays, the data of expiry i is in [sliceOffsets_[i], sliceOffsets_[i+1]) */
+    std::vector<Size> sliceOffsets_;
+    std::vector<Real> strikes_, variances_, slopes_;
 };
 
 // inline definitions
@@ -0,0 +1,454 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/termstructures/warmstartbootstrap.hpp
+    \brief bootstrap that can be warm started from a previous build of the same curve
+    \ingroup termstructures
+*/
+
+#ifndef quantext_warm_start_bootstrap_hpp
+#define quantext_warm_start_bootstrap_hpp
+
+#include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+#include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
+#include <ql/termstructures/bootstraperror.hpp>
+#include <ql/termstructures/bootstraphelper.hpp>
+#include <ql/utilities/dataformatters.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! State shared between successive builds of a bootstrapped curve
+/*! Holds the pillar values and the (inverse) Jacobian of the helper quote errors w.r.t. the pillar values of the last
+    successful build together with statistics on the bootstrap effort. The state is only used as a starting point,
+    if the number of alive pillars changes or the warm start does not converge, the curve is bootstrapped from
+    scratch.
+
+    \ingroup termstructures
+*/
+class BootstrapWarmStart {
+public:
+    /*! If globalNewton is true, the curve is built by a global Newton iteration over all pillars using the Jacobian of
+        the previous build, which is computed by finite differences once after a pillar by pillar bootstrap. The
+        rate helpers do not provide sensitivities w.r.t. the curve, so that there is no analytic Jacobian. */
+    explicit BootstrapWarmStart(const bool globalNewton = true)
+        : globalNewton_(globalNewton), iterations_(0), evaluations_(0), usedGlobalNewton_(false), builds_(0) {}
+
+    //! \name Inspectors
+    //@{
+    bool globalNewton() const { return globalNewton_; }
+    //! pillar dates of the last build
+    const std::vector<Date>& dates() const { return dates_; }
+    //! pillar values of the last build
+    const std::vector<Real>& data() const { return data_; }
+    //! inverse Jacobian of the quote errors w.r.t. the pillar values 1, ..., n, empty if not available
+    const Matrix& inverseJacobian() const { return inverseJacobian_; }
+    bool hasData(const Size n) const { return data_.size() == n; }
+    bool hasJacobian(const Size n) const { return inverseJacobian_.rows() == n && inverseJacobian_.columns() == n; }
+    //@}
+
+    //! \name Statistics of the last build
+    //@{
+    //! number of global Newton iterations resp. bootstrap passes
+    Size iterations() const { return iterations_; }
+    //! number of rate helper quote error evaluations, including the ones for the Jacobian
+    Size evaluations() const { return evaluations_; }
+    //! true if the curve was built by the global Newton iteration
+    bool usedGlobalNewton() const { return usedGlobalNewton_; }
+    //! number of successful builds using this state
+    Size builds() const { return builds_; }
+    //@}
+
+    //! \name Modifiers, used by the bootstrap
+    //@{
+    void update(const std::vector<Date>& dates, const std::vector<Real>& data, const Size iterations,
+                const Size evaluations, const bool usedGlobalNewton) {
+        dates_ = dates;
+        data_ = data;
+        iterations_ = iterations;
+        evaluations_ = evaluations;
+        usedGlobalNewton_ = usedGlobalNewton;
+        ++builds_;
+    }
+    void setInverseJacobian(const Matrix& inverseJacobian) { inverseJacobian_ = inverseJacobian; }
+    void resetInverseJacobian() { inverseJacobian_ = Matrix(); }
+    //! forget the previous build
+    void reset() {
+        dates_.clear();
+        data_.clear();
+        inverseJacobian_ = Matrix();
+    }
+    //@}
+
+private:
+    bool globalNewton_;
+    std::vector<Date> dates_;
+    std::vector<Real> data_;
+    Matrix inverseJacobian_;
+    Size iterations_, evaluations_;
+    bool usedGlobalNewton_;
+    Size builds_;
+};
+
+//! Bootstrap for piecewise curves that can be warm started from a previous build
+/*! The pillar by pillar bootstrap follows QuantLib::IterativeBootstrap. In addition
+
+    - the pillar values of a previous build stored in the BootstrapWarmStart state are used as initial guess, if the
+      number of alive pillars did not change
+    - if requested, the curve is built by a global Newton iteration starting from the previous pillar values using
+      the Jacobian of the previous build; if this fails to converge, the pillar by pillar bootstrap is used
+    - the number of iterations and helper evaluations is recorded in the state
+
+    This is meant for repeated builds of nearly identical curves, e.g. intraday market refreshes or par rate bump
+    runs; for a single build it is equivalent to the IterativeBootstrap.
+
+    \ingroup termstructures
+*/
+template <class Curve> class WarmStartBootstrap {
+    typedef typename Curve::traits_type Traits;
+    typedef typename Curve::interpolator_type Interpolator;
+
+public:
+    explicit WarmStartBootstrap(
+        const boost::shared_ptr<BootstrapWarmStart>& warmStart = boost::make_shared<BootstrapWarmStart>());
+    void setup(Curve* ts);
+    void calculate() const;
+    const boost::shared_ptr<BootstrapWarmStart>& warmStart() const { return warmStart_; }
+
+private:
+    // counts the quote error evaluations in the 1d solvers
+    class CountingError {
+    public:
+        CountingError(const BootstrapError<Curve>& error, Size& evaluations)
+            : error_(error), evaluations_(evaluations) {}
+        Real operator()(const Real guess) const {
+            ++evaluations_;
+            return error_(guess);
+        }
+
+    private:
+        const BootstrapError<Curve>& error_;
+        Size& evaluations_;
+    };
+
+    void initialize() const;
+    Real quoteError(const Size i) const;
+    void interpolateAll() const;
+    bool globalNewton() const;
+    void pillarBootstrap(bool validData) const;
+    void updateJacobian() const;
+
+    boost::shared_ptr<BootstrapWarmStart> warmStart_;
+    Curve* ts_;
+    Size n_;
+    Brent firstSolver_;
+    FiniteDifferenceNewtonSafe solver_;
+    mutable bool initialized_, validCurve_;
+    mutable Size firstAliveHelper_, alive_;
+    mutable Size iterations_, evaluations_;
+    mutable std::vector<Real> previousData_;
+    mutable std::vector<boost::shared_ptr<BootstrapError<Curve> > > errors_;
+};
+
+// template definitions
+
+template <class Curve>
+WarmStartBootstrap<Curve>::WarmStartBootstrap(const boost::shared_ptr<BootstrapWarmStart>& warmStart)
+    : warmStart_(warmStart), ts_(0), n_(0), initialized_(false), validCurve_(false), firstAliveHelper_(0),
+      alive_(0), iterations_(0), evaluations_(0) {
+    QL_REQUIRE(warmStart_, "WarmStartBootstrap: no warm start state given");
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::setup(Curve* ts) {
+    ts_ = ts;
+    n_ = ts_->instruments_.size();
+    QL_REQUIRE(n_ > 0, "no bootstrap helpers given");
+    for (Size j = 0; j < n_; ++j)
+        ts_->registerWith(ts_->instruments_[j]);
+    // do not initialize yet: instruments could be invalid here
+    // but valid later when bootstrapping is actually required
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::initialize() const {
+    // ensure helpers are sorted
+    std::sort(ts_->instruments_.begin(), ts_->instruments_.end(), detail::BootstrapHelperSorter());
+
+    // skip expired helpers
+    Date firstDate = Traits::initialDate(ts_);
+    QL_REQUIRE(ts_->instruments_[n_ - 1]->pillarDate() > firstDate, "all instruments expired");
+    firstAliveHelper_ = 0;
+    while (ts_->instruments_[firstAliveHelper_]->pillarDate() <= firstDate)
+        ++firstAliveHelper_;
+    alive_ = n_ - firstAliveHelper_;
+    QL_REQUIRE(alive_ >= Interpolator::requiredPoints - 1, "not enough alive instruments: "
+                                                              << alive_ << " provided, "
+                                                              << Interpolator::requiredPoints - 1 << " required");
+
+    // calculate dates and times, create errors_
+    ts_->dates_.resize(alive_ + 1);
+    ts_->times_.resize(alive_ + 1);
+    errors_.resize(alive_ + 1);
+    ts_->dates_[0] = firstDate;
+    ts_->times_[0] = ts_->timeFromReference(ts_->dates_[0]);
+    for (Size i = 1, j = firstAliveHelper_; j < n_; ++i, ++j) {
+        const boost::shared_ptr<typename Traits::helper>& helper = ts_->instruments_[j];
+        ts_->dates_[i] = helper->pillarDate();
+        ts_->times_[i] = ts_->timeFromReference(ts_->dates_[i]);
+        // check for duplicated pillars
+        QL_REQUIRE(ts_->dates_[i - 1] != ts_->dates_[i], "more than one instrument with pillar " << ts_->dates_[i]);
+        errors_[i] = boost::make_shared<BootstrapError<Curve> >(ts_, helper, i);
+    }
+
+    // set initial guess only if the current curve cannot be used as guess
+    if (!validCurve_ || ts_->data_.size() != alive_ + 1) {
+        ts_->data_ = std::vector<Real>(alive_ + 1, Traits::initialValue(ts_));
+        validCurve_ = false;
+    }
+    previousData_.resize(alive_ + 1);
+    initialized_ = true;
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::calculate() const {
+
+    // we might have to call initialize even if the curve is initialized
+    // and not moving, just because helpers might be date relative and change
+    // with evaluation date change.
+    if (!initialized_ || ts_->moving_)
+        initialize();
+
+    // setup helpers
+    for (Size j = firstAliveHelper_; j < n_; ++j) {
+        const boost::shared_ptr<typename Traits::helper>& helper = ts_->instruments_[j];
+        // check for valid quote
+        QL_REQUIRE(helper->quote()->isValid(), io::ordinal(j + 1) << " instrument (maturity: " << helper->pillarDate()
+                                                                  << ") has an invalid quote");
+        // see IterativeBootstrap, this sets the curve being built on the helper
+        helper->setTermStructure(const_cast<Curve*>(ts_));
+    }
+
+    iterations_ = evaluations_ = 0;
+
+    // start from the current curve or the previous build, if applicable
+    bool warm = validCurve_;
+    if (!warm && warmStart_->hasData(alive_ + 1)) {
+        ts_->data_ = warmStart_->data();
+        warm = true;
+    }
+
+    bool usedGlobalNewton = false;
+    if (warm && warmStart_->globalNewton() && warmStart_->hasJacobian(alive_)) {
+        std::vector<Real> initialData = ts_->data_;
+        usedGlobalNewton = globalNewton();
+        if (!usedGlobalNewton) {
+            // the Jacobian might be outdated, the start values are still a reasonable guess
+            ts_->data_ = initialData;
+            warmStart_->resetInverseJacobian();
+        }
+    }
+
+    if (!usedGlobalNewton) {
+        pillarBootstrap(warm);
+        if (warmStart_->globalNewton())
+            updateJacobian();
+    }
+
+    validCurve_ = true;
+    warmStart_->update(ts_->dates_, ts_->data_, iterations_, evaluations_, usedGlobalNewton);
+}
+
+template <class Curve> Real WarmStartBootstrap<Curve>::quoteError(const Size i) const {
+    ++evaluations_;
+    return ts_->instruments_[firstAliveHelper_ + i - 1]->quoteError();
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::interpolateAll() const {
+    ts_->interpolation_ = ts_->interpolator_.interpolate(ts_->times_.begin(), ts_->times_.end(), ts_->data_.begin());
+    ts_->interpolation_.update();
+}
+
+template <class Curve> bool WarmStartBootstrap<Curve>::globalNewton() const {
+
+    std::vector<Real>& data = ts_->data_;
+    const Matrix& inverseJacobian = warmStart_->inverseJacobian();
+    Array errors(alive_), delta(alive_);
+
+    try {
+        interpolateAll();
+        for (Size iteration = 0; iteration < Traits::maxIterations(); ++iteration) {
+            ++iterations_;
+            for (Size i = 1; i <= alive_; ++i)
+                errors[i - 1] = quoteError(i);
+            delta = inverseJacobian * errors;
+            Real change = 0.0;
+            for (Size i = 1; i <= alive_; ++i) {
+                if (!std::isfinite(delta[i - 1]))
+                    return false;
+                Traits::updateGuess(data, data[i] - delta[i - 1], i);
+                change = std::max(change, std::fabs(delta[i - 1]));
+            }
+            // the new values must stay in the range the pillar by pillar bootstrap would allow
+            for (Size i = 1; i <= alive_; ++i) {
+                if (data[i] < Traits::minValueAfter(i, ts_, true, firstAliveHelper_) ||
+                    data[i] > Traits::maxValueAfter(i, ts_, true, firstAliveHelper_))
+                    return false;
+            }
+            ts_->interpolation_.update();
+            if (change <= ts_->accuracy_)
+                return true;
+        }
+    } catch (const std::exception&) {
+        // fall back on the pillar by pillar bootstrap
+    }
+    return false;
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::pillarBootstrap(bool validData) const {
+
+    const std::vector<Time>& times = ts_->times_;
+    const std::vector<Real>& data = ts_->data_;
+    Real accuracy = ts_->accuracy_;
+    Size maxIterations = Traits::maxIterations() - 1;
+
+    // the start values are only used as guess in the first pass, if they are a bad guess we restart without them
+    bool warm = validData;
+    if (validData)
+        interpolateAll();
+
+    Size iteration = 0;
+    while (true) {
+        ++iterations_;
+        previousData_ = ts_->data_;
+        bool restart = false;
+
+        for (Size i = 1; i <= alive_; ++i) {
+
+            // bracket root and calculate guess
+            Real min = Traits::minValueAfter(i, ts_, validData, firstAliveHelper_);
+            Real max = Traits::maxValueAfter(i, ts_, validData, firstAliveHelper_);
+            Real guess = Traits::guess(i, ts_, validData, firstAliveHelper_);
+            // adjust guess if needed
+            if (guess >= max)
+                guess = max - (max - min) / 5.0;
+            else if (guess <= min)
+                guess = min + (max - min) / 5.0;
+
+            // extend interpolation if needed
+            if (!validData) {
+                try {
+                    // extend interpolation a point at a time including the pillar to be boostrapped
+                    ts_->interpolation_ =
+                        ts_->interpolator_.interpolate(times.begin(), times.begin() + i + 1, data.begin());
+                } catch (...) {
+                    if (!Interpolator::global)
+                        throw; // no chance to fix it in a later iteration
+                    // otherwise use Linear while the target interpolation is not usable yet
+                    ts_->interpolation_ = Linear().interpolate(times.begin(), times.begin() + i + 1, data.begin());
+                }
+                ts_->interpolation_.update();
+            }
+
+            try {
+                CountingError error(*errors_[i], evaluations_);
+                if (validData)
+                    solver_.solve(error, accuracy, guess, min, max);
+                else
+                    firstSolver_.solve(error, accuracy, guess, min, max);
+            } catch (std::exception& e) {
+                if (warm) {
+                    restart = true;
+                    break;
+                }
+                QL_FAIL(io::ordinal(iteration + 1)
+                        << " iteration: failed at " << io::ordinal(i) << " alive instrument, pillar "
+                        << errors_[i]->helper()->pillarDate() << ", maturity " << errors_[i]->helper()->maturityDate()
+                        << ", reference date " << ts_->dates_[0] << ": " << e.what());
+            }
+        }
+
+        if (restart) {
+            ts_->data_ = std::vector<Real>(alive_ + 1, Traits::initialValue(ts_));
+            validData = warm = false;
+            iteration = 0;
+            continue;
+        }
+
+        // for local interpolations one ordered pass is enough, also when warm started
+        if (!Interpolator::global)
+            break;
+        else if (iteration == 0 && !warm) {
+            // at least one more iteration to convergence check
+            validData = true;
+            ++iteration;
+            continue;
+        }
+
+        // exit condition
+        Real change = std::fabs(data[1] - previousData_[1]);
+        for (Size i = 2; i <= alive_; ++i)
+            change = std::max(change, std::fabs(data[i] - previousData_[i]));
+        if (change <= accuracy) // convergence reached
+            break;
+
+        QL_REQUIRE(iteration < maxIterations, "convergence not reached after "
+                                                  << iteration << " iterations; last improvement " << change
+                                                  << ", required accuracy " << accuracy);
+        validData = true;
+        warm = false;
+        ++iteration;
+    }
+}
+
+template <class Curve> void WarmStartBootstrap<Curve>::updateJacobian() const {
+
+    std::vector<Real>& data = ts_->data_;
+    const std::vector<Real> solution = data;
+    Matrix jacobian(alive_, alive_);
+    Array errors(alive_);
+
+    try {
+        for (Size i = 1; i <= alive_; ++i)
+            errors[i - 1] = quoteError(i);
+        for (Size j = 1; j <= alive_; ++j) {
+            Real value = data[j];
+            Real h = std::max(std::fabs(value), 0.01) * 1.0E-6;
+            Traits::updateGuess(data, value + h, j);
+            ts_->interpolation_.update();
+            for (Size i = 1; i <= alive_; ++i)
+                jacobian[i - 1][j - 1] = (quoteError(i) - errors[i - 1]) / h;
+            Traits::updateGuess(data, value, j);
+        }
+        ts_->interpolation_.update();
+        warmStart_->setInverseJacobian(inverse(jacobian));
+    } catch (const std::exception&) {
+        // e.g. a singular Jacobian, the next build will use the pillar by pillar bootstrap again
+        data = solution;
+        ts_->interpolation_.update();
+        warmStart_->resetInverseJacobian();
+    }
+}
+
+} // namespace QuantExt
+
+#endif
@@ -570,6 +570,47 @@ BOOST_AUTO_TEST_CASE(testLgmInvariances) {
     }
 } // testInvariances
 
+BOOST_AUTO_TEST_CASE(testCache) {
+
+    BOOST_TEST_MESSAGE("Testing cached model independent terms in the analytic LGM "
+                       "swaption engine...");
+
+    Handle<YieldTermStructure> discountingCurve(
+        boost::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
+    Handle<YieldTermStructure> forwardingCurve(
+        boost::make_shared<FlatForward>(0, NullCalendar(), 0.05, Actual365Fixed()));
+
+    boost::shared_ptr<SwapIndex> index =
+        boost::make_shared<EuriborSwapIsdaFixA>(10 * Years, forwardingCurve, discountingCurve);
+    Swaption swaption = MakeSwaption(index, 5 * Years, 0.04);
+
+    Array times(0);
+    Array alpha(1, 0.01);
+    Array kappa(1, 0.01);
+    boost::shared_ptr<LinearGaussMarkovModel> lgm =
+        boost::make_shared<LinearGaussMarkovModel>(boost::make_shared<IrLgm1fPiecewiseConstantParametrization>(
+            EURCurrency(), discountingCurve, times, alpha, times, kappa));
+
+    boost::shared_ptr<AnalyticLgmSwaptionEngine> engine = boost::make_shared<AnalyticLgmSwaptionEngine>(lgm);
+    boost::shared_ptr<AnalyticLgmSwaptionEngine> cachingEngine = boost::make_shared<AnalyticLgmSwaptionEngine>(lgm);
+    cachingEngine->enableCache();
+
+    Real tol = 1.0E-12;
+    Array params = lgm->params();
+    for (Size i = 0; i < 5; ++i) {
+        params[0] = 0.005 + 0.0025 * i;
+        lgm->setParams(params);
+        swaption.setPricingEngine(engine);
+        Real npv = swaption.NPV();
+        swaption.setPricingEngine(cachingEngine);
+        Real npvCached = swaption.NPV();
+        if (std::fabs(npv - npvCached) > tol) {
+            BOOST_ERROR("cached engine price (" << npvCached << ") differs from uncached price (" << npv
+                                                << ") for alpha = " << params[0]);
+        }
+    }
+} // testCache
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
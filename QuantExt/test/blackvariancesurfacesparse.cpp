@@ -266,6 +266,41 @@ BOOST_AUTO_TEST_CASE(testBalckVarianceSinglePoint) {
 
 }
 
+BOOST_AUTO_TEST_CASE(testBlackVarianceBatch) {
+    BOOST_TEST_MESSAGE("Testing batch evaluation of BlackVarianceSurfaceSparse");
+
+    SavedSettings backup;
+
+    Settings::instance().evaluationDate() = Date(1, Mar, 2010);
+    Date today = Settings::instance().evaluationDate();
+
+    vector<Date> dates = { Date(1, Mar, 2011), Date(1, Mar, 2011), Date(1, Mar, 2012), Date(1, Mar, 2012) };
+    vector<Real> strikes = { 90.0, 110.0, 80.0, 120.0 };
+    vector<Volatility> vols = { 0.2, 0.3, 0.25, 0.15 };
+    DayCounter dc = ActualActual();
+    auto surface = QuantExt::BlackVarianceSurfaceSparse(today, TARGET(), dates, strikes, vols, dc);
+
+    // linear in strike on each expiry and linear in time between the expiries
+    Time t1 = surface.timeFromReference(dates[0]), t2 = surface.timeFromReference(dates[2]);
+    Real v1 = 0.5 * (0.2 * 0.2 + 0.3 * 0.3) * t1, v2 = 0.5 * (0.25 * 0.25 + 0.15 * 0.15) * t2;
+    Time t = 0.25 * t1 + 0.75 * t2;
+    BOOST_CHECK_CLOSE(surface.blackVariance(t, 100.0), 0.25 * v1 + 0.75 * v2, 1e-12);
+
+    // batch evaluation in an order that moves the search hints back and forth matches single evaluations
+    vector<Time> times;
+    vector<Real> batchStrikes;
+    for (Size i = 0; i < 200; ++i) {
+        times.push_back(((i * 37) % 200) * 0.02);
+        batchStrikes.push_back(60.0 + ((i * 53) % 200) * 0.4);
+    }
+    vector<Real> variances;
+    surface.blackVariance(times, batchStrikes, variances);
+    BOOST_REQUIRE_EQUAL(variances.size(), times.size());
+    for (Size i = 0; i < times.size(); ++i)
+        BOOST_CHECK_CLOSE(variances[i], surface.blackVariance(times[i], batchStrikes[i]), 1e-12);
+
+    BOOST_CHECK_THROW(surface.blackVariance(times, vector<Real>(1, 100.0), variances), QuantLib::Error);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
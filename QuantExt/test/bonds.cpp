@@ -19,6 +19,7 @@
 #include "toplevelfixture.hpp"
 #include <boost/test/unit_test.hpp>
 #include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/credit/flathazardrate.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
@@ -128,6 +129,57 @@ BOOST_AUTO_TEST_CASE(testBondSpreads) {
     BOOST_TEST_MESSAGE("Bond spread of " << bondSpecificSpread->value() << " means price of " << pricePar);
     BOOST_CHECK_CLOSE(pricePar, parRedemption, 0.0001);
 }
+
+BOOST_AUTO_TEST_CASE(testRiskyBondEngineBatchEvaluation) {
+
+    BOOST_TEST_MESSAGE("Testing risky bond engine against a period by period valuation");
+
+    SavedSettings backup;
+    Date today(8, Dec, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    DayCounter dc = Actual365Fixed();
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(today, 0.02, dc));
+    Handle<DefaultProbabilityTermStructure> dpts(boost::make_shared<FlatHazardRate>(today, 0.015, dc));
+    Handle<Quote> recovery(boost::make_shared<SimpleQuote>(0.4));
+    Calendar calendar = WeekendsOnly();
+
+    // coupon bond, started before today, and zero bond
+    Schedule schedule(Date(15, Mar, 2016), Date(15, Mar, 2026), 6 * Months, calendar, Following, Following,
+                      DateGeneration::Backward, false);
+    Leg couponLeg = FixedRateLeg(schedule).withNotionals(100.0).withCouponRates(0.03, dc);
+    boost::shared_ptr<QuantLib::Bond> couponBond =
+        boost::make_shared<QuantLib::Bond>(0, calendar, Date(15, Mar, 2016), couponLeg);
+    Leg zeroLeg(1, boost::make_shared<Redemption>(100.0, Date(20, Jun, 2022)));
+    boost::shared_ptr<QuantLib::Bond> zeroBond = boost::make_shared<QuantLib::Bond>(0, calendar, today, zeroLeg);
+
+    Period step = 1 * Months;
+    boost::shared_ptr<PricingEngine> engine =
+        boost::make_shared<QuantExt::DiscountingRiskyBondEngine>(yts, dpts, recovery, Handle<Quote>(), step);
+    couponBond->setPricingEngine(engine);
+    zeroBond->setPricingEngine(engine);
+
+    // reference values from the scalar curve calls
+    Real expected = 0.0;
+    for (auto const& cf : couponLeg) {
+        if (cf->hasOccurred(today))
+            continue;
+        auto cpn = boost::dynamic_pointer_cast<Coupon>(cf);
+        Date start = std::max(cpn->accrualStartDate(), today), end = cpn->accrualEndDate();
+        expected += cf->amount() * dpts->survivalProbability(cf->date()) * yts->discount(cf->date());
+        Date defaultDate = start + (end - start) / 2;
+        expected += cpn->nominal() * 0.4 * dpts->defaultProbability(start, end) * yts->discount(defaultDate);
+    }
+    BOOST_CHECK_CLOSE(couponBond->NPV(), expected, 1.0E-10);
+
+    expected = 100.0 * dpts->survivalProbability(zeroLeg[0]->date()) * yts->discount(zeroLeg[0]->date());
+    for (Date start = today; start < zeroLeg[0]->date(); start += step) {
+        Date end = std::min(start + step, zeroLeg[0]->date());
+        expected += 100.0 * 0.4 * dpts->defaultProbability(start, end) * yts->discount(start + (end - start) / 2);
+    }
+    BOOST_CHECK_CLOSE(zeroBond->NPV(), expected, 1.0E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -20,11 +20,15 @@
 #include <boost/make_shared.hpp>
 #include <boost/test/unit_test.hpp>
 #include <ql/currencies/all.hpp>
+#include <ql/indexes/ibor/eonia.hpp>
 #include <ql/indexes/indexmanager.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/cashflows/averageonindexedcoupon.hpp>
+#include <qle/cashflows/averageonindexedcouponpricer.hpp>
 #include <qle/cashflows/equitycoupon.hpp>
 #include <qle/cashflows/equitycouponpricer.hpp>
 #include <qle/cashflows/fxlinkedcashflow.hpp>
@@ -173,6 +177,49 @@ BOOST_AUTO_TEST_CASE(testEquityCoupon) {
     BOOST_CHECK_CLOSE(eq4.amount(), expectedAmount, 1e-10);
 }
 
+BOOST_AUTO_TEST_CASE(testAverageONAccruedStateCache) {
+
+    BOOST_TEST_MESSAGE("Testing cached accrued state of average ON coupons against full recomputation");
+
+    Date today(5, Jan, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    Handle<YieldTermStructure> curve(boost::make_shared<FlatForward>(0, TARGET(), 0.01, Actual360()));
+    boost::shared_ptr<OvernightIndex> index = boost::make_shared<Eonia>(curve);
+    boost::shared_ptr<AverageONIndexedCouponPricer> pricer = boost::make_shared<AverageONIndexedCouponPricer>();
+
+    AverageONIndexedCoupon cached(Date(5, Jul, 2016), 1.0, today, Date(5, Jul, 2016), index, 1.0, 0.0, 0,
+                                  Actual360());
+    AverageONIndexedCoupon full(Date(5, Jul, 2016), 1.0, today, Date(5, Jul, 2016), index, 1.0, 0.0, 0,
+                                Actual360());
+    cached.setPricer(pricer);
+    full.setPricer(pricer);
+    cached.enableAccruedStateCache(true);
+
+    // two paths stepping forward in time, appending fixings for the dates passed since the last step as a
+    // simulation would, the fixing history is restored and the accrued state reset between the paths
+    std::vector<Date> steps = { Date(20, Jan, 2016), Date(1, Mar, 2016), Date(4, Apr, 2016), Date(1, Jul, 2016) };
+    const std::vector<Date>& fixingDates = cached.fixingDates();
+    for (Size path = 0; path < 2; ++path) {
+        Settings::instance().evaluationDate() = today;
+        BOOST_CHECK_CLOSE(cached.rate(), full.rate(), 1e-10);
+        Date last = today;
+        for (auto const& d : steps) {
+            for (auto const& f : fixingDates) {
+                if (f >= last && f < d)
+                    index->addFixing(f, 0.01 + 0.001 * path + 0.0001 * (f - today) / 30.0);
+            }
+            Settings::instance().evaluationDate() = d;
+            BOOST_CHECK_CLOSE(cached.rate(), full.rate(), 1e-10);
+            // pricing again at the same date reuses the state
+            BOOST_CHECK_CLOSE(cached.rate(), full.rate(), 1e-10);
+            last = d;
+        }
+        IndexManager::instance().clearHistory(index->name());
+        cached.resetAccruedState();
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
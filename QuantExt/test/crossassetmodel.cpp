@@ -166,6 +166,27 @@ struct BermudanTestData {
     Real reversion;
 }; // BermudanTestData
 
+// numeric lgm engines evaluating the conditional swap values point by point
+class PointwiseNumericLgmSwaptionEngine : public NumericLgmSwaptionEngine {
+public:
+    using NumericLgmSwaptionEngine::NumericLgmSwaptionEngine;
+
+protected:
+    void conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0, Real* u) const {
+        NumericLgmSwaptionEngineBase::conditionalSwapValues(x, n, t, expiry0, u);
+    }
+};
+
+class PointwiseNumericLgmNonstandardSwaptionEngine : public NumericLgmNonstandardSwaptionEngine {
+public:
+    using NumericLgmNonstandardSwaptionEngine::NumericLgmNonstandardSwaptionEngine;
+
+protected:
+    void conditionalSwapValues(const Real* x, Size n, Real t, const Date expiry0, Real* u) const {
+        NumericLgmSwaptionEngineBase::conditionalSwapValues(x, n, t, expiry0, u);
+    }
+};
+
 } // anonymous namespace
 
 BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
@@ -287,6 +308,64 @@ BOOST_AUTO_TEST_CASE(testNonstandardBermudanSwaption) {
                     << (npv - ns_npv) << ", tolerance is " << tol);
 } // testNonstandardBermudanSwaption
 
+BOOST_AUTO_TEST_CASE(testNumericLgmSwaptionEngineGridSlices) {
+
+    BOOST_TEST_MESSAGE("Testing numeric LGM swaption engine grid slice against pointwise evaluation...");
+
+    BermudanTestData d;
+
+    boost::shared_ptr<NonstandardSwaption> ns_swaption = boost::make_shared<NonstandardSwaption>(*d.swaption);
+
+    boost::shared_ptr<IrLgm1fParametrization> lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(
+        EURCurrency(), d.yts, d.stepTimes_a, d.sigmas_a, d.stepTimes_a, d.kappas_a);
+
+    boost::shared_ptr<LinearGaussMarkovModel> lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    // the forwarding curve differs from the model curve, so that the fwd-fwd correction is non-trivial
+    Handle<YieldTermStructure> fwdCurve(boost::make_shared<FlatForward>(d.evalDate, 0.025, Actual365Fixed()));
+    boost::shared_ptr<VanillaSwap> underlying = boost::make_shared<VanillaSwap>(
+        VanillaSwap::Receiver, 1.0, d.fixedSchedule, 0.02, Thirty360(), d.floatingSchedule,
+        boost::make_shared<Euribor>(6 * Months, fwdCurve), 0.001, Actual360());
+    Swaption swaption(underlying, d.exercise);
+
+    Handle<YieldTermStructure> discountCurve(boost::make_shared<FlatForward>(d.evalDate, 0.015, Actual365Fixed()));
+
+    Real tol = 1.0E-12;
+    for (Size i = 0; i < 2; ++i) {
+        Handle<YieldTermStructure> disc = i == 0 ? Handle<YieldTermStructure>() : discountCurve;
+        boost::shared_ptr<PricingEngine> engine =
+            boost::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, disc);
+        boost::shared_ptr<PricingEngine> engineRef =
+            boost::make_shared<PointwiseNumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, disc);
+        boost::shared_ptr<PricingEngine> ns_engine =
+            boost::make_shared<NumericLgmNonstandardSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, disc);
+        boost::shared_ptr<PricingEngine> ns_engineRef =
+            boost::make_shared<PointwiseNumericLgmNonstandardSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, disc);
+
+        swaption.setPricingEngine(engineRef);
+        Real npvRef = swaption.NPV();
+        ns_swaption->setPricingEngine(ns_engineRef);
+        Real ns_npvRef = ns_swaption->NPV();
+
+        // the second pass uses the cached fixing periods
+        for (Size j = 0; j < 2; ++j) {
+            swaption.setPricingEngine(engine);
+            ns_swaption->setPricingEngine(ns_engine);
+            Real npv = swaption.NPV();
+            Real ns_npv = ns_swaption->NPV();
+            if (std::fabs(npv - npvRef) >= tol)
+                BOOST_ERROR("Failed to verify grid slice swaption price ("
+                            << npv << ") against pointwise price (" << npvRef << "), difference is " << (npv - npvRef)
+                            << ", tolerance is " << tol << ", discount curve " << i << ", pass " << j);
+            if (std::fabs(ns_npv - ns_npvRef) >= tol)
+                BOOST_ERROR("Failed to verify grid slice nonstandard swaption price ("
+                            << ns_npv << ") against pointwise price (" << ns_npvRef << "), difference is "
+                            << (ns_npv - ns_npvRef) << ", tolerance is " << tol << ", discount curve " << i
+                            << ", pass " << j);
+        }
+    }
+} // testNumericLgmSwaptionEngineGridSlices
+
 BOOST_AUTO_TEST_CASE(testLgm1fCalibration) {
 
     BOOST_TEST_MESSAGE("Testing calibration of LGM 1F model (analytic engine) "
@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/weekendsonly.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+#include <qle/instruments/creditdefaultswap.hpp>
+#include <qle/pricingengines/midpointcdsengine.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+
+namespace {
+
+struct LegNpvs {
+    Real couponLeg, defaultLeg;
+};
+
+// period by period valuation of a running CDS sold at the given spread, using scalar curve calls only
+LegNpvs scalarCdsValuation(const Leg& leg, const Date& today, Real notional, Real recovery, bool paysAtDefaultTime,
+                           const Handle<YieldTermStructure>& yts,
+                           const Handle<DefaultProbabilityTermStructure>& dpts) {
+    LegNpvs result = {0.0, 0.0};
+    for (auto const& cf : leg) {
+        if (cf->hasOccurred(today))
+            continue;
+        auto cpn = boost::dynamic_pointer_cast<FixedRateCoupon>(cf);
+        Date start = cpn->accrualStartDate(), end = cpn->accrualEndDate();
+        Date effectiveStart = (start <= today && today <= end) ? today : start;
+        Date defaultDate = effectiveStart + (end - effectiveStart) / 2;
+        Probability P = dpts->defaultProbability(effectiveStart, end);
+        Real df = paysAtDefaultTime ? yts->discount(defaultDate) : yts->discount(cf->date());
+        result.couponLeg += dpts->survivalProbability(cf->date()) * cf->amount() * yts->discount(cf->date());
+        result.couponLeg += P * (paysAtDefaultTime ? cpn->accruedAmount(defaultDate) : cf->amount()) * df;
+        result.defaultLeg -= notional * (1.0 - recovery) * P * df;
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MidPointCdsEngineTest)
+
+BOOST_AUTO_TEST_CASE(testBatchEvaluation) {
+
+    BOOST_TEST_MESSAGE("Testing mid-point CDS engine against a period by period valuation");
+
+    SavedSettings backup;
+    Date today(8, Dec, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    DayCounter dc = Actual365Fixed();
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(today, 0.02, dc));
+    Handle<DefaultProbabilityTermStructure> dpts(boost::make_shared<FlatHazardRate>(today, 0.015, dc));
+    Real recovery = 0.4, notional = 1.0E7, spread = 0.01;
+    Calendar calendar = WeekendsOnly();
+
+    // running CDS with quarterly premiums, started before today
+    Schedule schedule(Date(20, Sep, 2016), Date(20, Dec, 2026), 3 * Months, calendar, Following, Unadjusted,
+                      DateGeneration::Backward, false);
+    boost::shared_ptr<PricingEngine> engine = boost::make_shared<QuantExt::MidPointCdsEngine>(dpts, recovery, yts);
+
+    for (bool paysAtDefaultTime : {true, false}) {
+        QuantExt::CreditDefaultSwap cds(Protection::Seller, notional, spread, schedule, Following, Actual360(), true,
+                                        paysAtDefaultTime);
+        cds.setPricingEngine(engine);
+        LegNpvs expected = scalarCdsValuation(cds.coupons(), today, notional, recovery, paysAtDefaultTime, yts, dpts);
+        BOOST_CHECK_CLOSE(cds.couponLegNPV(), expected.couponLeg, 1.0E-10);
+        BOOST_CHECK_CLOSE(cds.defaultLegNPV(), expected.defaultLeg, 1.0E-10);
+        BOOST_CHECK_CLOSE(cds.NPV(), expected.couponLeg + expected.defaultLeg, 1.0E-10);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
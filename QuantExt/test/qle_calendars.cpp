@@ -17,8 +17,14 @@
 */
 
 #include "toplevelfixture.hpp"
+#include "utilities.hpp"
 #include <boost/test/unit_test.hpp>
 #include <ql/time/calendar.hpp>
+#include <ql/time/calendars/jointcalendar.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/calendars/unitedkingdom.hpp>
+#include <ql/time/calendars/unitedstates.hpp>
+#include <qle/calendars/cachedcalendar.hpp>
 #include <qle/calendars/chile.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/france.hpp>
@@ -263,6 +269,52 @@ BOOST_AUTO_TEST_CASE(testFrenchCalendar) {
     check::checkCalendars(expectedHolidays, hol);
 }
 
+BOOST_AUTO_TEST_CASE(testCachedCalendar) {
+
+    BOOST_TEST_MESSAGE("Testing cached calendar against the wrapped calendar");
+
+    // the cached range ends before the end of the test period to test the fallback as well
+    Calendar joint = JointCalendar(TARGET(), UnitedKingdom(), UnitedStates());
+    CachedCalendar cached(joint, 2000, 2030);
+
+    BOOST_CHECK(cached == joint);
+    BOOST_CHECK_EQUAL(cached.name(), joint.name());
+
+    BusinessDayConvention conventions[] = { Following, ModifiedFollowing, Preceding, ModifiedPreceding, Unadjusted };
+    Integer steps[] = { -100, -25, -2, -1, 0, 1, 2, 25, 100 };
+
+    for (Date d(15, December, 1999); d <= Date(15, January, 2032); ++d) {
+        BOOST_REQUIRE_EQUAL(cached.isBusinessDay(d), joint.isBusinessDay(d));
+        for (Size i = 0; i < LENGTH(conventions); ++i) {
+            BOOST_REQUIRE_EQUAL(cached.adjust(d, conventions[i]), joint.adjust(d, conventions[i]));
+            BOOST_REQUIRE_EQUAL(static_cast<const Calendar&>(cached).adjust(d, conventions[i]),
+                                joint.adjust(d, conventions[i]));
+        }
+        for (Size i = 0; i < LENGTH(steps); ++i) {
+            BOOST_REQUIRE_EQUAL(cached.advance(d, steps[i], Days), joint.advance(d, steps[i], Days));
+            BOOST_REQUIRE_EQUAL(cached.advance(d, steps[i] * Days, ModifiedFollowing),
+                                joint.advance(d, steps[i] * Days, ModifiedFollowing));
+            BOOST_REQUIRE_EQUAL(cached.advance(d, steps[i], Months, ModifiedFollowing, true),
+                                joint.advance(d, steps[i], Months, ModifiedFollowing, true));
+            Date d2 = d + steps[i];
+            for (Size k = 0; k < 4; ++k) {
+                bool includeFirst = k % 2 == 0, includeLast = k / 2 == 0;
+                BOOST_REQUIRE_EQUAL(cached.businessDaysBetween(d, d2, includeFirst, includeLast),
+                                    joint.businessDaysBetween(d, d2, includeFirst, includeLast));
+            }
+        }
+    }
+
+    // holidays added to the cached calendar are taken into account
+    Date d(14, June, 2019);
+    BOOST_REQUIRE(cached.isBusinessDay(d));
+    cached.addHoliday(d);
+    BOOST_CHECK(!cached.isBusinessDay(d));
+    BOOST_CHECK_EQUAL(cached.adjust(d), Date(17, June, 2019));
+    BOOST_CHECK_EQUAL(cached.advance(Date(13, June, 2019), 1, Days), Date(17, June, 2019));
+    BOOST_CHECK_EQUAL(cached.businessDaysBetween(Date(13, June, 2019), Date(17, June, 2019)), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
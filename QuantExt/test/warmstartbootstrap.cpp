@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2019 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+#include "toplevelfixture.hpp"
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/math/interpolations/loglinearinterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+#include <qle/termstructures/warmstartbootstrap.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using std::vector;
+
+namespace {
+
+// deposit and swap helpers on quotes that can be shifted
+struct TestData {
+    TestData() : today(15, Aug, 2018), dc(Actual365Fixed()) {
+        Settings::instance().evaluationDate() = today;
+        boost::shared_ptr<IborIndex> index = boost::make_shared<Euribor>(6 * Months);
+        Real depositRates[] = { 0.010, 0.011, 0.012 };
+        Period depositTenors[] = { 1 * Months, 3 * Months, 6 * Months };
+        for (Size i = 0; i < 3; ++i) {
+            quotes.push_back(boost::make_shared<SimpleQuote>(depositRates[i]));
+            helpers.push_back(boost::make_shared<DepositRateHelper>(Handle<Quote>(quotes.back()), depositTenors[i], 2,
+                                                                    TARGET(), ModifiedFollowing, false, Actual360()));
+        }
+        for (Size i = 1; i <= 15; ++i) {
+            quotes.push_back(boost::make_shared<SimpleQuote>(0.013 + 0.001 * i - 0.00003 * i * i));
+            helpers.push_back(boost::make_shared<SwapRateHelper>(Handle<Quote>(quotes.back()), i * Years, TARGET(),
+                                                                 Annual, ModifiedFollowing, Thirty360(), index));
+        }
+    }
+    void shift(const Real s) {
+        for (Size i = 0; i < quotes.size(); ++i)
+            quotes[i]->setValue(quotes[i]->value() + s * (1.0 + 0.1 * i));
+    }
+    SavedSettings backup;
+    Date today;
+    DayCounter dc;
+    vector<boost::shared_ptr<SimpleQuote> > quotes;
+    vector<boost::shared_ptr<RateHelper> > helpers;
+};
+
+template <class Traits, class Interpolator>
+void testWarmStart(const bool globalNewton, const Interpolator& interpolator = Interpolator()) {
+
+    TestData d;
+    boost::shared_ptr<BootstrapWarmStart> warmStart = boost::make_shared<BootstrapWarmStart>(globalNewton);
+    typedef PiecewiseYieldCurve<Traits, Interpolator, WarmStartBootstrap> WarmCurve;
+
+    Real tol = 1.0E-9;
+    for (Size k = 0; k < 4; ++k) {
+        // fresh curves on each build, as in ore::data::YieldCurve
+        PiecewiseYieldCurve<Traits, Interpolator> curve(d.today, d.helpers, d.dc, 1.0E-12, interpolator);
+        WarmCurve warmCurve(d.today, d.helpers, d.dc, 1.0E-12, interpolator, WarmStartBootstrap<WarmCurve>(warmStart));
+        for (Size i = 1; i <= 20; ++i) {
+            Date date = d.today + i * Years;
+            Real expected = curve.discount(date);
+            Real discount = warmCurve.discount(date);
+            if (std::fabs(discount - expected) > tol)
+                BOOST_ERROR("warm started discount factor (" << discount << ") differs from iterative bootstrap ("
+                                                             << expected << ") at " << date << " in build " << k
+                                                             << ", global Newton " << globalNewton);
+        }
+        BOOST_TEST_MESSAGE("build " << k << ": " << warmStart->iterations() << " iterations, "
+                                    << warmStart->evaluations() << " evaluations, global Newton used "
+                                    << warmStart->usedGlobalNewton());
+        BOOST_CHECK_EQUAL(warmStart->builds(), k + 1);
+        if (k > 0)
+            BOOST_CHECK_EQUAL(warmStart->usedGlobalNewton(), globalNewton);
+        // the curve itself reacts on quote changes as well
+        d.shift(0.0001);
+        if (k == 3) {
+            Real expected = curve.discount(d.today + 10 * Years);
+            Real discount = warmCurve.discount(d.today + 10 * Years);
+            BOOST_CHECK_SMALL(discount - expected, tol);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(WarmStartBootstrapTest)
+
+BOOST_AUTO_TEST_CASE(testLocalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing warm started bootstrap with local interpolation...");
+    testWarmStart<Discount, LogLinear>(false);
+    testWarmStart<Discount, LogLinear>(true);
+    testWarmStart<ZeroYield, Linear>(true);
+}
+
+BOOST_AUTO_TEST_CASE(testGlobalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing warm started bootstrap with global interpolation...");
+    testWarmStart<ZeroYield, Cubic>(false, Cubic(CubicInterpolation::Kruger, true));
+    testWarmStart<ZeroYield, Cubic>(true, Cubic(CubicInterpolation::Kruger, true));
+}
+
+BOOST_AUTO_TEST_CASE(testChangingPillars) {
+
+    BOOST_TEST_MESSAGE("Testing warm started bootstrap with changing number of pillars...");
+
+    TestData d;
+    boost::shared_ptr<BootstrapWarmStart> warmStart = boost::make_shared<BootstrapWarmStart>();
+    typedef PiecewiseYieldCurve<Discount, LogLinear, WarmStartBootstrap> WarmCurve;
+
+    WarmCurve warmCurve(d.today, d.helpers, d.dc, 1.0E-12, LogLinear(), WarmStartBootstrap<WarmCurve>(warmStart));
+    warmCurve.discount(1.0);
+    BOOST_CHECK(warmStart->hasJacobian(d.helpers.size()));
+
+    // a state with a different number of pillars is not used
+    vector<boost::shared_ptr<RateHelper> > helpers(d.helpers.begin(), d.helpers.end() - 1);
+    PiecewiseYieldCurve<Discount, LogLinear> curve(d.today, helpers, d.dc, 1.0E-12);
+    WarmCurve warmCurve2(d.today, helpers, d.dc, 1.0E-12, LogLinear(), WarmStartBootstrap<WarmCurve>(warmStart));
+    BOOST_CHECK_SMALL(warmCurve2.discount(10.0) - curve.discount(10.0), 1.0E-9);
+    BOOST_CHECK(!warmStart->usedGlobalNewton());
+    BOOST_CHECK(warmStart->hasJacobian(helpers.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()